@@ -31,6 +31,7 @@
 #include <ghoul/opengl/texture.h>
 #include <ghoul/filesystem/file.h>
 #include <memory>
+#include <vector>
 
 namespace openspace {
 
@@ -48,6 +49,17 @@ public:
     size_t width();
     void setCallback(TfChangedCallback callback);
     void setTextureFromTxt(std::shared_ptr<ghoul::opengl::Texture> ptr);
+
+    /// Returns the texels of the transfer function texture
+    std::vector<glm::vec4> samples();
+
+    /**
+     * Reads a transfer function in the txt format and returns its texels, with the
+     * colors premultiplied by alpha. No texture is created, so this can be used without
+     * an OpenGL context. An empty vector is returned if the file has no mapping keys.
+     */
+    static std::vector<glm::vec4> samplesFromTxt(const std::string& filepath);
+
 private:
     void setTextureFromTxt() {
         setTextureFromTxt(_texture);
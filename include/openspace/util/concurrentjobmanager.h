@@ -25,11 +25,9 @@
 #ifndef __OPENSPACE_CORE___CONCURRENT_JOB_MANAGER___H__
 #define __OPENSPACE_CORE___CONCURRENT_JOB_MANAGER___H__
 
-#include <openspace/util/concurrentqueue.h>
+#include <openspace/util/concurrentringbuffer.h>
 #include <openspace/util/threadpool.h>
 
-#include <mutex>
-
 namespace openspace {
 
 // Templated abstract base class representing a job to be done.
@@ -61,8 +59,7 @@ public:
     size_t numFinishedJobs() const;
 
 private:
-    ConcurrentQueue<std::shared_ptr<Job<P>>> _finishedJobs;
-    std::mutex _finishedJobsMutex;
+    ConcurrentRingBuffer<std::shared_ptr<Job<P>>> _finishedJobs;
     ThreadPool threadPool;
 };
 
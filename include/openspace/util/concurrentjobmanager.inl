@@ -25,6 +25,13 @@
 #include <ghoul/misc/assert.h>
 
 namespace openspace {
+
+namespace detail {
+    // Initial capacity of the lock-free part of the finished jobs queue. Jobs that are
+    // finished while the queue is full are kept in an unbounded overflow queue
+    constexpr const size_t FinishedJobsCapacity = 1024;
+} // namespace detail
+
 template<typename P>
 Job<P>::Job() {}
 
@@ -33,14 +40,14 @@ Job<P>::~Job() {}
 
 template<typename P>
 ConcurrentJobManager<P>::ConcurrentJobManager(ThreadPool pool)
-    : threadPool(pool)
+    : _finishedJobs(detail::FinishedJobsCapacity)
+    , threadPool(pool)
 { }
 
 template<typename P>
 void ConcurrentJobManager<P>::enqueueJob(std::shared_ptr<Job<P>> job) {
     threadPool.enqueue([this, job]() {
         job->execute();
-        std::lock_guard<std::mutex> lock(_finishedJobsMutex);
         _finishedJobs.push(job);
     });
 }
@@ -53,7 +60,6 @@ void ConcurrentJobManager<P>::clearEnqueuedJobs() {
 template<typename P>
 std::shared_ptr<Job<P>> ConcurrentJobManager<P>::popFinishedJob() {
     ghoul_assert(_finishedJobs.size() > 0, "There is no finished job to pop!");
-    std::lock_guard<std::mutex> lock(_finishedJobsMutex);
     return _finishedJobs.pop();
 }
 
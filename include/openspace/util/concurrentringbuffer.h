@@ -0,0 +1,121 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___CONCURRENT_RING_BUFFER___H__
+#define __OPENSPACE_CORE___CONCURRENT_RING_BUFFER___H__
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <type_traits>
+
+namespace openspace {
+
+/**
+ * Templated lock-free multi-producer/multi-consumer queue based on a bounded ring buffer
+ * (after Dmitry Vyukov's bounded MPMC queue). It offers the same push/pop/size interface
+ * as the ConcurrentQueue, but producers and consumers only synchronize through atomic
+ * sequence numbers on the individual slots. The capacity is rounded up to the next power
+ * of two.
+ *
+ * What happens when the ring buffer is full is selected by the OnFull policy. With
+ * OnFull::Block, push spins until a consumer has freed a slot. With OnFull::Overflow,
+ * the surplus items are stored in a mutex-protected unbounded queue that is drained
+ * after the ring buffer, so that the producers never wait on the consumers.
+ */
+template <typename T>
+class ConcurrentRingBuffer {
+public:
+    enum class OnFull {
+        Block = 0,
+        Overflow
+    };
+
+    ConcurrentRingBuffer(size_t capacity, OnFull onFull = OnFull::Overflow);
+    ~ConcurrentRingBuffer();
+
+    ConcurrentRingBuffer(const ConcurrentRingBuffer&) = delete;
+    ConcurrentRingBuffer& operator=(const ConcurrentRingBuffer&) = delete;
+
+    /// Returns the first item, waiting for one to become available if necessary
+    T pop();
+
+    void pop(T& item);
+
+    /// Returns false without waiting if the queue is empty
+    bool tryPop(T& item);
+
+    void push(const T& item);
+
+    void push(T&& item);
+
+    /// Returns false without waiting if the ring buffer is full; never overflows. The
+    /// item is not ordered after items that are currently overflowing
+    bool tryPush(const T& item);
+
+    bool tryPush(T&& item);
+
+    /// Returns the number of items, which is only approximate while the queue is in use
+    size_t size() const;
+
+    size_t capacity() const;
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    template <typename U>
+    bool tryPushRing(U&& item);
+    bool tryPopRing(T& item);
+
+    template <typename U>
+    void pushImpl(U&& item);
+
+    static constexpr const size_t CacheLineSize = 64;
+
+    const size_t _mask;
+    const OnFull _onFull;
+    std::unique_ptr<Cell[]> _buffer;
+
+    // Producers and consumers only touch their own position, so keep them on separate
+    // cache lines to avoid false sharing
+    alignas(CacheLineSize) std::atomic<size_t> _enqueuePosition;
+    alignas(CacheLineSize) std::atomic<size_t> _dequeuePosition;
+
+    alignas(CacheLineSize) std::atomic<size_t> _nOverflowItems;
+    // Number of producers that are pushing into the ring buffer while the queue is not
+    // overflowing
+    std::atomic<size_t> _nRingPushers;
+    std::queue<T> _overflow;
+    std::mutex _overflowMutex;
+};
+
+} // namespace openspace
+
+#include "concurrentringbuffer.inl"
+
+#endif // __OPENSPACE_CORE___CONCURRENT_RING_BUFFER___H__
@@ -0,0 +1,229 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+namespace openspace {
+
+namespace detail {
+
+inline size_t nextPowerOfTwo(size_t v) {
+    size_t result = 1;
+    while (result < v) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace detail
+
+template <typename T>
+ConcurrentRingBuffer<T>::ConcurrentRingBuffer(size_t capacity, OnFull onFull)
+    : _mask(detail::nextPowerOfTwo(std::max<size_t>(capacity, 2)) - 1)
+    , _onFull(onFull)
+    , _buffer(new Cell[_mask + 1])
+    , _enqueuePosition(0)
+    , _dequeuePosition(0)
+    , _nOverflowItems(0)
+    , _nRingPushers(0)
+{
+    for (size_t i = 0; i <= _mask; ++i) {
+        _buffer[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+ConcurrentRingBuffer<T>::~ConcurrentRingBuffer() {
+    // Destroy the items that are still stored in the ring buffer
+    T item;
+    while (tryPopRing(item)) {}
+}
+
+template <typename T>
+template <typename U>
+bool ConcurrentRingBuffer<T>::tryPushRing(U&& item) {
+    Cell* cell;
+    size_t pos = _enqueuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        cell = &_buffer[pos & _mask];
+        const size_t seq = cell->sequence.load(std::memory_order_acquire);
+        const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            // The slot is free; try to claim it
+            if (_enqueuePosition.compare_exchange_weak(
+                    pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // The slot still holds an item from the previous lap, so we are full
+            return false;
+        }
+        else {
+            // Another producer claimed the slot before us
+            pos = _enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    new (&cell->storage) T(std::forward<U>(item));
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool ConcurrentRingBuffer<T>::tryPopRing(T& item) {
+    Cell* cell;
+    size_t pos = _dequeuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        cell = &_buffer[pos & _mask];
+        const size_t seq = cell->sequence.load(std::memory_order_acquire);
+        const intptr_t diff =
+            static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (_dequeuePosition.compare_exchange_weak(
+                    pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // The slot has not been written yet, so we are empty
+            return false;
+        }
+        else {
+            pos = _dequeuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    T* storedItem = reinterpret_cast<T*>(&cell->storage);
+    item = std::move(*storedItem);
+    storedItem->~T();
+    // Mark the slot as free for the producer one lap ahead
+    cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+template <typename U>
+void ConcurrentRingBuffer<T>::pushImpl(U&& item) {
+    if (_onFull == OnFull::Overflow) {
+        // As long as there are overflowing items, new items have to go after them to
+        // keep the order of the queue. Producers announce themselves in _nRingPushers
+        // before checking for overflowing items, so that a producer that starts to
+        // overflow can wait for the ones that are still pushing into the ring buffer
+        _nRingPushers.fetch_add(1);
+        if (_nOverflowItems.load() == 0 && tryPushRing(std::forward<U>(item))) {
+            _nRingPushers.fetch_sub(1);
+            return;
+        }
+        _nRingPushers.fetch_sub(1);
+
+        std::lock_guard<std::mutex> lock(_overflowMutex);
+        // A consumer might have drained the overflow queue in the meantime
+        if (_nOverflowItems.load() == 0 && tryPushRing(std::forward<U>(item))) {
+            return;
+        }
+        // Raising the counter first makes new producers take the lock; the ones that
+        // have already seen an empty overflow queue finish their push first
+        _nOverflowItems.fetch_add(1);
+        while (_nRingPushers.load() > 0) {
+            std::this_thread::yield();
+        }
+        _overflow.push(std::forward<U>(item));
+    }
+    else {
+        while (!tryPushRing(std::forward<U>(item))) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+template <typename T>
+T ConcurrentRingBuffer<T>::pop() {
+    T item;
+    pop(item);
+    return item;
+}
+
+template <typename T>
+void ConcurrentRingBuffer<T>::pop(T& item) {
+    while (!tryPop(item)) {
+        std::this_thread::yield();
+    }
+}
+
+template <typename T>
+bool ConcurrentRingBuffer<T>::tryPop(T& item) {
+    if (tryPopRing(item)) {
+        return true;
+    }
+    if (_nOverflowItems > 0) {
+        std::lock_guard<std::mutex> lock(_overflowMutex);
+        if (!_overflow.empty()) {
+            item = std::move(_overflow.front());
+            _overflow.pop();
+            --_nOverflowItems;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+void ConcurrentRingBuffer<T>::push(const T& item) {
+    pushImpl(item);
+}
+
+template <typename T>
+void ConcurrentRingBuffer<T>::push(T&& item) {
+    pushImpl(std::move(item));
+}
+
+template <typename T>
+bool ConcurrentRingBuffer<T>::tryPush(const T& item) {
+    return tryPushRing(item);
+}
+
+template <typename T>
+bool ConcurrentRingBuffer<T>::tryPush(T&& item) {
+    return tryPushRing(std::move(item));
+}
+
+template <typename T>
+size_t ConcurrentRingBuffer<T>::size() const {
+    const size_t dequeuePos = _dequeuePosition.load(std::memory_order_relaxed);
+    const size_t enqueuePos = _enqueuePosition.load(std::memory_order_relaxed);
+    const size_t ringSize = (enqueuePos > dequeuePos) ? enqueuePos - dequeuePos : 0;
+    return ringSize + _nOverflowItems;
+}
+
+template <typename T>
+size_t ConcurrentRingBuffer<T>::capacity() const {
+    return _mask + 1;
+}
+
+} // namespace openspace
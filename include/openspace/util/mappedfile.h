@@ -0,0 +1,84 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___MAPPEDFILE___H__
+#define __OPENSPACE_CORE___MAPPEDFILE___H__
+
+#include <string>
+
+namespace openspace {
+
+/**
+ * A read-only memory mapping of an entire file. The pages of the file are only read from
+ * disk when they are first accessed and can be dropped by the operating system under
+ * memory pressure, which makes it possible to work on files that are larger than the
+ * available RAM.
+ */
+class MappedFile {
+public:
+    enum class AccessPattern {
+        Sequential = 0,
+        Random
+    };
+
+    /**
+     * Maps the file at \p path into memory. The \p accessPattern is forwarded to the
+     * operating system as a hint for its read-ahead.
+     * \throw ghoul::RuntimeError If the file could not be opened or mapped
+     */
+    explicit MappedFile(const std::string& path,
+        AccessPattern accessPattern = AccessPattern::Sequential);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const std::string& path() const;
+    const char* data() const;
+    size_t size() const;
+
+    /**
+     * Hints to the operating system that the bytes in the range
+     * [<code>offset</code>, <code>offset + length</code>) will be accessed soon, so that
+     * they can be read from disk ahead of time.
+     */
+    void prefetch(size_t offset, size_t length) const;
+
+    /**
+     * Reads one byte of every page in the range
+     * [<code>offset</code>, <code>offset + length</code>), so that the range has been
+     * read from disk when this function returns. Unlike prefetch, this blocks the calling
+     * thread instead of the thread that accesses the range first.
+     */
+    void touch(size_t offset, size_t length) const;
+
+private:
+    std::string _path;
+    const char* _data = nullptr;
+    size_t _size = 0;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___MAPPEDFILE___H__
@@ -0,0 +1,130 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___SPECKLOADER___H__
+#define __OPENSPACE_CORE___SPECKLOADER___H__
+
+#include <ghoul/glm.h>
+#include <string>
+#include <vector>
+
+namespace openspace::speck {
+
+/**
+ * The contents of a speck file. Every data line of the file describes one entry, which
+ * consists of its x, y, and z coordinates followed by the values of the data variables.
+ * The values of all entries are stored back to back in #entries, so the values of the
+ * <code>i</code>-th entry start at <code>i * valuesPerEntry</code>. This is the layout
+ * in which the renderables cache and upload the data, so it can be used without
+ * reordering.
+ */
+struct Dataset {
+    struct Variable {
+        // Index of the variable in the file. X, Y, and Z are not counted, so the values
+        // of the variable start at index + 3 in each entry
+        int index;
+        std::string name;
+    };
+
+    struct Texture {
+        int index;
+        std::string file;
+    };
+
+    struct Mesh {
+        int textureIndex = 0;
+        int colorIndex = 0;
+        // 'solid', 'wire', or 'point'. Empty if the mesh did not specify a style
+        std::string style;
+        int numU = 0;
+        int numV = 0;
+        // Up to seven values per vertex, in the order they were specified in the file
+        std::vector<float> vertices;
+    };
+
+    /// Returns the number of entries in the dataset
+    size_t nEntries() const;
+
+    /// Returns the index of the variable with the provided \p name or -1 if the dataset
+    /// does not contain a variable with that name
+    int variableIndex(const std::string& name) const;
+
+    std::vector<Variable> variables;
+    std::vector<Texture> textures;
+    std::vector<Mesh> meshes;
+
+    // Index of the variable containing the texture index of each entry, -1 if the file
+    // does not specify a 'texturevar'
+    int textureDataIndex = -1;
+    // Index of the first of the six variables containing the orientation vectors of each
+    // entry, -1 if the file does not specify a 'polyorivar'
+    int orientationDataIndex = -1;
+
+    int valuesPerEntry = 3;
+    std::vector<float> entries;
+};
+
+/**
+ * The labels of a label file. The position and text of the <code>i</code>-th label are
+ * stored at index <code>i</code> of the two vectors.
+ */
+struct Labels {
+    std::vector<glm::vec3> positions;
+    std::vector<std::string> texts;
+};
+
+/**
+ * Loads the speck file at \p path. The file is memory mapped and the header, which
+ * contains the data variables, textures and meshes, is parsed first. The data lines that
+ * follow the header are split into chunks that are parsed concurrently by up to
+ * \p nThreads threads. If \p nThreads is 0, one thread per hardware thread is used.
+ * Files that are too small to benefit from it are parsed on the calling thread.
+ * Values that are missing from a data line or that cannot be parsed are set to 0.
+ *
+ * \throw ghoul::RuntimeError If the file could not be opened or the header is malformed
+ */
+Dataset loadSpeckFile(const std::string& path, size_t nThreads = 0);
+
+/**
+ * Loads the label file at \p path. Lines up to and including the <code>textcolor</code>
+ * line are skipped, every following line contains the position of a label, the
+ * <code>text</code> keyword, and the text of the label, optionally followed by a
+ * comment that is separated by a <code>#</code>.
+ *
+ * \throw ghoul::RuntimeError If the file could not be opened
+ */
+Labels loadLabelFile(const std::string& path);
+
+/**
+ * Loads the color map file at \p path. The first line that is not a comment contains
+ * the number of colors, each of the following lines contains one RGBA color.
+ *
+ * \throw ghoul::RuntimeError If the file could not be opened or contains fewer colors
+ *        than specified
+ */
+std::vector<glm::vec4> loadColorMapFile(const std::string& path);
+
+} // namespace openspace::speck
+
+#endif // __OPENSPACE_CORE___SPECKLOADER___H__
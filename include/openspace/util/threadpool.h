@@ -25,50 +25,127 @@
 #ifndef __OPENSPACE_CORE___THREAD_POOL___H__
 #define __OPENSPACE_CORE___THREAD_POOL___H__
 
+#include <array>
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
+#include <future>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <vector>
-#include <atomic>
-
-// Implementatin based on http://progsch.net/wordpress/?p=81
 
 namespace openspace {
 
 class ThreadPool;
 
+/**
+ * A CancellationToken can be passed along with a task to the ThreadPool. If the token is
+ * cancelled before a worker picks up the task, the task is discarded without being
+ * executed. Copies of a token share the same cancellation state.
+ */
+class CancellationToken {
+public:
+    CancellationToken();
+
+    void cancel();
+    bool isCancelled() const;
+
+private:
+    friend class ThreadPool;
+
+    std::shared_ptr<std::atomic_bool> _isCancelled;
+};
+
 class Worker {
 public:
-    Worker(ThreadPool& pool);
+    Worker(ThreadPool& pool, size_t index);
     void operator()();
 private:
     ThreadPool& pool;
+    size_t index;
 };
 
+/**
+ * A work-stealing thread pool. Each worker owns a set of task queues (one per
+ * Priority), each protected by its own lock, so that producers and consumers only
+ * contend when they touch the same worker. Tasks enqueued from outside of the pool are
+ * distributed round-robin over the workers, tasks enqueued from within a running task
+ * are placed on the calling worker's queue. A worker always executes its own tasks in
+ * FIFO order and steals from the back of other workers' queues when it runs dry.
+ * Higher priority tasks are always picked before lower priority tasks.
+ */
 class ThreadPool {
 public:
+    enum class Priority {
+        High = 0,
+        Normal,
+        Low
+    };
+
     ThreadPool(size_t numThreads);
     ThreadPool(const ThreadPool& toCopy);
     ~ThreadPool();
 
-    void enqueue(std::function<void()> f);
+    void enqueue(std::function<void()> f, Priority priority = Priority::Normal);
+    void enqueue(std::function<void()> f, Priority priority, CancellationToken token);
+
+    /**
+     * Enqueues the callable \p f and returns a future for its result. If the task is
+     * cancelled through \p token or removed by clearTasks before it is executed, the
+     * returned future will throw a <code>std::future_error</code> with the
+     * <code>broken_promise</code> error code.
+     */
+    template <typename F>
+    auto submit(F&& f, Priority priority = Priority::Normal)
+        -> std::future<decltype(f())>;
+
+    template <typename F>
+    auto submit(F&& f, Priority priority, CancellationToken token)
+        -> std::future<decltype(f())>;
+
     void clearTasks();
 
+    size_t numThreads() const;
+    size_t numQueuedTasks() const;
+
 private:
     friend class Worker;
 
+    static constexpr const int NumPriorities = 3;
+
+    struct Task {
+        std::function<void()> function;
+        // Empty for tasks that were enqueued without a CancellationToken
+        std::shared_ptr<const std::atomic_bool> isCancelled;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::array<std::deque<Task>, NumPriorities> tasks;
+        // Total number of tasks in all priorities, readable without taking the lock
+        std::atomic<size_t> size = { 0 };
+    };
+
+    void push(Task task, Priority priority);
+    bool popTask(size_t workerIndex, Task& task);
+
     std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkQueue>> queues;
 
-    std::deque<std::function<void()>> tasks;
+    std::atomic<size_t> nextQueue;
+    std::atomic<size_t> nQueuedTasks;
+    std::atomic<size_t> nSleepingWorkers;
 
-    std::mutex queue_mutex;
+    std::mutex sleep_mutex;
     std::condition_variable condition;
 
-    bool stop;
+    std::atomic_bool stop;
 };
 
 } // namespace openspace
 
+#include "threadpool.inl"
+
 #endif // __OPENSPACE_CORE___THREAD_POOL___H__
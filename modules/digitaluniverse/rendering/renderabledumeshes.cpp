@@ -27,6 +27,7 @@
 #include <modules/digitaluniverse/digitaluniversemodule.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/util/speckloader.h>
 #include <openspace/util/updatestructures.h>
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/rendering/renderengine.h>
@@ -701,215 +702,62 @@ bool RenderableDUMeshes::loadData() {
 }
 
 bool RenderableDUMeshes::readSpeckFile() {
-    std::string _file = _speckFile;
-    std::ifstream file(_file);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Speck file '{}'", _file));
+    speck::Dataset dataset;
+    try {
+        dataset = speck::loadSpeckFile(_speckFile);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(fmt::format("Failed to read Speck file '{}': {}", _speckFile, e.message));
         return false;
     }
 
     int meshIndex = 0;
+    for (speck::Dataset::Mesh& m : dataset.meshes) {
+        RenderingMesh mesh;
+        mesh.meshIndex = meshIndex;
+        mesh.textureIndex = m.textureIndex;
+        mesh.colorIndex = m.colorIndex;
+        mesh.numU = m.numU;
+        mesh.numV = m.numV;
+        mesh.vertices = std::move(m.vertices);
 
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line = "";
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        if (file.eof()) {
-            break;
+        // For now we support only wire, which is also used if no style is specified
+        if (m.style == "solid") {
+            mesh.style = Solid;
         }
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
+        else if (m.style == "wire" || m.style.empty()) {
+            mesh.style = Wire;
         }
-
-        if (line.empty() || line[0] == '#') {
-            continue;
+        else if (m.style == "point") {
+            mesh.style = Point;
         }
-
-        if (line.substr(0, 4) != "mesh") {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            break;
+        else {
+            mesh.style = INVALID;
         }
 
-        if (line.substr(0, 4) == "mesh") {
-            // mesh lines are structured as follows:
-            // mesh -t texnum -c colorindex -s style {
-            // where textnum is the index of the texture;
-            // colorindex is the index of the color for the mesh
-            // and style is solid, wire or point (for now we support only wire)
-            std::stringstream str(line);
-
-            RenderingMesh mesh;
-            mesh.meshIndex = meshIndex;
-
-            std::string dummy;
-            str >> dummy; // mesh command
-            dummy.clear();
-            str >> dummy; // texture index command?
-            do {
-                if (dummy == "-t") {
-                    dummy.clear();
-                    str >> mesh.textureIndex; // texture index
-                }
-                else if (dummy == "-c") {
-                    dummy.clear();
-                    str >> mesh.colorIndex; // color index command
-                }
-                else if (dummy == "-s") {
-                    dummy.clear();
-                    str >> dummy; // style value command
-                    if (dummy == "solid") {
-                        mesh.style = Solid;
-                    }
-                    else if (dummy == "wire") {
-                        mesh.style = Wire;
-                    }
-                    else if (dummy == "point") {
-                        mesh.style = Point;
-                    }
-                    else {
-                        mesh.style = INVALID;
-                        break;
-                    }
-                }
-                dummy.clear();
-                str >> dummy;
-            } while (dummy != "{");
-
-            std::getline(file, line);
-            std::stringstream dim(line);
-            dim >> mesh.numU; // numU
-            dim >> mesh.numV; // numV
-
-            // We can now read the vertices data:
-            for (int l = 0; l < mesh.numU * mesh.numV; ++l) {
-                std::getline(file, line);
-                if (line.substr(0, 1) != "}") {
-                    std::stringstream lineData(line);
-                    for (int i = 0; i < 7; ++i) {
-                        GLfloat value;
-                        lineData >> value;
-                        bool errorReading = lineData.rdstate() & std::ifstream::failbit;
-                        if (!errorReading) {
-                            mesh.vertices.push_back(value);
-                        }
-                        else {
-                            break;
-                        }
-                    }
-                }
-                else {
-                    break;
-                }
-            }
-
-            std::getline(file, line);
-            if (line.substr(0, 1) == "}") {
-                _renderingMeshesMap.insert({ meshIndex++, mesh });
-            }
-            else {
-                return false;
-            }
-        }
+        _renderingMeshesMap.insert({ meshIndex++, std::move(mesh) });
     }
 
     return true;
 }
 
 bool RenderableDUMeshes::readLabelFile() {
-    std::string _file = _labelFile;
-    std::ifstream file(_file);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Label file '{}'", _file));
-        return false;
+    speck::Labels labels;
+    try {
+        labels = speck::loadLabelFile(_labelFile);
     }
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line = "";
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-
-        if (line.substr(0, 9) != "textcolor") {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            continue;
-        }
-
-        if (line.substr(0, 9) == "textcolor") {
-            // textcolor lines are structured as follows:
-            // textcolor # description
-            // where # is color text defined in configuration file
-            std::stringstream str(line);
-
-            // TODO: handle cases of labels with different colors
-            break;
-        }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(fmt::format("Failed to read Label file '{}': {}", _labelFile, e.message));
+        return false;
     }
 
-
-    do {
-        std::vector<float> values(_nValuesPerAstronomicalObject);
-
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-        if (line.empty()) {
-            continue;
-        }
-
-        std::stringstream str(line);
-
-        glm::vec3 position;
-        for (auto j = 0; j < 3; ++j) {
-            str >> position[j];
-        }
-
-        std::string dummy;
-        str >> dummy; // text keyword
-
-        std::string label;
-        str >> label;
-        dummy.clear();
-
-        while (str >> dummy) {
-            label += " " + dummy;
-            dummy.clear();
-        }
-
+    _labelData.reserve(_labelData.size() + labels.texts.size());
+    for (size_t i = 0; i < labels.texts.size(); ++i) {
         glm::vec3 transformedPos = glm::vec3(
-            _transformationMatrix * glm::dvec4(position, 1.0)
+            _transformationMatrix * glm::dvec4(labels.positions[i], 1.0)
         );
-        _labelData.push_back(std::make_pair(transformedPos, label));
-
-    } while (!file.eof());
+        _labelData.emplace_back(transformedPos, std::move(labels.texts[i]));
+    }
 
     return true;
 }
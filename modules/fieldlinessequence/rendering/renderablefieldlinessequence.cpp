@@ -38,6 +38,7 @@
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/textureunit.h>
 #include <fstream>
+#include <limits>
 #include <sstream>
 
 namespace {
@@ -46,6 +47,12 @@ namespace {
     const GLuint VaPosition = 0; // MUST CORRESPOND TO THE SHADER PROGRAM
     const GLuint VaColor    = 1; // MUST CORRESPOND TO THE SHADER PROGRAM
     const GLuint VaMasking  = 2; // MUST CORRESPOND TO THE SHADER PROGRAM
+    const GLuint VaMorphPosition = 3; // MUST CORRESPOND TO THE SHADER PROGRAM
+
+    // Maximum number of bytes of the next state that are uploaded per update when
+    // morphing. The next state is not needed until the current one has been shown for a
+    // while, so its upload is spread over several frames
+    constexpr const size_t MorphUploadBytesPerUpdate = 4 * 1024 * 1024;
 
     // ----- KEYS POSSIBLE IN MODFILE. EXPECTED DATA TYPE OF VALUE IN [BRACKETS]  ----- //
     // ---------------------------- MANDATORY MODFILE KEYS ---------------------------- //
@@ -65,10 +72,15 @@ namespace {
     constexpr const char* KeyCdfExtraVariables = "ExtraVariables";
     // [STRING]
     constexpr const char* KeyCdfTracingVariable = "TracingVariable";
+    // [INTEGER] Number of .cdf files that are converted at the same time. Each file
+    // needs its own copy of the simulation data in memory
+    constexpr const char* KeyCdfConcurrentFiles = "ConcurrentFiles";
     // [STRING]
     constexpr const char* KeyJsonScalingFactor = "ScaleToMeters";
     // [BOOLEAN] If value False => Load in initializing step and store in RAM
     constexpr const char* KeyOslfsLoadAtRuntime = "LoadAtRuntime";
+    // [INTEGER] Number of states kept in memory ahead of time when loading at runtime
+    constexpr const char* KeyOslfsPrefetchedStates = "PrefetchedStates";
 
     // ---------------------------- OPTIONAL MODFILE KEYS  ---------------------------- //
     // [STRING ARRAY] Values should be paths to .txt files
@@ -357,7 +369,7 @@ void RenderableFieldlinesSequence::initializeGL() {
 
     //------------------ Initialize OpenGL VBOs and VAOs-------------------------------//
     glGenVertexArrays(1, &_vertexArrayObject);
-    glGenBuffers(1, &_vertexPositionBuffer);
+    glGenBuffers(2, _vertexPositionBuffers.data());
     glGenBuffers(1, &_vertexColorBuffer);
     glGenBuffers(1, &_vertexMaskingBuffer);
 
@@ -576,13 +588,17 @@ bool RenderableFieldlinesSequence::loadJsonStatesIntoRAM(const std::string& outp
 bool RenderableFieldlinesSequence::prepareForOsflsStreaming() {
     extractTriggerTimesFromFileNames();
     FieldlinesState newState;
-    if (!newState.loadStateFromOsfls(_sourceFiles[0])) {
+    if (!newState.loadStateFromOsfls(_sourceFiles[0], true)) {
         LERROR("The provided .osfls files seem to be corrupt!");
         return false;
     }
     _states.push_back(newState);
     _nStates = _startTimes.size();
     _activeStateIndex = 0;
+    _stateStreamer = std::make_unique<FieldlinesStateStreamer>(
+        _sourceFiles,
+        _nPrefetchedStates
+    );
     return true;
 
 }
@@ -616,6 +632,13 @@ void RenderableFieldlinesSequence::extractOsflsInfoFromDictionary() {
             _identifier, KeyOslfsLoadAtRuntime
         ));
     }
+
+    float nPrefetchedStates;
+    if (_dictionary->getValue(KeyOslfsPrefetchedStates, nPrefetchedStates) &&
+        nPrefetchedStates >= 1.f)
+    {
+        _nPrefetchedStates = static_cast<size_t>(nPrefetchedStates);
+    }
 }
 
 void RenderableFieldlinesSequence::setupProperties() {
@@ -691,6 +714,8 @@ void RenderableFieldlinesSequence::setupProperties() {
         _pMaskingQuantity = 0;
         _pMaskingMin = std::to_string(_maskingRanges[0].x);
         _pMaskingMax = std::to_string(_maskingRanges[0].y);
+
+        updateStreamedQuantities();
     }
 }
 
@@ -700,6 +725,7 @@ void RenderableFieldlinesSequence::definePropertyCallbackFunctions() {
     if (hasExtras) {
         _pColorQuantity.onChange([this] {
             _shouldUpdateColorBuffer = true;
+            updateStreamedQuantities();
             _pColorQuantityMin = std::to_string(_colorTableRanges[_pColorQuantity].x);
             _pColorQuantityMax = std::to_string(_colorTableRanges[_pColorQuantity].y);
             _pColorTablePath = _colorTablePaths[_pColorQuantity];
@@ -730,6 +756,7 @@ void RenderableFieldlinesSequence::definePropertyCallbackFunctions() {
 
         _pMaskingQuantity.onChange([this] {
             _shouldUpdateMaskingBuffer = true;
+            updateStreamedQuantities();
             _pMaskingMin = std::to_string(_maskingRanges[_pMaskingQuantity].x);
             _pMaskingMax = std::to_string(_maskingRanges[_pMaskingQuantity].y);
         });
@@ -868,20 +895,24 @@ bool RenderableFieldlinesSequence::getStatesFromCdfFiles(const std::string& outp
     std::vector<std::string> extraMagVars;
     extractMagnitudeVarsFromStrings(extraVars, extraMagVars);
 
-    // Load states into RAM!
-    for (const std::string& cdfPath : _sourceFiles) {
-
-        FieldlinesState newState;
-        bool isSuccessful = fls::convertCdfToFieldlinesState(newState, cdfPath,
-            seedPoints, tracingVar, extraVars, extraMagVars);
-
-        if (isSuccessful) {
+    float nConcurrentFiles = 1.f;
+    _dictionary->getValue(KeyCdfConcurrentFiles, nConcurrentFiles);
+
+    // Load states into RAM! The states are added in the order of the source files
+    fls::convertCdfsToFieldlinesStates(
+        _sourceFiles,
+        seedPoints,
+        tracingVar,
+        extraVars,
+        extraMagVars,
+        [this, &outputFolder](size_t, FieldlinesState& newState) {
             addStateToSequence(newState);
             if (!outputFolder.empty()) {
                 newState.saveStateToOsfls(outputFolder);
             }
-        }
-    }
+        },
+        static_cast<unsigned int>(std::max(nConcurrentFiles, 1.f))
+    );
     return true;
 }
 
@@ -994,8 +1025,9 @@ void RenderableFieldlinesSequence::deinitializeGL() {
     glDeleteVertexArrays(1, &_vertexArrayObject);
     _vertexArrayObject = 0;
 
-    glDeleteBuffers(1, &_vertexPositionBuffer);
-    _vertexPositionBuffer = 0;
+    glDeleteBuffers(2, _vertexPositionBuffers.data());
+    _vertexPositionBuffers = { 0, 0 };
+    _positionBufferStateIndex = { -1, -1 };
 
     glDeleteBuffers(1, &_vertexColorBuffer);
     _vertexColorBuffer = 0;
@@ -1009,15 +1041,8 @@ void RenderableFieldlinesSequence::deinitializeGL() {
         _shaderProgram = nullptr;
     }
 
-    // Stall main thread until thread that's loading states is done!
-    bool printedWarning = false;
-    while (_isLoadingStateFromDisk) {
-        if (!printedWarning) {
-            LWARNING("Trying to destroy class when an active thread is still using it");
-            printedWarning = true;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
-    }
+    // Waits for the state that is currently being read from disk
+    _stateStreamer = nullptr;
 }
 
 bool RenderableFieldlinesSequence::isReady() const {
@@ -1039,6 +1064,7 @@ void RenderableFieldlinesSequence::render(const RenderData& data, RendererTasks&
         _shaderProgram->setUniform("modelViewProjection",
                 data.camera.sgctInternal.projectionMatrix() * glm::mat4(modelViewMat));
 
+        _shaderProgram->setUniform("morphFactor",  _morphFactor);
         _shaderProgram->setUniform("colorMethod",  _pColorMethod);
         _shaderProgram->setUniform("lineColor",    _pColorUniform);
         _shaderProgram->setUniform("usingDomain",  _pDomainEnabled);
@@ -1131,9 +1157,27 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
             // true => We stepped forward to a time represented by another state
             || (nextIdx < _nStates && currentTime >= _startTimes[nextIdx]))
         {
+            const int prevTriggerTimeIndex = _activeTriggerTimeIndex;
             updateActiveTriggerTimeIndex(currentTime);
 
             if (_loadingStatesDynamically) {
+                // Prefetch in the direction that time is moving. When time is paused,
+                // scrubbing determines the direction instead
+                const double deltaTime = data.time.deltaTime();
+                if (deltaTime != 0.0) {
+                    _prefetchDirection = deltaTime > 0.0 ? 1 : -1;
+                }
+                else if (prevTriggerTimeIndex >= 0) {
+                    _prefetchDirection =
+                        _activeTriggerTimeIndex >= prevTriggerTimeIndex ? 1 : -1;
+                }
+                // The state that was kept as morph target does not need to be read again
+                const bool isMorphTarget =
+                    _morphTargetStateIndex == _activeTriggerTimeIndex;
+                const int prefetchIndex = isMorphTarget ?
+                    _activeTriggerTimeIndex + 1 :
+                    _activeTriggerTimeIndex;
+                _stateStreamer->prefetch(prefetchIndex, _prefetchDirection);
                 _mustLoadNewStateFromDisk = true;
             } else {
                 _needsUpdate = true;
@@ -1147,24 +1191,27 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
         _needsUpdate              = false;
     }
 
+    // Swaps in the active state as soon as the streamer has read it, or directly if it
+    // was kept as the morph target. Until then, the previous state is rendered
     if (_mustLoadNewStateFromDisk) {
-        if (!_isLoadingStateFromDisk && !_newStateIsReady) {
-            _isLoadingStateFromDisk    = true;
-            _mustLoadNewStateFromDisk  = false;
-            std::string filePath = _sourceFiles[_activeTriggerTimeIndex];
-            std::thread readBinaryThread([this, f = std::move(filePath)] {
-                readNewState(f);
-            });
-            readBinaryThread.detach();
+        bool isLoaded = false;
+        if (_morphTargetStateIndex == _activeTriggerTimeIndex) {
+            std::swap(_states[0], _morphTargetState);
+            _morphTargetStateIndex = -1;
+            isLoaded = true;
+        }
+        else {
+            isLoaded = _stateStreamer->fetch(_activeTriggerTimeIndex, _states[0]);
         }
-    }
 
-    if (_needsUpdate || _newStateIsReady) {
-        if (_loadingStatesDynamically) {
-            _states[0] = std::move(*_newState);
+        if (isLoaded) {
+            _mustLoadNewStateFromDisk = false;
+            _needsUpdate              = true;
         }
+    }
 
-        updateVertexPositionBuffer();
+    if (_needsUpdate) {
+        _shownStateIndex = _activeTriggerTimeIndex;
 
         if (_states[_activeStateIndex].nExtraQuantities() > 0) {
             _shouldUpdateColorBuffer   = true;
@@ -1172,8 +1219,11 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
         }
 
         // Everything is set and ready for rendering!
-        _needsUpdate     = false;
-        _newStateIsReady = false;
+        _needsUpdate = false;
+    }
+
+    if (_activeTriggerTimeIndex != -1) {
+        updateVertexPositionBuffers(currentTime);
     }
 
     if (_shouldUpdateColorBuffer) {
@@ -1204,54 +1254,163 @@ void RenderableFieldlinesSequence::updateActiveTriggerTimeIndex(double currentTi
     }
 }
 
-// Reading state from disk. Must be thread safe!
-void RenderableFieldlinesSequence::readNewState(const std::string& filePath) {
-    _newState = std::make_unique<FieldlinesState>();
-    if (_newState->loadStateFromOsfls(filePath)) {
-        _newStateIsReady = true;
-    }
-    _isLoadingStateFromDisk = false;
-}
-
 // Unbind buffers and arrays
 inline void unbindGL() {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 }
 
-void RenderableFieldlinesSequence::updateVertexPositionBuffer() {
-    glBindVertexArray(_vertexArrayObject);
-    glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffer);
+// Returns the state after the shown state if the positions can be interpolated towards
+// it, nullptr otherwise
+const FieldlinesState* RenderableFieldlinesSequence::morphTarget() {
+    const FieldlinesState& shown = _states[_activeStateIndex];
+    const size_t next = static_cast<size_t>(_shownStateIndex) + 1;
+    if (!shown.isMorphable() || next >= _nStates) {
+        return nullptr;
+    }
 
-    const std::vector<glm::vec3>& vertPos = _states[_activeStateIndex].vertexPositions();
+    const FieldlinesState* target = nullptr;
+    if (_loadingStatesDynamically) {
+        if (_morphTargetStateIndex != static_cast<int>(next)) {
+            if (!_stateStreamer->fetch(static_cast<int>(next), _morphTargetState)) {
+                return nullptr;
+            }
+            _morphTargetStateIndex = static_cast<int>(next);
+        }
+        target = &_morphTargetState;
+    }
+    else {
+        target = &_states[next];
+    }
 
-    glBufferData(
-        GL_ARRAY_BUFFER,
-        vertPos.size() * sizeof(glm::vec3),
-        vertPos.data(),
-        GL_STATIC_DRAW
+    // Only states that consist of the same lines can be interpolated
+    const bool isCompatible = target->isMorphable() &&
+                              target->lineCount() == shown.lineCount();
+    return isCompatible ? target : nullptr;
+}
+
+// Uploads the vertex positions of state, which has the trigger time index stateIndex,
+// to the position buffer with index buffer. Continues a previous upload of the same state
+// and uploads at most maxBytes. Returns true if the whole state has been uploaded
+bool RenderableFieldlinesSequence::uploadVertexPositions(int buffer, int stateIndex,
+                                                         const FieldlinesState& state,
+                                                         size_t maxBytes)
+{
+    const size_t totalBytes = state.nVertices() * sizeof(glm::vec3);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffers[buffer]);
+    if (_positionBufferStateIndex[buffer] != stateIndex) {
+        // Orphans the previous storage, so the upload does not wait for draw calls that
+        // still use it
+        glBufferData(GL_ARRAY_BUFFER, totalBytes, nullptr, GL_STATIC_DRAW);
+        _positionBufferStateIndex[buffer] = stateIndex;
+        _positionBufferUploadedBytes[buffer] = 0;
+    }
+
+    // For memory mapped states, the positions are uploaded straight from the file
+    const size_t offset = _positionBufferUploadedBytes[buffer];
+    const size_t nBytes = std::min(totalBytes - offset, maxBytes);
+    if (nBytes > 0) {
+        glBufferSubData(
+            GL_ARRAY_BUFFER,
+            offset,
+            nBytes,
+            reinterpret_cast<const char*>(state.vertexPositionData()) + offset
+        );
+        _positionBufferUploadedBytes[buffer] += nBytes;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return _positionBufferUploadedBytes[buffer] == totalBytes;
+}
+
+// Makes sure that the shown state is in one of the position buffers. For morphable
+// sequences, the next state is uploaded to the other buffer over the following updates
+// and the positions are interpolated towards it once it is complete. When the sequence
+// advances to the next state, the buffers switch roles so that only the new next state
+// has to be uploaded
+void RenderableFieldlinesSequence::updateVertexPositionBuffers(double currentTime) {
+    if (_shownStateIndex == -1) {
+        return;
+    }
+
+    int current = -1;
+    for (int i = 0; i < 2; ++i) {
+        if (_positionBufferStateIndex[i] == _shownStateIndex) {
+            current = i;
+        }
+    }
+    if (current == -1) {
+        // Keep the buffer that already holds the next state, if any
+        current = _positionBufferStateIndex[0] == _shownStateIndex + 1 ? 1 : 0;
+    }
+    // The shown state is needed right away
+    uploadVertexPositions(
+        current,
+        _shownStateIndex,
+        _states[_activeStateIndex],
+        std::numeric_limits<size_t>::max()
     );
 
+    const int next = 1 - current;
+    _morphFactor = 0.f;
+    const FieldlinesState* target = morphTarget();
+    if (target) {
+        const bool isComplete = uploadVertexPositions(
+            next,
+            _shownStateIndex + 1,
+            *target,
+            MorphUploadBytesPerUpdate
+        );
+        if (isComplete) {
+            const double start = _startTimes[_shownStateIndex];
+            const double end = _startTimes[_shownStateIndex + 1];
+            _morphFactor = static_cast<float>(
+                glm::clamp((currentTime - start) / (end - start), 0.0, 1.0)
+            );
+        }
+    }
+
+    glBindVertexArray(_vertexArrayObject);
+    glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffers[current]);
     glEnableVertexAttribArray(VaPosition);
     glVertexAttribPointer(VaPosition, 3, GL_FLOAT, GL_FALSE, 0, 0);
 
+    if (_morphFactor > 0.f) {
+        glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffers[next]);
+        glEnableVertexAttribArray(VaMorphPosition);
+        glVertexAttribPointer(VaMorphPosition, 3, GL_FLOAT, GL_FALSE, 0, 0);
+    }
+    else {
+        glDisableVertexAttribArray(VaMorphPosition);
+    }
+
     unbindGL();
 }
 
+void RenderableFieldlinesSequence::updateStreamedQuantities() {
+    if (_stateStreamer) {
+        _stateStreamer->setResidentQuantities({
+            static_cast<size_t>(_pColorQuantity),
+            static_cast<size_t>(_pMaskingQuantity)
+        });
+    }
+}
+
 void RenderableFieldlinesSequence::updateVertexColorBuffer() {
     glBindVertexArray(_vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, _vertexColorBuffer);
 
-    bool isSuccessful;
-    const std::vector<float>& quantities = _states[_activeStateIndex].extraQuantity(
-        _pColorQuantity, isSuccessful
-    );
+    // The streamer reads the selected quantity of memory mapped states from disk while
+    // loading them, so it is only read here if it was selected after the state was loaded
+    const FieldlinesState& state = _states[_activeStateIndex];
+    const float* quantities = state.extraQuantityData(_pColorQuantity);
 
-    if (isSuccessful) {
+    if (quantities) {
         glBufferData(
             GL_ARRAY_BUFFER,
-            quantities.size() * sizeof(float),
-            quantities.data(),
+            state.nVertices() * sizeof(float),
+            quantities,
             GL_STATIC_DRAW
         );
 
@@ -1266,16 +1425,14 @@ void RenderableFieldlinesSequence::updateVertexMaskingBuffer() {
     glBindVertexArray(_vertexArrayObject);
     glBindBuffer(GL_ARRAY_BUFFER, _vertexMaskingBuffer);
 
-    bool isSuccessful;
-    const std::vector<float>& maskings = _states[_activeStateIndex].extraQuantity(
-        _pMaskingQuantity, isSuccessful
-    );
+    const FieldlinesState& state = _states[_activeStateIndex];
+    const float* maskings = state.extraQuantityData(_pMaskingQuantity);
 
-    if (isSuccessful) {
+    if (maskings) {
         glBufferData(
             GL_ARRAY_BUFFER,
-            maskings.size() * sizeof(float),
-            maskings.data(),
+            state.nVertices() * sizeof(float),
+            maskings,
             GL_STATIC_DRAW
         );
 
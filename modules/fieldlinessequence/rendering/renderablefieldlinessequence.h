@@ -28,6 +28,7 @@
 #include <openspace/rendering/renderable.h>
 
 #include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <modules/fieldlinessequence/util/fieldlinesstatestreamer.h>
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/triggerproperty.h>
@@ -35,7 +36,7 @@
 #include <openspace/properties/vector/vec2property.h>
 #include <openspace/properties/vector/vec4property.h>
 #include <openspace/rendering/transferfunction.h>
-#include <atomic>
+#include <array>
 
 namespace { enum class SourceFileType; }
 
@@ -65,21 +66,15 @@ private:
     std::string       _identifier;                               // Name of the Node!
 
     // ------------------------------------- FLAGS -------------------------------------//
-    // Used for 'runtime-states'. True when loading a new state from disk on another
-    // thread.
-    std::atomic<bool> _isLoadingStateFromDisk    { false};
     // False => states are stored in RAM (using 'in-RAM-states'), True => states are
     // loaded from disk during runtime (using 'runtime-states')
     bool              _loadingStatesDynamically  = false;
-    // Used for 'runtime-states': True if new 'runtime-state' must be loaded from disk.
-    // False => the previous frame's state should still be shown
+    // Used for 'runtime-states': True if the active 'runtime-state' has not been fetched
+    // from the streamer yet. The previous frame's state is shown until it has
     bool              _mustLoadNewStateFromDisk  = false;
     // Used for 'in-RAM-states' : True if new 'in-RAM-state'  must be loaded.
     // False => the previous frame's state should still be shown
     bool              _needsUpdate               = false;
-    // Used for 'runtime-states'. True when finished loading a new state from disk on
-    // another thread.
-    std::atomic<bool> _newStateIsReady           = false;
     // True when new state is loaded or user change which quantity to color the lines by
     bool              _shouldUpdateColorBuffer   = false;
     // True when new state is loaded or user change which quantity used for masking out
@@ -93,8 +88,20 @@ private:
     int               _activeStateIndex          = -1;
     // Active index of _startTimes
     int               _activeTriggerTimeIndex    = -1;
+    // Index of _startTimes of the state that is currently rendered. Lags behind
+    // _activeTriggerTimeIndex while a 'runtime-state' is being loaded
+    int               _shownStateIndex           = -1;
+    // Used for 'runtime-states': Index of _startTimes of _morphTargetState, -1 if empty
+    int               _morphTargetStateIndex     = -1;
+    // How far the positions are interpolated from the shown state towards the next one
+    float             _morphFactor               = 0.f;
     // Number of states in the sequence
     size_t            _nStates                   = 0;
+    // Used for 'runtime-states': Number of states the streamer keeps in memory
+    size_t            _nPrefetchedStates         = 4;
+    // Used for 'runtime-states': 1 when the sequence is played forward, -1 when it is
+    // played backward. Determines which states are prefetched
+    int               _prefetchDirection         = 1;
     // In setup it is used to scale JSON coordinates. During runtime it is used to scale
     // domain limits.
     float             _scalingFactor             = 1.f;
@@ -108,14 +115,19 @@ private:
     // OpenGL Vertex Buffer Object containing the extraQuantity values used for masking
     // out segments of the lines
     GLuint            _vertexMaskingBuffer       = 0;
-    // OpenGL Vertex Buffer Object containing the vertex positions
-    GLuint            _vertexPositionBuffer      = 0;
+    // OpenGL Vertex Buffer Objects containing the vertex positions. One holds the shown
+    // state, the other the next state for morphable sequences
+    std::array<GLuint, 2> _vertexPositionBuffers       = { 0, 0 };
+    // Index of _startTimes of the state in each position buffer, -1 if none
+    std::array<int, 2>    _positionBufferStateIndex    = { -1, -1 };
+    // Number of bytes of that state that have been uploaded to each position buffer
+    std::array<size_t, 2> _positionBufferUploadedBytes = { 0, 0 };
 
     // ----------------------------------- POINTERS ------------------------------------//
     // The Lua-Modfile-Dictionary used during initialization
     std::unique_ptr<ghoul::Dictionary>            _dictionary;
-    // Used for 'runtime-states' when switching out current state to a new state
-    std::unique_ptr<FieldlinesState>              _newState;
+    // Used for 'runtime-states' to read the states around the active state from disk
+    std::unique_ptr<FieldlinesStateStreamer>      _stateStreamer;
     std::unique_ptr<ghoul::opengl::ProgramObject> _shaderProgram;
     // Transfer function used to color lines when _pColorMethod is set to BY_QUANTITY
     std::unique_ptr<TransferFunction>             _transferFunction;
@@ -134,6 +146,8 @@ private:
     std::vector<double>          _startTimes;
     // Stores the FieldlineStates
     std::vector<FieldlinesState> _states;
+    // Used for 'runtime-states': The state after the shown state of a morphable sequence
+    FieldlinesState              _morphTargetState;
 
     // ---------------------------------- Properties ---------------------------------- //
     // Group to hold the color properties
@@ -220,9 +234,12 @@ private:
     bool prepareForOsflsStreaming();
 
     // ------------------------- FUNCTIONS USED DURING RUNTIME ------------------------ //
-    void readNewState(const std::string& filePath);
+    const FieldlinesState* morphTarget();
     void updateActiveTriggerTimeIndex(double currentTime);
-    void updateVertexPositionBuffer();
+    bool uploadVertexPositions(int buffer, int stateIndex, const FieldlinesState& state,
+        size_t maxBytes);
+    void updateVertexPositionBuffers(double currentTime);
+    void updateStreamedQuantities();
     void updateVertexColorBuffer();
     void updateVertexMaskingBuffer();
 };
@@ -41,6 +41,9 @@ uniform int       particleSpacing;
 uniform double    time;
 uniform bool      usingParticles;
 
+// Morphing Uniforms
+uniform float     morphFactor;
+
 // Masking Uniforms
 uniform bool      usingMasking;
 uniform vec2      maskingRange;
@@ -56,6 +59,7 @@ uniform vec2      domainLimR;
 layout(location = 0) in vec3 in_position;        // Should be provided in meters
 layout(location = 1) in float in_color_scalar;   // The extra value used to color lines. Location must correspond to _VA_COLOR in renderablefieldlinessequence.h
 layout(location = 2) in float in_masking_scalar; // The extra value used to mask out parts of lines. Location must correspond to _VA_MASKING in renderablefieldlinessequence.h
+layout(location = 3) in vec3 in_morph_position;  // Position in the next state of a morphable sequence. Location must correspond to VaMorphPosition in renderablefieldlinessequence.cpp
 
 // These should correspond to the enum 'ColorMethod' in renderablefieldlinesequence.cpp
 const int uniformColor     = 0;
@@ -80,6 +84,12 @@ bool isPartOfParticle(const double time, const int vertexId, const int particleS
 
 void main() {
 
+    // Interpolates towards the next state of morphable sequences
+    vec3 position = in_position;
+    if (morphFactor > 0.0) {
+        position = mix(in_position, in_morph_position, morphFactor);
+    }
+
     bool hasColor = true;
 
     if (usingMasking && (in_masking_scalar < maskingRange.x ||
@@ -88,11 +98,11 @@ void main() {
     }
 
     if (usingDomain && hasColor) {
-        float radius = length(in_position);
+        float radius = length(position);
 
-        if (in_position.x < domainLimX.x || in_position.x > domainLimX.y ||
-            in_position.y < domainLimY.x || in_position.y > domainLimY.y ||
-            in_position.z < domainLimZ.x || in_position.z > domainLimZ.y ||
+        if (position.x < domainLimX.x || position.x > domainLimX.y ||
+            position.y < domainLimY.x || position.y > domainLimY.y ||
+            position.z < domainLimZ.x || position.z > domainLimZ.y ||
             radius        < domainLimR.x || radius        > domainLimR.y) {
 
             hasColor = false;
@@ -119,7 +129,7 @@ void main() {
         vs_color = vec4(0);
     }
 
-    vec4 position_in_meters = vec4(in_position, 1);
+    vec4 position_in_meters = vec4(position, 1);
     vec4 positionClipSpace = modelViewProjection * position_in_meters;
     gl_Position = vec4(positionClipSpace.xy, 0, positionClipSpace.w);
     vs_depth = gl_Position.w;
@@ -24,16 +24,67 @@
 
 #include <modules/fieldlinessequence/util/fieldlinesstate.h>
 
+#include <openspace/util/mappedfile.h>
 #include <openspace/util/time.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
 #include <ext/json/json.hpp>
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 
 namespace {
     constexpr const char* _loggerCat = "FieldlinesState";
-    constexpr const int CurrentVersion = 0;
+    constexpr const int CurrentVersion = 1;
     using json = nlohmann::json;
+
+    // Sections of a version 1 .osfls file are aligned to pages, so that the pages of one
+    // extra quantity never contain the data of another
+    constexpr const uint64_t OsflsSectionAlignment = 4096;
+
+    // The sections of a version 1 .osfls file, in the order of the section table. The
+    // table holds one section per extra quantity, starting at OsflsSectionExtraQuantities
+    constexpr const uint64_t OsflsSectionLineStart = 0;
+    constexpr const uint64_t OsflsSectionLineCount = 1;
+    constexpr const uint64_t OsflsSectionVertexPositions = 2;
+    constexpr const uint64_t OsflsSectionExtraQuantityNames = 3;
+    constexpr const uint64_t OsflsSectionExtraQuantities = 4;
+
+    struct OsflsHeader {
+        int32_t version;
+        int32_t model;
+        double triggerTime;
+        uint64_t nLines;
+        uint64_t nPoints;
+        uint64_t nExtras;
+        uint64_t nSections;
+        uint8_t isMorphable;
+        uint8_t padding[15];
+    };
+    static_assert(sizeof(OsflsHeader) == 64, "Unexpected padding in OsflsHeader");
+
+    // Offset from the beginning of the file and size of a section, in bytes
+    struct OsflsSection {
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    // The lines are drawn directly from the line starts and counts, so every line has to
+    // lie within the nPoints vertices of the state
+    bool hasValidLineRanges(const std::vector<GLint>& lineStart,
+                            const std::vector<GLsizei>& lineCount, uint64_t nPoints)
+    {
+        for (size_t i = 0; i < lineStart.size(); ++i) {
+            if (lineStart[i] < 0 || lineCount[i] < 0 ||
+                static_cast<uint64_t>(lineStart[i]) > nPoints ||
+                static_cast<uint64_t>(lineCount[i]) > nPoints - lineStart[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
 } // namespace
 
 namespace openspace {
@@ -44,6 +95,7 @@ namespace openspace {
  * expected to be in degrees. scale is an optional scaling factor.
  */
 void FieldlinesState::convertLatLonToCartesian(float scale /* = 1.f */) {
+    unmap();
     for (glm::vec3& p : _vertexPositions) {
 
         const float r = p.x * scale;
@@ -56,12 +108,16 @@ void FieldlinesState::convertLatLonToCartesian(float scale /* = 1.f */) {
 }
 
 void FieldlinesState::scalePositions(float scale) {
+    unmap();
     for (glm::vec3& p : _vertexPositions) {
         p *= scale;
     }
 }
 
-bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile) {
+bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile,
+                                         bool keepMapped,
+                                         const std::vector<size_t>& residentQuantities)
+{
     std::ifstream ifs(pathToOsflsFile, std::ifstream::binary);
     if (!ifs.is_open()) {
         LERROR("Couldn't open file: " + pathToOsflsFile);
@@ -71,15 +127,26 @@ bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile) {
     int binFileVersion;
     ifs.read(reinterpret_cast<char*>(&binFileVersion), sizeof(int));
 
+    // Release a previous mapping. The vectors keep their capacity, so they are reused
+    // when the state is loaded again
+    _mappedFile = nullptr;
+    _mappedVertexPositions = nullptr;
+    _mappedExtraQuantities.clear();
+    _nMappedVertices = 0;
+
     switch (binFileVersion) {
         case 0:
-            // No need to put everything in this scope now, as only version 0 exists!
-            break;
+            return readOsflsVersion0(ifs);
+        case 1:
+            ifs.close();
+            return readOsflsVersion1(pathToOsflsFile, keepMapped, residentQuantities);
         default:
             LERROR("VERSION OF BINARY FILE WAS NOT RECOGNIZED!");
             return false;
     }
+}
 
+bool FieldlinesState::readOsflsVersion0(std::ifstream& ifs) {
     // Define tmp variables to store meta data in
     size_t nLines;
     size_t nPoints;
@@ -115,6 +182,11 @@ bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile) {
         ifs.read(reinterpret_cast<char*>(vec.data()), sizeof(float) * nPoints);
     }
 
+    if (!ifs.good() || !hasValidLineRanges(_lineStart, _lineCount, nPoints)) {
+        LERROR("Invalid line ranges in version 0 .osfls file");
+        return false;
+    }
+
     // Read all extra quantities' names. Stored as multiple c-strings
     std::string allNamesInOne;
     char* s = new char[byteSizeAllNames];
@@ -134,6 +206,147 @@ bool FieldlinesState::loadStateFromOsfls(const std::string& pathToOsflsFile) {
     return true;
 }
 
+bool FieldlinesState::readOsflsVersion1(const std::string& pathToOsflsFile,
+                                        bool keepMapped,
+                                        const std::vector<size_t>& residentQuantities)
+{
+    std::shared_ptr<MappedFile> file;
+    try {
+        file = std::make_shared<MappedFile>(pathToOsflsFile);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(e.message);
+        return false;
+    }
+
+    const char* data = file->data();
+    const size_t fileSize = file->size();
+    if (fileSize < sizeof(OsflsHeader)) {
+        LERROR(fmt::format("{}: File is too small for its header", pathToOsflsFile));
+        return false;
+    }
+    OsflsHeader header;
+    std::memcpy(&header, data, sizeof(OsflsHeader));
+
+    // Every line, vertex and extra quantity takes up space in the file, which bounds
+    // the counts so that the sizes computed from them below can not overflow
+    const bool hasValidCounts =
+        header.nExtras <= (fileSize - sizeof(OsflsHeader)) / sizeof(OsflsSection) &&
+        header.nLines <= fileSize / sizeof(int32_t) &&
+        header.nPoints <= fileSize / (3 * sizeof(float));
+    if (!hasValidCounts) {
+        LERROR(fmt::format("{}: Invalid header", pathToOsflsFile));
+        return false;
+    }
+
+    const uint64_t nSections = OsflsSectionExtraQuantities + header.nExtras;
+    const size_t tableEnd = sizeof(OsflsHeader) + nSections * sizeof(OsflsSection);
+    if (header.nSections != nSections || fileSize < tableEnd) {
+        LERROR(fmt::format("{}: Invalid section table", pathToOsflsFile));
+        return false;
+    }
+    std::vector<OsflsSection> sections(nSections);
+    std::memcpy(
+        sections.data(),
+        data + sizeof(OsflsHeader),
+        nSections * sizeof(OsflsSection)
+    );
+
+    // Validate the size of each section, so that the pointers below stay in the file
+    auto expectedSize = [&header](uint64_t section) -> uint64_t {
+        switch (section) {
+            case OsflsSectionLineStart:
+            case OsflsSectionLineCount:
+                return header.nLines * sizeof(int32_t);
+            case OsflsSectionVertexPositions:
+                return header.nPoints * 3 * sizeof(float);
+            case OsflsSectionExtraQuantityNames:
+                return 0;
+            default:
+                return header.nPoints * sizeof(float);
+        }
+    };
+    for (uint64_t i = 0; i < nSections; ++i) {
+        const OsflsSection& s = sections[i];
+        const bool isInFile = s.offset <= fileSize && s.size <= fileSize - s.offset;
+        const bool isAligned = s.offset % OsflsSectionAlignment == 0;
+        const bool hasSize = i == OsflsSectionExtraQuantityNames ||
+                             s.size == expectedSize(i);
+        if (!isInFile || !isAligned || !hasSize) {
+            LERROR(fmt::format("{}: Invalid section {}", pathToOsflsFile, i));
+            return false;
+        }
+    }
+
+    // The line starts and counts are needed on the CPU for the draw call
+    const OsflsSection& starts = sections[OsflsSectionLineStart];
+    const OsflsSection& counts = sections[OsflsSectionLineCount];
+    _lineStart.resize(header.nLines);
+    _lineCount.resize(header.nLines);
+    std::memcpy(_lineStart.data(), data + starts.offset, starts.size);
+    std::memcpy(_lineCount.data(), data + counts.offset, counts.size);
+    if (!hasValidLineRanges(_lineStart, _lineCount, header.nPoints)) {
+        LERROR(fmt::format("{}: Invalid line ranges", pathToOsflsFile));
+        _lineStart.clear();
+        _lineCount.clear();
+        return false;
+    }
+
+    _triggerTime = header.triggerTime;
+    _model = static_cast<fls::Model>(header.model);
+    _isMorphable = header.isMorphable != 0;
+
+    // Names are stored as consecutive c-strings
+    const OsflsSection& names = sections[OsflsSectionExtraQuantityNames];
+    _extraQuantityNames.resize(header.nExtras);
+    const char* name = data + names.offset;
+    const char* namesEnd = name + names.size;
+    for (std::string& n : _extraQuantityNames) {
+        const char* end = std::find(name, namesEnd, '\0');
+        n.assign(name, end);
+        name = std::min(end + 1, namesEnd);
+    }
+
+    const OsflsSection& positions = sections[OsflsSectionVertexPositions];
+    if (keepMapped) {
+        _vertexPositions.clear();
+        _extraQuantities.clear();
+
+        _nMappedVertices = header.nPoints;
+        _mappedVertexPositions = reinterpret_cast<const glm::vec3*>(
+            data + positions.offset
+        );
+        _mappedExtraQuantities.resize(header.nExtras);
+        for (uint64_t i = 0; i < header.nExtras; ++i) {
+            const OsflsSection& s = sections[OsflsSectionExtraQuantities + i];
+            _mappedExtraQuantities[i] = reinterpret_cast<const float*>(data + s.offset);
+        }
+        // Read the data that is uploaded to the GPU on this thread, so that the page
+        // faults do not happen while the data is uploaded on the main thread. The other
+        // extra quantities are read from disk when they are selected
+        file->touch(positions.offset, positions.size);
+        for (size_t i : residentQuantities) {
+            if (i < header.nExtras) {
+                const OsflsSection& s = sections[OsflsSectionExtraQuantities + i];
+                file->touch(s.offset, s.size);
+            }
+        }
+        _mappedFile = std::move(file);
+    }
+    else {
+        _vertexPositions.resize(header.nPoints);
+        std::memcpy(_vertexPositions.data(), data + positions.offset, positions.size);
+        _extraQuantities.resize(header.nExtras);
+        for (uint64_t i = 0; i < header.nExtras; ++i) {
+            const OsflsSection& s = sections[OsflsSectionExtraQuantities + i];
+            _extraQuantities[i].resize(header.nPoints);
+            std::memcpy(_extraQuantities[i].data(), data + s.offset, s.size);
+        }
+    }
+
+    return true;
+}
+
 bool FieldlinesState::loadStateFromJson(const std::string& pathToJsonFile,
                                         fls::Model Model,
                                         float coordToMeters = 1.f)
@@ -222,28 +435,27 @@ bool FieldlinesState::loadStateFromJson(const std::string& pathToJsonFile,
 /**
  * @param absPath must be the path to the file (incl. filename but excl. extension!)
  * Directory must exist! File is created (or overwritten if already existing).
- * File is structured like this: (for version 0)
- *  0. int                    - version number of binary state file! (in case something
+ * File is structured like this: (for version 1)
+ *  0. OsflsHeader            - version number of binary state file! (in case something
  *                              needs to be altered in the future, then increase
- *                              CurrentVersion)
- *  1. double                 - _triggerTime
- *  2. int                    - _model
- *  3. bool                   - _isMorphable
- *  4. size_t                 - Number of lines in the state  == _lineStart.size()
- *                                                            == _lineCount.size()
- *  5. size_t                 - Total number of vertex points == _vertexPositions.size()
- *                                                           == _extraQuantities[i].size()
- *  6. size_t                 - Number of extra quantites     == _extraQuantities.size()
- *                                                           == _extraQuantityNames.size()
- *  7. site_t                 - Number of total bytes that ALL _extraQuantityNames
- *                              consists of (Each such name is stored as a c_str which
- *                              means it ends with the null char '\0' )
- *  7. std::vector<GLint>     - _lineStart
- *  8. std::vector<GLsizei>   - _lineCount
- *  9. std::vector<glm::vec3> - _vertexPositions
- * 10. std::vector<float>     - _extraQuantities
- * 11. array of c_str         - Strings naming the extra quantities (elements of
+ *                              CurrentVersion), _model, _triggerTime, number of lines,
+ *                              number of vertex points, number of extra quantities,
+ *                              number of sections (== 4 + number of extra quantities)
+ *                              and _isMorphable. 64 bytes in total
+ *  1. OsflsSection[]         - Offset from the beginning of the file and size in bytes of
+ *                              each of the following sections
+ *  2. std::vector<GLint>     - _lineStart
+ *  3. std::vector<GLsizei>   - _lineCount
+ *  4. std::vector<glm::vec3> - _vertexPositions
+ *  5. array of c_str         - Strings naming the extra quantities (elements of
  *                              _extraQuantityNames). Each string ends with null char '\0'
+ *  6. std::vector<float>     - One section for each of the _extraQuantities
+ * Each section starts at a multiple of OsflsSectionAlignment bytes, so that the file can
+ * be memory mapped and each section used in place.
+ * Version 0 files consisted of the version number, _triggerTime, _model, _isMorphable,
+ * the number of lines, vertex points and extra quantities and the byte size of all names
+ * followed by the arrays in the order _lineStart, _lineCount, _vertexPositions,
+ * _extraQuantities and the names, all tightly packed. They can still be loaded
  */
 void FieldlinesState::saveStateToOsfls(const std::string& absPath) {
     // ------------------------------- Create the file ------------------------------- //
@@ -268,36 +480,61 @@ void FieldlinesState::saveStateToOsfls(const std::string& absPath) {
     }
 
     const size_t nLines       = _lineStart.size();
-    const size_t nPoints      = _vertexPositions.size();
-    const size_t nExtras      = _extraQuantities.size();
-    const size_t nStringBytes = allExtraQuantityNamesInOne.size();
+    const size_t nPoints      = nVertices();
+    const size_t nExtras      = nExtraQuantities();
+
+    // ---------------------- Place the sections after the table ---------------------- //
+    std::vector<const char*> sectionData(OsflsSectionExtraQuantities + nExtras);
+    std::vector<OsflsSection> sections(sectionData.size());
+    sectionData[OsflsSectionLineStart] = reinterpret_cast<const char*>(_lineStart.data());
+    sections[OsflsSectionLineStart].size = sizeof(int32_t) * nLines;
+    sectionData[OsflsSectionLineCount] = reinterpret_cast<const char*>(_lineCount.data());
+    sections[OsflsSectionLineCount].size = sizeof(int32_t) * nLines;
+    sectionData[OsflsSectionVertexPositions] =
+        reinterpret_cast<const char*>(vertexPositionData());
+    sections[OsflsSectionVertexPositions].size = 3 * sizeof(float) * nPoints;
+    sectionData[OsflsSectionExtraQuantityNames] = allExtraQuantityNamesInOne.c_str();
+    sections[OsflsSectionExtraQuantityNames].size = allExtraQuantityNamesInOne.size();
+    for (size_t i = 0; i < nExtras; ++i) {
+        const size_t section = OsflsSectionExtraQuantities + i;
+        sectionData[section] = reinterpret_cast<const char*>(extraQuantityData(i));
+        sections[section].size = sizeof(float) * nPoints;
+    }
+
+    auto align = [](uint64_t offset) {
+        return (offset + OsflsSectionAlignment - 1) / OsflsSectionAlignment *
+               OsflsSectionAlignment;
+    };
+    uint64_t offset = sizeof(OsflsHeader) + sections.size() * sizeof(OsflsSection);
+    for (OsflsSection& section : sections) {
+        section.offset = align(offset);
+        offset = section.offset + section.size;
+    }
+
+    OsflsHeader header = {};
+    header.version = CurrentVersion;
+    header.model = static_cast<int32_t>(_model);
+    header.triggerTime = _triggerTime;
+    header.nLines = nLines;
+    header.nPoints = nPoints;
+    header.nExtras = nExtras;
+    header.nSections = sections.size();
+    header.isMorphable = _isMorphable ? 1 : 0;
 
     //----------------------------- WRITE EVERYTHING TO FILE -----------------------------
-    // VERSION OF BINARY FIELDLINES STATE FILE - IN CASE STRUCTURE CHANGES IN THE FUTURE
-    ofs.write(reinterpret_cast<const char*>(&CurrentVersion), sizeof(int));
-
-    //-------------------- WRITE META DATA FOR STATE --------------------------------
-    ofs.write(reinterpret_cast<const char*>(&_triggerTime), sizeof(_triggerTime));
-    ofs.write(reinterpret_cast<const char*>(&_model), sizeof(int32_t));
-    ofs.write(reinterpret_cast<const char*>(&_isMorphable), sizeof(bool));
-
-    ofs.write(reinterpret_cast<const char*>(&nLines), sizeof(uint64_t));
-    ofs.write(reinterpret_cast<const char*>(&nPoints), sizeof(uint64_t));
-    ofs.write(reinterpret_cast<const char*>(&nExtras), sizeof(uint64_t));
-    ofs.write(reinterpret_cast<const char*>(&nStringBytes), sizeof(uint64_t));
-
-    //---------------------- WRITE ALL ARRAYS OF DATA --------------------------------
-    ofs.write(reinterpret_cast<char*>(_lineStart.data()), sizeof(int32_t) * nLines);
-    ofs.write(reinterpret_cast<char*>(_lineCount.data()), sizeof(uint32_t) * nLines);
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(OsflsHeader));
     ofs.write(
-        reinterpret_cast<char*>(_vertexPositions.data()),
-        3 * sizeof(float) * nPoints
+        reinterpret_cast<const char*>(sections.data()),
+        sections.size() * sizeof(OsflsSection)
     );
-    // Write the data for each vector in _extraQuantities
-    for (std::vector<float>& vec : _extraQuantities) {
-        ofs.write(reinterpret_cast<char*>(vec.data()), sizeof(float) * nPoints);
+
+    const std::vector<char> padding(OsflsSectionAlignment, '\0');
+    uint64_t position = sizeof(OsflsHeader) + sections.size() * sizeof(OsflsSection);
+    for (size_t i = 0; i < sections.size(); ++i) {
+        ofs.write(padding.data(), sections[i].offset - position);
+        ofs.write(sectionData[i], sections[i].size);
+        position = sections[i].offset + sections[i].size;
     }
-    ofs.write(allExtraQuantityNamesInOne.c_str(), nStringBytes);
 }
 
 // TODO: This should probably be rewritten, but this is the way the files were structured
@@ -345,18 +582,18 @@ void FieldlinesState::saveStateToJson(const std::string& absPath) {
 
     const std::string timeStr = Time(_triggerTime).ISO8601();
     const size_t nLines       = _lineStart.size();
-    // const size_t nPoints      = _vertexPositions.size();
-    const size_t nExtras      = _extraQuantities.size();
+    const size_t nExtras      = nExtraQuantities();
+    const glm::vec3* positions = vertexPositionData();
 
     size_t pointIndex = 0;
     for (size_t lineIndex = 0; lineIndex < nLines; ++lineIndex) {
         json jData = json::array();
         for (GLsizei i = 0; i < _lineCount[lineIndex]; i++, ++pointIndex) {
-            const glm::vec3 pos = _vertexPositions[pointIndex];
+            const glm::vec3 pos = positions[pointIndex];
             json jDataElement = {pos.x, pos.y, pos.z};
 
             for (size_t extraIndex = 0; extraIndex < nExtras; ++extraIndex) {
-                jDataElement.push_back(_extraQuantities[extraIndex][pointIndex]);
+                jDataElement.push_back(extraQuantityData(extraIndex)[pointIndex]);
             }
             jData.push_back(jDataElement);
         }
@@ -381,9 +618,10 @@ void FieldlinesState::saveStateToJson(const std::string& absPath) {
 // If index is out of scope an empty vector is returned and the referenced bool is false.
 std::vector<float> FieldlinesState::extraQuantity(size_t index, bool& isSuccessful) const
 {
-    if (index < _extraQuantities.size()) {
+    if (index < nExtraQuantities()) {
         isSuccessful = true;
-        return _extraQuantities[index];
+        const float* data = extraQuantityData(index);
+        return std::vector<float>(data, data + nVertices());
     }
     else {
         isSuccessful = false;
@@ -395,12 +633,21 @@ std::vector<float> FieldlinesState::extraQuantity(size_t index, bool& isSuccessf
 // Moves the points in @param line over to _vertexPositions and updates
 // _lineStart & _lineCount accordingly.
 
+void FieldlinesState::reserve(size_t nLines, size_t nPoints) {
+    unmap();
+    _lineStart.reserve(_lineStart.size() + nLines);
+    _lineCount.reserve(_lineCount.size() + nLines);
+    _vertexPositions.reserve(_vertexPositions.size() + nPoints);
+}
+
 void FieldlinesState::addLine(std::vector<glm::vec3>& line) {
+    unmap();
     const size_t nNewPoints = line.size();
     const size_t nOldPoints = _vertexPositions.size();
     _lineStart.push_back(static_cast<GLint>(nOldPoints));
     _lineCount.push_back(static_cast<GLsizei>(nNewPoints));
-    _vertexPositions.reserve(nOldPoints + nNewPoints);
+    // Growing by exactly the size of the line would reallocate for every line, callers
+    // that know the total size use reserve instead
     _vertexPositions.insert(
         _vertexPositions.end(),
         std::make_move_iterator(line.begin()),
@@ -410,10 +657,16 @@ void FieldlinesState::addLine(std::vector<glm::vec3>& line) {
 }
 
 void FieldlinesState::setExtraQuantityNames(std::vector<std::string> names) {
+    unmap();
     _extraQuantityNames = std::move(names);
     _extraQuantities.resize(_extraQuantityNames.size());
 }
 
+void FieldlinesState::setExtraQuantity(size_t idx, std::vector<float> values) {
+    unmap();
+    _extraQuantities[idx] = std::move(values);
+}
+
 const std::vector<std::vector<float>>& FieldlinesState::extraQuantities() const {
     return _extraQuantities;
 }
@@ -430,12 +683,20 @@ const std::vector<GLint>& FieldlinesState::lineStart() const {
     return _lineStart;
 }
 
+bool FieldlinesState::isMorphable() const {
+    return _isMorphable;
+}
+
 fls::Model FieldlinesState::FieldlinesState::model() const {
     return _model;
 }
 
 size_t FieldlinesState::nExtraQuantities() const {
-    return _extraQuantities.size();
+    return _mappedFile ? _mappedExtraQuantities.size() : _extraQuantities.size();
+}
+
+size_t FieldlinesState::nVertices() const {
+    return _mappedFile ? _nMappedVertices : _vertexPositions.size();
 }
 
 double FieldlinesState::triggerTime() const {
@@ -446,4 +707,37 @@ const std::vector<glm::vec3>& FieldlinesState::vertexPositions() const {
     return _vertexPositions;
 }
 
+const glm::vec3* FieldlinesState::vertexPositionData() const {
+    return _mappedFile ? _mappedVertexPositions : _vertexPositions.data();
+}
+
+const float* FieldlinesState::extraQuantityData(size_t index) const {
+    if (index >= nExtraQuantities()) {
+        return nullptr;
+    }
+    return _mappedFile ? _mappedExtraQuantities[index] : _extraQuantities[index].data();
+}
+
+void FieldlinesState::unmap() {
+    if (!_mappedFile) {
+        return;
+    }
+    _vertexPositions.assign(
+        _mappedVertexPositions,
+        _mappedVertexPositions + _nMappedVertices
+    );
+    _extraQuantities.resize(_mappedExtraQuantities.size());
+    for (size_t i = 0; i < _mappedExtraQuantities.size(); ++i) {
+        _extraQuantities[i].assign(
+            _mappedExtraQuantities[i],
+            _mappedExtraQuantities[i] + _nMappedVertices
+        );
+    }
+
+    _mappedFile = nullptr;
+    _mappedVertexPositions = nullptr;
+    _mappedExtraQuantities.clear();
+    _nMappedVertices = 0;
+}
+
 } // namespace openspace
@@ -29,33 +29,58 @@
 
 #include <ghoul/glm.h>
 #include <ghoul/opengl/ghoul_gl.h>
+#include <iosfwd>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace openspace {
 
+class MappedFile;
+
 class FieldlinesState {
 public:
     void convertLatLonToCartesian(float scale = 1.f);
     void scalePositions(float scale);
 
-    bool loadStateFromOsfls(const std::string& pathToOsflsFile);
+    /**
+     * Loads the state from a version 0 or version 1 .osfls file. If \p keepMapped is
+     * <code>true</code> and the file is of version 1, the vertex positions and the extra
+     * quantities are not copied but accessed directly in the memory mapped file. The
+     * vertex positions and the extra quantities listed in \p residentQuantities are
+     * read from disk before this function returns, the pages of the other extra
+     * quantities are only read once they are accessed.
+     */
+    bool loadStateFromOsfls(const std::string& pathToOsflsFile, bool keepMapped = false,
+        const std::vector<size_t>& residentQuantities = {});
     void saveStateToOsfls(const std::string& pathToOsflsFile);
 
     bool loadStateFromJson(const std::string& pathToJsonFile, fls::Model model,
         float coordToMeters);
     void saveStateToJson(const std::string& pathToJsonFile);
 
+    // Only contains the extra quantities of states that are not memory mapped
     const std::vector<std::vector<float>>& extraQuantities() const;
     const std::vector<std::string>& extraQuantityNames() const;
     const std::vector<GLsizei>& lineCount() const;
     const std::vector<GLint>& lineStart() const;
 
+    // Morphable states of a sequence consist of the same lines, so their vertex
+    // positions can be interpolated
+    bool isMorphable() const;
     fls::Model model() const;
     size_t nExtraQuantities() const;
+    size_t nVertices() const;
     double triggerTime() const;
+    // Only contains the vertex positions of states that are not memory mapped
     const std::vector<glm::vec3>& vertexPositions() const;
 
+    // The nVertices() vertex positions, regardless of whether the state is memory mapped
+    const glm::vec3* vertexPositionData() const;
+    // The nVertices() values of the extra quantity at index, regardless of whether the
+    // state is memory mapped. Returns nullptr if index is out of scope
+    const float* extraQuantityData(size_t index) const;
+
     // Special getter. Returns extraQuantities[index].
     std::vector<float> extraQuantity(size_t index, bool& isSuccesful) const;
 
@@ -63,10 +88,19 @@ public:
     void setTriggerTime(double t) { _triggerTime = t; }
     void setExtraQuantityNames(std::vector<std::string> names);
 
+    // Reserves memory for nLines more lines with a total of nPoints more vertices
+    void reserve(size_t nLines, size_t nPoints);
     void addLine(std::vector<glm::vec3>& line);
     void appendToExtra(size_t idx, float val) { _extraQuantities[idx].push_back(val); }
+    void setExtraQuantity(size_t idx, std::vector<float> values);
 
 private:
+    bool readOsflsVersion0(std::ifstream& ifs);
+    bool readOsflsVersion1(const std::string& pathToOsflsFile, bool keepMapped,
+        const std::vector<size_t>& residentQuantities);
+    // Copies the memory mapped data into the vectors and releases the mapping
+    void unmap();
+
     bool                            _isMorphable = false;
     double                          _triggerTime = -1.0;
     fls::Model                      _model;
@@ -76,6 +110,13 @@ private:
     std::vector<GLsizei>            _lineCount;
     std::vector<GLint>              _lineStart;
     std::vector<glm::vec3>          _vertexPositions;
+
+    // Used for states that are memory mapped from version 1 .osfls files. The mapping is
+    // shared between copies of the state
+    std::shared_ptr<const MappedFile> _mappedFile;
+    const glm::vec3*                _mappedVertexPositions = nullptr;
+    std::vector<const float*>       _mappedExtraQuantities;
+    size_t                          _nMappedVertices = 0;
 };
 
 } // namespace openspace
@@ -0,0 +1,153 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/fieldlinessequence/util/fieldlinesstatestreamer.h>
+
+#include <algorithm>
+
+namespace openspace {
+
+FieldlinesStateStreamer::FieldlinesStateStreamer(std::vector<std::string> sourceFiles,
+                                                 size_t nStates)
+    : _sourceFiles(std::move(sourceFiles))
+    , _slots(std::max<size_t>(nStates, 1))
+    , _loaderPool(1)
+{}
+
+FieldlinesStateStreamer::~FieldlinesStateStreamer() {
+    // The state currently being read is finished, but no further states are loaded
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+}
+
+void FieldlinesStateStreamer::prefetch(int index, int direction) {
+    const int nFiles = static_cast<int>(_sourceFiles.size());
+    const int step = direction < 0 ? -1 : 1;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _window.clear();
+    for (int i = index; i >= 0 && i < nFiles && _window.size() < _slots.size(); i += step)
+    {
+        _window.push_back(i);
+    }
+
+    if (!_isLoading) {
+        _isLoading = true;
+        _loaderPool.enqueue([this]() { loadStates(); });
+    }
+}
+
+bool FieldlinesStateStreamer::fetch(int index, FieldlinesState& state) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (Slot& s : _slots) {
+        if (s.index == index && s.status == Status::Ready) {
+            std::swap(s.state, state);
+            s.index = -1;
+            s.status = Status::Empty;
+            return true;
+        }
+    }
+    return false;
+}
+
+void FieldlinesStateStreamer::setResidentQuantities(std::vector<size_t> quantities) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _residentQuantities = std::move(quantities);
+}
+
+int FieldlinesStateStreamer::assignNextLoad(size_t& slot) {
+    auto inWindow = [this](int index) {
+        return std::find(_window.begin(), _window.end(), index) != _window.end();
+    };
+
+    for (int index : _window) {
+        auto it = std::find_if(
+            _slots.begin(),
+            _slots.end(),
+            [index](const Slot& s) { return s.index == index; }
+        );
+        if (it != _slots.end()) {
+            continue;
+        }
+
+        // Prefer slots that have been fetched, then the ones that left the window
+        auto free = std::find_if(
+            _slots.begin(),
+            _slots.end(),
+            [](const Slot& s) { return s.status == Status::Empty; }
+        );
+        if (free == _slots.end()) {
+            free = std::find_if(
+                _slots.begin(),
+                _slots.end(),
+                [&inWindow](const Slot& s) {
+                    return s.status != Status::Loading && !inWindow(s.index);
+                }
+            );
+        }
+        if (free == _slots.end()) {
+            return -1;
+        }
+
+        free->index = index;
+        free->status = Status::Loading;
+        slot = std::distance(_slots.begin(), free);
+        return index;
+    }
+    return -1;
+}
+
+void FieldlinesStateStreamer::loadStates() {
+    std::vector<size_t> residentQuantities;
+    while (true) {
+        size_t slot = 0;
+        int index = -1;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_stop) {
+                index = assignNextLoad(slot);
+            }
+            if (index == -1) {
+                _isLoading = false;
+                return;
+            }
+            residentQuantities = _residentQuantities;
+        }
+
+        // The slot is marked as Loading, so neither fetch nor assignNextLoad touch it.
+        // Version 1 files are memory mapped, so only the pages that are uploaded to the
+        // GPU are read from disk, which happens here before the state is marked as ready
+        FieldlinesState& state = _slots[slot].state;
+        const bool success = state.loadStateFromOsfls(
+            _sourceFiles[index],
+            true,
+            residentQuantities
+        );
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _slots[slot].status = success ? Status::Ready : Status::Failed;
+    }
+}
+
+} // namespace openspace
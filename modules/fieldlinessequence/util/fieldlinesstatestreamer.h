@@ -0,0 +1,112 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESSTATESTREAMER___H__
+#define __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESSTATESTREAMER___H__
+
+#include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <openspace/util/threadpool.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Streams the states of a sequence of .osfls files from disk. A single background loader
+ * keeps a ring of pre-read states around the index that was last passed to prefetch,
+ * reading ahead in the direction that the sequence is being played. The states in the
+ * ring keep their buffers between loads, so once the ring is warm, reading a state does
+ * not allocate. None of the public functions block on a load in progress.
+ */
+class FieldlinesStateStreamer {
+public:
+    /**
+     * Creates a streamer for the states in \p sourceFiles, ordered by trigger time, that
+     * keeps up to \p nStates states in memory at the same time.
+     */
+    FieldlinesStateStreamer(std::vector<std::string> sourceFiles, size_t nStates);
+    ~FieldlinesStateStreamer();
+
+    /**
+     * Sets the state that is currently needed. The background loader reads that state
+     * first, followed by the states after it in the direction of \p direction (forward
+     * if it is non-negative, backward otherwise) until the ring is full. States outside
+     * of this window are reused for new loads.
+     */
+    void prefetch(int index, int direction);
+
+    /**
+     * If the state at \p index has been read, it is swapped into \p state and
+     * <code>true</code> is returned. The previous content of \p state is handed back to
+     * the ring so its buffers are reused for the next load. Returns <code>false</code>
+     * if the state is not read yet or failed to load.
+     */
+    bool fetch(int index, FieldlinesState& state);
+
+    /**
+     * Sets the extra quantities, typically the ones used for coloring and masking, that
+     * are read from disk together with the vertex positions of every state that is
+     * loaded after this call. The other extra quantities are only read from disk once
+     * they are accessed.
+     */
+    void setResidentQuantities(std::vector<size_t> quantities);
+
+private:
+    enum class Status {
+        Empty = 0,
+        Loading,
+        Ready,
+        Failed
+    };
+
+    struct Slot {
+        int index = -1;
+        Status status = Status::Empty;
+        FieldlinesState state;
+    };
+
+    void loadStates();
+    // Returns the next state of the window that is not in the ring and assigns it to a
+    // slot, or returns -1 if the window is complete. Must be called with _mutex held
+    int assignNextLoad(size_t& slot);
+
+    const std::vector<std::string> _sourceFiles;
+
+    std::mutex _mutex;
+    std::vector<Slot> _slots;
+    // Indices that the ring should contain, in the order they are loaded
+    std::vector<int> _window;
+    std::vector<size_t> _residentQuantities;
+    bool _isLoading = false;
+    bool _stop = false;
+
+    // Declared last so that the loader is joined before the slots are destroyed
+    ThreadPool _loaderPool;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESSTATESTREAMER___H__
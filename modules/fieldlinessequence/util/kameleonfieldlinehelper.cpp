@@ -26,9 +26,15 @@
 
 #include <modules/fieldlinessequence/util/commons.h>
 #include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <openspace/util/threadpool.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
 
@@ -56,6 +62,23 @@ namespace {
     constexpr const char* JParallelB  = "Current: mag(J||B)";
     // [nPa]/[amu/cm^3] * ToKelvin => Temperature in Kelvin
     constexpr const float ToKelvin = 72429735.6984f;
+
+    // Number of seed points or vertices a worker claims at a time
+    constexpr const size_t WorkBatchSize = 64;
+
+    unsigned int resolveThreadCount(unsigned int nThreads) {
+        if (nThreads == 0) {
+            nThreads = std::thread::hardware_concurrency();
+        }
+        return std::max(nThreads, 1u);
+    }
+
+    // Locks the mutex that serializes the accesses to the cdf files, if there is one
+    std::unique_lock<std::mutex> lockFileAccess(std::mutex* fileAccessMutex) {
+        return fileAccessMutex ?
+            std::unique_lock<std::mutex>(*fileAccessMutex) :
+            std::unique_lock<std::mutex>();
+    }
 } // namespace
 
 namespace openspace::fls {
@@ -63,10 +86,11 @@ namespace openspace::fls {
 // -------------------- DECLARE FUNCTIONS USED (ONLY) IN THIS FILE -------------------- //
 #ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
     bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& seeds,
-        const std::string tracingVar, FieldlinesState& state);
+        const std::string tracingVar, FieldlinesState& state, unsigned int nThreads,
+        std::mutex* fileAccessMutex);
     void addExtraQuantities(ccmc::Kameleon* kameleon,
         std::vector<std::string>& extraScalarVars, std::vector<std::string>& extraMagVars,
-        FieldlinesState& state);
+        FieldlinesState& state, unsigned int nThreads, std::mutex* fileAccessMutex);
     void prepareStateAndKameleonForExtras(ccmc::Kameleon* kameleon,
         std::vector<std::string>& extraScalarVars, std::vector<std::string>& extraMagVars,
         FieldlinesState& state);
@@ -87,12 +111,18 @@ namespace openspace::fls {
  * \param extraMagVars, variables which should be used for extracting magnitudes, must be
  *        a multiple of 3; e.g. "ux", "uy" & "uz" to get the magnitude of the velocity
  *        vector at each line vertex
+ * \param nThreads, number of threads used to trace the lines and sample the extra
+ *        quantities. 0 uses all hardware threads
+ * \param fileAccessMutex, if provided, is locked whenever the cdf file is opened, read
+ *        or closed, as the cdf library is not thread safe
  */
 bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfPath,
                                  const std::vector<glm::vec3>& seedPoints,
                                  std::string tracingVar,
                                  std::vector<std::string>& extraVars,
-                                 std::vector<std::string>& extraMagVars)
+                                 std::vector<std::string>& extraMagVars,
+                                 unsigned int nThreads,
+                                 std::mutex* fileAccessMutex)
 {
 
 #ifndef OPENSPACE_MODULE_KAMELEON_ENABLED
@@ -102,18 +132,39 @@ bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfP
 #else // OPENSPACE_MODULE_KAMELEON_ENABLED
 
     // Create Kameleon object and open CDF file!
-    std::unique_ptr<ccmc::Kameleon> kameleon = kameleonHelper::createKameleonObject(
-        cdfPath
-    );
+    std::unique_ptr<ccmc::Kameleon> kameleon;
+    {
+        std::unique_lock<std::mutex> lock = lockFileAccess(fileAccessMutex);
+        kameleon = kameleonHelper::createKameleonObject(cdfPath);
+        if (!kameleon) {
+            return false;
+        }
 
-    state.setModel(fls::stringToModel(kameleon->getModelName()));
-    state.setTriggerTime(kameleonHelper::getTime(kameleon.get()));
+        state.setModel(fls::stringToModel(kameleon->getModelName()));
+        state.setTriggerTime(kameleonHelper::getTime(kameleon.get()));
+    }
 
-    if (addLinesToState(kameleon.get(), seedPoints, tracingVar, state)) {
+    nThreads = resolveThreadCount(nThreads);
+    const bool success = addLinesToState(
+        kameleon.get(),
+        seedPoints,
+        tracingVar,
+        state,
+        nThreads,
+        fileAccessMutex
+    );
+    if (success) {
         // The line points are in their RAW format (unscaled & maybe spherical)
         // Before we scale to meters (and maybe cartesian) we must extract
         // the extraQuantites, as the iterpolator needs the unaltered positions
-        addExtraQuantities(kameleon.get(), extraVars, extraMagVars, state);
+        addExtraQuantities(
+            kameleon.get(),
+            extraVars,
+            extraMagVars,
+            state,
+            nThreads,
+            fileAccessMutex
+        );
         switch (state.model()) {
             case fls::Model::Batsrus:
                 state.scalePositions(fls::ReToMeter);
@@ -124,14 +175,87 @@ bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfP
             default:
                 break;
         }
-
-        return true;
     }
 
-    return false;
+    // Closing the file accesses it as well
+    std::unique_lock<std::mutex> lock = lockFileAccess(fileAccessMutex);
+    kameleon = nullptr;
+    return success;
 #endif // OPENSPACE_MODULE_KAMELEON_ENABLED
 }
 
+/**
+ * Converts the cdf files in \p cdfPaths concurrently. Up to \p nConcurrentFiles files are
+ * converted at the same time, each of which is traced with an equal share of the
+ * hardware threads. Opening, reading and closing the files is serialized, so only the
+ * tracing and sampling of different files overlaps. \p onState is called on the calling
+ * thread with the index into \p cdfPaths and the state of every file that was converted
+ * successfully, in the order of \p cdfPaths. All other parameters are the same as for
+ * convertCdfToFieldlinesState.
+ * Returns the number of files that were converted successfully
+ */
+size_t convertCdfsToFieldlinesStates(const std::vector<std::string>& cdfPaths,
+    const std::vector<glm::vec3>& seedPoints, const std::string& tracingVar,
+    const std::vector<std::string>& extraVars,
+    const std::vector<std::string>& extraMagVars,
+    const std::function<void(size_t, FieldlinesState&)>& onState,
+    unsigned int nConcurrentFiles)
+{
+    if (cdfPaths.empty()) {
+        return 0;
+    }
+
+    const unsigned int nHardwareThreads = resolveThreadCount(0);
+    nConcurrentFiles = std::min(
+        std::max(nConcurrentFiles, 1u),
+        static_cast<unsigned int>(std::min<size_t>(cdfPaths.size(), nHardwareThreads))
+    );
+    const unsigned int nThreadsPerFile = std::max(
+        nHardwareThreads / nConcurrentFiles,
+        1u
+    );
+
+    struct Result {
+        FieldlinesState state;
+        bool isSuccessful;
+    };
+
+    std::mutex fileAccessMutex;
+    ThreadPool pool(nConcurrentFiles);
+    std::vector<std::future<std::unique_ptr<Result>>> results;
+    results.reserve(cdfPaths.size());
+    for (const std::string& cdfPath : cdfPaths) {
+        results.push_back(pool.submit([&, cdfPath]() {
+            // The extra variables are pruned to the ones that exist in the file, so
+            // every file needs its own copy
+            std::vector<std::string> vars = extraVars;
+            std::vector<std::string> magVars = extraMagVars;
+            auto result = std::make_unique<Result>();
+            result->isSuccessful = convertCdfToFieldlinesState(
+                result->state,
+                cdfPath,
+                seedPoints,
+                tracingVar,
+                vars,
+                magVars,
+                nThreadsPerFile,
+                &fileAccessMutex
+            );
+            return result;
+        }));
+    }
+
+    size_t nSuccessful = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        std::unique_ptr<Result> result = results[i].get();
+        if (result->isSuccessful) {
+            onState(i, result->state);
+            ++nSuccessful;
+        }
+    }
+    return nSuccessful;
+}
+
 #ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
 /**
  * Traces and adds line vertices to state.
@@ -140,7 +264,9 @@ bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfP
  * Note that extraQuantities will NOT be set!
  */
 bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& seedPoints,
-                     const std::string tracingVar, FieldlinesState& state) {
+                     const std::string tracingVar, FieldlinesState& state,
+                     unsigned int nThreads, std::mutex* fileAccessMutex)
+{
 
     float innerBoundaryLimit;
 
@@ -160,40 +286,77 @@ bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& see
     }
 
     // ---------------------------- LOAD TRACING VARIABLE ---------------------------- //
-    if (!kameleon->loadVariable(tracingVar)) {
-        LERROR("Failed to load tracing variable: " + tracingVar);
-        return false;
+    {
+        std::unique_lock<std::mutex> lock = lockFileAccess(fileAccessMutex);
+        if (!kameleon->loadVariable(tracingVar)) {
+            LERROR("Failed to load tracing variable: " + tracingVar);
+            return false;
+        }
     }
 
-    bool success = false;
     LINFO("Tracing field lines!");
-    // LOOP THROUGH THE SEED POINTS, TRACE LINES, CONVERT POINTS TO glm::vec3 AND STORE //
-    for (const glm::vec3& seed : seedPoints) {
-        //--------------------------------------------------------------------------//
-        // We have to create a new tracer (or actually a new interpolator) for each //
-        // new line, otherwise some issues occur                                    //
-        //--------------------------------------------------------------------------//
-        std::unique_ptr<ccmc::Interpolator> interpolator =
-                std::make_unique<ccmc::KameleonInterpolator>(kameleon->model);
-        ccmc::Tracer tracer(kameleon, interpolator.get());
-        tracer.setInnerBoundary(innerBoundaryLimit); // TODO specify in Lua?
-        ccmc::Fieldline ccmcFieldline = tracer.bidirectionalTrace(
-            tracingVar,
-            seed.x,
-            seed.y,
-            seed.z
-        );
-        const std::vector<ccmc::Point3f>& positions = ccmcFieldline.getPositions();
-
-        const size_t nLinePoints = positions.size();
+    // Every worker claims batches of seed points from a shared counter and stores each
+    // traced line at the index of its seed point, so that the lines end up in the state
+    // in the same order regardless of the number of threads
+    std::vector<std::vector<glm::vec3>> lines(seedPoints.size());
+    std::atomic<size_t> nextSeed(0);
+    auto traceLines = [&]() {
+        for (size_t first = nextSeed.fetch_add(WorkBatchSize);
+             first < seedPoints.size();
+             first = nextSeed.fetch_add(WorkBatchSize))
+        {
+            const size_t last = std::min(first + WorkBatchSize, seedPoints.size());
+            for (size_t i = first; i < last; ++i) {
+                const glm::vec3& seed = seedPoints[i];
+                //------------------------------------------------------------------//
+                // We have to create a new tracer (or actually a new interpolator)  //
+                // for each new line, otherwise some issues occur. The Kameleon     //
+                // interpolators are not thread safe either, so they are never      //
+                // shared between workers                                           //
+                //------------------------------------------------------------------//
+                std::unique_ptr<ccmc::Interpolator> interpolator =
+                    std::make_unique<ccmc::KameleonInterpolator>(kameleon->model);
+                ccmc::Tracer tracer(kameleon, interpolator.get());
+                tracer.setInnerBoundary(innerBoundaryLimit); // TODO specify in Lua?
+                ccmc::Fieldline ccmcFieldline = tracer.bidirectionalTrace(
+                    tracingVar,
+                    seed.x,
+                    seed.y,
+                    seed.z
+                );
+                const std::vector<ccmc::Point3f>& positions =
+                    ccmcFieldline.getPositions();
 
-        std::vector<glm::vec3> vertices;
-        vertices.reserve(nLinePoints);
-        for (const ccmc::Point3f& p : positions) {
-            vertices.emplace_back(p.component1, p.component2, p.component3);
+                std::vector<glm::vec3>& vertices = lines[i];
+                vertices.reserve(positions.size());
+                for (const ccmc::Point3f& p : positions) {
+                    vertices.emplace_back(p.component1, p.component2, p.component3);
+                }
+            }
         }
-        state.addLine(vertices);
-        success = (nLinePoints > 0) ? true : success;
+    };
+
+    const size_t nBatches = (seedPoints.size() + WorkBatchSize - 1) / WorkBatchSize;
+    nThreads = static_cast<unsigned int>(std::min<size_t>(nThreads, nBatches));
+    ThreadPool pool(std::max(nThreads, 1u));
+    std::vector<std::future<void>> futures;
+    for (unsigned int i = 0; i < pool.numThreads(); ++i) {
+        futures.push_back(pool.submit(traceLines));
+    }
+    for (std::future<void>& f : futures) {
+        f.get();
+    }
+
+    size_t nPoints = 0;
+    for (const std::vector<glm::vec3>& line : lines) {
+        nPoints += line.size();
+    }
+    state.reserve(lines.size(), nPoints);
+
+    bool success = false;
+    for (std::vector<glm::vec3>& line : lines) {
+        success = !line.empty() || success;
+        state.addLine(line);
     }
 
     return success;
@@ -214,65 +377,119 @@ bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& see
  * names of the components needed to calculate magnitude. E.g. {"ux", "uy", "uz"} will
  * calculate: sqrt(ux*ux + uy*uy + uz*uz). Magnitude will be stored in _extraQuantities
  * @param state, The FieldlinesState which the extra quantities should be added to.
+ * @param nThreads, number of threads used to sample the extra quantities
+ * @param fileAccessMutex, locked while the variables are loaded, if provided
  */
 #ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
 void addExtraQuantities(ccmc::Kameleon* kameleon,
                         std::vector<std::string>& extraScalarVars,
                         std::vector<std::string>& extraMagVars,
-                        FieldlinesState& state)
+                        FieldlinesState& state,
+                        unsigned int nThreads,
+                        std::mutex* fileAccessMutex)
 {
-
-    prepareStateAndKameleonForExtras(kameleon, extraScalarVars, extraMagVars, state);
+    {
+        std::unique_lock<std::mutex> lock = lockFileAccess(fileAccessMutex);
+        prepareStateAndKameleonForExtras(kameleon, extraScalarVars, extraMagVars, state);
+    }
 
     const size_t nXtraScalars = extraScalarVars.size();
     const size_t nXtraMagnitudes = extraMagVars.size() / 3;
+    const std::vector<glm::vec3>& positions = state.vertexPositions();
+    const size_t nPoints = positions.size();
+    const fls::Model model = state.model();
 
-    std::unique_ptr<ccmc::Interpolator> interpolator =
-            std::make_unique<ccmc::KameleonInterpolator>(kameleon->model);
+    std::vector<std::vector<float>> extras(
+        nXtraScalars + nXtraMagnitudes,
+        std::vector<float>(nPoints)
+    );
+    std::vector<bool> isParallelToB(nXtraMagnitudes);
+    for (size_t i = 0; i < nXtraMagnitudes; ++i) {
+        isParallelToB[i] = state.extraQuantityNames()[nXtraScalars + i] == JParallelB;
+    }
 
     // ------ Extract all the extraQuantities from kameleon and store in state! ------ //
-    for (const glm::vec3& p : state.vertexPositions()) {
-        // Load the scalars!
-        for (size_t i = 0; i < nXtraScalars; i++) {
-            float val;
-            if (extraScalarVars[i] == TAsPOverRho) {
-                val = interpolator->interpolate("p", p.x, p.y, p.z);
-                val *= ToKelvin;
-                val /= interpolator->interpolate("rho", p.x, p.y, p.z);
-            } else {
-                val = interpolator->interpolate(extraScalarVars[i], p.x, p.y, p.z);
+    // Every worker claims batches of vertices from a shared counter and samples them
+    // with its own interpolator
+    std::atomic<size_t> nextPoint(0);
+    auto sampleExtras = [&]() {
+        std::unique_ptr<ccmc::Interpolator> interpolator =
+            std::make_unique<ccmc::KameleonInterpolator>(kameleon->model);
 
-                // When measuring density in ENLIL CCMC multiply by the radius^2
-                if (extraScalarVars[i] == "rho" && state.model() == fls::Model::Enlil) {
-                    val *= std::pow(p.x * fls::AuToMeter, 2.0f);
+        for (size_t first = nextPoint.fetch_add(WorkBatchSize);
+             first < nPoints;
+             first = nextPoint.fetch_add(WorkBatchSize))
+        {
+            const size_t last = std::min(first + WorkBatchSize, nPoints);
+            for (size_t j = first; j < last; ++j) {
+                const glm::vec3& p = positions[j];
+                // Load the scalars!
+                for (size_t i = 0; i < nXtraScalars; i++) {
+                    float val;
+                    if (extraScalarVars[i] == TAsPOverRho) {
+                        val = interpolator->interpolate("p", p.x, p.y, p.z);
+                        val *= ToKelvin;
+                        val /= interpolator->interpolate("rho", p.x, p.y, p.z);
+                    } else {
+                        val = interpolator->interpolate(
+                            extraScalarVars[i],
+                            p.x,
+                            p.y,
+                            p.z
+                        );
+
+                        // When measuring density in ENLIL CCMC multiply by the radius^2
+                        if (extraScalarVars[i] == "rho" && model == fls::Model::Enlil) {
+                            val *= std::pow(p.x * fls::AuToMeter, 2.0f);
+                        }
+                    }
+                    extras[i][j] = val;
+                }
+                // Calculate and store the magnitudes!
+                for (size_t i = 0; i < nXtraMagnitudes; ++i) {
+                    const size_t idx = i*3;
+
+                    const float x =
+                        interpolator->interpolate(extraMagVars[idx], p.x, p.y, p.z);
+                    const float y =
+                        interpolator->interpolate(extraMagVars[idx+1], p.x, p.y, p.z);
+                    const float z =
+                        interpolator->interpolate(extraMagVars[idx+2], p.x, p.y, p.z);
+                    float val;
+                    // When looking at the current's magnitude in Batsrus, CCMC staff are
+                    // only interested in the magnitude parallel to the magnetic field
+                    if (isParallelToB[i]) {
+                        const glm::vec3 normMagnetic =  glm::normalize(glm::vec3(
+                                interpolator->interpolate("bx", p.x, p.y, p.z),
+                                interpolator->interpolate("by", p.x, p.y, p.z),
+                                interpolator->interpolate("bz", p.x, p.y, p.z)));
+                        // Magnitude of the part of the current vector that's parallel
+                        // to the magnetic field vector!
+                        val = glm::dot(glm::vec3(x,y,z), normMagnetic);
+
+                    } else {
+                        val = std::sqrt(x*x + y*y + z*z);
+                    }
+                    extras[i + nXtraScalars][j] = val;
                 }
             }
-            state.appendToExtra(i, val);
         }
-        // Calculate and store the magnitudes!
-        for (size_t i = 0; i < nXtraMagnitudes; ++i) {
-            const size_t idx = i*3;
-
-            const float x = interpolator->interpolate(extraMagVars[idx]  , p.x, p.y, p.z);
-            const float y = interpolator->interpolate(extraMagVars[idx+1], p.x, p.y, p.z);
-            const float z = interpolator->interpolate(extraMagVars[idx+2], p.x, p.y, p.z);
-            float val;
-            // When looking at the current's magnitude in Batsrus, CCMC staff are
-            // only interested in the magnitude parallel to the magnetic field
-            if (state.extraQuantityNames()[nXtraScalars + i] == JParallelB) {
-                const glm::vec3 normMagnetic =  glm::normalize(glm::vec3(
-                        interpolator->interpolate("bx", p.x, p.y, p.z),
-                        interpolator->interpolate("by", p.x, p.y, p.z),
-                        interpolator->interpolate("bz", p.x, p.y, p.z)));
-                // Magnitude of the part of the current vector that's parallel to
-                // the magnetic field vector!
-                val = glm::dot(glm::vec3(x,y,z), normMagnetic);
+    };
 
-            } else {
-                val = std::sqrt(x*x + y*y + z*z);
-            }
-            state.appendToExtra(i + nXtraScalars, val);
-        }
+    nThreads = static_cast<unsigned int>(
+        std::min<size_t>(nThreads, (nPoints + WorkBatchSize - 1) / WorkBatchSize)
+    );
+    ThreadPool pool(std::max(nThreads, 1u));
+    std::vector<std::future<void>> futures;
+    for (unsigned int i = 0; i < pool.numThreads(); ++i) {
+        futures.push_back(pool.submit(sampleExtras));
+    }
+    for (std::future<void>& f : futures) {
+        f.get();
+    }
+
+    for (size_t i = 0; i < extras.size(); ++i) {
+        state.setExtraQuantity(i, std::move(extras[i]));
     }
 }
 #endif // OPENSPACE_MODULE_KAMELEON_ENABLED
@@ -26,6 +26,8 @@
 #define __OPENSPACE_MODULE_FIELDLINESSEQUENCE___KAMELEONFIELDLINEHELPER___H__
 
 #include <ghoul/glm.h>
+#include <functional>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -37,7 +39,15 @@ namespace fls {
 
 bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfPath,
     const std::vector<glm::vec3>& seedPoints, std::string tracingVar,
-    std::vector<std::string>& extraVars, std::vector<std::string>& extraMagVars);
+    std::vector<std::string>& extraVars, std::vector<std::string>& extraMagVars,
+    unsigned int nThreads = 0, std::mutex* fileAccessMutex = nullptr);
+
+size_t convertCdfsToFieldlinesStates(const std::vector<std::string>& cdfPaths,
+    const std::vector<glm::vec3>& seedPoints, const std::string& tracingVar,
+    const std::vector<std::string>& extraVars,
+    const std::vector<std::string>& extraMagVars,
+    const std::function<void(size_t, FieldlinesState&)>& onState,
+    unsigned int nConcurrentFiles);
 
 } // namespace fls
 } // namespace openspace
@@ -0,0 +1,131 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___INTRUSIVE_LRU_CACHE___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___INTRUSIVE_LRU_CACHE___H__
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace openspace::globebrowsing::cache {
+
+/**
+ * Templated class implementing a Least-Recently-Used Cache with the same interface as
+ * the <code>LRUCache</code> but without any per-operation memory allocation. All items
+ * are stored in a slab of nodes that are linked into the recency list by index, and
+ * unused nodes are kept in a free list for reuse. Keys are looked up through an
+ * open-addressing hash table with linear probing, which stores node indices only. The
+ * slab and the table grow geometrically when needed and are never shrunk, so a cache
+ * that has reached its steady-state size does not allocate anymore.
+ * <code>KeyType</code> needs to be equality comparable and <code>HasherType</code>
+ * needs to return an integral hash value.
+ */
+template<typename KeyType, typename ValueType, typename HasherType>
+class IntrusiveLRUCache {
+public:
+    using Item = std::pair<KeyType, ValueType>;
+
+    /**
+     * \param size is the maximum size of the cache given in number of cached items.
+     */
+    IntrusiveLRUCache(size_t size);
+
+    void put(const KeyType& key, const ValueType& value);
+    std::vector<Item> putAndFetchPopped(const KeyType& key, const ValueType& value);
+
+    /**
+     * Same as the other overload, but the popped items are appended to the provided
+     * vector so that the caller can reuse its storage.
+     */
+    void putAndFetchPopped(const KeyType& key, const ValueType& value,
+        std::vector<Item>& popped);
+    void clear();
+    bool exist(const KeyType& key) const;
+
+    /**
+     * If value exists, the value is bumped to the front of the queue.
+     * \returns true if value of this key exists.
+     */
+    bool touch(const KeyType& key);
+    bool isEmpty() const;
+    ValueType get(const KeyType& key);
+
+    /**
+     * Pops the front of the queue.
+     */
+    Item popMRU();
+
+    /**
+     * Pops the back of the queue.
+     */
+    Item popLRU();
+    size_t size() const;
+    size_t maximumCacheSize() const;
+
+private:
+    using Index = uint32_t;
+    static constexpr const Index Invalid = static_cast<Index>(-1);
+
+    struct Node {
+        KeyType key;
+        ValueType value;
+        uint64_t hash;
+        Index previous;
+        Index next;
+    };
+
+    uint64_t hashOf(const KeyType& key) const;
+    size_t slotOf(uint64_t hash) const;
+
+    Index find(const KeyType& key, uint64_t hash) const;
+    void insertIntoTable(Index node);
+    void eraseFromTable(Index node);
+    void growTable();
+
+    void linkFront(Index node);
+    void unlink(Index node);
+    Index allocateNode(const KeyType& key, const ValueType& value, uint64_t hash);
+    Item releaseNode(Index node);
+
+    void putWithoutCleaning(const KeyType& key, const ValueType& value);
+
+    std::vector<Node> _nodes;
+    Index _freeList = Invalid;
+    Index _mostRecent = Invalid;
+    Index _leastRecent = Invalid;
+
+    std::vector<Index> _table;
+    int _tableShift = 64;
+
+    size_t _size = 0;
+    size_t _maximumCacheSize;
+};
+
+} // namespace openspace::globebrowsing::cache
+
+#include <modules/globebrowsing/cache/intrusivelrucache.inl>
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___INTRUSIVE_LRU_CACHE___H__
@@ -0,0 +1,334 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+
+namespace openspace::globebrowsing::cache {
+
+namespace intrusivelrucache {
+    // Number of items that space is reserved for up front, unless the cache is smaller
+    constexpr const size_t InitialCapacity = 64;
+
+    // 2^64 divided by the golden ratio, used for Fibonacci hashing
+    constexpr const uint64_t FibonacciMultiplier = 11400714819323198485ULL;
+} // namespace intrusivelrucache
+
+template<typename KeyType, typename ValueType, typename HasherType>
+IntrusiveLRUCache<KeyType, ValueType, HasherType>::IntrusiveLRUCache(size_t size)
+    : _maximumCacheSize(size)
+{
+    const size_t capacity = std::min(size, intrusivelrucache::InitialCapacity);
+    _nodes.reserve(capacity);
+
+    // Keep the load factor of the hash table at or below one half
+    size_t tableSize = 16;
+    _tableShift = 60;
+    while (tableSize < 2 * capacity) {
+        tableSize *= 2;
+        --_tableShift;
+    }
+    _table.resize(tableSize, Invalid);
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void IntrusiveLRUCache<KeyType, ValueType, HasherType>::clear() {
+    // Capacities are kept so that refilling the cache does not allocate
+    _nodes.clear();
+    std::fill(_table.begin(), _table.end(), Invalid);
+    _freeList = Invalid;
+    _mostRecent = Invalid;
+    _leastRecent = Invalid;
+    _size = 0;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void IntrusiveLRUCache<KeyType, ValueType, HasherType>::put(const KeyType& key,
+                                                            const ValueType& value)
+{
+    putWithoutCleaning(key, value);
+    while (_size > _maximumCacheSize) {
+        releaseNode(_leastRecent);
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+std::vector<std::pair<KeyType, ValueType>>
+IntrusiveLRUCache<KeyType, ValueType, HasherType>::putAndFetchPopped(
+                                                                const KeyType& key,
+                                                                const ValueType& value)
+{
+    std::vector<Item> popped;
+    putAndFetchPopped(key, value, popped);
+    return popped;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void IntrusiveLRUCache<KeyType, ValueType, HasherType>::putAndFetchPopped(
+                                                                const KeyType& key,
+                                                                const ValueType& value,
+                                                                std::vector<Item>& popped)
+{
+    putWithoutCleaning(key, value);
+    while (_size > _maximumCacheSize) {
+        popped.push_back(releaseNode(_leastRecent));
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+bool IntrusiveLRUCache<KeyType, ValueType, HasherType>::exist(const KeyType& key) const {
+    return find(key, hashOf(key)) != Invalid;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+bool IntrusiveLRUCache<KeyType, ValueType, HasherType>::touch(const KeyType& key) {
+    const Index node = find(key, hashOf(key));
+    if (node == Invalid) {
+        return false;
+    }
+    if (node != _mostRecent) {
+        unlink(node);
+        linkFront(node);
+    }
+    return true;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+bool IntrusiveLRUCache<KeyType, ValueType, HasherType>::isEmpty() const {
+    return _size == 0;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+ValueType IntrusiveLRUCache<KeyType, ValueType, HasherType>::get(const KeyType& key) {
+    const Index node = find(key, hashOf(key));
+    ghoul_assert(node != Invalid, "Key must exist in the cache");
+    if (node != _mostRecent) {
+        unlink(node);
+        linkFront(node);
+    }
+    return _nodes[node].value;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+std::pair<KeyType, ValueType>
+IntrusiveLRUCache<KeyType, ValueType, HasherType>::popMRU()
+{
+    ghoul_assert(_size > 0, "Can not pop from LRU cache. Ensure cache is not empty.");
+    return releaseNode(_mostRecent);
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+std::pair<KeyType, ValueType>
+IntrusiveLRUCache<KeyType, ValueType, HasherType>::popLRU()
+{
+    ghoul_assert(_size > 0, "Can not pop from LRU cache. Ensure cache is not empty.");
+    return releaseNode(_leastRecent);
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+size_t IntrusiveLRUCache<KeyType, ValueType, HasherType>::size() const {
+    return _size;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+size_t IntrusiveLRUCache<KeyType, ValueType, HasherType>::maximumCacheSize() const {
+    return _maximumCacheSize;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+uint64_t IntrusiveLRUCache<KeyType, ValueType, HasherType>::hashOf(
+                                                                const KeyType& key) const
+{
+    return static_cast<uint64_t>(HasherType()(key));
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+size_t IntrusiveLRUCache<KeyType, ValueType, HasherType>::slotOf(uint64_t hash) const {
+    // The hashers used for tiles put most of the entropy into the high bits, so the
+    // multiplication is used to spread it over the bits that select the slot
+    return static_cast<size_t>(
+        (hash * intrusivelrucache::FibonacciMultiplier) >> _tableShift
+    );
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+typename IntrusiveLRUCache<KeyType, ValueType, HasherType>::Index
+IntrusiveLRUCache<KeyType, ValueType, HasherType>::find(const KeyType& key,
+                                                        uint64_t hash) const
+{
+    const size_t mask = _table.size() - 1;
+    for (size_t i = slotOf(hash); ; i = (i + 1) & mask) {
+        const Index node = _table[i];
+        if (node == Invalid) {
+            return Invalid;
+        }
+        if (_nodes[node].hash == hash && _nodes[node].key == key) {
+            return node;
+        }
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void IntrusiveLRUCache<KeyType, ValueType, HasherType>::insertIntoTable(Index node) {
+    const size_t mask = _table.size() - 1;
+    size_t i = slotOf(_nodes[node].hash);
+    while (_table[i] != Invalid) {
+        i = (i + 1) & mask;
+    }
+    _table[i] = node;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void IntrusiveLRUCache<KeyType, ValueType, HasherType>::eraseFromTable(Index node) {
+    const size_t mask = _table.size() - 1;
+    size_t i = slotOf(_nodes[node].hash);
+    while (_table[i] != node) {
+        i = (i + 1) & mask;
+    }
+
+    // Backward shift deletion: move subsequent entries of the probe sequence into the
+    // hole unless their home slot lies cyclically between the hole and themselves. This
+    // keeps the table free of tombstones
+    size_t j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        const Index candidate = _table[j];
+        if (candidate == Invalid) {
+            break;
+        }
+        const size_t home = slotOf(_nodes[candidate].hash);
+        const bool staysInPlace = (i <= j) ?
+            (i < home && home <= j) :
+            (i < home || home <= j);
+        if (!staysInPlace) {
+            _table[i] = candidate;
+            i = j;
+        }
+    }
+    _table[i] = Invalid;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void IntrusiveLRUCache<KeyType, ValueType, HasherType>::growTable() {
+    _table.assign(_table.size() * 2, Invalid);
+    --_tableShift;
+    for (Index node = _mostRecent; node != Invalid; node = _nodes[node].next) {
+        insertIntoTable(node);
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void IntrusiveLRUCache<KeyType, ValueType, HasherType>::linkFront(Index node) {
+    Node& n = _nodes[node];
+    n.previous = Invalid;
+    n.next = _mostRecent;
+    if (_mostRecent != Invalid) {
+        _nodes[_mostRecent].previous = node;
+    }
+    _mostRecent = node;
+    if (_leastRecent == Invalid) {
+        _leastRecent = node;
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void IntrusiveLRUCache<KeyType, ValueType, HasherType>::unlink(Index node) {
+    Node& n = _nodes[node];
+    if (n.previous != Invalid) {
+        _nodes[n.previous].next = n.next;
+    }
+    else {
+        _mostRecent = n.next;
+    }
+    if (n.next != Invalid) {
+        _nodes[n.next].previous = n.previous;
+    }
+    else {
+        _leastRecent = n.previous;
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+typename IntrusiveLRUCache<KeyType, ValueType, HasherType>::Index
+IntrusiveLRUCache<KeyType, ValueType, HasherType>::allocateNode(const KeyType& key,
+                                                                const ValueType& value,
+                                                                uint64_t hash)
+{
+    if (_freeList != Invalid) {
+        const Index node = _freeList;
+        Node& n = _nodes[node];
+        _freeList = n.next;
+        n.key = key;
+        n.value = value;
+        n.hash = hash;
+        return node;
+    }
+    else {
+        _nodes.push_back({ key, value, hash, Invalid, Invalid });
+        return static_cast<Index>(_nodes.size() - 1);
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+std::pair<KeyType, ValueType>
+IntrusiveLRUCache<KeyType, ValueType, HasherType>::releaseNode(Index node)
+{
+    unlink(node);
+    eraseFromTable(node);
+
+    Node& n = _nodes[node];
+    Item item(std::move(n.key), std::move(n.value));
+    n.next = _freeList;
+    _freeList = node;
+    --_size;
+    return item;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void IntrusiveLRUCache<KeyType, ValueType, HasherType>::putWithoutCleaning(
+                                                                const KeyType& key,
+                                                                const ValueType& value)
+{
+    const uint64_t hash = hashOf(key);
+    Index node = find(key, hash);
+    if (node != Invalid) {
+        _nodes[node].value = value;
+        if (node != _mostRecent) {
+            unlink(node);
+            linkFront(node);
+        }
+        return;
+    }
+
+    if ((_size + 1) * 2 > _table.size()) {
+        growTable();
+    }
+    node = allocateNode(key, value, hash);
+    insertIntoTable(node);
+    linkFront(node);
+    ++_size;
+}
+
+} // namespace openspace::globebrowsing::cache
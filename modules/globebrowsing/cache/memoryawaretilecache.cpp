@@ -32,12 +32,19 @@
 #include <ghoul/misc/invariants.h>
 #include <ghoul/systemcapabilities/generalcapabilitiescomponent.h>
 
-#include <numeric>
 #include <algorithm>
+#include <limits>
+#include <numeric>
 
 namespace {
     constexpr const char* _loggerCat = "MemoryAwareTileCache";
 
+    constexpr const size_t ByteToMegaByte = 1024 * 1024;
+
+    int clampToInt(long long v) {
+        return static_cast<int>(std::min<long long>(v, std::numeric_limits<int>::max()));
+    }
+
     static const openspace::properties::Property::PropertyInfo CpuAllocatedDataInfo = {
         "CpuAllocatedTileData",
         "CPU allocated tile data (MB)",
@@ -52,10 +59,26 @@ namespace {
         "utilizing."
     };
 
+    static const openspace::properties::Property::PropertyInfo CachedTileDataInfo = {
+        "CachedTileData",
+        "Cached tile data (MB)",
+        "This value denotes the amount of CPU and GPU memory (in MB) that is used by the "
+        "tiles that are currently in the cache. It is kept below the tile cache size."
+    };
+
     static const openspace::properties::Property::PropertyInfo TileCacheSizeInfo = {
         "TileCacheSize",
         "Tile cache size",
-        "" // @TODO Missing documentation
+        "The budget (in MB) for the combined CPU and GPU memory of all cached tiles. "
+        "The value is applied when the 'ApplyTileCacheSize' property is triggered."
+    };
+
+    static const openspace::properties::Property::PropertyInfo MaximumProviderShareInfo =
+    {
+        "MaximumProviderShare",
+        "Maximum provider share",
+        "The largest fraction of the tile cache size that the tiles of a single tile "
+        "provider are allowed to occupy."
     };
 
     static const openspace::properties::Property::PropertyInfo ApplyTileCacheInfo = {
@@ -70,6 +93,25 @@ namespace {
         "" // @TODO Missing documentation
     };
 
+    static const openspace::properties::Property::PropertyInfo HitsInfo = {
+        "Hits",
+        "Cache hits",
+        "The number of tile lookups that were answered from the cache."
+    };
+
+    static const openspace::properties::Property::PropertyInfo MissesInfo = {
+        "Misses",
+        "Cache misses",
+        "The number of tile lookups for tiles that were not in the cache."
+    };
+
+    static const openspace::properties::Property::PropertyInfo EvictionsInfo = {
+        "Evictions",
+        "Cache evictions",
+        "The number of tiles that have been removed from the cache to make space for "
+        "other tiles."
+    };
+
     static const openspace::properties::Property::PropertyInfo UsePboInfo = {
         "UsePbo",
         "Use PBO",
@@ -84,11 +126,17 @@ namespace openspace::globebrowsing::cache {
 MemoryAwareTileCache::MemoryAwareTileCache()
     : PropertyOwner({ "TileCache" })
     , _numTextureBytesAllocatedOnCPU(0)
+    , _tiles([this](const ShardedTileCache::CachedTile& t) { releaseTexture(t); })
     , _cpuAllocatedTileData(CpuAllocatedDataInfo, 1024, 128, 16384, 1)
     , _gpuAllocatedTileData(GpuAllocatedDataInfo, 1024, 128, 16384, 1)
+    , _cachedTileData(CachedTileDataInfo, 0, 0, 16384, 1)
     , _tileCacheSize(TileCacheSizeInfo, 1024, 128, 16384, 1)
+    , _maximumProviderShare(MaximumProviderShareInfo, 0.5f, 0.05f, 1.f)
     , _applyTileCacheSize(ApplyTileCacheInfo)
     , _clearTileCache(ClearTileCacheInfo)
+    , _hits(HitsInfo, 0, 0, std::numeric_limits<int>::max())
+    , _misses(MissesInfo, 0, 0, std::numeric_limits<int>::max())
+    , _evictions(EvictionsInfo, 0, 0, std::numeric_limits<int>::max())
     , _usePbo(UsePboInfo, false)
 {
     createDefaultTextureContainers();
@@ -96,7 +144,9 @@ MemoryAwareTileCache::MemoryAwareTileCache()
     _clearTileCache.onChange([&]{ clear(); });
     addProperty(_clearTileCache);
 
-    _applyTileCacheSize.onChange([&]{ setSizeEstimated(_tileCacheSize * 1024 * 1024); });
+    _applyTileCacheSize.onChange([&]{
+        setSizeEstimated(_tileCacheSize * ByteToMegaByte);
+    });
     addProperty(_applyTileCacheSize);
 
     _cpuAllocatedTileData.setMaxValue(
@@ -111,25 +161,45 @@ MemoryAwareTileCache::MemoryAwareTileCache()
     _gpuAllocatedTileData.setReadOnly(true);
     addProperty(_gpuAllocatedTileData);
 
+    _cachedTileData.setMaxValue(
+        static_cast<int>(CpuCap.installedMainMemory() * 0.95)
+    );
+    _cachedTileData.setReadOnly(true);
+    addProperty(_cachedTileData);
+
     _tileCacheSize.setMaxValue(
         static_cast<int>(CpuCap.installedMainMemory() * 0.95)
     );
     addProperty(_tileCacheSize);
 
+    _maximumProviderShare.onChange([&]{
+        _tiles.setMaximumProviderShare(_maximumProviderShare);
+    });
+    _tiles.setMaximumProviderShare(_maximumProviderShare);
+    addProperty(_maximumProviderShare);
+
+    _hits.setReadOnly(true);
+    addProperty(_hits);
+    _misses.setReadOnly(true);
+    addProperty(_misses);
+    _evictions.setReadOnly(true);
+    addProperty(_evictions);
+
     addProperty(_usePbo);
 
-    setSizeEstimated(_tileCacheSize * 1024 * 1024);
+    setSizeEstimated(_tileCacheSize * ByteToMegaByte);
 }
 
 void MemoryAwareTileCache::clear() {
     LINFO("Clearing tile cache");
     _numTextureBytesAllocatedOnCPU = 0;
     for (std::pair<const TileTextureInitData::HashKey,
-        TextureContainerTileCache>& p : _textureContainerMap)
+        std::unique_ptr<TextureContainer>>& p : _textureContainerMap)
     {
-        p.second.first->reset();
-        p.second.second->clear();
+        p.second->reset();
     }
+
+    _tiles.clear();
     LINFO("Tile cache cleared");
 }
 
@@ -149,11 +219,9 @@ void MemoryAwareTileCache::assureTextureContainerExists(
     TileTextureInitData::HashKey initDataKey = initData.hashKey();
     if (_textureContainerMap.find(initDataKey) == _textureContainerMap.end()) {
         // For now create 500 textures of this type
-        _textureContainerMap.emplace(initDataKey,
-            TextureContainerTileCache(
-                std::make_unique<TextureContainer>(initData, 500),
-                std::make_unique<TileCache>(std::numeric_limits<std::size_t>::max())
-            )
+        _textureContainerMap.emplace(
+            initDataKey,
+            std::make_unique<TextureContainer>(initData, 500)
         );
     }
 }
@@ -162,14 +230,16 @@ void MemoryAwareTileCache::setSizeEstimated(size_t estimatedSize) {
     LDEBUG("Resetting tile cache size");
     ghoul_assert(_textureContainerMap.size() > 0, "Texture containers must exist.");
 
+    _tiles.setBudget(estimatedSize);
+
     size_t sumTextureTypeSize = std::accumulate(
         _textureContainerMap.cbegin(),
         _textureContainerMap.cend(),
         size_t(0),
         [](size_t s, const std::pair<const TileTextureInitData::HashKey,
-                                     TextureContainerTileCache>& p)
+                                     std::unique_ptr<TextureContainer>>& p)
         {
-            return s + p.second.first->tileTextureInitData().totalNumBytes();
+            return s + p.second->tileTextureInitData().totalNumBytes();
         }
     );
 
@@ -181,42 +251,20 @@ void MemoryAwareTileCache::setSizeEstimated(size_t estimatedSize) {
 void MemoryAwareTileCache::resetTextureContainerSize(size_t numTexturesPerTextureType) {
     _numTextureBytesAllocatedOnCPU = 0;
     for (std::pair<const TileTextureInitData::HashKey,
-        TextureContainerTileCache>& p : _textureContainerMap)
+        std::unique_ptr<TextureContainer>>& p : _textureContainerMap)
     {
-        p.second.first->reset(numTexturesPerTextureType);
-        p.second.second->clear();
+        p.second->reset(numTexturesPerTextureType);
     }
+
+    _tiles.clear();
 }
 
 bool MemoryAwareTileCache::exist(ProviderTileKey key) const {
-    TextureContainerMap::const_iterator result = std::find_if(
-        _textureContainerMap.cbegin(),
-        _textureContainerMap.cend(),
-        [&](const std::pair<const TileTextureInitData::HashKey,
-                            TextureContainerTileCache>& p)
-        {
-            return p.second.second->exist(key);
-        }
-    );
-    return result != _textureContainerMap.cend();
+    return _tiles.exist(key);
 }
 
 Tile MemoryAwareTileCache::get(ProviderTileKey key) {
-    TextureContainerMap::const_iterator it = std::find_if(
-        _textureContainerMap.cbegin(),
-        _textureContainerMap.cend(),
-        [&](const std::pair<const TileTextureInitData::HashKey,
-                            TextureContainerTileCache>& p)
-        {
-            return p.second.second->exist(key);
-        }
-    );
-    if (it != _textureContainerMap.cend()) {
-        return it->second.second->get(key);
-    }
-    else {
-        return Tile::TileUnavailable;
-    }
+    return _tiles.get(key);
 }
 
 ghoul::opengl::Texture* MemoryAwareTileCache::getTexture(
@@ -229,10 +277,10 @@ ghoul::opengl::Texture* MemoryAwareTileCache::getTexture(
     // Now we know that the texture container exists,
     // check if there are any unused textures
     ghoul::opengl::Texture* texture =
-        _textureContainerMap[initDataKey].first->getTextureIfFree();
-    // Second option. No more textures available. Pop from the LRU cache
+        _textureContainerMap[initDataKey]->getTextureIfFree();
+    // Second option. No more textures available. Evict a tile of this type
     if (!texture) {
-        Tile oldTile = _textureContainerMap[initDataKey].second->popLRU().second;
+        Tile oldTile = _tiles.evictTileOfType(initDataKey);
         // Use the old tile's texture
         texture = oldTile.texture();
     }
@@ -251,6 +299,10 @@ void MemoryAwareTileCache::createTileAndPut(ProviderTileKey key,
     else {
         const TileTextureInitData& initData = *rawTile->textureInitData;
         Texture* texture = getTexture(initData);
+        if (!texture) {
+            LWARNING("No texture available for tile, the tile cache size is too small");
+            return;
+        }
 
         // Re-upload texture, either using PBO or by using RAM data
         if (rawTile->pbo != 0) {
@@ -276,8 +328,7 @@ void MemoryAwareTileCache::createTileAndPut(ProviderTileKey key,
         }
         texture->setFilter(ghoul::opengl::Texture::FilterMode::AnisotropicMipMap);
         Tile tile(texture, rawTile->tileMetaData, Tile::Status::OK);
-        TileTextureInitData::HashKey initDataKey = initData.hashKey();
-        _textureContainerMap[initDataKey].second->put(key, tile);
+        _tiles.put(key, initData.hashKey(), tile, tileDataSize(initData));
     }
     return;
 }
@@ -286,18 +337,40 @@ void MemoryAwareTileCache::put(const ProviderTileKey& key,
                                const TileTextureInitData::HashKey& initDataKey,
                                Tile tile)
 {
-    _textureContainerMap[initDataKey].second->put(key, tile);
+    auto it = _textureContainerMap.find(initDataKey);
+    const size_t nBytes = (it != _textureContainerMap.end()) ?
+        tileDataSize(it->second->tileTextureInitData()) :
+        0;
+    _tiles.put(key, initDataKey, tile, nBytes);
     return;
 }
 
+void MemoryAwareTileCache::releaseTexture(const ShardedTileCache::CachedTile& evicted) {
+    // Hand the texture back so that it can be used for the next tile of this type
+    auto it = _textureContainerMap.find(evicted.initDataKey);
+    if (it != _textureContainerMap.end() && evicted.tile.texture()) {
+        it->second->release(evicted.tile.texture());
+    }
+}
+
+size_t MemoryAwareTileCache::tileDataSize(const TileTextureInitData& initData) const {
+    // Every tile occupies a texture on the GPU, and for some texture types the pixel
+    // data is also kept in RAM
+    const size_t nBytes = initData.totalNumBytes();
+    return initData.shouldAllocateDataOnCPU() ? 2 * nBytes : nBytes;
+}
+
 void MemoryAwareTileCache::update() {
     const size_t dataSizeCPU = getCPUAllocatedDataSize();
     const size_t dataSizeGPU = getGPUAllocatedDataSize();
 
-    const size_t ByteToMegaByte = 1024 * 1024;
-
     _cpuAllocatedTileData.setValue(static_cast<int>(dataSizeCPU / ByteToMegaByte));
     _gpuAllocatedTileData.setValue(static_cast<int>(dataSizeGPU / ByteToMegaByte));
+    _cachedTileData.setValue(static_cast<int>(getCachedTileDataSize() / ByteToMegaByte));
+
+    _hits.setValue(clampToInt(_tiles.nHits()));
+    _misses.setValue(clampToInt(_tiles.nMisses()));
+    _evictions.setValue(clampToInt(_tiles.nEvictions()));
 }
 
 size_t MemoryAwareTileCache::getGPUAllocatedDataSize() const {
@@ -306,9 +379,9 @@ size_t MemoryAwareTileCache::getGPUAllocatedDataSize() const {
         _textureContainerMap.cend(),
         size_t(0),
         [](size_t s, const std::pair<const TileTextureInitData::HashKey,
-        TextureContainerTileCache>& p)
+        std::unique_ptr<TextureContainer>>& p)
         {
-            const TextureContainer& textureContainer = *p.second.first;
+            const TextureContainer& textureContainer = *p.second;
             size_t bytesPerTexture =
                 textureContainer.tileTextureInitData().totalNumBytes();
             return s + bytesPerTexture * textureContainer.size();
@@ -322,9 +395,9 @@ size_t MemoryAwareTileCache::getCPUAllocatedDataSize() const {
         _textureContainerMap.cend(),
         size_t(0),
         [](size_t s, const std::pair<const TileTextureInitData::HashKey,
-        TextureContainerTileCache>& p)
+        std::unique_ptr<TextureContainer>>& p)
         {
-            const TextureContainer& textureContainer = *p.second.first;
+            const TextureContainer& textureContainer = *p.second;
             const TileTextureInitData& initData = textureContainer.tileTextureInitData();
             if (initData.shouldAllocateDataOnCPU()) {
                 size_t bytesPerTexture = initData.totalNumBytes();
@@ -336,8 +409,20 @@ size_t MemoryAwareTileCache::getCPUAllocatedDataSize() const {
     return dataSize + _numTextureBytesAllocatedOnCPU;
 }
 
+size_t MemoryAwareTileCache::getCachedTileDataSize() const {
+    return _tiles.cachedBytes();
+}
+
 bool MemoryAwareTileCache::shouldUsePbo() const {
     return _usePbo;
 }
 
+unsigned long long MemoryAwareTileCache::generation() const {
+    return _tiles.generation();
+}
+
+void MemoryAwareTileCache::increaseGeneration() {
+    _tiles.increaseGeneration();
+}
+
 } // namespace openspace::globebrowsing::cache
@@ -25,7 +25,7 @@
 #ifndef __OPENSPACE_MODULE_GLOBEBROWSING___MEMORY_AWARE_TILE_CACHE___H__
 #define __OPENSPACE_MODULE_GLOBEBROWSING___MEMORY_AWARE_TILE_CACHE___H__
 
-#include <modules/globebrowsing/cache/lrucache.h>
+#include <modules/globebrowsing/cache/shardedtilecache.h>
 #include <modules/globebrowsing/cache/texturecontainer.h>
 #include <modules/globebrowsing/tile/tile.h>
 #include <modules/globebrowsing/tile/tileindex.h>
@@ -38,51 +38,20 @@
 #include <openspace/properties/triggerproperty.h>
 
 #include <memory>
-#include <vector>
 #include <unordered_map>
 
 namespace openspace::globebrowsing::cache {
 
-struct ProviderTileKey {
-    TileIndex tileIndex;
-    unsigned int providerID;
-
-    bool operator==(const ProviderTileKey& r) const {
-        return (providerID == r.providerID) &&
-            (tileIndex == r.tileIndex);
-    }
-};
-
-struct ProviderTileHasher {
-    /**
-    Creates a hash which can be used as key in hash maps.
-    First set the bits to be unique for all tiles.
-    +-------+------------+-------+------------+
-    | USAGE | BIT RANGE  | #BITS | MAX VALUE  |
-    +-------+------------+-------+------------+
-    | level |   0 -  5   |   5   |         31 |
-    |     x |   5 - 35   |  30   | 1073741824 |
-    |     y |  35 - 64   |  29   |  536870912 |
-    +-------+------------+-------+------------+
-
-    Bits are then shifted depending on the tile provider used.
-    */
-    unsigned long long operator()(const ProviderTileKey& t) const {
-        unsigned long long key = 0;
-        key |= static_cast<unsigned long long>(t.tileIndex.level);
-        key |= static_cast<unsigned long long>(t.tileIndex.x) << 5ULL;
-        key |= static_cast<unsigned long long>(t.tileIndex.y) << 35ULL;
-        // Now the key is unique for all tiles, however not for all tile providers.
-        // Add to the key depending on the tile provider to avoid some hash collisions.
-        // (All hash collisions can not be avoided due to the limit in 64 bit for the
-        // hash key)
-        // Idea: make some offset in the place of the bits for the x value. Lesser chance
-        // of having different x-value than having different tile provider ids.
-        key += static_cast<unsigned long long>(t.providerID) << 25ULL;
-        return key;
-    }
-};
-
+/**
+ * Cache for the tiles of all tile providers that owns the textures of the tiles. The
+ * bookkeeping of which tiles are cached is done by a ShardedTileCache, so
+ * <code>exist</code> and <code>get</code> may be called from any thread; all other
+ * functions create or reuse OpenGL textures and must be called from the main thread.
+ *
+ * The byte budget of the cache accounts for the GPU memory of each cached tile and, for
+ * texture types that keep their data on the CPU, the RAM as well. No single provider may
+ * use more than a configurable fraction of the budget.
+ */
 class MemoryAwareTileCache : public properties::PropertyOwner {
 public:
     MemoryAwareTileCache();
@@ -99,30 +68,55 @@ public:
 
     size_t getGPUAllocatedDataSize() const;
     size_t getCPUAllocatedDataSize() const;
+    /// Returns the number of bytes used by the tiles that are currently in the cache
+    size_t getCachedTileDataSize() const;
     bool shouldUsePbo() const;
 
+    /**
+     * Returns a number that is increased whenever tiles are added to or removed from
+     * the cache, so that a change in which tiles are available can be detected by
+     * comparing it to a previous value.
+     */
+    unsigned long long generation() const;
+
+    /**
+     * Increases the generation for changes to the available tiles that do not go
+     * through the cache, for example a tile provider switching to another dataset.
+     */
+    void increaseGeneration();
+
 private:
+    using TextureContainerMap = std::unordered_map<TileTextureInitData::HashKey,
+        std::unique_ptr<TextureContainer>>;
 
     void createDefaultTextureContainers();
     void assureTextureContainerExists(const TileTextureInitData& initData);
     void resetTextureContainerSize(size_t numTexturesPerTextureType);
 
-    using TileCache = LRUCache<ProviderTileKey, Tile, ProviderTileHasher>;
-    using TextureContainerTileCache =
-        std::pair<std::unique_ptr<TextureContainer>, std::unique_ptr<TileCache>>;
-    using TextureContainerMap = std::unordered_map<TileTextureInitData::HashKey,
-        TextureContainerTileCache>;
+    /// Returns the number of bytes a cached tile of the given texture type occupies
+    size_t tileDataSize(const TileTextureInitData& initData) const;
+
+    /// Hands the texture of a tile that was evicted back to its texture container
+    void releaseTexture(const ShardedTileCache::CachedTile& evicted);
 
     TextureContainerMap _textureContainerMap;
     size_t _numTextureBytesAllocatedOnCPU;
 
+    ShardedTileCache _tiles;
+
     // Properties
     properties::IntProperty _cpuAllocatedTileData;
     properties::IntProperty _gpuAllocatedTileData;
+    properties::IntProperty _cachedTileData;
     properties::IntProperty _tileCacheSize;
+    properties::FloatProperty _maximumProviderShare;
     properties::TriggerProperty _applyTileCacheSize;
     properties::TriggerProperty _clearTileCache;
 
+    properties::IntProperty _hits;
+    properties::IntProperty _misses;
+    properties::IntProperty _evictions;
+
     /// Whether or not pixel buffer objects should be used when uploading tile data
     properties::BoolProperty _usePbo;
 };
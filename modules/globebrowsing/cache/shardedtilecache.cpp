@@ -0,0 +1,320 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/cache/shardedtilecache.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace openspace::globebrowsing::cache {
+
+ShardedTileCache::ShardedTileCache(EvictionCallback onEviction)
+    : _onEviction(std::move(onEviction))
+    , _cachedBytes(0)
+    , _budget(0)
+    , _maximumProviderShare(1.f)
+    , _nHits(0)
+    , _nMisses(0)
+    , _nEvictions(0)
+    , _generation(0)
+{}
+
+void ShardedTileCache::clear() {
+    std::unique_lock<std::shared_mutex> lock(_shardsMutex);
+    for (std::pair<const unsigned int, std::unique_ptr<ProviderShard>>& p : _shards) {
+        std::lock_guard<std::mutex> shardLock(p.second->mutex);
+        p.second->tiles.clear();
+        p.second->nBytes = 0;
+    }
+    _cachedBytes = 0;
+    ++_generation;
+}
+
+void ShardedTileCache::setBudget(size_t budget) {
+    _budget = budget;
+}
+
+size_t ShardedTileCache::budget() const {
+    return _budget;
+}
+
+void ShardedTileCache::setMaximumProviderShare(float share) {
+    _maximumProviderShare = share;
+}
+
+ShardedTileCache::ProviderShard* ShardedTileCache::shard(unsigned int providerID) const {
+    // Shards are never removed, so the pointer stays valid after the lock is released
+    std::shared_lock<std::shared_mutex> lock(_shardsMutex);
+    auto it = _shards.find(providerID);
+    return it != _shards.end() ? it->second.get() : nullptr;
+}
+
+ShardedTileCache::ProviderShard& ShardedTileCache::assureShardExists(
+                                                                  unsigned int providerID)
+{
+    ProviderShard* s = shard(providerID);
+    if (s) {
+        return *s;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(_shardsMutex);
+    std::unique_ptr<ProviderShard>& newShard = _shards[providerID];
+    if (!newShard) {
+        newShard = std::make_unique<ProviderShard>();
+    }
+    return *newShard;
+}
+
+bool ShardedTileCache::exist(const ProviderTileKey& key) const {
+    ProviderShard* s = shard(key.providerID);
+    if (!s) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(s->mutex);
+    return std::any_of(
+        s->tiles.cbegin(),
+        s->tiles.cend(),
+        [&](const std::pair<const TileTextureInitData::HashKey, TileCache>& p) {
+            return p.second.exist(key);
+        }
+    );
+}
+
+Tile ShardedTileCache::get(const ProviderTileKey& key) {
+    ProviderShard* s = shard(key.providerID);
+    if (s) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        for (std::pair<const TileTextureInitData::HashKey, TileCache>& p : s->tiles) {
+            if (p.second.exist(key)) {
+                ++_nHits;
+                return p.second.get(key).tile;
+            }
+        }
+    }
+    ++_nMisses;
+    return Tile::TileUnavailable;
+}
+
+void ShardedTileCache::put(const ProviderTileKey& key,
+                           TileTextureInitData::HashKey initDataKey, Tile tile,
+                           size_t nBytes)
+{
+    ProviderShard& s = assureShardExists(key.providerID);
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto it = s.tiles.find(initDataKey);
+        if (it == s.tiles.end()) {
+            it = s.tiles.emplace(
+                initDataKey,
+                TileCache(std::numeric_limits<size_t>::max())
+            ).first;
+        }
+
+        TileCache& cache = it->second;
+        if (cache.exist(key)) {
+            // The tile is replaced, so its previous size no longer counts
+            const size_t previousBytes = cache.get(key).nBytes;
+            s.nBytes -= previousBytes;
+            _cachedBytes -= previousBytes;
+        }
+        cache.put(key, { tile, initDataKey, nBytes });
+        s.nBytes += nBytes;
+        _cachedBytes += nBytes;
+    }
+    ++_generation;
+    enforceBudget(s, key);
+}
+
+Tile ShardedTileCache::evictTileOfType(TileTextureInitData::HashKey initDataKey) {
+    while (true) {
+        // Find the provider that is most above its fair share among the providers that
+        // have tiles of the requested type
+        ProviderShard* victim = nullptr;
+        {
+            std::shared_lock<std::shared_mutex> lock(_shardsMutex);
+            const size_t nProviders = static_cast<size_t>(std::count_if(
+                _shards.cbegin(),
+                _shards.cend(),
+                [](const std::pair<const unsigned int,
+                                   std::unique_ptr<ProviderShard>>& p)
+                {
+                    return p.second->nBytes > 0;
+                }
+            ));
+            const long long fairShare =
+                static_cast<long long>(_budget / std::max<size_t>(nProviders, 1));
+
+            long long largestExcess = std::numeric_limits<long long>::min();
+            for (const std::pair<const unsigned int, std::unique_ptr<ProviderShard>>& p :
+                 _shards)
+            {
+                ProviderShard& s = *p.second;
+                std::lock_guard<std::mutex> shardLock(s.mutex);
+                auto it = s.tiles.find(initDataKey);
+                if (it == s.tiles.end() || it->second.isEmpty()) {
+                    continue;
+                }
+                const long long excess = static_cast<long long>(s.nBytes) - fairShare;
+                if (excess > largestExcess) {
+                    largestExcess = excess;
+                    victim = &s;
+                }
+            }
+        }
+
+        if (!victim) {
+            return Tile::TileUnavailable;
+        }
+
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        // Another thread might have evicted the victim's last tile of this type or
+        // cleared the cache since the victim was selected; select again in that case
+        auto it = victim->tiles.find(initDataKey);
+        if (it == victim->tiles.end() || it->second.isEmpty()) {
+            continue;
+        }
+
+        CachedTile evicted = it->second.popLRU().second;
+        victim->nBytes -= evicted.nBytes;
+        _cachedBytes -= evicted.nBytes;
+        ++_nEvictions;
+        ++_generation;
+        return evicted.tile;
+    }
+}
+
+bool ShardedTileCache::evictFromShard(ProviderShard& shard,
+                                      const ProviderTileKey& keep)
+{
+    CachedTile evicted = { Tile::TileUnavailable, 0, 0 };
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        // Providers almost always use a single texture type; if there are several,
+        // evict from the one with the most tiles. The kept tile is the most recently
+        // used one of its type, so it would only be evicted if it is the only one
+        TileCache* cache = nullptr;
+        for (std::pair<const TileTextureInitData::HashKey, TileCache>& p : shard.tiles) {
+            TileCache& c = p.second;
+            if (c.isEmpty() || (c.size() == 1 && c.exist(keep))) {
+                continue;
+            }
+            if (!cache || c.size() > cache->size()) {
+                cache = &c;
+            }
+        }
+        if (!cache) {
+            return false;
+        }
+
+        evicted = cache->popLRU().second;
+        shard.nBytes -= evicted.nBytes;
+        _cachedBytes -= evicted.nBytes;
+    }
+
+    if (_onEviction) {
+        _onEviction(evicted);
+    }
+    ++_nEvictions;
+    ++_generation;
+    return true;
+}
+
+void ShardedTileCache::enforceBudget(ProviderShard& insertedInto,
+                                     const ProviderTileKey& inserted)
+{
+    // Per-provider quota; the tile that has just been inserted is never evicted
+    const size_t providerQuota = static_cast<size_t>(_budget * _maximumProviderShare);
+    while (insertedInto.nBytes > providerQuota) {
+        if (!evictFromShard(insertedInto, inserted)) {
+            break;
+        }
+    }
+
+    // Global budget; evict from the provider that is most above its fair share
+    while (_cachedBytes > _budget) {
+        ProviderShard* victim = nullptr;
+        {
+            std::shared_lock<std::shared_mutex> lock(_shardsMutex);
+            const size_t nProviders = static_cast<size_t>(std::count_if(
+                _shards.cbegin(),
+                _shards.cend(),
+                [](const std::pair<const unsigned int,
+                                   std::unique_ptr<ProviderShard>>& p)
+                {
+                    return p.second->nBytes > 0;
+                }
+            ));
+            const long long fairShare =
+                static_cast<long long>(_budget / std::max<size_t>(nProviders, 1));
+
+            long long largestExcess = std::numeric_limits<long long>::min();
+            for (const std::pair<const unsigned int, std::unique_ptr<ProviderShard>>& p :
+                 _shards)
+            {
+                const long long excess =
+                    static_cast<long long>(p.second->nBytes.load()) - fairShare;
+                if (p.second->nBytes > 0 && excess > largestExcess) {
+                    largestExcess = excess;
+                    victim = p.second.get();
+                }
+            }
+        }
+
+        if (!victim || !evictFromShard(*victim, inserted)) {
+            break;
+        }
+    }
+}
+
+size_t ShardedTileCache::cachedBytes() const {
+    return _cachedBytes;
+}
+
+size_t ShardedTileCache::cachedBytes(unsigned int providerID) const {
+    ProviderShard* s = shard(providerID);
+    return s ? s->nBytes.load() : 0;
+}
+
+long long ShardedTileCache::nHits() const {
+    return _nHits;
+}
+
+long long ShardedTileCache::nMisses() const {
+    return _nMisses;
+}
+
+long long ShardedTileCache::nEvictions() const {
+    return _nEvictions;
+}
+
+unsigned long long ShardedTileCache::generation() const {
+    return _generation;
+}
+
+void ShardedTileCache::increaseGeneration() {
+    ++_generation;
+}
+
+} // namespace openspace::globebrowsing::cache
@@ -0,0 +1,197 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___SHARDED_TILE_CACHE___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___SHARDED_TILE_CACHE___H__
+
+#include <modules/globebrowsing/cache/intrusivelrucache.h>
+#include <modules/globebrowsing/tile/tile.h>
+#include <modules/globebrowsing/tile/tileindex.h>
+#include <modules/globebrowsing/tile/tiletextureinitdata.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace openspace::globebrowsing::cache {
+
+struct ProviderTileKey {
+    TileIndex tileIndex;
+    unsigned int providerID;
+
+    bool operator==(const ProviderTileKey& r) const {
+        return (providerID == r.providerID) &&
+            (tileIndex == r.tileIndex);
+    }
+};
+
+struct ProviderTileHasher {
+    /**
+    Creates a hash which can be used as key in hash maps.
+    First set the bits to be unique for all tiles.
+    +-------+------------+-------+------------+
+    | USAGE | BIT RANGE  | #BITS | MAX VALUE  |
+    +-------+------------+-------+------------+
+    | level |   0 -  5   |   5   |         31 |
+    |     x |   5 - 35   |  30   | 1073741824 |
+    |     y |  35 - 64   |  29   |  536870912 |
+    +-------+------------+-------+------------+
+
+    Bits are then shifted depending on the tile provider used.
+    */
+    unsigned long long operator()(const ProviderTileKey& t) const {
+        unsigned long long key = 0;
+        key |= static_cast<unsigned long long>(t.tileIndex.level);
+        key |= static_cast<unsigned long long>(t.tileIndex.x) << 5ULL;
+        key |= static_cast<unsigned long long>(t.tileIndex.y) << 35ULL;
+        // Now the key is unique for all tiles, however not for all tile providers.
+        // Add to the key depending on the tile provider to avoid some hash collisions.
+        // (All hash collisions can not be avoided due to the limit in 64 bit for the
+        // hash key)
+        // Idea: make some offset in the place of the bits for the x value. Lesser chance
+        // of having different x-value than having different tile provider ids.
+        key += static_cast<unsigned long long>(t.providerID) << 25ULL;
+        return key;
+    }
+};
+
+/**
+ * Keeps track of which tiles are cached and how much memory they use. The tiles are
+ * stored in one shard per tile provider so that lookups from different layers, for
+ * example from tile-loading worker threads, do not contend with each other.
+ *
+ * The cache is limited by a byte budget. When the budget is exceeded, the least recently
+ * used tile of the provider that is furthest above its fair share of the budget is
+ * evicted, so that a single layer cannot starve the others. In addition, no single
+ * provider may use more than a fraction of the budget. The cache does not own the
+ * textures of the tiles; tiles that are evicted to meet the budget are passed to the
+ * eviction callback so that their textures can be reused.
+ */
+class ShardedTileCache {
+public:
+    struct CachedTile {
+        Tile tile;
+        TileTextureInitData::HashKey initDataKey;
+        size_t nBytes;
+    };
+
+    using EvictionCallback = std::function<void(const CachedTile&)>;
+
+    ShardedTileCache(EvictionCallback onEviction = EvictionCallback());
+
+    /// Removes all tiles without calling the eviction callback
+    void clear();
+
+    void setBudget(size_t budget);
+    size_t budget() const;
+
+    /// Sets the largest fraction of the budget that the tiles of one provider may use
+    void setMaximumProviderShare(float share);
+
+    bool exist(const ProviderTileKey& key) const;
+    Tile get(const ProviderTileKey& key);
+
+    /**
+     * Inserts the \p tile, which occupies \p nBytes, or replaces the tile that is cached
+     * for \p key. Afterwards, tiles are evicted until the budget and the share of the
+     * provider are met. The inserted tile itself is never evicted.
+     */
+    void put(const ProviderTileKey& key, TileTextureInitData::HashKey initDataKey,
+        Tile tile, size_t nBytes);
+
+    /**
+     * Removes the least recently used tile of the given texture type from the provider
+     * that is most above its fair share of the budget and returns it, so that its
+     * texture can be used for another tile. The eviction callback is not called. Returns
+     * Tile::TileUnavailable if no tile of that type is cached.
+     */
+    Tile evictTileOfType(TileTextureInitData::HashKey initDataKey);
+
+    /// Returns the number of bytes used by all cached tiles
+    size_t cachedBytes() const;
+
+    /// Returns the number of bytes used by the cached tiles of one provider
+    size_t cachedBytes(unsigned int providerID) const;
+
+    long long nHits() const;
+    long long nMisses() const;
+    long long nEvictions() const;
+
+    /**
+     * Returns a number that is increased whenever tiles are added to or removed from
+     * the cache, so that a change in which tiles are available can be detected by
+     * comparing it to a previous value.
+     */
+    unsigned long long generation() const;
+    void increaseGeneration();
+
+private:
+    using TileCache = IntrusiveLRUCache<ProviderTileKey, CachedTile, ProviderTileHasher>;
+
+    /// All tiles of one tile provider
+    struct ProviderShard {
+        mutable std::mutex mutex;
+        /// One least-recently-used list per texture type used by the provider
+        std::unordered_map<TileTextureInitData::HashKey, TileCache> tiles;
+        std::atomic<size_t> nBytes = { 0 };
+    };
+
+    ProviderShard* shard(unsigned int providerID) const;
+    ProviderShard& assureShardExists(unsigned int providerID);
+
+    /**
+     * Evicts the least recently used tile of the provider, but never the tile with the
+     * key \p keep. Returns false if there is no other tile to evict
+     */
+    bool evictFromShard(ProviderShard& shard, const ProviderTileKey& keep);
+
+    /**
+     * Evicts tiles until the budget and the per-provider quota of the provider are met,
+     * keeping the tile with the key \p inserted that has just been put into the cache
+     */
+    void enforceBudget(ProviderShard& insertedInto, const ProviderTileKey& inserted);
+
+    EvictionCallback _onEviction;
+
+    /// Guards the set of shards; the contents of each shard are guarded by its own mutex
+    mutable std::shared_mutex _shardsMutex;
+    std::unordered_map<unsigned int, std::unique_ptr<ProviderShard>> _shards;
+
+    std::atomic<size_t> _cachedBytes;
+    std::atomic<size_t> _budget;
+    std::atomic<float> _maximumProviderShare;
+
+    std::atomic<long long> _nHits;
+    std::atomic<long long> _nMisses;
+    std::atomic<long long> _nEvictions;
+
+    std::atomic<unsigned long long> _generation;
+};
+
+} // namespace openspace::globebrowsing::cache
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___SHARDED_TILE_CACHE___H__
@@ -37,6 +37,7 @@ TextureContainer::TextureContainer(TileTextureInitData initData, size_t numTextu
 
 void TextureContainer::reset() {
     _textures.clear();
+    _releasedTextures.clear();
     _freeTexture = 0;
     for (size_t i = 0; i < _numTextures; ++i) {
         auto tex = std::make_unique<ghoul::opengl::Texture>(
@@ -63,7 +64,12 @@ void TextureContainer::reset(size_t numTextures) {
 }
 
 ghoul::opengl::Texture* TextureContainer::getTextureIfFree() {
-    if (_freeTexture < _textures.size()) {
+    if (!_releasedTextures.empty()) {
+        ghoul::opengl::Texture* texture = _releasedTextures.back();
+        _releasedTextures.pop_back();
+        return texture;
+    }
+    else if (_freeTexture < _textures.size()) {
         ghoul::opengl::Texture* texture = _textures[_freeTexture].get();
         _freeTexture++;
         return texture;
@@ -73,6 +79,10 @@ ghoul::opengl::Texture* TextureContainer::getTextureIfFree() {
     }
 }
 
+void TextureContainer::release(ghoul::opengl::Texture* texture) {
+    _releasedTextures.push_back(texture);
+}
+
 const TileTextureInitData& TextureContainer::tileTextureInitData() const {
     return _initData;
 }
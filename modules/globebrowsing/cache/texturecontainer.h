@@ -56,6 +56,13 @@ public:
      */
     ghoul::opengl::Texture* getTextureIfFree();
 
+    /**
+     * Hands a texture that was previously returned by getTextureIfFree back to the
+     * container so that it can be reused. This is used when a tile is evicted from the
+     * cache without its texture being reused immediately.
+     */
+    void release(ghoul::opengl::Texture* texture);
+
     const TileTextureInitData& tileTextureInitData() const;
 
     /**
@@ -65,6 +72,7 @@ public:
 
 private:
     std::vector<std::unique_ptr<ghoul::opengl::Texture>> _textures;
+    std::vector<ghoul::opengl::Texture*> _releasedTextures;
 
     const TileTextureInitData _initData;
     size_t _freeTexture;
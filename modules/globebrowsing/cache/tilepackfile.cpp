@@ -0,0 +1,785 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/cache/tilepackfile.h>
+
+#include <modules/globebrowsing/tile/rawtile.h>
+#include <modules/globebrowsing/tile/tilemetadata.h>
+#include <modules/globebrowsing/tile/rawtiledatareader/tiledatakernels.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#ifdef WIN32
+#include <Windows.h>
+#else // WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif // WIN32
+
+namespace {
+    constexpr const char* _loggerCat = "TilePackFile";
+
+    constexpr const uint32_t PackMagic = 0x4B505453;   // 'STPK'
+    constexpr const uint32_t IndexMagic = 0x58495453;  // 'STIX'
+    constexpr const uint32_t RecordMagic = 0x43525453; // 'STRC'
+    constexpr const uint32_t CurrentVersion = 1;
+
+    // Records are padded to this alignment so that the image data of each tile starts
+    // at an aligned address in the mapped file
+    constexpr const uint64_t RecordAlignment = 16;
+
+    // When a pack file is opened and its size exceeds CompactionThreshold of the maximum
+    // size, the least recently used tiles are removed until it is below CompactionTarget
+    constexpr const double CompactionThreshold = 0.9;
+    constexpr const double CompactionTarget = 0.75;
+
+    using DatasetInfo = openspace::globebrowsing::cache::TilePackFile::DatasetInfo;
+
+    struct PackHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t initDataHashKey;
+        uint32_t hasDatasetInfo;
+        DatasetInfo datasetInfo;
+        uint32_t reserved[2];
+    };
+    static_assert(sizeof(PackHeader) == 64, "Unexpected padding in PackHeader");
+
+    struct RecordHeader {
+        uint32_t magic;
+        int32_t level;
+        int32_t x;
+        int32_t y;
+        uint64_t imageSize;
+        uint32_t metaDataSize;
+        int32_t error;
+    };
+    static_assert(sizeof(RecordHeader) == 32, "Unexpected padding in RecordHeader");
+
+    struct IndexHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t packSize;
+        uint64_t generation;
+        uint64_t nEntries;
+    };
+    static_assert(sizeof(IndexHeader) == 32, "Unexpected padding in IndexHeader");
+
+    struct IndexEntry {
+        uint64_t key;
+        uint64_t offset;
+        uint64_t size;
+        uint64_t lastUsed;
+    };
+
+    PackHeader createPackHeader(uint64_t initDataHashKey, bool hasDatasetInfo,
+                                const DatasetInfo& info)
+    {
+        PackHeader header = {};
+        header.magic = PackMagic;
+        header.version = CurrentVersion;
+        header.initDataHashKey = initDataHashKey;
+        header.hasDatasetInfo = hasDatasetInfo ? 1 : 0;
+        header.datasetInfo = info;
+        return header;
+    }
+
+    uint64_t recordSize(uint64_t imageSize, uint64_t metaDataSize) {
+        uint64_t size = sizeof(RecordHeader) + imageSize + metaDataSize;
+        return (size + RecordAlignment - 1) / RecordAlignment * RecordAlignment;
+    }
+} // namespace
+
+namespace openspace::globebrowsing::cache {
+
+TilePackFile::Entry::Entry(uint64_t o, uint64_t s, uint64_t l)
+    : offset(o)
+    , size(s)
+    , lastUsed(l)
+{}
+
+TilePackFile::TilePackFile(std::string path, const TileTextureInitData& initData,
+                           size_t maximumSize, ReadOnly readOnly)
+    : _path(std::move(path))
+    , _indexPath(_path + ".index")
+    , _initData(initData)
+    , _maximumSize(maximumSize)
+    , _readOnly(readOnly)
+    , _hasDatasetInfo(false)
+    , _datasetInfo({ 0.f, 0.f, 1.f, 0.f, 1.f, 0, 0, 0, 0 })
+    , _packSize(0)
+    , _generation(0)
+    , _mappedData(nullptr)
+    , _mappedSize(0)
+    , _tailData(nullptr)
+    , _tailOffset(0)
+    , _tailSize(0)
+{
+    bool isComplete = true;
+    if (readHeader()) {
+        if (!readIndex()) {
+            LINFO(fmt::format("Rebuilding index of tile pack file '{}'", _path));
+            isComplete = scanPackFile();
+        }
+    }
+    else {
+        if (_readOnly == ReadOnly::Yes) {
+            throw ghoul::RuntimeError(
+                fmt::format("Tile pack file '{}' is missing or incompatible", _path),
+                "TilePackFile"
+            );
+        }
+        writeHeader();
+    }
+    ++_generation;
+
+    if (_readOnly == ReadOnly::No) {
+        if (_packSize > CompactionThreshold * _maximumSize) {
+            compact(static_cast<size_t>(CompactionTarget * _maximumSize));
+        }
+        else if (!isComplete) {
+            // The last session did not finish writing its last tile. Rewriting the pack
+            // file removes the incomplete record at the end
+            compact(_maximumSize);
+        }
+
+        _writeStream.open(_path, std::ofstream::binary | std::ofstream::app);
+        if (!_writeStream.good()) {
+            throw ghoul::RuntimeError(
+                fmt::format("Could not open tile pack file '{}' for writing", _path),
+                "TilePackFile"
+            );
+        }
+    }
+
+    map();
+    LDEBUG(fmt::format(
+        "Opened tile pack file '{}' with {} tiles ({} bytes)",
+        _path, _entries.size(), _packSize
+    ));
+}
+
+TilePackFile::~TilePackFile() {
+    if (_readOnly == ReadOnly::No) {
+        saveIndex();
+    }
+    unmap();
+}
+
+bool TilePackFile::exist(const TileIndex& tileIndex) const {
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    return _entries.find(tileIndex.hashKey()) != _entries.end();
+}
+
+std::shared_ptr<RawTile> TilePackFile::readTile(const TileIndex& tileIndex,
+                                                char* dataDestination,
+                                                char* pboMappedDataDestination)
+{
+    ghoul_assert(
+        dataDestination || pboMappedDataDestination,
+        "Need to specify a data destination"
+    );
+
+    const TileIndex::TileHashKey key = tileIndex.hashKey();
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        auto it = _entries.find(key);
+        if (it == _entries.end()) {
+            return nullptr;
+        }
+        Entry& entry = it->second;
+        if (mappedRecord(entry)) {
+            entry.lastUsed.store(_generation, std::memory_order_relaxed);
+            return readRecord(
+                tileIndex,
+                entry,
+                dataDestination,
+                pboMappedDataDestination
+            );
+        }
+    }
+
+    // The tile was written after the pack file was mapped the last time
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    auto it = _entries.find(key);
+    if (it == _entries.end()) {
+        return nullptr;
+    }
+    Entry& entry = it->second;
+    if (!mappedRecord(entry)) {
+        // Only the records appended since the pack file was mapped are mapped, until
+        // they take up as much space as the rest of the file. That way the whole file is
+        // only remapped each time its size has doubled
+        if (_mappedData && _packSize - _mappedSize < _mappedSize) {
+            mapTail();
+        }
+        else {
+            unmap();
+            map();
+        }
+        if (!mappedRecord(entry)) {
+            return nullptr;
+        }
+    }
+    entry.lastUsed.store(_generation, std::memory_order_relaxed);
+    return readRecord(tileIndex, entry, dataDestination, pboMappedDataDestination);
+}
+
+bool TilePackFile::writeTile(const RawTile& rawTile, const char* imageData) {
+    ghoul_assert(imageData, "Image data must exist");
+
+    if (_readOnly == ReadOnly::Yes) {
+        return false;
+    }
+
+    std::string metaData;
+    if (rawTile.tileMetaData) {
+        std::ostringstream stream;
+        rawTile.tileMetaData->serialize(stream);
+        metaData = stream.str();
+    }
+
+    RecordHeader header;
+    header.magic = RecordMagic;
+    header.level = rawTile.tileIndex.level;
+    header.x = rawTile.tileIndex.x;
+    header.y = rawTile.tileIndex.y;
+    header.imageSize = _initData.totalNumBytes();
+    header.metaDataSize = static_cast<uint32_t>(metaData.size());
+    header.error = static_cast<int32_t>(rawTile.error);
+
+    const uint64_t size = recordSize(header.imageSize, header.metaDataSize);
+    const uint64_t padding =
+        size - sizeof(RecordHeader) - header.imageSize - header.metaDataSize;
+    const char zeros[RecordAlignment] = {};
+
+    const TileIndex::TileHashKey key = rawTile.tileIndex.hashKey();
+
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    if (!_writeStream.is_open() || _entries.find(key) != _entries.end() ||
+        _packSize + size > _maximumSize)
+    {
+        return false;
+    }
+
+    _writeStream.write(reinterpret_cast<const char*>(&header), sizeof(RecordHeader));
+    _writeStream.write(imageData, header.imageSize);
+    _writeStream.write(metaData.data(), metaData.size());
+    _writeStream.write(zeros, padding);
+    // Flushing makes the record visible to the memory mapping the next time it is
+    // remapped
+    _writeStream.flush();
+
+    if (!_writeStream.good()) {
+        // Any incomplete record is removed when the pack file is opened the next time
+        LWARNING(fmt::format(
+            "Error writing to tile pack file '{}'. Disabling writing", _path
+        ));
+        _writeStream.close();
+        return false;
+    }
+
+    _entries.try_emplace(key, _packSize, size, _generation);
+    _packSize += size;
+    return true;
+}
+
+void TilePackFile::saveIndex() {
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+
+    std::ofstream file(_indexPath, std::ofstream::binary | std::ofstream::trunc);
+    if (!file.good()) {
+        LWARNING(fmt::format("Could not write tile pack index '{}'", _indexPath));
+        return;
+    }
+
+    IndexHeader header;
+    header.magic = IndexMagic;
+    header.version = CurrentVersion;
+    header.packSize = _packSize;
+    header.generation = _generation;
+    header.nEntries = _entries.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(IndexHeader));
+
+    std::vector<IndexEntry> entries;
+    entries.reserve(_entries.size());
+    for (const std::pair<const TileIndex::TileHashKey, Entry>& p : _entries) {
+        entries.push_back({
+            p.first,
+            p.second.offset,
+            p.second.size,
+            p.second.lastUsed.load(std::memory_order_relaxed)
+        });
+    }
+    file.write(
+        reinterpret_cast<const char*>(entries.data()),
+        entries.size() * sizeof(IndexEntry)
+    );
+}
+
+void TilePackFile::setDatasetInfo(const DatasetInfo& datasetInfo) {
+    ghoul_assert(_readOnly == ReadOnly::No, "Pack file must be writable");
+
+    std::unique_lock<std::shared_mutex> lock(_mutex);
+    _hasDatasetInfo = true;
+    _datasetInfo = datasetInfo;
+
+    // The header is the only part of the pack file that is ever overwritten
+    std::fstream file(_path, std::fstream::binary | std::fstream::in | std::fstream::out);
+    PackHeader header = createPackHeader(_initData.hashKey(), true, _datasetInfo);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(PackHeader));
+    if (!file.good()) {
+        LWARNING(fmt::format("Could not write header of tile pack file '{}'", _path));
+    }
+}
+
+bool TilePackFile::hasDatasetInfo() const {
+    return _hasDatasetInfo;
+}
+
+const TilePackFile::DatasetInfo& TilePackFile::datasetInfo() const {
+    return _datasetInfo;
+}
+
+const std::string& TilePackFile::path() const {
+    return _path;
+}
+
+const TileTextureInitData& TilePackFile::tileTextureInitData() const {
+    return _initData;
+}
+
+size_t TilePackFile::numTiles() const {
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    return _entries.size();
+}
+
+size_t TilePackFile::size() const {
+    std::shared_lock<std::shared_mutex> lock(_mutex);
+    return static_cast<size_t>(_packSize);
+}
+
+size_t TilePackFile::maximumSize() const {
+    return _maximumSize;
+}
+
+bool TilePackFile::readHeader() {
+    std::ifstream file(_path, std::ifstream::binary | std::ifstream::ate);
+    if (!file.good()) {
+        return false;
+    }
+    const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    if (fileSize < sizeof(PackHeader)) {
+        return false;
+    }
+
+    file.seekg(0);
+    PackHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(PackHeader));
+    if (!file.good() || header.magic != PackMagic || header.version != CurrentVersion) {
+        LWARNING(fmt::format("Discarding corrupt tile pack file '{}'", _path));
+        return false;
+    }
+    if (header.initDataHashKey != _initData.hashKey()) {
+        LINFO(fmt::format(
+            "Discarding tile pack file '{}' created with different tile settings", _path
+        ));
+        return false;
+    }
+
+    _hasDatasetInfo = (header.hasDatasetInfo != 0);
+    if (_hasDatasetInfo) {
+        _datasetInfo = header.datasetInfo;
+    }
+    _packSize = fileSize;
+    return true;
+}
+
+void TilePackFile::writeHeader() {
+    std::ofstream file(_path, std::ofstream::binary | std::ofstream::trunc);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Could not create tile pack file '{}'", _path),
+            "TilePackFile"
+        );
+    }
+    PackHeader header = createPackHeader(
+        _initData.hashKey(),
+        _hasDatasetInfo,
+        _datasetInfo
+    );
+    file.write(reinterpret_cast<const char*>(&header), sizeof(PackHeader));
+
+    _entries.clear();
+    _packSize = sizeof(PackHeader);
+    std::remove(_indexPath.c_str());
+}
+
+bool TilePackFile::readIndex() {
+    std::ifstream file(_indexPath, std::ifstream::binary | std::ifstream::ate);
+    if (!file.good()) {
+        return false;
+    }
+    const uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    if (fileSize < sizeof(IndexHeader)) {
+        return false;
+    }
+
+    file.seekg(0);
+    IndexHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(IndexHeader));
+    if (!file.good() || header.magic != IndexMagic ||
+        header.version != CurrentVersion || header.packSize != _packSize)
+    {
+        // The pack file was modified without updating the index, for example if the
+        // application crashed
+        return false;
+    }
+    if (header.nEntries > (fileSize - sizeof(IndexHeader)) / sizeof(IndexEntry)) {
+        // A corrupt entry count must not be used to size the allocation below
+        return false;
+    }
+
+    std::vector<IndexEntry> entries(header.nEntries);
+    file.read(
+        reinterpret_cast<char*>(entries.data()),
+        entries.size() * sizeof(IndexEntry)
+    );
+    if (!file.good()) {
+        return false;
+    }
+
+    _entries.clear();
+    _entries.reserve(entries.size());
+    for (const IndexEntry& e : entries) {
+        if (e.offset < sizeof(PackHeader) || e.offset + e.size > _packSize) {
+            _entries.clear();
+            return false;
+        }
+        _entries.try_emplace(e.key, e.offset, e.size, e.lastUsed);
+    }
+    _generation = header.generation;
+    return true;
+}
+
+bool TilePackFile::scanPackFile() {
+    std::ifstream file(_path, std::ifstream::binary);
+
+    _entries.clear();
+    uint64_t offset = sizeof(PackHeader);
+    while (offset + sizeof(RecordHeader) <= _packSize) {
+        RecordHeader header;
+        file.seekg(offset);
+        file.read(reinterpret_cast<char*>(&header), sizeof(RecordHeader));
+        if (!file.good() || header.magic != RecordMagic ||
+            header.imageSize != _initData.totalNumBytes())
+        {
+            break;
+        }
+
+        const uint64_t size = recordSize(header.imageSize, header.metaDataSize);
+        if (offset + size > _packSize) {
+            break;
+        }
+
+        const TileIndex tileIndex(header.x, header.y, header.level);
+        _entries.try_emplace(tileIndex.hashKey(), offset, size, 0);
+        offset += size;
+    }
+
+    const bool isComplete = (offset == _packSize);
+    _packSize = offset;
+    return isComplete;
+}
+
+void TilePackFile::compact(size_t targetSize) {
+    using EntryRef = std::pair<TileIndex::TileHashKey, const Entry*>;
+    std::vector<EntryRef> entries;
+    entries.reserve(_entries.size());
+    for (const std::pair<const TileIndex::TileHashKey, Entry>& p : _entries) {
+        entries.emplace_back(p.first, &p.second);
+    }
+    // Most recently used first; ties are broken by the position in the file to keep the
+    // records in the order they were written
+    std::sort(
+        entries.begin(),
+        entries.end(),
+        [](const EntryRef& a, const EntryRef& b) {
+            const uint64_t lastUsedA = a.second->lastUsed.load(std::memory_order_relaxed);
+            const uint64_t lastUsedB = b.second->lastUsed.load(std::memory_order_relaxed);
+            if (lastUsedA != lastUsedB) {
+                return lastUsedA > lastUsedB;
+            }
+            return a.second->offset < b.second->offset;
+        }
+    );
+
+    const std::string tmpPath = _path + ".tmp";
+    std::ifstream in(_path, std::ifstream::binary);
+    std::ofstream out(tmpPath, std::ofstream::binary | std::ofstream::trunc);
+    if (!in.good() || !out.good()) {
+        LWARNING(fmt::format("Could not compact tile pack file '{}'", _path));
+        return;
+    }
+
+    PackHeader header = createPackHeader(
+        _initData.hashKey(),
+        _hasDatasetInfo,
+        _datasetInfo
+    );
+    out.write(reinterpret_cast<const char*>(&header), sizeof(PackHeader));
+
+    std::unordered_map<TileIndex::TileHashKey, Entry> compacted;
+    uint64_t offset = sizeof(PackHeader);
+    std::vector<char> buffer;
+    for (const EntryRef& e : entries) {
+        const Entry& entry = *e.second;
+        if (offset + entry.size > targetSize) {
+            continue;
+        }
+        buffer.resize(entry.size);
+        in.seekg(entry.offset);
+        in.read(buffer.data(), entry.size);
+        out.write(buffer.data(), entry.size);
+        compacted.try_emplace(
+            e.first,
+            offset,
+            entry.size,
+            entry.lastUsed.load(std::memory_order_relaxed)
+        );
+        offset += entry.size;
+    }
+    in.close();
+    out.close();
+
+    if (!out.good()) {
+        LWARNING(fmt::format("Could not compact tile pack file '{}'", _path));
+        std::remove(tmpPath.c_str());
+        return;
+    }
+
+    // std::rename does not replace existing files on all platforms
+    std::remove(_path.c_str());
+    if (std::rename(tmpPath.c_str(), _path.c_str()) != 0) {
+        throw ghoul::RuntimeError(
+            fmt::format("Could not replace tile pack file '{}'", _path),
+            "TilePackFile"
+        );
+    }
+    std::remove(_indexPath.c_str());
+
+    LINFO(fmt::format(
+        "Compacted tile pack file '{}' from {} to {} tiles",
+        _path, _entries.size(), compacted.size()
+    ));
+    _entries.swap(compacted);
+    _packSize = offset;
+}
+
+void TilePackFile::map() {
+    ghoul_assert(!_mappedData && !_tailData, "Pack file must not be mapped");
+
+    // Records are only ever appended, so everything up to the current size consists of
+    // complete records
+    _mappedData = mapRegion(0, static_cast<size_t>(_packSize));
+    _mappedSize = _mappedData ? static_cast<size_t>(_packSize) : 0;
+}
+
+void TilePackFile::mapTail() {
+    ghoul_assert(_mappedData, "Pack file must be mapped");
+
+    unmapRegion(_tailData, _tailSize);
+    // The offset of a mapping has to be aligned, so the tail overlaps the last page of
+    // the main mapping
+#ifdef WIN32
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    const uint64_t alignment = systemInfo.dwAllocationGranularity;
+#else // WIN32
+    const uint64_t alignment = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif // WIN32
+    _tailOffset = _mappedSize / alignment * alignment;
+    _tailSize = static_cast<size_t>(_packSize - _tailOffset);
+    _tailData = mapRegion(_tailOffset, _tailSize);
+    if (!_tailData) {
+        _tailOffset = 0;
+        _tailSize = 0;
+    }
+}
+
+void TilePackFile::unmap() {
+    unmapRegion(_mappedData, _mappedSize);
+    _mappedData = nullptr;
+    _mappedSize = 0;
+    unmapRegion(_tailData, _tailSize);
+    _tailData = nullptr;
+    _tailOffset = 0;
+    _tailSize = 0;
+}
+
+const char* TilePackFile::mapRegion(uint64_t offset, size_t size) const {
+    if (size == 0) {
+        return nullptr;
+    }
+
+#ifdef WIN32
+    HANDLE file = CreateFileA(
+        _path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        LWARNING(fmt::format("Could not open tile pack file '{}'", _path));
+        return nullptr;
+    }
+    const char* data = nullptr;
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping) {
+        // The view keeps a reference to the mapping, so the handles can be closed
+        data = static_cast<const char*>(MapViewOfFile(
+            mapping,
+            FILE_MAP_READ,
+            static_cast<DWORD>(offset >> 32),
+            static_cast<DWORD>(offset & 0xFFFFFFFF),
+            size
+        ));
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+    if (!data) {
+        LWARNING(fmt::format("Could not map tile pack file '{}'", _path));
+        return nullptr;
+    }
+    return data;
+#else // WIN32
+    int fd = open(_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LWARNING(fmt::format("Could not open tile pack file '{}'", _path));
+        return nullptr;
+    }
+    // The mapping stays valid after the file descriptor is closed
+    void* data = mmap(
+        nullptr,
+        size,
+        PROT_READ,
+        MAP_SHARED,
+        fd,
+        static_cast<off_t>(offset)
+    );
+    close(fd);
+    if (data == MAP_FAILED) {
+        LWARNING(fmt::format("Could not map tile pack file '{}'", _path));
+        return nullptr;
+    }
+    madvise(data, size, MADV_RANDOM);
+    return static_cast<const char*>(data);
+#endif // WIN32
+}
+
+void TilePackFile::unmapRegion(const char* data, [[ maybe_unused ]] size_t size) {
+    if (!data) {
+        return;
+    }
+#ifdef WIN32
+    UnmapViewOfFile(data);
+#else // WIN32
+    munmap(const_cast<char*>(data), size);
+#endif // WIN32
+}
+
+const char* TilePackFile::mappedRecord(const Entry& entry) const {
+    const uint64_t end = entry.offset + entry.size;
+    if (_mappedData && end <= _mappedSize) {
+        return _mappedData + entry.offset;
+    }
+    if (_tailData && entry.offset >= _tailOffset && end <= _tailOffset + _tailSize) {
+        return _tailData + (entry.offset - _tailOffset);
+    }
+    return nullptr;
+}
+
+std::shared_ptr<RawTile> TilePackFile::readRecord(const TileIndex& tileIndex,
+                                                  const Entry& entry,
+                                                  char* dataDestination,
+                                                  char* pboMappedDataDestination) const
+{
+    const char* record = mappedRecord(entry);
+
+    RecordHeader header;
+    std::memcpy(&header, record, sizeof(RecordHeader));
+    if (header.magic != RecordMagic || header.level != tileIndex.level ||
+        header.x != tileIndex.x || header.y != tileIndex.y ||
+        header.imageSize != _initData.totalNumBytes())
+    {
+        LWARNING(fmt::format(
+            "Corrupt record for tile {} in tile pack file '{}'",
+            tileIndex.toString(), _path
+        ));
+        return nullptr;
+    }
+
+    const char* imageData = record + sizeof(RecordHeader);
+    if (dataDestination) {
+        std::memcpy(dataDestination, imageData, header.imageSize);
+    }
+    if (pboMappedDataDestination) {
+        tiledatakernels::copyToMappedBuffer(
+            pboMappedDataDestination,
+            imageData,
+            header.imageSize
+        );
+    }
+
+    std::shared_ptr<RawTile> rawTile = std::make_shared<RawTile>();
+    rawTile->imageData = dataDestination;
+    rawTile->error = static_cast<RawTile::ReadError>(header.error);
+    rawTile->tileIndex = tileIndex;
+    rawTile->textureInitData = std::make_shared<TileTextureInitData>(_initData);
+
+    if (header.metaDataSize > 0) {
+        std::istringstream stream(
+            std::string(imageData + header.imageSize, header.metaDataSize)
+        );
+        rawTile->tileMetaData = std::make_shared<TileMetaData>(
+            TileMetaData::deserialize(stream)
+        );
+    }
+    return rawTile;
+}
+
+} // namespace openspace::globebrowsing::cache
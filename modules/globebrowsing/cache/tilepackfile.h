@@ -0,0 +1,215 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___TILE_PACK_FILE___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___TILE_PACK_FILE___H__
+
+#include <modules/globebrowsing/tile/tileindex.h>
+#include <modules/globebrowsing/tile/tiletextureinitdata.h>
+
+#include <ghoul/misc/boolean.h>
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace openspace::globebrowsing {
+    struct RawTile;
+} // namespace openspace::globebrowsing
+
+namespace openspace::globebrowsing::cache {
+
+/**
+ * A persistent, second level cache for <code>RawTile</code>s of a single tile provider.
+ * The tiles are stored in an append-only pack file in which every record consists of a
+ * small header, the image data as it would be uploaded to the GPU and the serialized
+ * <code>TileMetaData</code>. The pack file is memory mapped for reading. The location of
+ * each record is kept in a separate index file which is written when the pack file is
+ * closed and rebuilt from the pack file if it is missing or out of date.
+ *
+ * Each time a pack file is opened, a new generation is started and every tile that is
+ * read or written is stamped with it. The pack file never grows beyond the maximum size;
+ * once it gets close to it, the tiles that were used least recently are removed the next
+ * time the file is opened.
+ *
+ * All tiles in a pack file share the same <code>TileTextureInitData</code>; a pack file
+ * that was written with different texture settings is discarded when it is opened.
+ * Pack files can also be created offline (see <code>TilePyramidBakeTask</code>), in
+ * which case the properties of the dataset are stored in the header as well so that the
+ * tiles can be served by a <code>TilePackRawTileDataReader</code>.
+ */
+class TilePackFile {
+public:
+    BooleanType(ReadOnly);
+
+    /**
+     * The properties of the dataset the tiles were read from, as reported by its
+     * <code>RawTileDataReader</code>.
+     */
+    struct DatasetInfo {
+        float noDataValue;
+        float depthOffset;
+        float depthScale;
+        float depthTransformOffset;
+        float depthTransformScale;
+        int32_t rasterXSize;
+        int32_t rasterYSize;
+        int32_t nRasters;
+        int32_t maxChunkLevel;
+    };
+
+    /**
+     * Opens the pack file at \p path or creates a new one if it does not exist or is not
+     * compatible with \p initData.
+     *
+     * \param path The path to the pack file. The index is stored next to it
+     * \param initData The texture settings that all tiles in the pack file share
+     * \param maximumSize The maximum size of the pack file in bytes
+     * \param readOnly If <code>ReadOnly::Yes</code>, the pack file will never be modified
+     *
+     * \throw ghoul::RuntimeError If the pack file could not be opened or created, or if
+     *        it is opened read-only and is not compatible with \p initData
+     */
+    TilePackFile(std::string path, const TileTextureInitData& initData,
+        size_t maximumSize, ReadOnly readOnly = ReadOnly::No);
+
+    /**
+     * Saves the index of the pack file unless it was opened read-only.
+     */
+    ~TilePackFile();
+
+    /**
+     * \returns <code>true</code> if the tile with index \p tileIndex is stored
+     */
+    bool exist(const TileIndex& tileIndex) const;
+
+    /**
+     * Reads the tile with index \p tileIndex into \p dataDestination and
+     * \p pboMappedDataDestination, of which at least one has to be specified. The
+     * returned <code>RawTile</code> has the same layout as the ones created by the
+     * <code>RawTileDataReader</code>, with <code>imageData</code> pointing to
+     * \p dataDestination.
+     *
+     * \returns The tile or <code>nullptr</code> if it is not stored in the pack file
+     */
+    std::shared_ptr<RawTile> readTile(const TileIndex& tileIndex, char* dataDestination,
+        char* pboMappedDataDestination);
+
+    /**
+     * Appends \p rawTile to the pack file, reading its image data from \p imageData. The
+     * tile is not written if the pack file is read-only, the tile is already stored or
+     * the maximum size would be exceeded.
+     *
+     * \returns <code>true</code> if the tile was written
+     */
+    bool writeTile(const RawTile& rawTile, const char* imageData);
+
+    /**
+     * Writes the index file so that the next session does not need to scan the pack
+     * file.
+     */
+    void saveIndex();
+
+    /**
+     * Stores \p datasetInfo in the header of the pack file.
+     */
+    void setDatasetInfo(const DatasetInfo& datasetInfo);
+
+    /**
+     * \returns <code>true</code> if the header contains information about the dataset
+     */
+    bool hasDatasetInfo() const;
+    const DatasetInfo& datasetInfo() const;
+
+    const std::string& path() const;
+    const TileTextureInitData& tileTextureInitData() const;
+    size_t numTiles() const;
+    size_t size() const;
+    size_t maximumSize() const;
+
+private:
+    struct Entry {
+        Entry(uint64_t o, uint64_t s, uint64_t l);
+
+        uint64_t offset;
+        uint64_t size;
+        std::atomic<uint64_t> lastUsed;
+    };
+
+    bool readHeader();
+    void writeHeader();
+    bool readIndex();
+    bool scanPackFile();
+    void compact(size_t targetSize);
+
+    /// Maps the records in the pack file
+    void map();
+
+    /// Maps the records that were written after the last call to <code>map</code>
+    void mapTail();
+
+    void unmap();
+
+    /// Maps \p size bytes of the pack file, starting at the aligned \p offset
+    const char* mapRegion(uint64_t offset, size_t size) const;
+    static void unmapRegion(const char* data, size_t size);
+
+    /// Returns the mapped record of \p entry or <code>nullptr</code> if it is not mapped
+    const char* mappedRecord(const Entry& entry) const;
+
+    std::shared_ptr<RawTile> readRecord(const TileIndex& tileIndex, const Entry& entry,
+        char* dataDestination, char* pboMappedDataDestination) const;
+
+    const std::string _path;
+    const std::string _indexPath;
+    const TileTextureInitData _initData;
+    const size_t _maximumSize;
+    const ReadOnly _readOnly;
+
+    bool _hasDatasetInfo;
+    DatasetInfo _datasetInfo;
+
+    std::unordered_map<TileIndex::TileHashKey, Entry> _entries;
+    uint64_t _packSize;
+    uint64_t _generation;
+
+    std::ofstream _writeStream;
+    const char* _mappedData;
+    size_t _mappedSize;
+    // Records that were appended after the pack file was mapped are mapped separately
+    // so that the whole file does not have to be remapped for every new tile
+    const char* _tailData;
+    uint64_t _tailOffset;
+    size_t _tailSize;
+    mutable std::shared_mutex _mutex;
+};
+
+} // namespace openspace::globebrowsing::cache
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___TILE_PACK_FILE___H__
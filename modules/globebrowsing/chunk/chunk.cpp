@@ -30,15 +30,20 @@
 #include <modules/globebrowsing/rendering/layer/layermanager.h>
 #include <modules/globebrowsing/tile/tileselector.h>
 #include <modules/globebrowsing/tile/tilemetadata.h>
+#include <modules/globebrowsing/tile/tileloadpriority.h>
 
 #include <openspace/util/updatestructures.h>
 
+#include <mutex>
+
 namespace openspace::globebrowsing {
 
 Chunk::Chunk(const RenderableGlobe& owner, const TileIndex& tileIndex, bool initVisible)
     : _owner(owner)
     , _tileIndex(tileIndex)
     , _isVisible(initVisible)
+    , _tileLoadPriority(0.f)
+    , _boundingHeights({ 0.f, 0.f, false })
     , _surfacePatch(tileIndex)
 {}
 
@@ -58,25 +63,32 @@ bool Chunk::isVisible() const {
     return _isVisible;
 }
 
+float Chunk::tileLoadPriority() const {
+    return _tileLoadPriority;
+}
+
 Chunk::Status Chunk::update(const RenderData& data) {
-    const auto& savedCamera = _owner.savedCamera();
-    const Camera& camRef = savedCamera != nullptr ? *savedCamera : data.camera;
-    RenderData myRenderData = {
-        camRef,
-        data.position,
-        data.time,
-        data.doPerformanceMeasurement,
-        data.renderBinMask,
-        data.modelTransform
-    };
+    const ChunkedLodGlobe& chunkedLodGlobe = *_owner.chunkedLodGlobe();
+
+    // Tiles requested while evaluating this chunk get the priority it had last update
+    TileLoadPriorityScope priorityScope(_tileLoadPriority);
+
+    {
+        // The culling and all chunk level evaluators use the bounding heights, so they
+        // are only looked up once in the tile providers
+        std::lock_guard<std::mutex> lock(chunkedLodGlobe.tileProviderMutex());
+        _boundingHeights = calculateBoundingHeights();
+    }
 
     _isVisible = true;
-    if (_owner.chunkedLodGlobe()->testIfCullable(*this, myRenderData)) {
+    if (chunkedLodGlobe.testIfCullable(*this, data)) {
         _isVisible = false;
+        _tileLoadPriority = 0.f;
         return Status::WantMerge;
     }
 
-    int desiredLevel = _owner.chunkedLodGlobe()->getDesiredLevel(*this, myRenderData);
+    _tileLoadPriority = chunkedLodGlobe.getTileLoadPriority(*this, data);
+    int desiredLevel = chunkedLodGlobe.getDesiredLevel(*this, data);
 
     if (desiredLevel < _tileIndex.level) {
         return Status::WantMerge;
@@ -90,6 +102,10 @@ Chunk::Status Chunk::update(const RenderData& data) {
 }
 
 Chunk::BoundingHeights Chunk::boundingHeights() const {
+    return _boundingHeights;
+}
+
+Chunk::BoundingHeights Chunk::calculateBoundingHeights() const {
     using ChunkTileSettingsPair = std::pair<ChunkTile, const LayerRenderSettings*>;
 
     BoundingHeights boundingHeights {
@@ -82,7 +82,15 @@ public:
     bool isVisible() const;
 
     /**
-     * Returns BoundingHeights that fits the Chunk as tightly as possible.
+     * Returns the priority of loading the tiles of this Chunk, as computed in the last
+     * call to <code>update</code>. Chunks with a larger projected area have a higher
+     * priority and culled chunks have the lowest priority.
+     */
+    float tileLoadPriority() const;
+
+    /**
+     * Returns BoundingHeights that fits the Chunk as tightly as possible, as computed in
+     * the last call to <code>update</code>.
      *
      * If the Chunk uses more than one HightLayer, the BoundingHeights will be set
      * to cover all HeightLayers. If the Chunk has a higher level than its highest
@@ -93,9 +101,13 @@ public:
     BoundingHeights boundingHeights() const;
 
 private:
+    BoundingHeights calculateBoundingHeights() const;
+
     const RenderableGlobe& _owner;
     const TileIndex _tileIndex;
     bool _isVisible;
+    float _tileLoadPriority;
+    BoundingHeights _boundingHeights;
     const GeodeticPatch _surfacePatch;
 };
 
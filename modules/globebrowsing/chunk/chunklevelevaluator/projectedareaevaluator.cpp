@@ -34,6 +34,13 @@
 namespace openspace::globebrowsing::chunklevelevaluator {
 
 int ProjectedArea::getDesiredLevel(const Chunk& chunk, const RenderData& data) const {
+    const RenderableGlobe& globe = chunk.owner();
+    double scaledArea =
+        globe.generalProperties().lodScaleFactor * projectedArea(chunk, data);
+    return chunk.tileIndex().level + static_cast<int>(round(scaledArea - 1));
+}
+
+double ProjectedArea::projectedArea(const Chunk& chunk, const RenderData& data) const {
     // Calculations are done in the reference frame of the globe
     // (model space). Hence, the camera position needs to be transformed
     // with the inverse model matrix
@@ -117,10 +124,7 @@ int ProjectedArea::getDesiredLevel(const Chunk& chunk, const RenderData& data) c
     const glm::dvec3 AC = C - A;
     double areaABC = 0.5 * glm::length(glm::cross(AC, AB));
     double projectedChunkAreaApprox = 8 * areaABC;
-
-    double scaledArea =
-        globe.generalProperties().lodScaleFactor * projectedChunkAreaApprox;
-    return chunk.tileIndex().level + static_cast<int>(round(scaledArea - 1));
+    return projectedChunkAreaApprox;
 }
 
 } // namespace openspace::globebrowsing::chunklevelevaluator
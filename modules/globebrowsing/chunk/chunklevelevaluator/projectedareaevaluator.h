@@ -40,6 +40,12 @@ class ProjectedArea : public Evaluator {
 public:
     virtual int getDesiredLevel(
         const Chunk& chunk, const RenderData& data) const override;
+
+    /**
+     * Returns the approximate area of the chunk projected on the unit sphere centered in
+     * the position of the camera.
+     */
+    double projectedArea(const Chunk& chunk, const RenderData& data) const;
 };
 
 } // namespace openspace::globebrowsing::chunklevelevaluator
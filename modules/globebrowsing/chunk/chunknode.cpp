@@ -35,6 +35,8 @@ ChunkNode::ChunkNode(const Chunk& chunk, ChunkNode* parent)
     : _parent(parent)
     , _children({ {nullptr, nullptr, nullptr, nullptr} })
     , _chunk(chunk)
+    , _wantsMerge(false)
+    , _isSettled(false)
 {}
 
 bool ChunkNode::isRoot() const {
@@ -45,31 +47,80 @@ bool ChunkNode::isLeaf() const {
     return _children[0] == nullptr;
 }
 
-bool ChunkNode::updateChunkTree(const RenderData& data) {
+bool ChunkNode::updateChunkTree(const RenderData& data, bool skipSettledSubtrees,
+                                UpdateStatistics& statistics)
+{
+    if (skipSettledSubtrees && _isSettled) {
+        ++statistics.nSkippedSubtrees;
+        return _wantsMerge;
+    }
+
     if (isLeaf()) {
+        ++statistics.nUpdatedNodes;
         Chunk::Status status = _chunk.update(data);
         if (status == Chunk::Status::WantSplit) {
             split();
         }
-        return status == Chunk::Status::WantMerge;
+        _wantsMerge = status == Chunk::Status::WantMerge;
+        _isSettled = status != Chunk::Status::WantSplit;
+        return _wantsMerge;
     }
     else {
-        char requestedMergeMask = 0;
         for (int i = 0; i < 4; ++i) {
-            if (_children[i]->updateChunkTree(data)) {
-                requestedMergeMask |= (1 << i);
-            }
+            _children[i]->updateChunkTree(data, skipSettledSubtrees, statistics);
         }
+        updateChunk(data, statistics);
+        return false;
+    }
+}
 
-        bool allChildrenWantsMerge = requestedMergeMask == 0xf;
-        bool thisChunkWantsSplit = _chunk.update(data) == Chunk::Status::WantSplit;
+void ChunkNode::collectSubtrees(int depth, bool skipSettledSubtrees,
+                                std::vector<ChunkNode*>& subtrees,
+                                std::vector<ChunkNode*>& parents,
+                                UpdateStatistics& statistics)
+{
+    if (skipSettledSubtrees && _isSettled) {
+        ++statistics.nSkippedSubtrees;
+        return;
+    }
 
-        if (allChildrenWantsMerge && !thisChunkWantsSplit) {
-            merge();
+    if (depth == 0 || isLeaf()) {
+        subtrees.push_back(this);
+    }
+    else {
+        for (int i = 0; i < 4; ++i) {
+            _children[i]->collectSubtrees(
+                depth - 1,
+                skipSettledSubtrees,
+                subtrees,
+                parents,
+                statistics
+            );
         }
+        parents.push_back(this);
+    }
+}
 
-        return false;
+void ChunkNode::updateChunk(const RenderData& data, UpdateStatistics& statistics) {
+    ghoul_assert(!isLeaf(), "Only the chunks of internal nodes can be updated");
+
+    bool allChildrenWantsMerge = true;
+    bool allChildrenAreSettled = true;
+    for (int i = 0; i < 4; ++i) {
+        allChildrenWantsMerge &= _children[i]->_wantsMerge;
+        allChildrenAreSettled &= _children[i]->_isSettled;
     }
+
+    ++statistics.nUpdatedNodes;
+    bool thisChunkWantsSplit = _chunk.update(data) == Chunk::Status::WantSplit;
+
+    const bool shouldMerge = allChildrenWantsMerge && !thisChunkWantsSplit;
+    if (shouldMerge) {
+        merge();
+    }
+
+    _wantsMerge = false;
+    _isSettled = allChildrenAreSettled && !shouldMerge;
 }
 
 void ChunkNode::depthFirst(const std::function<void(const ChunkNode&)>& f) const {
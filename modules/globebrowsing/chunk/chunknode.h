@@ -30,6 +30,7 @@
 #include <array>
 #include <functional>
 #include <memory>
+#include <vector>
 
 namespace openspace::globebrowsing {
 
@@ -37,6 +38,18 @@ class ChunkedLodGlobe;
 
 class ChunkNode {
 public:
+    /// Counts the work that was done while updating the chunk tree
+    struct UpdateStatistics {
+        int nUpdatedNodes = 0;
+        int nSkippedSubtrees = 0;
+
+        UpdateStatistics& operator+=(const UpdateStatistics& rhs) {
+            nUpdatedNodes += rhs.nUpdatedNodes;
+            nSkippedSubtrees += rhs.nSkippedSubtrees;
+            return *this;
+        }
+    };
+
     ChunkNode(const Chunk& chunk, ChunkNode* parent = nullptr);
 
     /**
@@ -68,15 +81,43 @@ public:
      * otherwise check if the children wants to merge. If all children wants to merge
      * and the Status of this Chunk is not Status::WANT_SPLIT it will merge.
      *
+     * A subtree is settled if its last update did not split or merge any of its nodes.
+     * As the update only depends on the camera and the tile data, updating a settled
+     * subtree again with the same inputs would not change it either.
+     *
+     * \param skipSettledSubtrees if true, settled subtrees are not updated and keep the
+     *        result of their last update
      * \returns true if the ChunkNode can merge and false if it can not merge.
     */
-    bool updateChunkTree(const RenderData& data);
+    bool updateChunkTree(const RenderData& data, bool skipSettledSubtrees,
+        UpdateStatistics& statistics);
+
+    /**
+     * Collects the roots of the subtrees \p depth levels below this node, and the leaves
+     * above that level, into \p subtrees. These subtrees are independent of each other
+     * and can be updated with <code>updateChunkTree</code> on separate threads. The
+     * internal nodes above them are collected into \p parents, with all children before
+     * their parents, and have to be updated with <code>updateChunk</code> afterwards.
+     */
+    void collectSubtrees(int depth, bool skipSettledSubtrees,
+        std::vector<ChunkNode*>& subtrees, std::vector<ChunkNode*>& parents,
+        UpdateStatistics& statistics);
+
+    /**
+     * Updates the Chunk of an internal node whose children have already been updated,
+     * and merges the children if all of them want to merge.
+     */
+    void updateChunk(const RenderData& data, UpdateStatistics& statistics);
 
 private:
     ChunkNode* _parent;
     std::array<std::unique_ptr<ChunkNode>, 4> _children;
 
     Chunk _chunk;
+
+    // The result of the last update of this node
+    bool _wantsMerge;
+    bool _isSettled;
 };
 
 } // namespace openspace::globebrowsing
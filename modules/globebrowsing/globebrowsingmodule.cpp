@@ -25,12 +25,14 @@
 #include <modules/globebrowsing/globebrowsingmodule.h>
 
 #include <modules/globebrowsing/cache/memoryawaretilecache.h>
+#include <modules/globebrowsing/cache/tilepackfile.h>
 #include <modules/globebrowsing/geometry/angle.h>
 #include <modules/globebrowsing/geometry/geodetic2.h>
 #include <modules/globebrowsing/geometry/geodeticpatch.h>
 #include <modules/globebrowsing/globes/renderableglobe.h>
 #include <modules/globebrowsing/other/distanceswitch.h>
 #include <modules/globebrowsing/tile/tileindex.h>
+#include <modules/globebrowsing/tile/tiletextureinitdata.h>
 #include <modules/globebrowsing/tile/rawtiledatareader/gdalwrapper.h>
 #include <modules/globebrowsing/tile/tileprovider/defaulttileprovider.h>
 #include <modules/globebrowsing/tile/tileprovider/singleimageprovider.h>
@@ -43,16 +45,23 @@
 #include <modules/globebrowsing/tile/tileprovider/tileproviderbyindex.h>
 #include <modules/globebrowsing/rendering/layer/layermanager.h>
 #include <modules/globebrowsing/rendering/layer/layer.h>
+#include <modules/globebrowsing/tasks/tilepyramidbaketask.h>
 
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/interaction/navigationhandler.h>
 #include <openspace/util/factorymanager.h>
+#include <openspace/util/threadpool.h>
 
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/templatefactory.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/systemcapabilities/generalcapabilitiescomponent.h>
 
+#include <algorithm>
+#include <thread>
 #include <vector>
 
 #ifdef GLOBEBROWSING_USE_GDAL
@@ -77,6 +86,12 @@
 namespace {
     constexpr const char* _loggerCat = "GlobeBrowsingModule";
 
+    constexpr const char* KeyTileDiskCache = "TileDiskCache";
+    constexpr const char* KeyTileDiskCacheSize = "TileDiskCacheSize";
+
+    // Default maximum size of the disk cache of each tile dataset, in MB
+    constexpr const double DefaultTileDiskCacheSize = 512.0;
+
 #ifdef GLOBEBROWSING_USE_GDAL
     openspace::GlobeBrowsingModule::Capabilities
     parseSubDatasets(char** subDatasets, int nSubdatasets)
@@ -135,9 +150,23 @@ namespace {
 
 namespace openspace {
 
-GlobeBrowsingModule::GlobeBrowsingModule() : OpenSpaceModule(Name) {}
+GlobeBrowsingModule::GlobeBrowsingModule()
+    : OpenSpaceModule(Name)
+    , _isTileDiskCacheEnabled(true)
+    , _tileDiskCacheSize(0)
+{}
+
+void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& configuration) {
+    if (configuration.hasKeyAndValue<bool>(KeyTileDiskCache)) {
+        _isTileDiskCacheEnabled = configuration.value<bool>(KeyTileDiskCache);
+    }
+    double cacheSize = DefaultTileDiskCacheSize;
+    if (configuration.hasKeyAndValue<double>(KeyTileDiskCacheSize)) {
+        cacheSize = configuration.value<double>(KeyTileDiskCacheSize);
+    }
+    // Convert from MB to Bytes
+    _tileDiskCacheSize = static_cast<size_t>(cacheSize * 1024 * 1024);
 
-void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary&) {
     // TODO: Remove dependency on OsEng.
     // Instead, make this class implement an interface that OsEng depends on.
     // Do not try to register module callbacks if OsEng does not exist,
@@ -153,6 +182,12 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary&) {
     OsEng.registerModuleCallback(OpenSpaceEngine::CallbackOption::Initialize, [&] {
         _tileCache = std::make_unique<globebrowsing::cache::MemoryAwareTileCache>();
         addPropertySubOwner(*_tileCache);
+        // The render thread updates one of the subtrees itself
+        const size_t nThreads = std::max<size_t>(
+            std::thread::hardware_concurrency(),
+            2
+        ) - 1;
+        _chunkEvaluationThreadPool = std::make_unique<ThreadPool>(nThreads);
 #ifdef GLOBEBROWSING_USE_GDAL
         // Convert from MB to Bytes
         GdalWrapper::create(
@@ -169,6 +204,7 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary&) {
 
     // Deinitialize
     OsEng.registerModuleCallback(OpenSpaceEngine::CallbackOption::Deinitialize, [&] {
+        _chunkEvaluationThreadPool = nullptr;
 #ifdef GLOBEBROWSING_USE_GDAL
         GdalWrapper::ref().destroy();
 #endif // GLOBEBROWSING_USE_GDAL
@@ -218,12 +254,59 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary&) {
         )]);
 
     FactoryManager::ref().addFactory(std::move(fTileProvider));
+
+    auto fTask = FactoryManager::ref().factory<Task>();
+    ghoul_assert(fTask, "No task factory existed");
+    fTask->registerClass<TilePyramidBakeTask>("TilePyramidBakeTask");
 }
 
 globebrowsing::cache::MemoryAwareTileCache* GlobeBrowsingModule::tileCache() {
     return _tileCache.get();
 }
 
+ThreadPool* GlobeBrowsingModule::chunkEvaluationThreadPool() {
+    return _chunkEvaluationThreadPool.get();
+}
+
+std::shared_ptr<globebrowsing::cache::TilePackFile> GlobeBrowsingModule::tilePackFile(
+    const std::string& datasetPath, const globebrowsing::TileTextureInitData& initData,
+    bool performPreProcessing)
+{
+    using globebrowsing::cache::TilePackFile;
+
+    // The cache manager does not exist in the TaskRunner
+    if (!_isTileDiskCacheEnabled || !FileSys.cacheManager()) {
+        return nullptr;
+    }
+
+    // Tiles are cached per dataset rather than per tile provider, as the identifiers of
+    // tile providers are not stable between sessions
+    const std::string identifier = fmt::format(
+        "{}|{}|{}", datasetPath, initData.hashKey(), performPreProcessing
+    );
+
+    std::lock_guard<std::mutex> lock(_tilePackFilesMutex);
+    std::shared_ptr<TilePackFile> packFile = _tilePackFiles[identifier].lock();
+    if (packFile) {
+        return packFile;
+    }
+
+    std::string path = FileSys.cacheManager()->cachedFilename(
+        "tiles.pack",
+        identifier,
+        ghoul::filesystem::CacheManager::Persistent::Yes
+    );
+    try {
+        packFile = std::make_shared<TilePackFile>(path, initData, _tileDiskCacheSize);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LWARNINGC(e.component, e.message);
+        return nullptr;
+    }
+    _tilePackFiles[identifier] = packFile;
+    return packFile;
+}
+
 scripting::LuaLibrary GlobeBrowsingModule::luaLibrary() const {
     std::string listLayerGroups = layerGroupNamesList();
 
@@ -27,7 +27,9 @@
 
 #include <openspace/util/openspacemodule.h>
 #include <ghoul/glm.h>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <future>
 
 namespace openspace::globebrowsing {
@@ -36,12 +38,18 @@ namespace openspace::globebrowsing {
     struct Geodetic2;
     struct Geodetic3;
 
-    namespace cache { class MemoryAwareTileCache; }
+    class TileTextureInitData;
+
+    namespace cache {
+        class MemoryAwareTileCache;
+        class TilePackFile;
+    } // namespace cache
 } // namespace openspace::globebrowsing
 
 namespace openspace {
 
 class Camera;
+class ThreadPool;
 
 class GlobeBrowsingModule : public OpenSpaceModule {
 public:
@@ -57,6 +65,25 @@ public:
         double latitude, double longitude, double altitude);
 
     globebrowsing::cache::MemoryAwareTileCache* tileCache();
+
+    /**
+     * Returns the thread pool that is shared by all globes for updating their chunk
+     * trees, or <code>nullptr</code> if the module has not been initialized.
+     */
+    ThreadPool* chunkEvaluationThreadPool();
+
+    /**
+     * Returns the persistent tile cache for the dataset at \p datasetPath read with the
+     * texture settings \p initData. Tile providers that read the same dataset with the
+     * same settings share the pack file.
+     *
+     * \returns The pack file or <code>nullptr</code> if the disk cache is disabled or
+     *          the pack file could not be opened
+     */
+    std::shared_ptr<globebrowsing::cache::TilePackFile> tilePackFile(
+        const std::string& datasetPath,
+        const globebrowsing::TileTextureInitData& initData, bool performPreProcessing);
+
     scripting::LuaLibrary luaLibrary() const override;
     globebrowsing::RenderableGlobe* castFocusNodeRenderableToGlobe();
 
@@ -108,6 +135,15 @@ private:
     static std::string layerTypeNamesList();
 
     std::unique_ptr<globebrowsing::cache::MemoryAwareTileCache> _tileCache;
+    std::unique_ptr<ThreadPool> _chunkEvaluationThreadPool;
+
+    bool _isTileDiskCacheEnabled;
+    /// Maximum size of each pack file in bytes
+    size_t _tileDiskCacheSize;
+    // cache identifier -> pack file
+    std::map<std::string, std::weak_ptr<globebrowsing::cache::TilePackFile>>
+        _tilePackFiles;
+    std::mutex _tilePackFilesMutex;
 
 #ifdef GLOBEBROWSING_USE_GDAL
 
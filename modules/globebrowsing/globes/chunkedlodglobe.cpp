@@ -24,6 +24,8 @@
 
 #include <modules/globebrowsing/globes/chunkedlodglobe.h>
 
+#include <modules/globebrowsing/globebrowsingmodule.h>
+#include <modules/globebrowsing/cache/memoryawaretilecache.h>
 #include <modules/globebrowsing/chunk/chunk.h>
 #include <modules/globebrowsing/chunk/chunklevelevaluator/chunklevelevaluator.h>
 #include <modules/globebrowsing/chunk/chunklevelevaluator/availabletiledataevaluator.h>
@@ -41,14 +43,45 @@
 #include <modules/globebrowsing/rendering/layer/layermanager.h>
 #include <modules/debugging/rendering/debugrenderer.h>
 #include <modules/globebrowsing/tile/tileindex.h>
+#include <modules/globebrowsing/tile/tileloadpriority.h>
+#include <modules/globebrowsing/tile/rawtiledatareader/rawtiledatareader.h>
 
+#include <openspace/engine/moduleengine.h>
+#include <openspace/engine/openspaceengine.h>
+#include <openspace/util/camera.h>
+#include <openspace/util/threadpool.h>
 #include <openspace/util/time.h>
+#include <openspace/util/updatestructures.h>
 
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/opengl/texture.h>
 
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
 #include <math.h>
 
+namespace {
+    // The hemispheres are split into subtrees this many levels below their roots for
+    // the parallel update, which gives at most 128 subtrees to balance over the threads
+    constexpr const int ParallelSubtreeDepth = 3;
+
+    // The camera movement is measured relative to the altitude, which is clamped to
+    // this many meters for cameras close to or below the reference ellipsoid
+    constexpr const double MinimumCameraAltitude = 1.0;
+
+    double angleBetween(const glm::dvec3& a, const glm::dvec3& b) {
+        return std::acos(glm::clamp(glm::dot(a, b), -1.0, 1.0));
+    }
+
+    template <typename T>
+    void hashCombine(size_t& seed, const T& value) {
+        seed ^= std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+} // namespace
+
 namespace openspace::globebrowsing {
 
 const TileIndex ChunkedLodGlobe::LEFT_HEMISPHERE_INDEX = TileIndex(0, 0, 1);
@@ -107,6 +140,10 @@ std::shared_ptr<LayerManager> ChunkedLodGlobe::layerManager() const {
     return _layerManager;
 }
 
+std::mutex& ChunkedLodGlobe::tileProviderMutex() const {
+    return _tileProviderMutex;
+}
+
 bool ChunkedLodGlobe::testIfCullable(const Chunk& chunk,
                                      const RenderData& renderData) const
 {
@@ -138,9 +175,14 @@ int ChunkedLodGlobe::getDesiredLevel(
         desiredLevel = _chunkEvaluatorByDistance->getDesiredLevel(chunk, renderData);
     }
 
-    int levelByAvailableData = _chunkEvaluatorByAvailableTiles->getDesiredLevel(
-        chunk, renderData
-    );
+    int levelByAvailableData;
+    {
+        std::lock_guard<std::mutex> lock(_tileProviderMutex);
+        levelByAvailableData = _chunkEvaluatorByAvailableTiles->getDesiredLevel(
+            chunk,
+            renderData
+        );
+    }
     if (levelByAvailableData != chunklevelevaluator::Evaluator::UnknownDesiredLevel &&
         _owner.debugProperties().limitLevelByAvailableData)
     {
@@ -151,6 +193,14 @@ int ChunkedLodGlobe::getDesiredLevel(
     return desiredLevel;
 }
 
+float ChunkedLodGlobe::getTileLoadPriority(const Chunk& chunk,
+                                           const RenderData& renderData) const
+{
+    return static_cast<float>(
+        _chunkEvaluatorByProjectedArea->projectedArea(chunk, renderData)
+    );
+}
+
 float ChunkedLodGlobe::getHeight(glm::dvec3 position) const {
     float height = 0;
 
@@ -292,8 +342,19 @@ void ChunkedLodGlobe::render(const RenderData& data, RendererTasks&) {
     auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
     stats.i["time"] = millis;
 
-    _leftRoot->updateChunkTree(data);
-    _rightRoot->updateChunkTree(data);
+    // Totals over all tile readers, the difference between the number of tiles read and
+    // the number of reads is the number of reads saved by coalescing tile reads
+    const RawTileDataReader::ReadStatistics& readStatistics =
+        RawTileDataReader::readStatistics();
+    stats.i["tile reads"] = readStatistics.nReads;
+    stats.i["tiles read"] = readStatistics.nTiles;
+    stats.i["coalesced tiles read"] = readStatistics.nCoalescedTiles;
+
+    auto updateStart = std::chrono::high_resolution_clock::now();
+    updateChunkTree(data);
+    stats.d["chunk tree update time"] = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - updateStart
+    ).count();
 
     // Calculate the MVP matrix
     glm::dmat4 viewTransform = glm::dmat4(data.camera.combinedViewMatrix());
@@ -309,6 +370,7 @@ void ChunkedLodGlobe::render(const RenderData& data, RendererTasks&) {
             stats.i["leafs chunk nodes"]++;
             if (chunk.isVisible()) {
                 stats.i["rendered chunks"]++;
+                TileLoadPriorityScope priorityScope(chunk.tileLoadPriority());
                 _renderer->renderChunk(chunkNode.getChunk(), data);
                 debugRenderChunk(chunk, mvp);
             }
@@ -326,6 +388,204 @@ void ChunkedLodGlobe::render(const RenderData& data, RendererTasks&) {
     stats.i["chunk globe render time"] = ms2 - millis;
 }
 
+void ChunkedLodGlobe::updateChunkTree(const RenderData& data) {
+    // Culling and level of detail use the saved camera, if there is one
+    const std::shared_ptr<const Camera> savedCamera = _owner.savedCamera();
+    const Camera& camera = savedCamera ? *savedCamera : data.camera;
+    const RenderData cameraData = {
+        camera,
+        data.position,
+        data.time,
+        data.doPerformanceMeasurement,
+        data.renderBinMask,
+        data.modelTransform
+    };
+
+    const bool skipSettledSubtrees = canSkipSettledSubtrees(camera);
+
+    ThreadPool* threadPool = nullptr;
+    if (canUpdateInParallel()) {
+        GlobeBrowsingModule* module = OsEng.moduleEngine().module<GlobeBrowsingModule>();
+        threadPool = module->chunkEvaluationThreadPool();
+    }
+
+    ChunkNode::UpdateStatistics statistics;
+    if (!threadPool) {
+        _leftRoot->updateChunkTree(cameraData, skipSettledSubtrees, statistics);
+        _rightRoot->updateChunkTree(cameraData, skipSettledSubtrees, statistics);
+    }
+    else {
+        std::vector<ChunkNode*> subtrees;
+        std::vector<ChunkNode*> parents;
+        for (ChunkNode* root : { _leftRoot.get(), _rightRoot.get() }) {
+            root->collectSubtrees(
+                ParallelSubtreeDepth,
+                skipSettledSubtrees,
+                subtrees,
+                parents,
+                statistics
+            );
+        }
+
+        // The render thread and the workers take subtrees until all are updated. Each
+        // thread uses its own copy of the camera, since it caches the matrices that are
+        // requested from it
+        std::atomic<size_t> nextSubtree(0);
+        auto updateSubtrees = [&]() {
+            Camera threadCamera(camera);
+            const RenderData threadData = {
+                threadCamera,
+                data.position,
+                data.time,
+                data.doPerformanceMeasurement,
+                data.renderBinMask,
+                data.modelTransform
+            };
+            ChunkNode::UpdateStatistics threadStatistics;
+            for (size_t i = nextSubtree++; i < subtrees.size(); i = nextSubtree++) {
+                subtrees[i]->updateChunkTree(
+                    threadData,
+                    skipSettledSubtrees,
+                    threadStatistics
+                );
+            }
+            return threadStatistics;
+        };
+
+        // Together with the render thread there is at most one thread per subtree
+        std::vector<std::future<ChunkNode::UpdateStatistics>> workers;
+        const size_t nThreads = std::min(threadPool->numThreads() + 1, subtrees.size());
+        for (size_t i = 1; i < nThreads; ++i) {
+            workers.push_back(
+                threadPool->submit(updateSubtrees, ThreadPool::Priority::High)
+            );
+        }
+
+        // The workers reference the local variables, so all of them have to finish
+        // before an error can be passed on
+        std::exception_ptr error;
+        try {
+            statistics += updateSubtrees();
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+        for (std::future<ChunkNode::UpdateStatistics>& worker : workers) {
+            try {
+                statistics += worker.get();
+            }
+            catch (...) {
+                error = error ? error : std::current_exception();
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        // The children are collected before their parents
+        for (ChunkNode* parent : parents) {
+            parent->updateChunk(cameraData, statistics);
+        }
+    }
+
+    stats.i["chunk nodes updated"] = statistics.nUpdatedNodes;
+    stats.i["chunk subtrees skipped"] = statistics.nSkippedSubtrees;
+}
+
+bool ChunkedLodGlobe::canSkipSettledSubtrees(const Camera& camera) {
+    const glm::dmat4& inverseModelTransform = _owner.inverseModelTransform();
+    const glm::dmat3 inverseRotation = glm::dmat3(inverseModelTransform);
+    cache::MemoryAwareTileCache* tileCache =
+        OsEng.moduleEngine().module<GlobeBrowsingModule>()->tileCache();
+
+    ChunkTreeUpdateReference current;
+    current.cameraPosition = glm::dvec3(
+        inverseModelTransform * glm::dvec4(camera.positionVec3(), 1.0)
+    );
+    current.cameraViewDirection = glm::normalize(
+        inverseRotation * camera.viewDirectionWorldSpace()
+    );
+    current.cameraUpDirection = glm::normalize(
+        inverseRotation * camera.lookUpVectorWorldSpace()
+    );
+    current.projectionMatrix = camera.sgctInternal.projectionMatrix();
+    current.tileCacheGeneration = tileCache ? tileCache->generation() : 0;
+    current.settingsHash = chunkTreeSettingsHash();
+    current.isValid = true;
+
+    const ChunkTreeUpdateReference& reference = _updateReference;
+    const double threshold = _owner.debugProperties().chunkReevaluationThreshold;
+    const double altitude = std::max(
+        glm::length(current.cameraPosition) - _owner.ellipsoid().minimumRadius(),
+        MinimumCameraAltitude
+    );
+    const double distanceMoved = glm::distance(
+        current.cameraPosition,
+        reference.cameraPosition
+    );
+
+    const bool canSkip = reference.isValid &&
+        current.tileCacheGeneration == reference.tileCacheGeneration &&
+        current.settingsHash == reference.settingsHash &&
+        current.projectionMatrix == reference.projectionMatrix &&
+        distanceMoved < threshold * altitude &&
+        angleBetween(current.cameraViewDirection, reference.cameraViewDirection) <
+            threshold &&
+        angleBetween(current.cameraUpDirection, reference.cameraUpDirection) < threshold;
+
+    if (!canSkip) {
+        _updateReference = current;
+    }
+    return canSkip;
+}
+
+bool ChunkedLodGlobe::canUpdateInParallel() const {
+    if (!_owner.debugProperties().parallelChunkEvaluation) {
+        return false;
+    }
+
+    // Text tile providers render their tiles with OpenGL the first time they are
+    // requested, which only works on the render thread. Of the tiles that are requested
+    // while updating the chunks, only those of the height layers are actually fetched
+    const LayerGroup& heightLayers =
+        _layerManager->layerGroup(layergroupid::GroupID::HeightLayers);
+    for (const std::shared_ptr<Layer>& layer : heightLayers.activeLayers()) {
+        if (layer->type() == layergroupid::TypeID::TileIndexTileLayer ||
+            layer->type() == layergroupid::TypeID::SizeReferenceTileLayer)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t ChunkedLodGlobe::chunkTreeSettingsHash() const {
+    const RenderableGlobe::DebugProperties& debug = _owner.debugProperties();
+
+    size_t hash = 0;
+    hashCombine(hash, _owner.generalProperties().lodScaleFactor.value());
+    hashCombine(hash, debug.performFrustumCulling.value());
+    hashCombine(hash, debug.performHorizonCulling.value());
+    hashCombine(hash, debug.levelByProjectedAreaElseDistance.value());
+    hashCombine(hash, debug.limitLevelByAvailableData.value());
+
+    for (size_t i = 0; i < layergroupid::NUM_LAYER_GROUPS; ++i) {
+        const LayerGroup& layerGroup = _layerManager->layerGroup(i);
+        for (const std::shared_ptr<Layer>& layer : layerGroup.activeLayers()) {
+            hashCombine(hash, layer.get());
+        }
+    }
+
+    // The bounding heights of the chunks depend on the settings of the height layers
+    const LayerGroup& heightLayers =
+        _layerManager->layerGroup(layergroupid::GroupID::HeightLayers);
+    for (const std::shared_ptr<Layer>& layer : heightLayers.activeLayers()) {
+        hashCombine(hash, layer->renderSettings().multiplier.value());
+        hashCombine(hash, layer->renderSettings().offset.value());
+    }
+    return hash;
+}
+
 void ChunkedLodGlobe::debugRenderChunk(const Chunk& chunk, const glm::dmat4& mvp) const {
     if (_owner.debugProperties().showChunkBounds ||
         _owner.debugProperties().showChunkAABB)
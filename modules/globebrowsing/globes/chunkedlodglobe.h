@@ -31,10 +31,11 @@
 #include <modules/globebrowsing/geometry/geodeticpatch.h>
 
 #include <memory>
+#include <mutex>
 
 namespace openspace::globebrowsing {
 
-namespace chunklevelevaluator { class Evaluator; }
+namespace chunklevelevaluator { class Evaluator; class ProjectedArea; }
 
 namespace culling { class ChunkCuller; }
 
@@ -87,6 +88,12 @@ public:
      */
     int getDesiredLevel(const Chunk& chunk, const RenderData& renderData) const;
 
+    /**
+     * Gets the priority of loading the tiles of a visible chunk, which is its projected
+     * area. Chunks that cover more of the view get their tiles loaded first.
+     */
+    float getTileLoadPriority(const Chunk& chunk, const RenderData& renderData) const;
+
     /**
      * Calculates the height from the surface of the reference ellipsoid to the
      * heigh mapped surface.
@@ -117,9 +124,50 @@ public:
 
     std::shared_ptr<LayerManager> layerManager() const;
 
+    /**
+     * Guards the tile providers while the chunk tree is updated on multiple threads.
+     * Every access of the tile providers while updating a <code>Chunk</code> has to
+     * lock it.
+     */
+    std::mutex& tileProviderMutex() const;
+
     StatsCollector stats;
 
 private:
+    /// The inputs to the chunk tree update that decide whether a chunk splits or merges
+    struct ChunkTreeUpdateReference {
+        // The camera in model space
+        glm::dvec3 cameraPosition = glm::dvec3(0.0);
+        glm::dvec3 cameraViewDirection = glm::dvec3(0.0);
+        glm::dvec3 cameraUpDirection = glm::dvec3(0.0);
+        glm::mat4 projectionMatrix = glm::mat4(0.f);
+
+        unsigned long long tileCacheGeneration = 0;
+        size_t settingsHash = 0;
+        bool isValid = false;
+    };
+
+    /**
+     * Updates the chunk tree for the camera that is used for culling and level of detail
+     * calculations. The subtrees of the two hemispheres are updated in parallel when
+     * possible and settled subtrees are skipped if the inputs did not change enough
+     * since the last full update.
+     */
+    void updateChunkTree(const RenderData& data);
+
+    /**
+     * Returns true if the inputs to the chunk tree update are close enough to those of
+     * the last full update that settled subtrees do not have to be updated again.
+     * Otherwise the current inputs become the reference of the next frames.
+     */
+    bool canSkipSettledSubtrees(const Camera& camera);
+
+    /// Returns true if the chunks can be updated on other threads than the render thread
+    bool canUpdateInParallel() const;
+
+    /// Combines the properties and layers that affect the chunk tree update into a hash
+    size_t chunkTreeSettingsHash() const;
+
     void debugRenderChunk(const Chunk& chunk, const glm::dmat4& data) const;
 
     static const GeodeticPatch COVERAGE;
@@ -140,11 +188,14 @@ private:
     std::vector<std::unique_ptr<culling::ChunkCuller>> _chunkCullers;
 
     std::unique_ptr<chunklevelevaluator::Evaluator> _chunkEvaluatorByAvailableTiles;
-    std::unique_ptr<chunklevelevaluator::Evaluator> _chunkEvaluatorByProjectedArea;
+    std::unique_ptr<chunklevelevaluator::ProjectedArea> _chunkEvaluatorByProjectedArea;
     std::unique_ptr<chunklevelevaluator::Evaluator> _chunkEvaluatorByDistance;
 
     std::shared_ptr<LayerManager> _layerManager;
 
+    ChunkTreeUpdateReference _updateReference;
+    mutable std::mutex _tileProviderMutex;
+
     bool _shadersNeedRecompilation;
 };
 
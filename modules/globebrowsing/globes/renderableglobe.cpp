@@ -116,6 +116,21 @@ namespace {
         "" // @TODO Missing documentation
     };
 
+    static const openspace::properties::Property::PropertyInfo ParallelEvaluationInfo = {
+        "ParallelChunkEvaluation",
+        "Parallel chunk evaluation",
+        "If enabled, the chunk tree is updated on multiple threads."
+    };
+
+    static const openspace::properties::Property::PropertyInfo ReevaluationInfo = {
+        "ChunkReevaluationThreshold",
+        "Chunk reevaluation threshold",
+        "Parts of the chunk tree that did not change in their last update are not "
+        "updated again until the camera has moved more than this fraction of its "
+        "altitude or turned more than this many radians, or until the available tiles "
+        "changed. A value of 0 updates the entire chunk tree every frame."
+    };
+
     static const openspace::properties::Property::PropertyInfo PerformShadingInfo = {
         "PerformShading",
         "Perform shading",
@@ -184,7 +199,9 @@ RenderableGlobe::RenderableGlobe(const ghoul::Dictionary& dictionary)
         BoolProperty(ResetTileProviderInfo, false),
         BoolProperty(CollectStatsInfo, false),
         BoolProperty(LimitLevelInfo, true),
-        IntProperty(ModelSpaceRenderingInfo, 10, 1, 22)
+        IntProperty(ModelSpaceRenderingInfo, 10, 1, 22),
+        BoolProperty(ParallelEvaluationInfo, true),
+        FloatProperty(ReevaluationInfo, 0.001f, 0.f, 0.1f)
     })
     , _generalProperties({
         BoolProperty(PerformShadingInfo, true),
@@ -266,6 +283,8 @@ RenderableGlobe::RenderableGlobe(const ghoul::Dictionary& dictionary)
     _debugPropertyOwner.addProperty(_debugProperties.collectStats);
     _debugPropertyOwner.addProperty(_debugProperties.limitLevelByAvailableData);
     _debugPropertyOwner.addProperty(_debugProperties.modelSpaceRenderingCutoffLevel);
+    _debugPropertyOwner.addProperty(_debugProperties.parallelChunkEvaluation);
+    _debugPropertyOwner.addProperty(_debugProperties.chunkReevaluationThreshold);
 
     auto notifyShaderRecompilation = [&](){
         _chunkedLodGlobe->notifyShaderRecompilation();
@@ -73,6 +73,8 @@ public:
         properties::BoolProperty collectStats;
         properties::BoolProperty limitLevelByAvailableData;
         properties::IntProperty modelSpaceRenderingCutoffLevel;
+        properties::BoolProperty parallelChunkEvaluation;
+        properties::FloatProperty chunkReevaluationThreshold;
     };
 
     struct GeneralProperties {
@@ -25,30 +25,30 @@
 #ifndef __OPENSPACE_MODULE_GLOBEBROWSING___PRIORITIZING_CONCURRENT_JOB_MANAGER___H__
 #define __OPENSPACE_MODULE_GLOBEBROWSING___PRIORITIZING_CONCURRENT_JOB_MANAGER___H__
 
-#include <modules/globebrowsing/other/lruthreadpool.h>
+#include <modules/globebrowsing/other/prioritythreadpool.h>
 
 #include <openspace/util/concurrentjobmanager.h>
-#include <openspace/util/concurrentqueue.h>
-
-#include <mutex>
+#include <openspace/util/concurrentringbuffer.h>
 
 namespace openspace::globebrowsing {
 
 /**
- * Concurrent job manager which prioritizes which jobs to work on depending on which
- * ones were enqueued latest. The class is templated both on the job type and the key
- * type which is used to identify jobs. In case a job need to be explicitly ended
- * It can be identified using its key.
+ * Concurrent job manager which prioritizes which jobs to work on depending on their
+ * priority, and on which ones were enqueued latest for jobs of equal priority. The class
+ * is templated both on the job type and the key type which is used to identify jobs. In
+ * case a job need to be explicitly ended It can be identified using its key.
  */
 template<typename P, typename KeyType>
 class PrioritizingConcurrentJobManager {
 public:
-    PrioritizingConcurrentJobManager(LRUThreadPool<KeyType> pool);
+    PrioritizingConcurrentJobManager(PriorityThreadPool<KeyType> pool);
 
     /**
-     * Enqueues a job which is identified using a given key
+     * Enqueues a job which is identified using a given key. Jobs with a higher
+     * <code>priority</code> are executed first.
      */
-    void enqueueJob(std::shared_ptr<Job<P>> job, KeyType key);
+    void enqueueJob(std::shared_ptr<Job<P>> job, KeyType key,
+        float priority = PriorityThreadPool<KeyType>::DemotedPriority);
 
     /**
      * The keys returned by this function have been popped from the queue and corresponds
@@ -69,6 +69,12 @@ public:
      */
     bool touch(KeyType key);
 
+    /**
+     * Sets new priorities for all enqueued jobs at once. Enqueued jobs whose keys are not
+     * part of <code>priorities</code> are demoted to the lowest priority.
+     */
+    void updatePriorities(const std::unordered_map<KeyType, float>& priorities);
+
     /**
      * Clear all enqueued jobs. Can not end jobs that workers are currently handling.
      * Therefore it is not safe to assume that there will be no finished jobs after
@@ -84,10 +90,10 @@ public:
     size_t numFinishedJobs() const;
 
 private:
-    ConcurrentQueue<std::shared_ptr<Job<P>>> _finishedJobs;
-    std::mutex _finishedJobsMutex;
-    /// An LRU thread pool is used since the jobs can be bumped and hence prioritized.
-    LRUThreadPool<KeyType> _threadPool;
+    /// Polled by the render thread every frame, so it must not block on the workers
+    ConcurrentRingBuffer<std::shared_ptr<Job<P>>> _finishedJobs;
+    /// A priority thread pool is used since the jobs can be bumped and reprioritized
+    PriorityThreadPool<KeyType> _threadPool;
 
 };
 
@@ -28,19 +28,19 @@ namespace openspace::globebrowsing {
 
 template <typename P, typename KeyType>
 PrioritizingConcurrentJobManager<P, KeyType>::PrioritizingConcurrentJobManager(
-    LRUThreadPool<KeyType> pool)
-    : _threadPool(pool)
+    PriorityThreadPool<KeyType> pool)
+    : _finishedJobs(openspace::detail::FinishedJobsCapacity)
+    , _threadPool(pool)
 { }
 
 template <typename P, typename KeyType>
 void PrioritizingConcurrentJobManager<P, KeyType>::enqueueJob(std::shared_ptr<Job<P>> job,
-    KeyType key)
+    KeyType key, float priority)
 {
     _threadPool.enqueue([this, job]() {
         job->execute();
-        std::lock_guard<std::mutex> lock(_finishedJobsMutex);
         _finishedJobs.push(job);
-    }, key);
+    }, key, priority);
 }
 
 template <typename P, typename KeyType>
@@ -60,6 +60,13 @@ bool PrioritizingConcurrentJobManager<P, KeyType>::touch(KeyType key) {
     return _threadPool.touch(key);
 }
 
+template <typename P, typename KeyType>
+void PrioritizingConcurrentJobManager<P, KeyType>::updatePriorities(
+    const std::unordered_map<KeyType, float>& priorities)
+{
+    _threadPool.updatePriorities(priorities);
+}
+
 template <typename P, typename KeyType>
 void PrioritizingConcurrentJobManager<P, KeyType>::clearEnqueuedJobs() {
     _threadPool.clearEnqueuedTasks();
@@ -68,9 +75,7 @@ void PrioritizingConcurrentJobManager<P, KeyType>::clearEnqueuedJobs() {
 template <typename P, typename KeyType>
 std::shared_ptr<Job<P>> PrioritizingConcurrentJobManager<P, KeyType>::popFinishedJob() {
     ghoul_assert(_finishedJobs.size() > 0, "There is no finished job to pop!");
-    std::lock_guard<std::mutex> lock(_finishedJobsMutex);
-    std::shared_ptr<Job<P>> result = _finishedJobs.pop();
-    return result;
+    return _finishedJobs.pop();
 }
 
 template <typename P, typename KeyType>
@@ -22,69 +22,94 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
-#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___LRU_THREAD_POOL___H__
-#define __OPENSPACE_MODULE_GLOBEBROWSING___LRU_THREAD_POOL___H__
-
-#include <modules/globebrowsing/cache/lrucache.h>
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___PRIORITY_THREAD_POOL___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___PRIORITY_THREAD_POOL___H__
 
 #include <condition_variable>
 #include <functional>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <unordered_map>
 #include <vector>
-#include <atomic>
-
-// Implementatin based on http://progsch.net/wordpress/?p=81
 
 namespace openspace::globebrowsing {
 
-template<typename KeyType> class LRUThreadPool;
+template<typename KeyType> class PriorityThreadPool;
 
 template<typename KeyType>
-class LRUThreadPoolWorker {
+class PriorityThreadPoolWorker {
 public:
-    LRUThreadPoolWorker(LRUThreadPool<KeyType>& pool);
+    PriorityThreadPoolWorker(PriorityThreadPool<KeyType>& pool);
     void operator()();
 private:
-    LRUThreadPool<KeyType>& _pool;
+    PriorityThreadPool<KeyType>& _pool;
 };
 
 /**
- * The <code>LRUThreadPool</code> will only enqueue a certain number of tasks. The most
- * recently enqueued task is the one that will be executed first. This class is templated
- * on a key type which used as an identifier to determine wheter or not a task with the
- * given key has been enqueued or not. This means that a task can be enqueued several
- * times. The user must ensure that an enqueued task with a given key should be
- * equal in outcome to a second enqueued task with the same key. This is because a second
- * enqueued task with the same key will simply be bumped and prioritised before other
- * enqueued tasks. The given task will be ignored.
+ * The <code>PriorityThreadPool</code> will only enqueue a certain number of tasks. The
+ * task with the highest priority is the one that will be executed first and tasks with
+ * the same priority are executed in the order of most recently enqueued or touched
+ * first. If the queue is full, the task with the lowest priority is popped from the
+ * queue. The class is templated on a key type which is used to identify tasks, and
+ * enqueueing a task with a key that is already enqueued replaces the enqueued task.
+ *
+ * The priorities of all enqueued tasks can be recomputed at once using
+ * <code>updatePriorities</code>, which demotes all tasks that did not get a new
+ * priority.
  */
 template<typename KeyType>
-class LRUThreadPool {
+class PriorityThreadPool {
 public:
-    LRUThreadPool(size_t numThreads, size_t queueSize);
-    LRUThreadPool(const LRUThreadPool& toCopy);
-    ~LRUThreadPool();
+    /// The priority that tasks are demoted to if they did not get a new priority
+    static constexpr const float DemotedPriority = 0.f;
+
+    PriorityThreadPool(size_t numThreads, size_t queueSize);
+    PriorityThreadPool(const PriorityThreadPool& toCopy);
+    ~PriorityThreadPool();
 
-    void enqueue(std::function<void()> f, KeyType key);
+    void enqueue(std::function<void()> f, KeyType key, float priority = DemotedPriority);
+
+    /**
+     * Bumps the task identified with <code>key</code> to be executed before the other
+     * enqueued tasks with the same priority.
+     * \returns true if the task was found, else returns false
+     */
     bool touch(KeyType key);
+
+    /**
+     * Sets the priorities of all enqueued tasks that are found in <code>priorities</code>
+     * and demotes all other enqueued tasks to <code>DemotedPriority</code>.
+     */
+    void updatePriorities(const std::unordered_map<KeyType, float>& priorities);
+
     std::vector<KeyType> getQueuedTasksKeys();
     std::vector<KeyType> getUnqueuedTasksKeys();
     void clearEnqueuedTasks();
 
 private:
-
-    struct DefaultHasher {
-        unsigned long long operator()(const KeyType& key) const {
-            return static_cast<unsigned long long>(key);
-        }
+    friend class PriorityThreadPoolWorker<KeyType>;
+
+    struct Task {
+        KeyType key;
+        std::function<void()> function;
+        float priority;
+        /// Increases with every enqueue or touch, used to order tasks of equal priority
+        unsigned long long order;
     };
-    friend class LRUThreadPoolWorker<KeyType>;
+
+    /// Orders the tasks so that the heap has the task to execute next on top
+    static bool hasLowerPriority(const Task& lhs, const Task& rhs);
+
+    /// Restores the heap property after any of the tasks has been modified
+    void rebuildQueue();
+    Task popHighestPriority();
 
     std::vector<std::thread> _workers;
-    cache::LRUCache<KeyType, std::function<void()>, DefaultHasher> _queuedTasks;
+    const size_t _queueSize;
+    /// The enqueued tasks stored as a binary heap
+    std::vector<Task> _queuedTasks;
     std::vector<KeyType> _unqueuedTasks;
+    unsigned long long _nextOrder;
     std::mutex _queueMutex;
     std::condition_variable _condition;
 
@@ -93,6 +118,6 @@ private:
 
 } // namespace openspace::globebrowsing
 
-#include "lruthreadpool.inl"
+#include "prioritythreadpool.inl"
 
-#endif // __OPENSPACE_MODULE_GLOBEBROWSING___LRU_THREAD_POOL___H__
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___PRIORITY_THREAD_POOL___H__
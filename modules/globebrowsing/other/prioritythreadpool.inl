@@ -0,0 +1,218 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <algorithm>
+
+namespace openspace::globebrowsing {
+
+template<typename KeyType>
+PriorityThreadPoolWorker<KeyType>::PriorityThreadPoolWorker(
+                                                      PriorityThreadPool<KeyType>& pool)
+    : _pool(pool)
+{}
+
+template<typename KeyType>
+void PriorityThreadPoolWorker<KeyType>::operator()() {
+    std::function<void()> task;
+    while (true) {
+        // acquire lock
+        {
+            std::unique_lock<std::mutex> lock(_pool._queueMutex);
+
+            // look for a work item
+            while (!_pool._stop && _pool._queuedTasks.empty()) {
+                // if there are none wait for notification
+                _pool._condition.wait(lock);
+            }
+
+            if (_pool._stop) { // exit if the pool is stopped
+                return;
+            }
+
+            // get the task from the queue
+            task = std::move(_pool.popHighestPriority().function);
+        }// release lock
+
+        // execute the task
+        task();
+    }
+}
+
+template<typename KeyType>
+PriorityThreadPool<KeyType>::PriorityThreadPool(size_t numThreads, size_t queueSize)
+    : _queueSize(queueSize)
+    , _nextOrder(0)
+    , _stop(false)
+{
+    _queuedTasks.reserve(queueSize + 1);
+    for (size_t i = 0; i < numThreads; ++i) {
+        _workers.push_back(std::thread(PriorityThreadPoolWorker<KeyType>(*this)));
+    }
+}
+
+template<typename KeyType>
+PriorityThreadPool<KeyType>::PriorityThreadPool(const PriorityThreadPool& toCopy)
+    : PriorityThreadPool(toCopy._workers.size(), toCopy._queueSize)
+{}
+
+// the destructor joins all threads
+template<typename KeyType>
+PriorityThreadPool<KeyType>::~PriorityThreadPool() {
+    {
+        std::unique_lock<std::mutex> lock(_queueMutex);
+        _stop = true;
+    }
+    _condition.notify_all();
+
+    // join them
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        _workers[i].join();
+    }
+}
+
+template<typename KeyType>
+bool PriorityThreadPool<KeyType>::hasLowerPriority(const Task& lhs, const Task& rhs) {
+    if (lhs.priority != rhs.priority) {
+        return lhs.priority < rhs.priority;
+    }
+    return lhs.order < rhs.order;
+}
+
+template<typename KeyType>
+void PriorityThreadPool<KeyType>::rebuildQueue() {
+    std::make_heap(_queuedTasks.begin(), _queuedTasks.end(), &hasLowerPriority);
+}
+
+template<typename KeyType>
+typename PriorityThreadPool<KeyType>::Task
+PriorityThreadPool<KeyType>::popHighestPriority()
+{
+    std::pop_heap(_queuedTasks.begin(), _queuedTasks.end(), &hasLowerPriority);
+    Task task = std::move(_queuedTasks.back());
+    _queuedTasks.pop_back();
+    return task;
+}
+
+// add new work item to the pool
+template<typename KeyType>
+void PriorityThreadPool<KeyType>::enqueue(std::function<void()> f, KeyType key,
+                                          float priority)
+{
+    { // acquire lock
+        std::unique_lock<std::mutex> lock(_queueMutex);
+
+        auto it = std::find_if(
+            _queuedTasks.begin(),
+            _queuedTasks.end(),
+            [&key](const Task& task) { return task.key == key; }
+        );
+        if (it != _queuedTasks.end()) {
+            // Replace the task that was already enqueued with this key
+            it->function = std::move(f);
+            it->priority = priority;
+            it->order = _nextOrder++;
+            rebuildQueue();
+        }
+        else {
+            _queuedTasks.push_back({ key, std::move(f), priority, _nextOrder++ });
+            std::push_heap(_queuedTasks.begin(), _queuedTasks.end(), &hasLowerPriority);
+
+            if (_queuedTasks.size() > _queueSize) {
+                // The lowest priority task is one of the leaves of the heap, but it is
+                // cheaper to search all of them for the small queues this is used with
+                auto lowest = std::min_element(
+                    _queuedTasks.begin(),
+                    _queuedTasks.end(),
+                    &hasLowerPriority
+                );
+                _unqueuedTasks.push_back(lowest->key);
+                _queuedTasks.erase(lowest);
+                rebuildQueue();
+            }
+        }
+    } // release lock
+
+    // wake up one thread
+    _condition.notify_one();
+}
+
+template<typename KeyType>
+bool PriorityThreadPool<KeyType>::touch(KeyType key) {
+    std::unique_lock<std::mutex> lock(_queueMutex);
+    auto it = std::find_if(
+        _queuedTasks.begin(),
+        _queuedTasks.end(),
+        [&key](const Task& task) { return task.key == key; }
+    );
+    if (it == _queuedTasks.end()) {
+        return false;
+    }
+    it->order = _nextOrder++;
+    rebuildQueue();
+    return true;
+}
+
+template<typename KeyType>
+void PriorityThreadPool<KeyType>::updatePriorities(
+                                      const std::unordered_map<KeyType, float>& priorities)
+{
+    std::unique_lock<std::mutex> lock(_queueMutex);
+    for (Task& task : _queuedTasks) {
+        auto it = priorities.find(task.key);
+        task.priority = it != priorities.end() ? it->second : DemotedPriority;
+    }
+    rebuildQueue();
+}
+
+template<typename KeyType>
+std::vector<KeyType> PriorityThreadPool<KeyType>::getUnqueuedTasksKeys() {
+    std::vector<KeyType> toReturn;
+    {
+        std::unique_lock<std::mutex> lock(_queueMutex);
+        toReturn.swap(_unqueuedTasks);
+    }
+    return toReturn;
+}
+
+template<typename KeyType>
+std::vector<KeyType> PriorityThreadPool<KeyType>::getQueuedTasksKeys() {
+    std::vector<KeyType> queuedTasks;
+    {
+        std::unique_lock<std::mutex> lock(_queueMutex);
+        while (!_queuedTasks.empty()) {
+            queuedTasks.push_back(popHighestPriority().key);
+        }
+    }
+    return queuedTasks;
+}
+
+template<typename KeyType>
+void PriorityThreadPool<KeyType>::clearEnqueuedTasks() {
+    { // acquire lock
+        std::unique_lock<std::mutex> lock(_queueMutex);
+        _queuedTasks.clear();
+    } // release lock
+}
+
+} // namespace openspace::globebrowsing
@@ -0,0 +1,338 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/tasks/tilepyramidbaketask.h>
+
+#include <modules/globebrowsing/cache/tilepackfile.h>
+#include <modules/globebrowsing/rendering/layer/layermanager.h>
+#include <modules/globebrowsing/tile/rawtile.h>
+#include <modules/globebrowsing/tile/rawtiledatareader/gdalrawtiledatareader.h>
+#include <modules/globebrowsing/tile/rawtiledatareader/simplerawtiledatareader.h>
+#include <modules/globebrowsing/tile/tileindex.h>
+
+#include <openspace/documentation/verifier.h>
+#include <openspace/util/threadpool.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/dictionary.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr const char* _loggerCat = "TilePyramidBakeTask";
+
+    constexpr const char* KeyInput = "Input";
+    constexpr const char* KeyOutput = "Output";
+    constexpr const char* KeyLayerGroup = "LayerGroup";
+    constexpr const char* KeyMaxLevel = "MaxLevel";
+    constexpr const char* KeyTilePixelSize = "TilePixelSize";
+    constexpr const char* KeyPadTiles = "PadTiles";
+    constexpr const char* KeyPerformPreProcessing = "PerformPreProcessing";
+    constexpr const char* KeyThreads = "Threads";
+
+    // Chunk trees start with the two hemispheres at level 1
+    constexpr const int MinLevel = 1;
+
+    // Level n consists of 2^n x 2^(n-1) tiles
+    uint64_t numTilesOnLevel(int level) {
+        return 1ULL << (2 * level - 1);
+    }
+
+    openspace::globebrowsing::TileIndex tileIndexAt(uint64_t i) {
+        int level = MinLevel;
+        while (i >= numTilesOnLevel(level)) {
+            i -= numTilesOnLevel(level);
+            ++level;
+        }
+        const uint64_t nTilesX = 1ULL << level;
+        return openspace::globebrowsing::TileIndex(
+            static_cast<int>(i % nTilesX),
+            static_cast<int>(i / nTilesX),
+            level
+        );
+    }
+} // namespace
+
+namespace openspace::globebrowsing {
+
+TilePyramidBakeTask::TilePyramidBakeTask(const ghoul::Dictionary& dictionary)
+    : _tilePixelSize(0)
+    , _padTiles(true)
+    , _nThreads(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+{
+    openspace::documentation::testSpecificationAndThrow(
+        documentation(),
+        dictionary,
+        "TilePyramidBakeTask"
+    );
+
+    // The input may also be an inline description of a web service
+    _inputPath = dictionary.value<std::string>(KeyInput);
+    if (FileSys.fileExists(absPath(_inputPath))) {
+        _inputPath = absPath(_inputPath);
+    }
+    _outputPath = absPath(dictionary.value<std::string>(KeyOutput));
+    _layerGroupID = layergroupid::getGroupIDFromName(
+        dictionary.value<std::string>(KeyLayerGroup)
+    );
+    _maxLevel = static_cast<int>(dictionary.value<double>(KeyMaxLevel));
+
+    if (dictionary.hasKey(KeyTilePixelSize)) {
+        _tilePixelSize = static_cast<int>(dictionary.value<double>(KeyTilePixelSize));
+    }
+    if (dictionary.hasKey(KeyPadTiles)) {
+        _padTiles = dictionary.value<bool>(KeyPadTiles);
+    }
+    _performPreProcessing =
+        LayerManager::shouldPerformPreProcessingOnLayergroup(_layerGroupID);
+    if (dictionary.hasKey(KeyPerformPreProcessing)) {
+        _performPreProcessing = dictionary.value<bool>(KeyPerformPreProcessing);
+    }
+    if (dictionary.hasKey(KeyThreads)) {
+        _nThreads = static_cast<int>(dictionary.value<double>(KeyThreads));
+    }
+}
+
+std::string TilePyramidBakeTask::description() {
+    return fmt::format(
+        "Read all tiles of '{}' down to level {} and write them to the tile pack file "
+        "'{}'",
+        _inputPath, _maxLevel, _outputPath
+    );
+}
+
+void TilePyramidBakeTask::perform(const Task::ProgressCallback& progressCallback) {
+#ifdef GLOBEBROWSING_USE_GDAL
+    // The GdalWrapper that usually registers the drivers is not created in the
+    // TaskRunner
+    GDALAllRegister();
+#endif // GLOBEBROWSING_USE_GDAL
+
+    TileTextureInitData initData = LayerManager::getTileTextureInitData(
+        _layerGroupID,
+        _padTiles,
+        _tilePixelSize
+    );
+    RawTileDataReader::PerformPreprocessing preprocess =
+        _performPreProcessing ? RawTileDataReader::PerformPreprocessing::Yes :
+        RawTileDataReader::PerformPreprocessing::No;
+
+    // Datasets must not be accessed from multiple threads, so each thread gets its own
+    // reader
+    std::vector<std::unique_ptr<RawTileDataReader>> readers;
+    for (int i = 0; i < _nThreads; ++i) {
+#ifdef GLOBEBROWSING_USE_GDAL
+        readers.push_back(std::make_unique<GdalRawTileDataReader>(
+            _inputPath,
+            initData,
+            preprocess
+        ));
+#else // GLOBEBROWSING_USE_GDAL
+        readers.push_back(std::make_unique<SimpleRawTileDataReader>(
+            _inputPath,
+            initData,
+            preprocess
+        ));
+#endif // GLOBEBROWSING_USE_GDAL
+    }
+
+    const RawTileDataReader& reader = *readers.front();
+    const int maxLevel = std::min(_maxLevel, reader.maxChunkLevel());
+    if (maxLevel < _maxLevel) {
+        LWARNING(fmt::format(
+            "Dataset '{}' only has tiles down to level {}", _inputPath, maxLevel
+        ));
+    }
+
+    cache::TilePackFile packFile(
+        _outputPath,
+        initData,
+        std::numeric_limits<size_t>::max()
+    );
+    const TileDepthTransform depthTransform = reader.getDepthTransform();
+    packFile.setDatasetInfo({
+        reader.noDataValueAsFloat(),
+        reader.depthOffset(),
+        reader.depthScale(),
+        depthTransform.depthOffset,
+        depthTransform.depthScale,
+        reader.rasterXSize(),
+        reader.rasterYSize(),
+        reader.dataSourceNumRasters(),
+        maxLevel
+    });
+
+    uint64_t nTiles = 0;
+    for (int level = MinLevel; level <= maxLevel; ++level) {
+        nTiles += numTilesOnLevel(level);
+    }
+    const size_t nPreviousTiles = packFile.numTiles();
+
+    std::atomic<uint64_t> nextTile(0);
+    std::atomic<uint64_t> nFinishedTiles(0);
+    std::atomic<uint64_t> nFailedTiles(0);
+
+    auto work = [&](const RawTileDataReader& r) {
+        std::vector<char> buffer(initData.totalNumBytes());
+        try {
+            for (uint64_t i = nextTile++; i < nTiles; i = nextTile++) {
+                const TileIndex tileIndex = tileIndexAt(i);
+                if (!packFile.exist(tileIndex)) {
+                    std::shared_ptr<RawTile> rawTile = r.readTileData(
+                        tileIndex,
+                        buffer.data(),
+                        nullptr
+                    );
+                    if (rawTile->error == RawTile::ReadError::None) {
+                        packFile.writeTile(*rawTile, buffer.data());
+                    }
+                    else {
+                        ++nFailedTiles;
+                    }
+                }
+                ++nFinishedTiles;
+            }
+        }
+        catch (...) {
+            // Stop the other workers from picking up new tiles
+            nextTile = nTiles;
+            throw;
+        }
+    };
+
+    ThreadPool pool(readers.size());
+    std::vector<std::future<void>> results;
+    for (const std::unique_ptr<RawTileDataReader>& r : readers) {
+        const RawTileDataReader* reader = r.get();
+        results.push_back(pool.submit([&work, reader]() { work(*reader); }));
+    }
+    for (std::future<void>& result : results) {
+        while (result.wait_for(std::chrono::milliseconds(100)) !=
+               std::future_status::ready)
+        {
+            progressCallback(static_cast<float>(nFinishedTiles) / nTiles);
+        }
+    }
+    // Rethrows the exception of a worker that failed. The index is saved by the
+    // destructor of the pack file, so the tiles written so far are kept
+    for (std::future<void>& result : results) {
+        result.get();
+    }
+
+    packFile.saveIndex();
+    progressCallback(1.f);
+
+    LINFO(fmt::format(
+        "Wrote {} new tiles to '{}' ({} bytes). {} tiles could not be read",
+        packFile.numTiles() - nPreviousTiles, _outputPath, packFile.size(),
+        nFailedTiles.load()
+    ));
+}
+
+documentation::Documentation TilePyramidBakeTask::documentation() {
+    using namespace documentation;
+    return {
+        "TilePyramidBakeTask",
+        "globebrowsing_tile_pyramid_bake_task",
+        {
+            {
+                "Type",
+                new StringEqualVerifier("TilePyramidBakeTask"),
+                Optional::No,
+                "The type of this task",
+            },
+            {
+                KeyInput,
+                new StringAnnotationVerifier("A dataset that GDAL can read"),
+                Optional::No,
+                "The dataset to read the tiles from. This is the same value that would "
+                "be used as the FilePath of a DefaultTileLayer",
+            },
+            {
+                KeyOutput,
+                new StringAnnotationVerifier("A valid filepath ending in .pack"),
+                Optional::No,
+                "The tile pack file to write the tiles to. If the file already exists "
+                "and was created with the same settings, only missing tiles are read",
+            },
+            {
+                KeyLayerGroup,
+                new StringInListVerifier({
+                    layergroupid::LAYER_GROUP_IDENTIFIERS[0],
+                    layergroupid::LAYER_GROUP_IDENTIFIERS[1],
+                    layergroupid::LAYER_GROUP_IDENTIFIERS[2],
+                    layergroupid::LAYER_GROUP_IDENTIFIERS[3],
+                    layergroupid::LAYER_GROUP_IDENTIFIERS[4]
+                }),
+                Optional::No,
+                "The layer group in which the tiles will be used, which determines the "
+                "texture format of the tiles",
+            },
+            {
+                KeyMaxLevel,
+                new IntInRangeVerifier(MinLevel, 22),
+                Optional::No,
+                "The deepest level of the tile pyramid to read",
+            },
+            {
+                KeyTilePixelSize,
+                new IntVerifier,
+                Optional::Yes,
+                "The preferred size of each tile in pixels. This has to match the "
+                "TilePixelSize of the layer using the tile pack file",
+            },
+            {
+                KeyPadTiles,
+                new BoolVerifier,
+                Optional::Yes,
+                "Determines whether the tiles are padded. This has to match the "
+                "PadTiles setting of the layer using the tile pack file",
+            },
+            {
+                KeyPerformPreProcessing,
+                new BoolVerifier,
+                Optional::Yes,
+                "Determines whether the minimum and maximum values of each tile are "
+                "calculated. The default depends on the layer group",
+            },
+            {
+                KeyThreads,
+                new IntGreaterVerifier(0),
+                Optional::Yes,
+                "The number of threads that read tiles. Defaults to the number of "
+                "cores",
+            }
+        }
+    };
+}
+
+} // namespace openspace::globebrowsing
@@ -0,0 +1,64 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___TILEPYRAMIDBAKETASK___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___TILEPYRAMIDBAKETASK___H__
+
+#include <openspace/util/task.h>
+
+#include <modules/globebrowsing/rendering/layer/layergroupid.h>
+
+#include <string>
+
+namespace openspace::globebrowsing {
+
+/**
+ * Reads all tiles of a dataset down to a given level and stores them in a tile pack
+ * file, which can be used as the <code>FilePath</code> of a
+ * <code>DefaultTileLayer</code> to serve the tiles without opening the dataset. The
+ * tiles are read in parallel, with one <code>RawTileDataReader</code> per thread, and
+ * tiles already present in the pack file are skipped so that an interrupted task can be
+ * resumed.
+ */
+class TilePyramidBakeTask : public Task {
+public:
+    TilePyramidBakeTask(const ghoul::Dictionary& dictionary);
+    std::string description() override;
+    void perform(const Task::ProgressCallback& progressCallback) override;
+    static documentation::Documentation documentation();
+
+private:
+    std::string _inputPath;
+    std::string _outputPath;
+    layergroupid::GroupID _layerGroupID;
+    int _maxLevel;
+    int _tilePixelSize;
+    bool _padTiles;
+    bool _performPreProcessing;
+    int _nThreads;
+};
+
+} // namespace openspace::globebrowsing
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___TILEPYRAMIDBAKETASK___H__
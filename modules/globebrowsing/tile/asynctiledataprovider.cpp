@@ -25,18 +25,22 @@
 #include <modules/globebrowsing/tile/asynctiledataprovider.h>
 
 #include <modules/globebrowsing/globebrowsingmodule.h>
-#include <modules/globebrowsing/other/lruthreadpool.h>
+#include <modules/globebrowsing/other/prioritythreadpool.h>
 
 #include <modules/globebrowsing/tile/tileloadjob.h>
+#include <modules/globebrowsing/tile/tileloadpriority.h>
 #include <modules/globebrowsing/tile/rawtiledatareader/rawtiledatareader.h>
 #include <modules/globebrowsing/tile/tiletextureinitdata.h>
 #include <modules/globebrowsing/cache/memoryawaretilecache.h>
+#include <modules/globebrowsing/cache/tilepackfile.h>
 
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/engine/moduleengine.h>
 
 #include <ghoul/logging/logmanager.h>
 
+#include <algorithm>
+
 namespace openspace::globebrowsing {
 
 namespace {
@@ -44,10 +48,12 @@ namespace {
 } // namespace
 
 AsyncTileDataProvider::AsyncTileDataProvider(const std::string& name,
-    const std::shared_ptr<RawTileDataReader> rawTileDataReader)
+    const std::shared_ptr<RawTileDataReader> rawTileDataReader,
+    std::shared_ptr<cache::TilePackFile> tilePackFile)
     : _name(name)
     , _rawTileDataReader(rawTileDataReader)
-    , _concurrentJobManager(LRUThreadPool<TileIndex::TileHashKey>(1, 10))
+    , _tilePackFile(std::move(tilePackFile))
+    , _concurrentJobManager(PriorityThreadPool<TileIndex::TileHashKey>(1, 10))
     , _pboContainer(nullptr)
     , _resetMode(ResetMode::ShouldResetAllButRawTileDataReader)
     , _shouldBeDeleted(false)
@@ -61,28 +67,81 @@ std::shared_ptr<RawTileDataReader> AsyncTileDataProvider::getRawTileDataReader()
 }
 
 bool AsyncTileDataProvider::enqueueTileIO(const TileIndex& tileIndex) {
+    const float priority = TileLoadPriorityScope::currentPriority();
+    auto it = _tileRequestPriorities.find(tileIndex.hashKey());
+    if (it == _tileRequestPriorities.end()) {
+        _tileRequestPriorities[tileIndex.hashKey()] = priority;
+    }
+    else {
+        it->second = std::max(it->second, priority);
+    }
+
     if (_resetMode == ResetMode::ShouldNotReset && satisfiesEnqueueCriteria(tileIndex)) {
-        if (_pboContainer) {
-            char* dataPtr = static_cast<char*>(_pboContainer->mapBuffer(
-                tileIndex.hashKey(), PixelBuffer::Access::WriteOnly));
-            if (dataPtr) {
-                auto job = std::make_shared<TileLoadJob>(_rawTileDataReader, tileIndex,
-                    dataPtr);
-                _concurrentJobManager.enqueueJob(job, tileIndex.hashKey());
-                _enqueuedTileRequests.insert(tileIndex.hashKey());
-            }
-            else {
-                return false;
+        _pendingTileRequests.push_back(tileIndex);
+        _enqueuedTileRequests.insert(tileIndex.hashKey());
+        return true;
+    }
+    return false;
+}
+
+void AsyncTileDataProvider::enqueuePendingTileRequests() {
+    // Group the requests by their parent. Tiles that are already in the tile pack file
+    // are not read from the dataset and are therefore not grouped
+    std::map<TileIndex::TileHashKey, std::vector<TileIndex>> siblings;
+    for (const TileIndex& tileIndex : _pendingTileRequests) {
+        if (tileIndex.level > 0 && !(_tilePackFile && _tilePackFile->exist(tileIndex))) {
+            siblings[tileIndex.parent().hashKey()].push_back(tileIndex);
+        }
+    }
+
+    std::map<TileIndex::TileHashKey, std::shared_ptr<TileReadBatch>> readBatches;
+    for (auto& group : siblings) {
+        if (group.second.size() > 1) {
+            readBatches[group.first] = std::make_shared<TileReadBatch>(
+                _rawTileDataReader,
+                std::move(group.second)
+            );
+        }
+    }
+
+    // Jobs are enqueued in the order they were requested to keep their priorities
+    for (const TileIndex& tileIndex : _pendingTileRequests) {
+        std::shared_ptr<TileReadBatch> readBatch;
+        if (tileIndex.level > 0) {
+            auto it = readBatches.find(tileIndex.parent().hashKey());
+            if (it != readBatches.end()) {
+                readBatch = it->second;
             }
         }
-        else {
-            auto job = std::make_shared<TileLoadJob>(_rawTileDataReader, tileIndex);
-            _concurrentJobManager.enqueueJob(job, tileIndex.hashKey());
-            _enqueuedTileRequests.insert(tileIndex.hashKey());
+
+        const float priority = _tileRequestPriorities[tileIndex.hashKey()];
+        if (!enqueueTileLoadJob(tileIndex, std::move(readBatch), priority)) {
+            _enqueuedTileRequests.erase(tileIndex.hashKey());
         }
-        return true;
     }
-    return false;
+    _pendingTileRequests.clear();
+}
+
+bool AsyncTileDataProvider::enqueueTileLoadJob(const TileIndex& tileIndex,
+                                              std::shared_ptr<TileReadBatch> readBatch,
+                                                float priority)
+{
+    if (_pboContainer) {
+        char* dataPtr = static_cast<char*>(_pboContainer->mapBuffer(
+            tileIndex.hashKey(), PixelBuffer::Access::WriteOnly));
+        if (!dataPtr) {
+            return false;
+        }
+        auto job = std::make_shared<TileLoadJob>(_rawTileDataReader, tileIndex,
+            dataPtr, _tilePackFile, std::move(readBatch));
+        _concurrentJobManager.enqueueJob(job, tileIndex.hashKey(), priority);
+    }
+    else {
+        auto job = std::make_shared<TileLoadJob>(_rawTileDataReader, tileIndex,
+            _tilePackFile, std::move(readBatch));
+        _concurrentJobManager.enqueueJob(job, tileIndex.hashKey(), priority);
+    }
+    return true;
 }
 
 std::vector<std::shared_ptr<RawTile>> AsyncTileDataProvider::getRawTiles() {
@@ -149,6 +208,12 @@ void AsyncTileDataProvider::endUnfinishedJobs() {
 }
 
 void AsyncTileDataProvider::endEnqueuedJobs() {
+    // Pending requests have neither a job nor a mapped pixel buffer yet
+    for (const TileIndex& tileIndex : _pendingTileRequests) {
+        _enqueuedTileRequests.erase(tileIndex.hashKey());
+    }
+    _pendingTileRequests.clear();
+
     std::vector<TileIndex::TileHashKey> enqueuedJobs =
         _concurrentJobManager.getKeysToEnqueuedJobs();
     for (const TileIndex::TileHashKey& enqueuedJob : enqueuedJobs) {
@@ -213,11 +278,16 @@ void AsyncTileDataProvider::update() {
         }
         case ResetMode::ShouldNotReset: {
             updatePboUsage();
+            // The jobs that were requested again since the last update get their new
+            // priorities and all other enqueued jobs are demoted
+            _concurrentJobManager.updatePriorities(_tileRequestPriorities);
+            enqueuePendingTileRequests();
             break;
         }
         default:
             break;
     }
+    _tileRequestPriorities.clear();
 }
 
 void AsyncTileDataProvider::reset() {
@@ -37,12 +37,16 @@
 #include <map>
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 namespace openspace::globebrowsing {
 
 //class GlobeBrowsingModule;
 struct RawTile;
 class RawTileDataReader;
+class TileReadBatch;
+
+namespace cache { class TilePackFile; }
 
 /**
  * The responsibility of this class is to enqueue tile requests and fetching finished
@@ -53,12 +57,20 @@ public:
     /**
      * \param textureDataProvider is the reader that will be used for the asynchronos
      * tile loading.
+     * \param tilePackFile is an optional persistent cache that is consulted before the
+     * tiles are read from <code>textureDataProvider</code>.
      */
     AsyncTileDataProvider(const std::string& name,
-                          std::shared_ptr<RawTileDataReader> textureDataProvider);
+                          std::shared_ptr<RawTileDataReader> textureDataProvider,
+                          std::shared_ptr<cache::TilePackFile> tilePackFile = nullptr);
 
     /**
-     * Creates a job which asynchronously loads a raw tile. This job is enqueued.
+     * Requests the tile to be loaded asynchronously. The requests made during a frame
+     * are enqueued as jobs in the following call to <code>update</code>, where requests
+     * for sibling tiles are grouped so that their reads can be coalesced. The load is
+     * prioritized by the current <code>TileLoadPriorityScope</code>, and the priorities
+     * of already enqueued loads are updated in bulk in <code>update</code>. Enqueued
+     * loads that are not requested again are demoted.
      */
     bool enqueueTileIO(const TileIndex& tileIndex);
 
@@ -107,6 +119,19 @@ protected:
 
     void updatePboUsage();
 
+    /**
+     * Creates and enqueues the jobs for all pending tile requests. Sibling tiles that
+     * are requested together share a <code>TileReadBatch</code>.
+     */
+    void enqueuePendingTileRequests();
+
+    /**
+     * Creates and enqueues a job loading the tile <code>tileIndex</code>.
+     * \returns false if no pixel buffer could be mapped for the tile
+     */
+    bool enqueueTileLoadJob(const TileIndex& tileIndex,
+        std::shared_ptr<TileReadBatch> readBatch, float priority);
+
     void performReset(ResetRawTileDataReader resetRawTileDataReader);
 
 private:
@@ -114,6 +139,8 @@ private:
     GlobeBrowsingModule* _globeBrowsingModule;
     /// The reader used for asynchronous reading
     std::shared_ptr<RawTileDataReader> _rawTileDataReader;
+    /// The persistent tile cache, nullptr if disk caching is disabled
+    std::shared_ptr<cache::TilePackFile> _tilePackFile;
 
     PrioritizingConcurrentJobManager<RawTile, TileIndex::TileHashKey>
         _concurrentJobManager;
@@ -121,6 +148,10 @@ private:
     /// nullptr if pbo is not used for texture uploading. Otherwise initialized.
     std::unique_ptr<PixelBufferContainer<TileIndex::TileHashKey>> _pboContainer;
     std::set<TileIndex::TileHashKey> _enqueuedTileRequests;
+    /// Requests that have not been turned into jobs yet, in the order they were made
+    std::vector<TileIndex> _pendingTileRequests;
+    /// The highest priority each tile has been requested with since the last update
+    std::unordered_map<TileIndex::TileHashKey, float> _tileRequestPriorities;
 
     ResetMode _resetMode;
     bool _shouldBeDeleted;
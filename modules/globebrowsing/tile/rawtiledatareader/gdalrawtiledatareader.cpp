@@ -54,9 +54,20 @@
 #endif // _MSC_VER
 
 #include <algorithm>
+#include <cstring>
 
 namespace openspace::globebrowsing {
 
+namespace {
+    // GDAL reads from an overview instead of the full resolution raster if the read is
+    // downsampled by roughly this factor or more, so coalesced reads are only used for
+    // tiles below it
+    constexpr const double MaxCoalescedDownsampling = 1.5;
+
+    // GDAL adds this to the source coordinate in its nearest neighbour sampling
+    constexpr const double SamplingEpsilon = 1e-10;
+} // namespace
+
 std::ostream& operator<<(std::ostream& os, const PixelRegion& pr) {
     return os << pr.start.x << ", " << pr.start.y << " with size " << pr.numPixels.x <<
         ", " << pr.numPixels.y;
@@ -225,6 +236,68 @@ RawTile::ReadError GdalRawTileDataReader::rasterRead(
     return error;
 }
 
+bool GdalRawTileDataReader::readCoalescedImageData(const IODescription& mergedIO,
+                                          const std::vector<IODescription>& tileIOs,
+                                          const std::vector<char*>& dataDestinations,
+                                                RawTile::ReadError& worstError) const
+{
+    for (const IODescription& io : tileIOs) {
+        const glm::dvec2 downsampling = glm::dvec2(io.read.region.numPixels) /
+                                        glm::dvec2(io.write.region.numPixels);
+        if (downsampling.x >= MaxCoalescedDownsampling ||
+            downsampling.y >= MaxCoalescedDownsampling)
+        {
+            return false;
+        }
+    }
+
+    const size_t bytesPerPixel = _initData.bytesPerPixel();
+    const PixelRegion& mergedRegion = mergedIO.read.region;
+
+    std::vector<char> mergedData(mergedIO.write.totalNumBytes, static_cast<char>(255));
+    IODescription io = mergedIO;
+    readImageData(io, worstError, mergedData.data());
+
+    std::vector<size_t> columnOffsets;
+    for (size_t i = 0; i < tileIOs.size(); ++i) {
+        const PixelRegion& read = tileIOs[i].read.region;
+        const PixelRegion& write = tileIOs[i].write.region;
+        const glm::dvec2 increment = glm::dvec2(read.numPixels) /
+                                     glm::dvec2(write.numPixels);
+
+        // Nearest neighbour sampling, the same way as GDALRasterBand::IRasterIO does it
+        columnOffsets.resize(write.numPixels.x);
+        for (int x = 0; x < write.numPixels.x; ++x) {
+            int xInSource = static_cast<int>(
+                (x + 0.5) * increment.x + read.start.x + SamplingEpsilon
+            );
+            xInSource = std::min(xInSource, read.end().x - 1);
+            columnOffsets[x] = (xInSource - mergedRegion.start.x) * bytesPerPixel;
+        }
+
+        // Both buffers store their lines bottom to top, see rasterRead
+        for (int y = 0; y < write.numPixels.y; ++y) {
+            int yInSource = static_cast<int>(
+                (y + 0.5) * increment.y + read.start.y + SamplingEpsilon
+            );
+            yInSource = std::min(yInSource, read.end().y - 1);
+            const char* sourceLine = mergedData.data() +
+                (mergedRegion.end().y - 1 - yInSource) * mergedIO.write.bytesPerLine;
+            char* destinationLine = dataDestinations[i] +
+                (write.numPixels.y - 1 - y) * tileIOs[i].write.bytesPerLine;
+
+            for (int x = 0; x < write.numPixels.x; ++x) {
+                std::memcpy(
+                    destinationLine + x * bytesPerPixel,
+                    sourceLine + columnOffsets[x],
+                    bytesPerPixel
+                );
+            }
+        }
+    }
+    return true;
+}
+
 GDALDataset* GdalRawTileDataReader::openGdalDataset(const std::string& filePath) {
     return static_cast<GDALDataset*>(GDALOpen(filePath.c_str(), GA_ReadOnly));
 }
@@ -43,6 +43,7 @@
 
 #include <string>
 #include <mutex>
+#include <vector>
 
 class GDALDataset;
 class GDALRasterBand;
@@ -96,6 +97,16 @@ private:
     virtual RawTile::ReadError rasterRead(int rasterBand, const IODescription& io,
                                           char* dst) const override;
 
+    /**
+     * Reads the merged region once and resamples each tile from it using the same
+     * nearest neighbour sampling that GDAL uses when reading the tile directly. Tiles
+     * that GDAL would read from an overview are not coalesced.
+     */
+    virtual bool readCoalescedImageData(const IODescription& mergedIO,
+        const std::vector<IODescription>& tileIOs,
+        const std::vector<char*>& dataDestinations,
+        RawTile::ReadError& worstError) const override;
+
     // GDAL Helper methods
     GDALDataset* openGdalDataset(const std::string& filePath);
 
@@ -24,6 +24,7 @@
 
 #include <modules/globebrowsing/tile/rawtiledatareader/rawtiledatareader.h>
 
+#include <modules/globebrowsing/tile/rawtiledatareader/tiledatakernels.h>
 #include <modules/globebrowsing/tile/rawtiledatareader/tiledatatype.h>
 
 #include <modules/globebrowsing/tile/tile.h>
@@ -52,6 +53,12 @@
 
 namespace openspace::globebrowsing {
 
+namespace {
+    // Coalescing the reads of several tiles is only worth it if the merged read does
+    // not cover much more of the dataset than the individual reads would
+    constexpr const double MaxCoalescedReadOverhead = 1.5;
+} // namespace
+
 RawTileDataReader::RawTileDataReader(const TileTextureInitData& initData,
                                      PerformPreprocessing preprocess)
     : _initData(initData)
@@ -86,12 +93,20 @@ std::shared_ptr<RawTile> RawTileDataReader::readTileData(TileIndex tileIndex,
         memset(dataDestination, 255, _initData.totalNumBytes());
         readImageData(io, worstError, dataDestination);
         size_t numBytes = _initData.totalNumBytes();
-        memcpy(pboMappedDataDestination, dataDestination, numBytes);
+        tiledatakernels::copyToMappedBuffer(
+            pboMappedDataDestination,
+            dataDestination,
+            numBytes
+        );
     }
     else {
         ghoul_assert(false, "Need to specify a data destination");
     }
 
+    ReadStatistics& statistics = readStatistics();
+    statistics.nReads++;
+    statistics.nTiles++;
+
     rawTile->imageData = dataDestination;
     rawTile->error = worstError;
     rawTile->tileIndex = tileIndex;
@@ -106,6 +121,95 @@ std::shared_ptr<RawTile> RawTileDataReader::readTileData(TileIndex tileIndex,
     return rawTile;
 }
 
+std::vector<std::shared_ptr<RawTile>> RawTileDataReader::readTileDataBatch(
+    const std::vector<TileIndex>& tileIndices,
+    const std::vector<char*>& dataDestinations) const
+{
+    ghoul_assert(
+        tileIndices.size() == dataDestinations.size(),
+        "Need one data destination per tile"
+    );
+
+    if (tileIndices.size() < 2) {
+        return {};
+    }
+
+    std::vector<IODescription> tileIOs;
+    tileIOs.reserve(tileIndices.size());
+    PixelRegion::PixelCoordinate start(std::numeric_limits<int>::max());
+    PixelRegion::PixelCoordinate end(std::numeric_limits<int>::min());
+    double tilesArea = 0.0;
+    for (const TileIndex& tileIndex : tileIndices) {
+        if (tileIndex.level != tileIndices.front().level) {
+            return {};
+        }
+        IODescription io = getIODescription(tileIndex);
+        // Reads that need wrapping are split up into several reads anyway
+        if (!io.read.region.isInside(io.read.fullRegion)) {
+            return {};
+        }
+        start = glm::min(start, io.read.region.start);
+        end = glm::max(end, io.read.region.end());
+        tilesArea += static_cast<double>(io.read.region.numPixels.x) *
+                     io.read.region.numPixels.y;
+        tileIOs.push_back(io);
+    }
+
+    const PixelRegion::PixelRange size = end - start;
+    const double mergedArea = static_cast<double>(size.x) * size.y;
+    if (mergedArea > MaxCoalescedReadOverhead * tilesArea) {
+        return {};
+    }
+
+    // The merged region is read at the resolution of the dataset and the tiles are
+    // produced from it by the implementation of readCoalescedImageData
+    IODescription mergedIO;
+    mergedIO.read.overview = 0;
+    mergedIO.read.region = PixelRegion(start, size);
+    mergedIO.read.fullRegion = tileIOs.front().read.fullRegion;
+    mergedIO.write.region = PixelRegion(PixelRegion::PixelCoordinate(0, 0), size);
+    mergedIO.write.bytesPerLine = _initData.bytesPerPixel() * size.x;
+    mergedIO.write.totalNumBytes = mergedIO.write.bytesPerLine * size.y;
+
+    RawTile::ReadError worstError = RawTile::ReadError::None;
+    bool success = readCoalescedImageData(
+        mergedIO,
+        tileIOs,
+        dataDestinations,
+        worstError
+    );
+    if (!success) {
+        return {};
+    }
+
+    ReadStatistics& statistics = readStatistics();
+    statistics.nReads++;
+    statistics.nTiles += tileIndices.size();
+    statistics.nCoalescedTiles += tileIndices.size();
+
+    std::vector<std::shared_ptr<RawTile>> rawTiles;
+    rawTiles.reserve(tileIndices.size());
+    for (size_t i = 0; i < tileIndices.size(); ++i) {
+        std::shared_ptr<RawTile> rawTile = std::make_shared<RawTile>();
+        rawTile->imageData = dataDestinations[i];
+        rawTile->error = worstError;
+        rawTile->tileIndex = tileIndices[i];
+        rawTile->textureInitData = std::make_shared<TileTextureInitData>(_initData);
+
+        if (_preprocess == PerformPreprocessing::Yes) {
+            rawTile->tileMetaData = getTileMetaData(rawTile, tileIOs[i].write.region);
+            rawTile->error = std::max(rawTile->error, postProcessErrorCheck(rawTile));
+        }
+        rawTiles.push_back(rawTile);
+    }
+    return rawTiles;
+}
+
+RawTileDataReader::ReadStatistics& RawTileDataReader::readStatistics() {
+    static ReadStatistics statistics;
+    return statistics;
+}
+
 void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& worstError,
                                       char* imageDataDest) const
 {
@@ -255,6 +359,14 @@ IODescription RawTileDataReader::adjustIODescription(const IODescription& io) co
     return io;
 }
 
+bool RawTileDataReader::readCoalescedImageData(const IODescription&,
+                                               const std::vector<IODescription>&,
+                                               const std::vector<char*>&,
+                                               RawTile::ReadError&) const
+{
+    return false;
+}
+
 IODescription RawTileDataReader::getIODescription(const TileIndex& tileIndex) const {
     IODescription io;
     io.read.region = highestResPixelRegion(tileIndex);
@@ -496,58 +608,53 @@ RawTile::ReadError RawTileDataReader::repeatedRasterRead(
 std::shared_ptr<TileMetaData> RawTileDataReader::getTileMetaData(
     std::shared_ptr<RawTile> rawTile, const PixelRegion& region) const
 {
-    size_t bytesPerLine = _initData.bytesPerPixel() * region.numPixels.x;
+    const size_t nRasters = _initData.nRasters();
+    const size_t bytesPerLine = _initData.bytesPerPixel() * region.numPixels.x;
+    const size_t valuesPerLine = nRasters * region.numPixels.x;
 
-    TileMetaData* preprocessData = new TileMetaData();
-    preprocessData->maxValues.resize(_initData.nRasters());
-    preprocessData->minValues.resize(_initData.nRasters());
-    preprocessData->hasMissingData.resize(_initData.nRasters());
-
-    std::vector<float> noDataValues;
-    noDataValues.resize(_initData.nRasters());
-
-    for (size_t raster = 0; raster < _initData.nRasters(); ++raster) {
-        preprocessData->maxValues[raster] = -FLT_MAX;
-        preprocessData->minValues[raster] = FLT_MAX;
-        preprocessData->hasMissingData[raster] = false;
-        noDataValues[raster] = noDataValueAsFloat();
-    }
-
-    bool allIsMissing = true;
+    // Float data is processed in place, which also allows missing values to be replaced
+    // with -FLT_MAX. All other types are converted to floats one line at a time
+    const bool isFloat = _initData.glType() == GL_FLOAT;
+    std::vector<float> lineValues(isFloat ? 0 : valuesPerLine);
 
+    std::vector<tiledatakernels::RasterStatistics> statistics(nRasters);
+    const float noDataValue = noDataValueAsFloat();
     for (int y = 0; y < region.numPixels.y; ++y) {
-        size_t yi = (region.numPixels.y - 1 - y) * bytesPerLine;
-        size_t i = 0;
-        for (int x = 0; x < region.numPixels.x; ++x) {
-            for (size_t raster = 0; raster < _initData.nRasters(); ++raster) {
-                float noDataValue = noDataValueAsFloat();
-                float val = tiledatatype::interpretFloat(
-                    _initData.glType(),
-                    &(rawTile->imageData[yi + i])
-                );
-                if (val != noDataValue &&
-                    val == val)
-                {
-                    preprocessData->maxValues[raster] = std::max(
-                        val,
-                        preprocessData->maxValues[raster]
-                    );
-                    preprocessData->minValues[raster] = std::min(
-                        val,
-                        preprocessData->minValues[raster]
-                    );
-                    allIsMissing = false;
-                }
-                else {
-                    preprocessData->hasMissingData[raster] = true;
-                    float& floatToRewrite = reinterpret_cast<float&>(
-                        rawTile->imageData[yi + i]
-                    );
-                    floatToRewrite = -FLT_MAX;
-                }
-                i += _initData.bytesPerDatum();
-            }
+        char* line = rawTile->imageData + y * bytesPerLine;
+        float* values = nullptr;
+        if (isFloat) {
+            values = reinterpret_cast<float*>(line);
+        }
+        else {
+            tiledatakernels::convertToFloat(
+                _initData.glType(),
+                line,
+                valuesPerLine,
+                lineValues.data()
+            );
+            values = lineValues.data();
         }
+        tiledatakernels::accumulateStatistics(
+            values,
+            region.numPixels.x,
+            nRasters,
+            noDataValue,
+            isFloat,
+            statistics.data()
+        );
+    }
+
+    TileMetaData* preprocessData = new TileMetaData();
+    preprocessData->maxValues.resize(nRasters);
+    preprocessData->minValues.resize(nRasters);
+    preprocessData->hasMissingData.resize(nRasters);
+
+    bool allIsMissing = true;
+    for (size_t raster = 0; raster < nRasters; ++raster) {
+        preprocessData->maxValues[raster] = statistics[raster].max;
+        preprocessData->minValues[raster] = statistics[raster].min;
+        preprocessData->hasMissingData[raster] = statistics[raster].hasMissingData;
+        allIsMissing &= !statistics[raster].hasData();
     }
 
     if (allIsMissing) {
@@ -38,7 +38,9 @@
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/opengl/texture.h>
 
+#include <atomic>
 #include <string>
+#include <vector>
 
 namespace openspace::globebrowsing {
 
@@ -48,6 +50,20 @@ class RawTileDataReader {
 public:
     BooleanType(PerformPreprocessing);
 
+    /**
+     * Counters for the reads performed by all readers. They are used to report how many
+     * reads of the underlying datasets are saved by coalescing the reads of neighbouring
+     * tiles.
+     */
+    struct ReadStatistics {
+        /// The number of reads of the underlying datasets, coalesced or not
+        std::atomic<long long> nReads = { 0 };
+        /// The total number of tiles that have been read
+        std::atomic<long long> nTiles = { 0 };
+        /// The number of tiles that have been read as part of a coalesced read
+        std::atomic<long long> nCoalescedTiles = { 0 };
+    };
+
     RawTileDataReader(const TileTextureInitData& initData,
                       PerformPreprocessing preprocess = PerformPreprocessing::No);
     virtual ~RawTileDataReader() = default;
@@ -56,8 +72,21 @@ public:
      * Reads data from the current dataset and initializes a <code>RawTile</code>
      * which gets returned.
      */
-    std::shared_ptr<RawTile> readTileData(TileIndex tileIndex,
+    virtual std::shared_ptr<RawTile> readTileData(TileIndex tileIndex,
         char* dataDestination, char* pboMappedDataDestination) const;
+
+    /**
+     * Reads all tiles in <code>tileIndices</code>, which have to be on the same level,
+     * with a single read of the dataset covering all of them and writes the tile at
+     * index i to <code>dataDestinations[i]</code>.
+     * \returns the tiles in the same order as <code>tileIndices</code>, or an empty
+     * vector if the reads could not be coalesced. In that case nothing has been read
+     * and the tiles have to be read individually using <code>readTileData</code>.
+     */
+    std::vector<std::shared_ptr<RawTile>> readTileDataBatch(
+        const std::vector<TileIndex>& tileIndices,
+        const std::vector<char*>& dataDestinations) const;
+
     TileDepthTransform getDepthTransform() const;
     const TileTextureInitData& tileTextureInitData() const;
     const PixelRegion::PixelRange fullPixelSize() const;
@@ -85,6 +114,12 @@ public:
      */
     std::shared_ptr<RawTile> defaultTileData() const;
 
+    /**
+     * Returns the read counters that are shared by all
+     * <code>RawTileDataReader</code>s.
+     */
+    static ReadStatistics& readStatistics();
+
 protected:
     /**
      * This function should set the variables <code>_cached</code>,
@@ -116,6 +151,19 @@ protected:
     virtual RawTile::ReadError rasterRead(
         int rasterBand, const IODescription& io, char* dst) const = 0;
 
+    /**
+     * Reads the region described by <code>mergedIO</code>, which covers the read regions
+     * of all <code>tileIOs</code> at the resolution of the dataset, once and produces
+     * the tile described by <code>tileIOs[i]</code> in <code>dataDestinations[i]</code>.
+     * The result has to be identical to reading each tile individually. The default
+     * implementation does not support coalesced reads.
+     * \returns <code>false</code>, without having read anything, if the reads could not
+     * be coalesced.
+     */
+    virtual bool readCoalescedImageData(const IODescription& mergedIO,
+        const std::vector<IODescription>& tileIOs,
+        const std::vector<char*>& dataDestinations, RawTile::ReadError& worstError) const;
+
     IODescription getIODescription(const TileIndex& tileIndex) const;
 
     /**
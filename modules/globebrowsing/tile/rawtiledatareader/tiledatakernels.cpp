@@ -0,0 +1,388 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/tile/rawtiledatareader/tiledatakernels.h>
+
+#include <ghoul/misc/assert.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#define TILEDATAKERNELS_USE_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TILEDATAKERNELS_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace openspace::globebrowsing::tiledatakernels {
+
+namespace {
+
+template <typename T>
+void convertScalar(const char* src, size_t count, float* dst) {
+    for (size_t i = 0; i < count; ++i) {
+        T value;
+        std::memcpy(&value, src + i * sizeof(T), sizeof(T));
+        dst[i] = static_cast<float>(value);
+    }
+}
+
+// Each of the vectorized conversions converts as many values as possible with vector
+// instructions and returns the number of converted values. The remainder is converted
+// by convertScalar
+
+#if defined(TILEDATAKERNELS_USE_AVX2)
+
+size_t convertUnsignedByte(const char* src, size_t count, float* dst) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+        __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+        _mm256_storeu_ps(dst + i, values);
+    }
+    return i;
+}
+
+size_t convertUnsignedShort(const char* src, size_t count, float* dst) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i shorts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i));
+        __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(shorts));
+        _mm256_storeu_ps(dst + i, values);
+    }
+    return i;
+}
+
+size_t convertShort(const char* src, size_t count, float* dst) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i shorts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i));
+        __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(shorts));
+        _mm256_storeu_ps(dst + i, values);
+    }
+    return i;
+}
+
+size_t convertInt(const char* src, size_t count, float* dst) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i ints = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 4 * i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtepi32_ps(ints));
+    }
+    return i;
+}
+
+size_t convertDouble(const char* src, size_t count, float* dst) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d doubles = _mm256_loadu_pd(reinterpret_cast<const double*>(src + 8 * i));
+        _mm_storeu_ps(dst + i, _mm256_cvtpd_ps(doubles));
+    }
+    return i;
+}
+
+#elif defined(TILEDATAKERNELS_USE_SSE2)
+
+size_t convertUnsignedByte(const char* src, size_t count, float* dst) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i low = _mm_unpacklo_epi8(bytes, zero);
+        __m128i high = _mm_unpackhi_epi8(bytes, zero);
+        _mm_storeu_ps(dst + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)));
+        _mm_storeu_ps(dst + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)));
+        _mm_storeu_ps(dst + i + 8, _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)));
+        _mm_storeu_ps(dst + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)));
+    }
+    return i;
+}
+
+size_t convertUnsignedShort(const char* src, size_t count, float* dst) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i shorts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i));
+        _mm_storeu_ps(dst + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(shorts, zero)));
+        _mm_storeu_ps(dst + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(shorts, zero)));
+    }
+    return i;
+}
+
+size_t convertShort(const char* src, size_t count, float* dst) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i shorts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i));
+        // Sign extend by moving each short to the upper half and shifting it back
+        __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(shorts, shorts), 16);
+        __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(shorts, shorts), 16);
+        _mm_storeu_ps(dst + i, _mm_cvtepi32_ps(low));
+        _mm_storeu_ps(dst + i + 4, _mm_cvtepi32_ps(high));
+    }
+    return i;
+}
+
+size_t convertInt(const char* src, size_t count, float* dst) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i ints = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * i));
+        _mm_storeu_ps(dst + i, _mm_cvtepi32_ps(ints));
+    }
+    return i;
+}
+
+size_t convertDouble(const char* src, size_t count, float* dst) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const double* doubles = reinterpret_cast<const double*>(src + 8 * i);
+        __m128 low = _mm_cvtpd_ps(_mm_loadu_pd(doubles));
+        __m128 high = _mm_cvtpd_ps(_mm_loadu_pd(doubles + 2));
+        _mm_storeu_ps(dst + i, _mm_movelh_ps(low, high));
+    }
+    return i;
+}
+
+#else
+
+size_t convertUnsignedByte(const char*, size_t, float*) { return 0; }
+size_t convertUnsignedShort(const char*, size_t, float*) { return 0; }
+size_t convertShort(const char*, size_t, float*) { return 0; }
+size_t convertInt(const char*, size_t, float*) { return 0; }
+size_t convertDouble(const char*, size_t, float*) { return 0; }
+
+#endif
+
+void accumulateStatisticsScalar(float* values, size_t begin, size_t count,
+                                size_t nRasters, float noDataValue,
+                                bool replaceMissingData, RasterStatistics* statistics)
+{
+    for (size_t i = begin; i < count; ++i) {
+        RasterStatistics& s = statistics[i % nRasters];
+        float value = values[i];
+        if (value != noDataValue && value == value) {
+            s.min = std::min(s.min, value);
+            s.max = std::max(s.max, value);
+        }
+        else {
+            s.hasMissingData = true;
+            if (replaceMissingData) {
+                values[i] = -FLT_MAX;
+            }
+        }
+    }
+}
+
+} // namespace
+
+bool RasterStatistics::hasData() const {
+    return min <= max;
+}
+
+void convertToFloat(GLenum glType, const char* src, size_t count, float* dst) {
+    switch (glType) {
+        case GL_UNSIGNED_BYTE: {
+            size_t i = convertUnsignedByte(src, count, dst);
+            convertScalar<GLubyte>(src + i, count - i, dst + i);
+            break;
+        }
+        case GL_UNSIGNED_SHORT:
+        // interpretFloat reads half floats as their unsigned short bit pattern
+        case GL_HALF_FLOAT: {
+            size_t i = convertUnsignedShort(src, count, dst);
+            convertScalar<GLushort>(src + 2 * i, count - i, dst + i);
+            break;
+        }
+        case GL_SHORT: {
+            size_t i = convertShort(src, count, dst);
+            convertScalar<GLshort>(src + 2 * i, count - i, dst + i);
+            break;
+        }
+        case GL_UNSIGNED_INT:
+            // There is no vectorized unsigned to float conversion before AVX-512
+            convertScalar<GLuint>(src, count, dst);
+            break;
+        case GL_INT: {
+            size_t i = convertInt(src, count, dst);
+            convertScalar<GLint>(src + 4 * i, count - i, dst + i);
+            break;
+        }
+        case GL_FLOAT:
+            std::memcpy(dst, src, count * sizeof(float));
+            break;
+        case GL_DOUBLE: {
+            size_t i = convertDouble(src, count, dst);
+            convertScalar<GLdouble>(src + 8 * i, count - i, dst + i);
+            break;
+        }
+        default: {
+            ghoul_assert(false, "Unknown data type");
+            throw ghoul::MissingCaseException();
+        }
+    }
+}
+
+void accumulateStatistics(float* values, size_t nPixels, size_t nRasters,
+                          float noDataValue, bool replaceMissingData,
+                          RasterStatistics* statistics)
+{
+    ghoul_assert(nRasters > 0, "Need at least one raster");
+
+    const size_t count = nPixels * nRasters;
+    size_t i = 0;
+
+#if defined(TILEDATAKERNELS_USE_AVX2) || defined(TILEDATAKERNELS_USE_SSE2)
+#if defined(TILEDATAKERNELS_USE_AVX2)
+    constexpr const size_t Lanes = 8;
+    using Vector = __m256;
+    auto set1 = [](float v) { return _mm256_set1_ps(v); };
+    auto load = [](const float* p) { return _mm256_loadu_ps(p); };
+    auto store = [](float* p, Vector v) { _mm256_storeu_ps(p, v); };
+    auto isValid = [](Vector v, Vector noData) {
+        // Unordered not-equal is true for NaN, which the ordered test then removes
+        return _mm256_and_ps(
+            _mm256_cmp_ps(v, noData, _CMP_NEQ_UQ),
+            _mm256_cmp_ps(v, v, _CMP_ORD_Q)
+        );
+    };
+    auto select = [](Vector mask, Vector a, Vector b) {
+        return _mm256_blendv_ps(b, a, mask);
+    };
+    auto allSet = [](Vector mask) { return _mm256_movemask_ps(mask) == 0xff; };
+    auto minimum = [](Vector a, Vector b) { return _mm256_min_ps(a, b); };
+    auto maximum = [](Vector a, Vector b) { return _mm256_max_ps(a, b); };
+    auto orMask = [](Vector a, Vector b) { return _mm256_or_ps(a, b); };
+    auto notMask = [](Vector mask) {
+        return _mm256_xor_ps(mask, _mm256_castsi256_ps(_mm256_set1_epi32(-1)));
+    };
+    auto zero = []() { return _mm256_setzero_ps(); };
+#else
+    constexpr const size_t Lanes = 4;
+    using Vector = __m128;
+    auto set1 = [](float v) { return _mm_set1_ps(v); };
+    auto load = [](const float* p) { return _mm_loadu_ps(p); };
+    auto store = [](float* p, Vector v) { _mm_storeu_ps(p, v); };
+    auto isValid = [](Vector v, Vector noData) {
+        // Unordered not-equal is true for NaN, which the ordered test then removes
+        return _mm_and_ps(_mm_cmpneq_ps(v, noData), _mm_cmpord_ps(v, v));
+    };
+    auto select = [](Vector mask, Vector a, Vector b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    };
+    auto allSet = [](Vector mask) { return _mm_movemask_ps(mask) == 0xf; };
+    auto minimum = [](Vector a, Vector b) { return _mm_min_ps(a, b); };
+    auto maximum = [](Vector a, Vector b) { return _mm_max_ps(a, b); };
+    auto orMask = [](Vector a, Vector b) { return _mm_or_ps(a, b); };
+    auto notMask = [](Vector mask) {
+        return _mm_xor_ps(mask, _mm_castsi128_ps(_mm_set1_epi32(-1)));
+    };
+    auto zero = []() { return _mm_setzero_ps(); };
+#endif
+
+    // Every lane always holds the same raster if the rasters evenly divide the lanes
+    if (Lanes % nRasters == 0) {
+        const Vector noData = set1(noDataValue);
+        const Vector largest = set1(FLT_MAX);
+        const Vector lowest = set1(-FLT_MAX);
+        Vector minValues = largest;
+        Vector maxValues = lowest;
+        Vector missing = zero();
+
+        for (; i + Lanes <= count; i += Lanes) {
+            Vector v = load(values + i);
+            Vector valid = isValid(v, noData);
+            minValues = minimum(minValues, select(valid, v, largest));
+            maxValues = maximum(maxValues, select(valid, v, lowest));
+            if (!allSet(valid)) {
+                missing = orMask(missing, notMask(valid));
+                if (replaceMissingData) {
+                    store(values + i, select(valid, v, lowest));
+                }
+            }
+        }
+
+        alignas(32) float laneMin[Lanes];
+        alignas(32) float laneMax[Lanes];
+        alignas(32) float laneMissing[Lanes];
+        store(laneMin, minValues);
+        store(laneMax, maxValues);
+        store(laneMissing, missing);
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            RasterStatistics& s = statistics[lane % nRasters];
+            s.min = std::min(s.min, laneMin[lane]);
+            s.max = std::max(s.max, laneMax[lane]);
+            uint32_t missingBits;
+            std::memcpy(&missingBits, &laneMissing[lane], sizeof(uint32_t));
+            s.hasMissingData |= (missingBits != 0);
+        }
+    }
+#endif
+
+    accumulateStatisticsScalar(
+        values,
+        i,
+        count,
+        nRasters,
+        noDataValue,
+        replaceMissingData,
+        statistics
+    );
+}
+
+void copyToMappedBuffer(char* dst, const char* src, size_t numBytes) {
+#if defined(TILEDATAKERNELS_USE_AVX2) || defined(TILEDATAKERNELS_USE_SSE2)
+    constexpr const size_t Alignment = 16;
+    const size_t misalignment = reinterpret_cast<uintptr_t>(dst) % Alignment;
+    if (misalignment != 0) {
+        const size_t head = std::min(Alignment - misalignment, numBytes);
+        std::memcpy(dst, src, head);
+        dst += head;
+        src += head;
+        numBytes -= head;
+    }
+
+    size_t i = 0;
+    for (; i + 4 * Alignment <= numBytes; i += 4 * Alignment) {
+        const __m128i* s = reinterpret_cast<const __m128i*>(src + i);
+        __m128i* d = reinterpret_cast<__m128i*>(dst + i);
+        __m128i a = _mm_loadu_si128(s);
+        __m128i b = _mm_loadu_si128(s + 1);
+        __m128i c = _mm_loadu_si128(s + 2);
+        __m128i e = _mm_loadu_si128(s + 3);
+        _mm_stream_si128(d, a);
+        _mm_stream_si128(d + 1, b);
+        _mm_stream_si128(d + 2, c);
+        _mm_stream_si128(d + 3, e);
+    }
+    // Make the non-temporal stores visible before the buffer is unmapped
+    _mm_sfence();
+    std::memcpy(dst + i, src + i, numBytes - i);
+#else
+    std::memcpy(dst, src, numBytes);
+#endif
+}
+
+} // namespace openspace::globebrowsing::tiledatakernels
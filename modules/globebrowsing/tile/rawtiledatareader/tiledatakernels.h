@@ -0,0 +1,77 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___TILE_DATA_KERNELS___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___TILE_DATA_KERNELS___H__
+
+#include <ghoul/opengl/ghoul_gl.h>
+
+#include <cfloat>
+#include <cstddef>
+
+/**
+ * The kernels in this file are vectorized using AVX2 if the module is compiled with AVX2
+ * enabled, using SSE2 on all other x86 targets and fall back to scalar code otherwise.
+ * All variants produce identical results.
+ */
+
+namespace openspace::globebrowsing::tiledatakernels {
+
+/// The value range and missing data of one raster of a tile
+struct RasterStatistics {
+    float min = FLT_MAX;
+    float max = -FLT_MAX;
+    bool hasMissingData = false;
+
+    /// Returns <code>true</code> if at least one value of the raster was not missing
+    bool hasData() const;
+};
+
+/**
+ * Converts <code>count</code> consecutive values of type <code>glType</code> starting at
+ * <code>src</code> to floats and writes them to <code>dst</code>. Every value is
+ * converted in the same way as by <code>tiledatatype::interpretFloat</code>.
+ */
+void convertToFloat(GLenum glType, const char* src, size_t count, float* dst);
+
+/**
+ * Updates the <code>statistics</code> of the <code>nRasters</code> interleaved rasters
+ * in <code>values</code>, which contains <code>nPixels</code> pixels. Values that are
+ * equal to <code>noDataValue</code> or NaN are counted as missing data and are replaced
+ * with <code>-FLT_MAX</code> if <code>replaceMissingData</code> is <code>true</code>.
+ * \param statistics has to point to <code>nRasters</code> elements
+ */
+void accumulateStatistics(float* values, size_t nPixels, size_t nRasters,
+    float noDataValue, bool replaceMissingData, RasterStatistics* statistics);
+
+/**
+ * Copies <code>numBytes</code> from <code>src</code> to <code>dst</code>, which is
+ * assumed to be a mapped pixel buffer. Mapped buffers are usually write-combined
+ * memory, so if possible non-temporal stores are used that bypass the cache.
+ */
+void copyToMappedBuffer(char* dst, const char* src, size_t numBytes);
+
+} // namespace openspace::globebrowsing::tiledatakernels
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___TILE_DATA_KERNELS___H__
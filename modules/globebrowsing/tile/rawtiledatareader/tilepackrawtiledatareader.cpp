@@ -0,0 +1,136 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/tile/rawtiledatareader/tilepackrawtiledatareader.h>
+
+#include <modules/globebrowsing/cache/tilepackfile.h>
+
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+
+#include <cstring>
+#include <limits>
+
+namespace openspace::globebrowsing {
+
+TilePackRawTileDataReader::TilePackRawTileDataReader(const std::string& filePath,
+        const TileTextureInitData& initData,
+        RawTileDataReader::PerformPreprocessing preprocess)
+    : RawTileDataReader(initData, preprocess)
+    , _packFilePath(filePath)
+{
+    initialize();
+}
+
+std::shared_ptr<RawTile> TilePackRawTileDataReader::readTileData(TileIndex tileIndex,
+    char* dataDestination, char* pboMappedDataDestination) const
+{
+    std::shared_ptr<RawTile> rawTile = _tilePackFile->readTile(
+        tileIndex,
+        dataDestination,
+        pboMappedDataDestination
+    );
+    if (rawTile) {
+        return rawTile;
+    }
+
+    // The tile was not baked, which is treated the same way as a failed read
+    const size_t numBytes = _initData.totalNumBytes();
+    if (dataDestination) {
+        std::memset(dataDestination, 255, numBytes);
+    }
+    if (pboMappedDataDestination) {
+        std::memset(pboMappedDataDestination, 255, numBytes);
+    }
+    rawTile = std::make_shared<RawTile>();
+    rawTile->imageData = dataDestination;
+    rawTile->error = RawTile::ReadError::Failure;
+    rawTile->tileIndex = tileIndex;
+    rawTile->textureInitData = std::make_shared<TileTextureInitData>(_initData);
+    return rawTile;
+}
+
+void TilePackRawTileDataReader::reset() {
+    // Dropping the previous pack file first makes sure that it is not mapped twice
+    _tilePackFile = nullptr;
+    initialize();
+}
+
+int TilePackRawTileDataReader::maxChunkLevel() const {
+    return _tilePackFile->datasetInfo().maxChunkLevel;
+}
+
+float TilePackRawTileDataReader::noDataValueAsFloat() const {
+    return _tilePackFile->datasetInfo().noDataValue;
+}
+
+int TilePackRawTileDataReader::rasterXSize() const {
+    return _tilePackFile->datasetInfo().rasterXSize;
+}
+
+int TilePackRawTileDataReader::rasterYSize() const {
+    return _tilePackFile->datasetInfo().rasterYSize;
+}
+
+int TilePackRawTileDataReader::dataSourceNumRasters() const {
+    return _tilePackFile->datasetInfo().nRasters;
+}
+
+float TilePackRawTileDataReader::depthOffset() const {
+    return _tilePackFile->datasetInfo().depthOffset;
+}
+
+float TilePackRawTileDataReader::depthScale() const {
+    return _tilePackFile->datasetInfo().depthScale;
+}
+
+void TilePackRawTileDataReader::initialize() {
+    _tilePackFile = std::make_shared<cache::TilePackFile>(
+        _packFilePath,
+        _initData,
+        std::numeric_limits<size_t>::max(),
+        cache::TilePackFile::ReadOnly::Yes
+    );
+    if (!_tilePackFile->hasDatasetInfo()) {
+        throw ghoul::RuntimeError(
+            "Tile pack file '" + _packFilePath + "' was not created by a "
+            "TilePyramidBakeTask",
+            "TilePackRawTileDataReader"
+        );
+    }
+
+    const cache::TilePackFile::DatasetInfo& info = _tilePackFile->datasetInfo();
+    _cached._maxLevel = info.maxChunkLevel;
+    _depthTransform.depthOffset = info.depthTransformOffset;
+    _depthTransform.depthScale = info.depthTransformScale;
+}
+
+RawTile::ReadError TilePackRawTileDataReader::rasterRead(int, const IODescription&,
+                                                         char*) const
+{
+    ghoul_assert(false, "Tiles are read from the pack file as a whole");
+    return RawTile::ReadError::Fatal;
+}
+
+} // namespace openspace::globebrowsing
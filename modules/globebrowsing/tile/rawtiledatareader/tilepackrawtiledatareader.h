@@ -0,0 +1,81 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___TILE_PACK_RAW_TILE_DATA_READER___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___TILE_PACK_RAW_TILE_DATA_READER___H__
+
+#include <modules/globebrowsing/tile/rawtiledatareader/rawtiledatareader.h>
+
+#include <memory>
+#include <string>
+
+namespace openspace::globebrowsing {
+
+namespace cache { class TilePackFile; }
+
+/**
+ * Serves tiles from a pack file that was created by the
+ * <code>TilePyramidBakeTask</code>. The pack file is memory mapped and each tile is
+ * copied directly from the mapping to its destination, without opening the original
+ * dataset. Tiles that were not baked are returned with the error
+ * <code>RawTile::ReadError::Failure</code>.
+ */
+class TilePackRawTileDataReader : public RawTileDataReader {
+public:
+    /**
+     * \throw ghoul::RuntimeError If the pack file does not exist, does not contain
+     *        information about its dataset or was baked with different texture
+     *        settings than \p initData
+     */
+    TilePackRawTileDataReader(const std::string& filePath,
+        const TileTextureInitData& initData,
+        RawTileDataReader::PerformPreprocessing preprocess =
+            RawTileDataReader::PerformPreprocessing::No);
+
+    virtual std::shared_ptr<RawTile> readTileData(TileIndex tileIndex,
+        char* dataDestination, char* pboMappedDataDestination) const override;
+
+    // Public virtual function overloading
+    virtual void reset() override;
+    virtual int maxChunkLevel() const override;
+    virtual float noDataValueAsFloat() const override;
+    virtual int rasterXSize() const override;
+    virtual int rasterYSize() const override;
+    virtual int dataSourceNumRasters() const override;
+    virtual float depthOffset() const override;
+    virtual float depthScale() const override;
+
+private:
+    // Private virtual function overloading
+    virtual void initialize() override;
+    virtual RawTile::ReadError rasterRead(
+        int rasterBand, const IODescription& io, char* dst) const override;
+
+    std::string _packFilePath;
+    std::shared_ptr<cache::TilePackFile> _tilePackFile;
+};
+
+} // namespace openspace::globebrowsing
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___TILE_PACK_RAW_TILE_DATA_READER___H__
@@ -24,13 +24,82 @@
 
 #include <modules/globebrowsing/tile/tileloadjob.h>
 
+#include <modules/globebrowsing/cache/tilepackfile.h>
 #include <modules/globebrowsing/tile/rawtiledatareader/rawtiledatareader.h>
+#include <modules/globebrowsing/tile/rawtiledatareader/tiledatakernels.h>
+
+#include <modules/globebrowsing/tile/tiletextureinitdata.h>
+
+#include <algorithm>
+#include <cstring>
 
 namespace openspace::globebrowsing {
 
+TileReadBatch::TileReadBatch(std::shared_ptr<RawTileDataReader> rawTileDataReader,
+                             std::vector<TileIndex> tileIndices)
+    : _rawTileDataReader(std::move(rawTileDataReader))
+    , _tileIndices(std::move(tileIndices))
+{}
+
+std::shared_ptr<RawTile> TileReadBatch::readTile(const TileIndex& tileIndex,
+                                                 char* dataDestination,
+                                                 char* pboMappedDataDestination)
+{
+    ghoul_assert(
+        dataDestination || pboMappedDataDestination,
+        "Need to specify a data destination"
+    );
+
+    std::call_once(_readFlag, [this]() {
+        size_t numBytes = _rawTileDataReader->tileTextureInitData().totalNumBytes();
+        std::vector<char*> dataDestinations;
+        for (size_t i = 0; i < _tileIndices.size(); ++i) {
+            _tileData.push_back(std::make_unique<char[]>(numBytes));
+            dataDestinations.push_back(_tileData.back().get());
+        }
+        _rawTiles = _rawTileDataReader->readTileDataBatch(
+            _tileIndices,
+            dataDestinations
+        );
+        if (_rawTiles.empty()) {
+            _tileData.clear();
+        }
+    });
+
+    if (_rawTiles.empty()) {
+        return nullptr;
+    }
+
+    auto it = std::find(_tileIndices.begin(), _tileIndices.end(), tileIndex);
+    ghoul_assert(it != _tileIndices.end(), "Tile must be part of the batch");
+    size_t i = std::distance(_tileIndices.begin(), it);
+    ghoul_assert(_tileData[i], "Tile must only be read once from the batch");
+
+    size_t numBytes = _rawTileDataReader->tileTextureInitData().totalNumBytes();
+    if (dataDestination) {
+        std::memcpy(dataDestination, _tileData[i].get(), numBytes);
+    }
+    if (pboMappedDataDestination) {
+        tiledatakernels::copyToMappedBuffer(
+            pboMappedDataDestination,
+            _tileData[i].get(),
+            numBytes
+        );
+    }
+    // Each tile is only read once, so its copy can be released right away
+    _tileData[i] = nullptr;
+
+    std::shared_ptr<RawTile> rawTile = std::make_shared<RawTile>(*_rawTiles[i]);
+    rawTile->imageData = dataDestination;
+    return rawTile;
+}
+
 TileLoadJob::TileLoadJob(std::shared_ptr<RawTileDataReader> rawTileDataReader,
-    const TileIndex& tileIndex)
+    const TileIndex& tileIndex, std::shared_ptr<cache::TilePackFile> tilePackFile,
+    std::shared_ptr<TileReadBatch> readBatch)
     : _rawTileDataReader(rawTileDataReader)
+    , _tilePackFile(std::move(tilePackFile))
+    , _readBatch(std::move(readBatch))
     , _chunkIndex(tileIndex)
     , _pboMappedDataDestination(nullptr)
     , _hasOwnershipOfData(false)
@@ -38,8 +107,12 @@ TileLoadJob::TileLoadJob(std::shared_ptr<RawTileDataReader> rawTileDataReader,
 
 
 TileLoadJob::TileLoadJob(std::shared_ptr<RawTileDataReader> rawTileDataReader,
-    const TileIndex& tileIndex, char* pboDataPtr)
+    const TileIndex& tileIndex, char* pboDataPtr,
+    std::shared_ptr<cache::TilePackFile> tilePackFile,
+    std::shared_ptr<TileReadBatch> readBatch)
     : _rawTileDataReader(rawTileDataReader)
+    , _tilePackFile(std::move(tilePackFile))
+    , _readBatch(std::move(readBatch))
     , _chunkIndex(tileIndex)
     , _pboMappedDataDestination(pboDataPtr)
     , _hasOwnershipOfData(false)
@@ -61,8 +134,48 @@ void TileLoadJob::execute() {
         dataPtr = new char[numBytes];
         _hasOwnershipOfData = true;
     }
-    _rawTile = _rawTileDataReader->readTileData(
-        _chunkIndex, dataPtr, _pboMappedDataDestination);
+
+    if (_tilePackFile) {
+        _rawTile = _tilePackFile->readTile(
+            _chunkIndex, dataPtr, _pboMappedDataDestination);
+        if (_rawTile) {
+            return;
+        }
+
+        // The pixel buffer is mapped write-only, so the tile needs to be read to CPU
+        // memory first in order to be written to the pack file
+        std::unique_ptr<char[]> tmpData;
+        if (!dataPtr) {
+            tmpData = std::make_unique<char[]>(numBytes);
+        }
+        char* readDestination = dataPtr ? dataPtr : tmpData.get();
+        _rawTile = readTile(readDestination);
+        if (_rawTile->error == RawTile::ReadError::None) {
+            _tilePackFile->writeTile(*_rawTile, readDestination);
+        }
+        _rawTile->imageData = dataPtr;
+        return;
+    }
+
+    _rawTile = readTile(dataPtr);
+}
+
+std::shared_ptr<RawTile> TileLoadJob::readTile(char* dataDestination) {
+    if (_readBatch) {
+        std::shared_ptr<RawTile> rawTile = _readBatch->readTile(
+            _chunkIndex,
+            dataDestination,
+            _pboMappedDataDestination
+        );
+        if (rawTile) {
+            return rawTile;
+        }
+    }
+    return _rawTileDataReader->readTileData(
+        _chunkIndex,
+        dataDestination,
+        _pboMappedDataDestination
+    );
 }
 
 std::shared_ptr<RawTile> TileLoadJob::product() {
@@ -28,20 +28,60 @@
 #include <modules/globebrowsing/tile/tile.h>
 #include <openspace/util/concurrentjobmanager.h>
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace openspace::globebrowsing {
 
 class RawTileDataReader;
 struct RawTile;
 
+namespace cache { class TilePackFile; }
+
+/**
+ * Shared by the <code>TileLoadJob</code>s of neighbouring tiles whose reads should be
+ * coalesced into a single read of the dataset. The first job of the batch that executes
+ * reads all tiles of the batch and the remaining jobs only copy their tile.
+ */
+class TileReadBatch {
+public:
+    TileReadBatch(std::shared_ptr<RawTileDataReader> rawTileDataReader,
+        std::vector<TileIndex> tileIndices);
+
+    /**
+     * Writes the tile <code>tileIndex</code>, which has to be part of this batch, to the
+     * given data destinations, reading the whole batch first if needed. At least one of
+     * the destinations has to be specified.
+     * \returns the read tile or nullptr if the reads could not be coalesced, in which
+     * case the tile has to be read on its own.
+     */
+    std::shared_ptr<RawTile> readTile(const TileIndex& tileIndex,
+        char* dataDestination, char* pboMappedDataDestination);
+
+private:
+    std::shared_ptr<RawTileDataReader> _rawTileDataReader;
+    std::vector<TileIndex> _tileIndices;
+
+    std::once_flag _readFlag;
+    std::vector<std::unique_ptr<char[]>> _tileData;
+    std::vector<std::shared_ptr<RawTile>> _rawTiles;
+};
+
 struct TileLoadJob : public Job<RawTile> {
     /**
      * Allocates enough data for one tile. When calling <code>product()</code>, the
      * ownership of this data will be released. If <code>product()</code> has not been
      * called before the TileLoadJob is finished, the data will be deleted as it has not
-     * been exposed outside of this object.
+     * been exposed outside of this object. If a <code>tilePackFile</code> is provided,
+     * the tile is read from it if possible and written to it after reading it from
+     * <code>rawTileDataReader</code> otherwise. If a <code>readBatch</code> is
+     * provided, the tile is read together with the other tiles of the batch.
      */
     TileLoadJob(std::shared_ptr<RawTileDataReader> rawTileDataReader,
-        const TileIndex& tileIndex);
+        const TileIndex& tileIndex,
+        std::shared_ptr<cache::TilePackFile> tilePackFile = nullptr,
+        std::shared_ptr<TileReadBatch> readBatch = nullptr);
 
     /**
      * No data is allocated unless specified so by the TileTextureInitData of
@@ -49,7 +89,9 @@ struct TileLoadJob : public Job<RawTile> {
      * buffer object.
      */
     TileLoadJob(std::shared_ptr<RawTileDataReader> rawTileDataReader,
-        const TileIndex& tileIndex, char* pboDataPtr);
+        const TileIndex& tileIndex, char* pboDataPtr,
+        std::shared_ptr<cache::TilePackFile> tilePackFile = nullptr,
+        std::shared_ptr<TileReadBatch> readBatch = nullptr);
 
     /**
      * Destroys the allocated data pointer if it has been allocated and the TileLoadJob
@@ -80,7 +122,15 @@ struct TileLoadJob : public Job<RawTile> {
     bool hasOwnershipOfData() const;
 
 protected:
+    /**
+     * Reads the tile from the batch it is part of, if any, or from the
+     * <code>RawTileDataReader</code> otherwise.
+     */
+    std::shared_ptr<RawTile> readTile(char* dataDestination);
+
     std::shared_ptr<RawTileDataReader> _rawTileDataReader;
+    std::shared_ptr<cache::TilePackFile> _tilePackFile;
+    std::shared_ptr<TileReadBatch> _readBatch;
     std::shared_ptr<RawTile> _rawTile;
     TileIndex _chunkIndex;
     char* _pboMappedDataDestination;
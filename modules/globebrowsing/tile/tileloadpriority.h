@@ -0,0 +1,58 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___TILE_LOAD_PRIORITY___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___TILE_LOAD_PRIORITY___H__
+
+namespace openspace::globebrowsing {
+
+/**
+ * Tiles are requested through the <code>TileProvider</code>s, which do not know which
+ * <code>Chunk</code> the tiles are requested for. While a
+ * <code>TileLoadPriorityScope</code> is alive, tile loads that are requested on the same
+ * thread get the priority of the scope, which the <code>ChunkedLodGlobe</code> bases on
+ * the projected area of the chunk that is being updated or rendered. Scopes can be
+ * nested, in which case the innermost scope determines the priority.
+ */
+class TileLoadPriorityScope {
+public:
+    explicit TileLoadPriorityScope(float priority);
+    ~TileLoadPriorityScope();
+
+    TileLoadPriorityScope(const TileLoadPriorityScope&) = delete;
+    TileLoadPriorityScope& operator=(const TileLoadPriorityScope&) = delete;
+
+    /**
+     * \returns the priority of the innermost scope on the calling thread, or 0 if there
+     * is no scope on the calling thread.
+     */
+    static float currentPriority();
+
+private:
+    float _previousPriority;
+};
+
+} // namespace openspace::globebrowsing
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___TILE_LOAD_PRIORITY___H__
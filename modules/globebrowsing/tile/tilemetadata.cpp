@@ -24,9 +24,14 @@
 
 #include <modules/globebrowsing/tile/tilemetadata.h>
 
+#include <iomanip>
+#include <limits>
+
 namespace openspace::globebrowsing {
 
-void TileMetaData::serialize(std::ostream& os) {
+void TileMetaData::serialize(std::ostream& os) const {
+    // Make sure the values survive a round trip through the text representation
+    os << std::setprecision(std::numeric_limits<float>::max_digits10);
     os << maxValues.size() << std::endl;
     for (float f : maxValues) {
         os << f << " ";
@@ -36,6 +41,10 @@ void TileMetaData::serialize(std::ostream& os) {
         os << f << " ";
     }
     os << std::endl;
+    for (bool b : hasMissingData) {
+        os << b << " ";
+    }
+    os << std::endl;
 }
 
 TileMetaData TileMetaData::deserialize(std::istream& is) {
@@ -49,6 +58,12 @@ TileMetaData TileMetaData::deserialize(std::istream& is) {
     for (int i = 0; i < n; i++) {
         is >> res.minValues[i];
     }
+    res.hasMissingData.resize(n);
+    for (int i = 0; i < n; i++) {
+        bool b;
+        is >> b;
+        res.hasMissingData[i] = b;
+    }
 
     return res;
 }
@@ -35,7 +35,7 @@ struct TileMetaData {
     std::vector<float> minValues;
     std::vector<bool> hasMissingData;
 
-    void serialize(std::ostream& s);
+    void serialize(std::ostream& s) const;
     static TileMetaData deserialize(std::istream& s);
 };
 
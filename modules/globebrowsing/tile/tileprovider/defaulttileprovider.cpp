@@ -26,12 +26,14 @@
 
 #include <modules/globebrowsing/globebrowsingmodule.h>
 #include <modules/globebrowsing/cache/memoryawaretilecache.h>
+#include <modules/globebrowsing/cache/tilepackfile.h>
 #include <modules/globebrowsing/rendering/layer/layergroupid.h>
 #include <modules/globebrowsing/rendering/layer/layermanager.h>
 #include <modules/globebrowsing/tile/asynctiledataprovider.h>
 #include <modules/globebrowsing/tile/rawtiledatareader/gdalrawtiledatareader.h>
 #include <modules/globebrowsing/tile/rawtiledatareader/simplerawtiledatareader.h>
 #include <modules/globebrowsing/tile/rawtiledatareader/rawtiledatareader.h>
+#include <modules/globebrowsing/tile/rawtiledatareader/tilepackrawtiledatareader.h>
 #include <modules/globebrowsing/tile/rawtile.h>
 #include <modules/globebrowsing/tile/rawtiledatareader/iodescription.h>
 
@@ -54,7 +56,8 @@ namespace {
         "FilePath",
         "File Path",
         "The path of the GDAL file or the image file that is to be used in this tile "
-        "provider."
+        "provider. This can also be a tile pack file (.pack) created by the "
+        "TilePyramidBakeTask."
     };
 
     static const openspace::properties::Property::PropertyInfo TilePixelSizeInfo = {
@@ -65,6 +68,17 @@ namespace {
         "(smaller images). The tile pixel size has to be smaller than the size of the "
         "complete image if a single image is used."
     };
+
+    // Tile pack files are created by the TilePyramidBakeTask
+    bool isTilePackFile(const std::string& filePath) {
+        const std::string extension = ".pack";
+        return filePath.size() > extension.size() &&
+            filePath.compare(
+                filePath.size() - extension.size(),
+                extension.size(),
+                extension
+            ) == 0;
+    }
 }
 
 namespace openspace::globebrowsing::tileprovider {
@@ -223,23 +237,44 @@ void DefaultTileProvider::initAsyncTileDataReader(TileTextureInitData initData)
         RawTileDataReader::PerformPreprocessing::No;
 
     // Initialize instance variables
+    std::shared_ptr<RawTileDataReader> tileDataset;
+    std::shared_ptr<cache::TilePackFile> tilePackFile;
+    if (isTilePackFile(_filePath)) {
+        // Pre-baked tiles are already on disk and do not need another cache
+        tileDataset = std::make_shared<TilePackRawTileDataReader>(
+            _filePath,
+            initData,
+            preprocess
+        );
+    }
+    else {
 #ifdef GLOBEBROWSING_USE_GDAL
-    auto tileDataset = std::make_shared<GdalRawTileDataReader>(
-        _filePath,
-        initData,
-        preprocess
-    );
+        tileDataset = std::make_shared<GdalRawTileDataReader>(
+            _filePath,
+            initData,
+            preprocess
+        );
 #else // GLOBEBROWSING_USE_GDAL
-    auto tileDataset = std::make_shared<SimpleRawTileDataReader>(
-        _filePath,
-        initData,
-        preprocess
-    );
+        tileDataset = std::make_shared<SimpleRawTileDataReader>(
+            _filePath,
+            initData,
+            preprocess
+        );
 #endif // GLOBEBROWSING_USE_GDAL
 
+        // Tiles are cached on disk between sessions so that they do not have to be
+        // read from the dataset again
+        tilePackFile = OsEng.moduleEngine().module<GlobeBrowsingModule>()->tilePackFile(
+            _filePath,
+            initData,
+            _performPreProcessing
+        );
+    }
+
     _asyncTextureDataProvider = std::make_shared<AsyncTileDataProvider>(
         _name,
-        tileDataset
+        tileDataset,
+        tilePackFile
     );
 
     // Tiles are only available for levels 2 and higher.
@@ -26,8 +26,13 @@
 
 #include <modules/globebrowsing/tile/tileprovider/temporaltileprovider.h>
 
+#include <modules/globebrowsing/globebrowsingmodule.h>
+#include <modules/globebrowsing/cache/memoryawaretilecache.h>
 #include <modules/globebrowsing/tile/tileprovider/defaulttileprovider.h>
 
+#include <openspace/engine/openspaceengine.h>
+#include <openspace/engine/moduleengine.h>
+
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
@@ -272,8 +277,15 @@ void TemporalTileProvider::ensureUpdated() {
 void TemporalTileProvider::update() {
     if (_successfulInitialization) {
         std::shared_ptr<TileProvider> newCurrent = getTileProvider();
-        if (newCurrent) {
+        if (newCurrent && newCurrent != _currentTileProvider) {
             _currentTileProvider = newCurrent;
+            // The tiles of the new provider might already be cached, in which case
+            // the cache would not otherwise notice that the available tiles changed
+            cache::MemoryAwareTileCache* tileCache =
+                OsEng.moduleEngine().module<GlobeBrowsingModule>()->tileCache();
+            if (tileCache) {
+                tileCache->increaseGeneration();
+            }
         }
         _currentTileProvider->update();
     }
@@ -101,6 +101,10 @@ void TextTileProvider::reset() {
 
 Tile TextTileProvider::createChunkIndexTile(const TileIndex& tileIndex) {
     ghoul::opengl::Texture* texture = _tileCache->getTexture(_initData);
+    if (!texture) {
+        // All textures of this type are in use and there was no cached tile to evict
+        return Tile::TileUnavailable;
+    }
 
     // Keep track of defaultFBO and viewport to be able to reset state when done
     GLint defaultFBO;
@@ -33,6 +33,7 @@
 #include <modules/kameleonvolume/tasks/kameleonmetadatatojsontask.h>
 #include <modules/kameleonvolume/tasks/kameleondocumentationtask.h>
 #include <modules/kameleonvolume/tasks/kameleonvolumetorawtask.h>
+#include <modules/kameleonvolume/tasks/kameleonvolumesequencetorawtask.h>
 
 namespace openspace {
 
@@ -51,6 +52,9 @@ void KameleonVolumeModule::internalInitialize(const ghoul::Dictionary&) {
     fTask->registerClass<KameleonMetadataToJsonTask>("KameleonMetadataToJsonTask");
     fTask->registerClass<KameleonDocumentationTask>("KameleonDocumentationTask");
     fTask->registerClass<KameleonVolumeToRawTask>("KameleonVolumeToRawTask");
+    fTask->registerClass<KameleonVolumeSequenceToRawTask>(
+        "KameleonVolumeSequenceToRawTask"
+    );
 }
 
 std::vector<documentation::Documentation> KameleonVolumeModule::documentations() const {
@@ -44,8 +44,16 @@
 #pragma warning (pop)
 #endif // WIN32
 
+#include <openspace/util/threadpool.h>
+
 #include <ghoul/fmt.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <future>
+#include <thread>
+
 namespace {
     constexpr const char* _loggerCat = "KameleonVolumeReader";
 } // namespace
@@ -68,16 +76,14 @@ KameleonVolumeReader::KameleonVolumeReader(const std::string& path)
     }
 
     _model = _kameleon.model;
-
-    // Possibly use a kameleon interpolator instead of a model interpolator?
-    _interpolator = std::unique_ptr<ccmc::Interpolator>(_model->createNewInterpolator());
 }
 
 std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
     const glm::uvec3 & dimensions,
     const std::string & variable,
     const glm::vec3 & lowerDomainBound,
-    const glm::vec3 & upperDomainBound) const
+    const glm::vec3 & upperDomainBound,
+    unsigned int nThreads) const
 {
     float min, max;
     return readFloatVolume(
@@ -86,7 +92,8 @@ std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
         lowerDomainBound,
         upperDomainBound,
         min,
-        max
+        max,
+        nThreads
     );
 }
 
@@ -96,45 +103,148 @@ std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
                                                             const glm::vec3 & lowerBound,
                                                             const glm::vec3 & upperBound,
                                                             float& minValue,
-                                                            float& maxValue) const
+                                                            float& maxValue,
+                                                            unsigned int nThreads) const
+{
+    std::vector<float> minValues;
+    std::vector<float> maxValues;
+    std::vector<std::unique_ptr<volume::RawVolume<float>>> volumes = readFloatVolumes(
+        dimensions,
+        { variable },
+        lowerBound,
+        upperBound,
+        minValues,
+        maxValues,
+        nThreads
+    );
+    minValue = minValues[0];
+    maxValue = maxValues[0];
+    return std::move(volumes[0]);
+}
+
+std::vector<std::unique_ptr<volume::RawVolume<float>>>
+KameleonVolumeReader::readFloatVolumes(const glm::uvec3& dimensions,
+                                       const std::vector<std::string>& variables,
+                                       const glm::vec3& lowerBound,
+                                       const glm::vec3& upperBound,
+                                       std::vector<float>& minValues,
+                                       std::vector<float>& maxValues,
+                                       unsigned int nThreads) const
 {
-    minValue = FLT_MAX;
-    maxValue = FLT_MIN;
+    const size_t nVariables = variables.size();
+
+    // The ids were resolved when the variables were loaded, so that the interpolation
+    // does not need to look up the variables by name for every voxel and the sampling
+    // does not access the file
+    std::vector<long> variableIds(nVariables);
+    for (size_t v = 0; v < nVariables; ++v) {
+        const auto it = _variableIds.find(variables[v]);
+        if (it == _variableIds.end()) {
+            throw ghoul::RuntimeError(fmt::format(
+                "Variable '{}' has not been loaded from '{}'", variables[v], _path
+            ));
+        }
+        variableIds[v] = it->second;
+    }
 
-    auto volume = std::make_unique<volume::RawVolume<float>>(dimensions);
-    const glm::vec3 dims = volume->dimensions();
+    std::vector<std::unique_ptr<volume::RawVolume<float>>> volumes(nVariables);
+    std::vector<float*> data(nVariables);
+    for (size_t v = 0; v < nVariables; ++v) {
+        volumes[v] = std::make_unique<volume::RawVolume<float>>(dimensions);
+        data[v] = volumes[v]->data();
+    }
+
+    // The sampling position along each axis only depends on the coordinate on that axis
+    const glm::vec3 dims = dimensions;
     const glm::vec3 diff = upperBound - lowerBound;
+    std::vector<float> positions[3];
+    for (int axis = 0; axis < 3; ++axis) {
+        positions[axis].resize(dimensions[axis]);
+        for (unsigned int i = 0; i < dimensions[axis]; ++i) {
+            positions[axis][i] =
+                lowerBound[axis] + diff[axis] * (static_cast<float>(i) / dims[axis]);
+        }
+    }
 
-    auto interpolate =
-        [this](const std::string& var, glm::vec3 volumeCoords) {
-            return _interpolator->interpolate(
-                var,
-                volumeCoords[0],
-                volumeCoords[1],
-                volumeCoords[2]);
+    struct Extremes {
+        std::vector<float> min;
+        std::vector<float> max;
+    };
+
+    // Every worker samples whole z-slices, which it takes from a shared counter to
+    // balance the load. The Kameleon interpolators are not thread safe, so each worker
+    // creates its own
+    std::atomic<unsigned int> nextSlice(0);
+    auto sampleSlices = [&]() {
+        std::unique_ptr<ccmc::Interpolator> interpolator(
+            _model->createNewInterpolator()
+        );
+        Extremes extremes = {
+            std::vector<float>(nVariables, FLT_MAX),
+            std::vector<float>(nVariables, -FLT_MAX)
         };
 
-    auto sample = [&variable, &interpolate](glm::vec3 volumeCoords) {
-        return interpolate(variable, volumeCoords);
+        const size_t sliceSize = static_cast<size_t>(dimensions.x) * dimensions.y;
+        for (unsigned int z = nextSlice++; z < dimensions.z; z = nextSlice++) {
+            size_t index = z * sliceSize;
+            for (unsigned int y = 0; y < dimensions.y; ++y) {
+                for (unsigned int x = 0; x < dimensions.x; ++x, ++index) {
+                    for (size_t v = 0; v < nVariables; ++v) {
+                        const float value = interpolator->interpolate(
+                            variableIds[v],
+                            positions[0][x],
+                            positions[1][y],
+                            positions[2][z]
+                        );
+                        data[v][index] = value;
+                        extremes.min[v] = std::min(extremes.min[v], value);
+                        extremes.max[v] = std::max(extremes.max[v], value);
+                    }
+                }
+            }
+        }
+        return extremes;
     };
 
-    float* data = volume->data();
-    for (size_t index = 0; index < volume->nCells(); index++) {
-        glm::vec3 coords = volume->indexToCoords(index);
-        glm::vec3 coordsZeroToOne = coords / dims;
-        glm::vec3 volumeCoords = lowerBound + diff * coordsZeroToOne;
-
-        data[index] = sample(volumeCoords);
+    if (nThreads == 0) {
+        nThreads = std::thread::hardware_concurrency();
+    }
+    nThreads = std::max(std::min(nThreads, dimensions.z), 1u);
+    ThreadPool pool(nThreads);
+    std::vector<std::future<Extremes>> results;
+    for (unsigned int i = 0; i < nThreads; ++i) {
+        results.push_back(pool.submit(sampleSlices));
+    }
 
-        if (data[index] < minValue) {
-            minValue = data[index];
-        }
-        if (data[index] > maxValue) {
-            maxValue = data[index];
+    minValues.assign(nVariables, FLT_MAX);
+    maxValues.assign(nVariables, -FLT_MAX);
+    for (std::future<Extremes>& result : results) {
+        const Extremes extremes = result.get();
+        for (size_t v = 0; v < nVariables; ++v) {
+            minValues[v] = std::min(minValues[v], extremes.min[v]);
+            maxValues[v] = std::max(maxValues[v], extremes.max[v]);
         }
     }
 
-    return volume;
+    return volumes;
+}
+
+bool KameleonVolumeReader::loadVariable(const std::string& variable) const {
+    if (_variableIds.find(variable) != _variableIds.end()) {
+        return true;
+    }
+
+    if (!_model->loadVariable(variable)) {
+        LERROR(fmt::format("Could not load variable '{}' from '{}'", variable, _path));
+        return false;
+    }
+    const long id = _model->getVariableID(variable);
+    if (id == -1) {
+        LERROR(fmt::format("Variable '{}' does not exist in '{}'", variable, _path));
+        return false;
+    }
+    _variableIds[variable] = id;
+    return true;
 }
 
 std::vector<std::string> KameleonVolumeReader::gridVariableNames() const {
@@ -27,6 +27,8 @@
 
 #include <string>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 #include <modules/volume/rawvolume.h>
 #include <ghoul/misc/dictionary.h>
 
@@ -57,7 +59,8 @@ public:
         const glm::uvec3& dimensions,
         const std::string& variable,
         const glm::vec3& lowerDomainBound,
-        const glm::vec3& upperDomainBound) const;
+        const glm::vec3& upperDomainBound,
+        unsigned int nThreads = 0) const;
 
     std::unique_ptr<volume::RawVolume<float>> readFloatVolume(
         const glm::uvec3& dimensions,
@@ -65,7 +68,33 @@ public:
         const glm::vec3& lowerBound,
         const glm::vec3& upperBound,
         float& minValue,
-        float& maxValue) const;
+        float& maxValue,
+        unsigned int nThreads = 0) const;
+
+    /**
+     * Resamples all \p variables onto a regular grid with the provided \p dimensions
+     * in a single pass, returning one volume per variable in the same order. The grid
+     * is split among \p nThreads threads, or all hardware threads if it is 0, each of
+     * which uses its own interpolator. The smallest and largest sampled value of each
+     * variable are written to \p minValues and \p maxValues. All \p variables have to be loaded with #loadVariable first,
+     * as this function does not access the file.
+     * \throw ghoul::RuntimeError If one of the \p variables has not been loaded
+     */
+    std::vector<std::unique_ptr<volume::RawVolume<float>>> readFloatVolumes(
+        const glm::uvec3& dimensions,
+        const std::vector<std::string>& variables,
+        const glm::vec3& lowerBound,
+        const glm::vec3& upperBound,
+        std::vector<float>& minValues,
+        std::vector<float>& maxValues,
+        unsigned int nThreads = 0) const;
+
+    /**
+     * Loads the \p variable from the file into memory unless it is already loaded and
+     * resolves its id for the resampling functions.
+     * \return <code>true</code> if the variable is available in memory
+     */
+    bool loadVariable(const std::string& variable) const;
 
     ghoul::Dictionary readMetaData() const;
 
@@ -90,8 +119,8 @@ private:
     std::string _path;
     ccmc::Kameleon _kameleon;
     ccmc::Model* _model;
-    std::unique_ptr<ccmc::Interpolator> _interpolator;
-
+    // The ids of all variables that have been loaded successfully
+    mutable std::unordered_map<std::string, long> _variableIds;
 };
 
 } // namespace kameleonvolume
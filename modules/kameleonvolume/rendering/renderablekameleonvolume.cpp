@@ -392,6 +392,9 @@ void RenderableKameleonVolume::loadRaw(const std::string& path) {
 
 void RenderableKameleonVolume::loadCdf(const std::string& path) {
     KameleonVolumeReader reader(path);
+    if (!reader.loadVariable(_variable)) {
+        return;
+    }
 
     if (_autoValueBounds) {
         _lowerValueBound = static_cast<float>(reader.minValue(_variable));
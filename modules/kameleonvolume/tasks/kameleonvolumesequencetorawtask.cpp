@@ -0,0 +1,403 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/kameleonvolume/tasks/kameleonvolumesequencetorawtask.h>
+
+#include <modules/kameleonvolume/kameleonvolumereader.h>
+#include <modules/volume/rawvolume.h>
+#include <modules/volume/rawvolumewriter.h>
+
+#include <openspace/documentation/verifier.h>
+#include <openspace/util/threadpool.h>
+
+#include <ghoul/filesystem/file.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/dictionaryluaformatter.h>
+#include <ghoul/misc/exception.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <thread>
+
+namespace {
+    constexpr const char* _loggerCat = "KameleonVolumeSequenceToRawTask";
+
+    constexpr const char* KeyInput = "Input";
+    constexpr const char* KeyOutputDirectory = "OutputDirectory";
+    constexpr const char* KeyDimensions = "Dimensions";
+    constexpr const char* KeyVariable = "Variable";
+    constexpr const char* KeyLowerDomainBound = "LowerDomainBound";
+    constexpr const char* KeyUpperDomainBound = "UpperDomainBound";
+    constexpr const char* KeyMaxConcurrentFiles = "MaxConcurrentFiles";
+
+    constexpr const char* KeyTime = "Time";
+    constexpr const char* KeyMinValue = "MinValue";
+    constexpr const char* KeyMaxValue = "MaxValue";
+    constexpr const char* KeyVisUnit = "VisUnit";
+
+    constexpr const int DefaultMaxConcurrentFiles = 2;
+
+    // Matches a file name against a pattern in which '*' matches any sequence of
+    // characters and '?' matches any single character
+    bool matchesPattern(const char* name, const char* pattern) {
+        if (*pattern == '\0') {
+            return *name == '\0';
+        }
+        if (*pattern == '*') {
+            return matchesPattern(name, pattern + 1) ||
+                   (*name != '\0' && matchesPattern(name + 1, pattern));
+        }
+        if (*name != '\0' && (*pattern == '?' || *pattern == *name)) {
+            return matchesPattern(name + 1, pattern + 1);
+        }
+        return false;
+    }
+
+    // Returns the sorted paths of all files that match the glob pattern. Wildcards are
+    // only supported in the file name, not in the directory part of the pattern
+    std::vector<std::string> expandGlob(const std::string& glob) {
+        const size_t separator = glob.find_last_of("/\\");
+        const std::string directory = separator == std::string::npos ?
+            "." :
+            glob.substr(0, separator);
+        const std::string pattern = glob.substr(separator + 1);
+
+        if (!FileSys.directoryExists(directory)) {
+            return {};
+        }
+
+        using RawPath = ghoul::filesystem::Directory::RawPath;
+        using Recursive = ghoul::filesystem::Directory::Recursive;
+        using Sort = ghoul::filesystem::Directory::Sort;
+        ghoul::filesystem::Directory dir(directory, RawPath::Yes);
+
+        std::vector<std::string> paths;
+        for (const std::string& path : dir.read(Recursive::No, Sort::Yes)) {
+            const std::string filename = ghoul::filesystem::File(path).filename();
+            if (matchesPattern(filename.c_str(), pattern.c_str())) {
+                paths.push_back(path);
+            }
+        }
+        return paths;
+    }
+} // namespace
+
+namespace openspace {
+namespace kameleonvolume {
+
+KameleonVolumeSequenceToRawTask::KameleonVolumeSequenceToRawTask(
+                                                      const ghoul::Dictionary& dictionary)
+    : _autoDomainBounds(false)
+    , _maxConcurrentFiles(DefaultMaxConcurrentFiles)
+{
+    openspace::documentation::testSpecificationAndThrow(
+        documentation(),
+        dictionary,
+        "KameleonVolumeSequenceToRawTask"
+    );
+
+    _inputPattern = absPath(dictionary.value<std::string>(KeyInput));
+    _outputDirectory = absPath(dictionary.value<std::string>(KeyOutputDirectory));
+    _variable = dictionary.value<std::string>(KeyVariable);
+    _dimensions = glm::uvec3(dictionary.value<glm::vec3>(KeyDimensions));
+
+    if (!dictionary.getValue<glm::vec3>(KeyLowerDomainBound, _lowerDomainBound)) {
+        _autoDomainBounds = true;
+    }
+    if (!dictionary.getValue<glm::vec3>(KeyUpperDomainBound, _upperDomainBound)) {
+        _autoDomainBounds = true;
+    }
+    if (dictionary.hasKey(KeyMaxConcurrentFiles)) {
+        _maxConcurrentFiles = std::max(
+            static_cast<int>(dictionary.value<double>(KeyMaxConcurrentFiles)),
+            1
+        );
+    }
+}
+
+std::string KameleonVolumeSequenceToRawTask::description() {
+    return "Extract volumetric data from the cdf-files matching " + _inputPattern +
+        ". Write raw volume data and dictionaries with metadata into " +
+        _outputDirectory;
+}
+
+void KameleonVolumeSequenceToRawTask::perform(
+                                           const Task::ProgressCallback& progressCallback)
+{
+    std::vector<std::string> inputPaths = expandGlob(_inputPattern);
+    if (inputPaths.empty()) {
+        LWARNING(fmt::format("No cdf files match '{}'", _inputPattern));
+        progressCallback(1.f);
+        return;
+    }
+
+    if (!FileSys.directoryExists(_outputDirectory)) {
+        FileSys.createDirectory(
+            _outputDirectory,
+            ghoul::filesystem::FileSystem::Recursive::Yes
+        );
+    }
+
+    // The dictionary is written last, so a file whose dictionary exists is complete
+    const size_t nInputs = inputPaths.size();
+    inputPaths.erase(
+        std::remove_if(
+            inputPaths.begin(),
+            inputPaths.end(),
+            [this](const std::string& path) {
+                const std::string baseName = ghoul::filesystem::File(path).baseName();
+                return FileSys.fileExists(FileSys.pathByAppendingComponent(
+                    _outputDirectory,
+                    baseName + ".dictionary"
+                ));
+            }
+        ),
+        inputPaths.end()
+    );
+    if (inputPaths.size() < nInputs) {
+        LINFO(fmt::format(
+            "Skipping {} of {} files that were converted in a previous run",
+            nInputs - inputPaths.size(), nInputs
+        ));
+    }
+    if (inputPaths.empty()) {
+        progressCallback(1.f);
+        return;
+    }
+
+    // Each worker converts one file at a time, which bounds the number of volumes in
+    // memory. Since the file accesses are serialized, the workers end up in different
+    // stages of the conversion of their files
+    ThreadPool pool(
+        std::min(static_cast<size_t>(_maxConcurrentFiles), inputPaths.size())
+    );
+    std::vector<std::future<bool>> results;
+    results.reserve(inputPaths.size());
+    for (const std::string& path : inputPaths) {
+        results.push_back(pool.submit([this, path]() { return convertFile(path); }));
+    }
+
+    size_t nFailed = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (!results[i].get()) {
+            ++nFailed;
+        }
+        progressCallback(static_cast<float>(i + 1) / results.size());
+    }
+
+    if (nFailed > 0) {
+        LERROR(fmt::format(
+            "Failed to convert {} of {} files. Run the task again to retry them",
+            nFailed, inputPaths.size()
+        ));
+    }
+}
+
+bool KameleonVolumeSequenceToRawTask::convertFile(const std::string& inputPath) {
+    const std::string baseName = ghoul::filesystem::File(inputPath).baseName();
+    const std::string rawVolumePath = FileSys.pathByAppendingComponent(
+        _outputDirectory,
+        baseName + ".rawvolume"
+    );
+    const std::string dictionaryPath = FileSys.pathByAppendingComponent(
+        _outputDirectory,
+        baseName + ".dictionary"
+    );
+
+    std::unique_ptr<KameleonVolumeReader> reader;
+    try {
+        // Read stage: open the file, load the variable and collect the metadata
+        glm::vec3 lowerDomainBound = _lowerDomainBound;
+        glm::vec3 upperDomainBound = _upperDomainBound;
+        ghoul::Dictionary metadata;
+        {
+            std::lock_guard<std::mutex> guard(_fileAccessMutex);
+            reader = std::make_unique<KameleonVolumeReader>(inputPath);
+            if (!reader->loadVariable(_variable)) {
+                reader = nullptr;
+                return false;
+            }
+
+            std::vector<std::string> gridVariables = reader->gridVariableNames();
+            if (gridVariables.size() == 3 && _autoDomainBounds) {
+                lowerDomainBound = glm::vec3(
+                    reader->minValue(gridVariables[0]),
+                    reader->minValue(gridVariables[1]),
+                    reader->minValue(gridVariables[2])
+                );
+                upperDomainBound = glm::vec3(
+                    reader->maxValue(gridVariables[0]),
+                    reader->maxValue(gridVariables[1]),
+                    reader->maxValue(gridVariables[2])
+                );
+            }
+
+            std::string time = reader->time();
+            // Do not include time offset in time string
+            if (time.back() == 'Z') {
+                time.pop_back();
+            }
+            metadata.setValue<std::string>(KeyTime, time);
+            metadata.setValue<glm::vec3>(KeyDimensions, _dimensions);
+            metadata.setValue<glm::vec3>(KeyLowerDomainBound, lowerDomainBound);
+            metadata.setValue<glm::vec3>(KeyUpperDomainBound, upperDomainBound);
+            metadata.setValue<float>(
+                KeyMinValue,
+                static_cast<float>(reader->minValue(_variable))
+            );
+            metadata.setValue<float>(
+                KeyMaxValue,
+                static_cast<float>(reader->maxValue(_variable))
+            );
+            metadata.setValue<std::string>(KeyVisUnit, reader->getVisUnit(_variable));
+        }
+
+        // Resample stage: the variable was loaded in the read stage, so this does not
+        // access the file. The cores are shared with the other files that are being
+        // resampled at the same time
+        const unsigned int nThreads = std::max(
+            std::thread::hardware_concurrency() /
+                static_cast<unsigned int>(_maxConcurrentFiles),
+            1u
+        );
+        std::unique_ptr<volume::RawVolume<float>> rawVolume = reader->readFloatVolume(
+            _dimensions,
+            _variable,
+            lowerDomainBound,
+            upperDomainBound,
+            nThreads
+        );
+
+        {
+            std::lock_guard<std::mutex> guard(_fileAccessMutex);
+            reader = nullptr;
+        }
+
+        // Write stage: the dictionary is written to a temporary file that is renamed
+        // once it is complete, which marks the conversion of this file as finished
+        volume::RawVolumeWriter<float> writer(rawVolumePath);
+        writer.write(*rawVolume);
+
+        ghoul::DictionaryLuaFormatter formatter;
+        const std::string temporaryPath = dictionaryPath + ".tmp";
+        {
+            std::ofstream f(temporaryPath);
+            f << "return " << formatter.format(metadata);
+            if (!f.good()) {
+                LERROR(fmt::format("Could not write '{}'", temporaryPath));
+                return false;
+            }
+        }
+        if (std::rename(temporaryPath.c_str(), dictionaryPath.c_str()) != 0) {
+            LERROR(fmt::format("Could not write '{}'", dictionaryPath));
+            return false;
+        }
+    }
+    catch (const ghoul::RuntimeError& e) {
+        // Closing the file accesses it as well
+        std::lock_guard<std::mutex> guard(_fileAccessMutex);
+        reader = nullptr;
+        LERROR(fmt::format("Failed to convert '{}': {}", inputPath, e.message));
+        return false;
+    }
+
+    LINFO(fmt::format("Converted '{}'", inputPath));
+    return true;
+}
+
+documentation::Documentation KameleonVolumeSequenceToRawTask::documentation() {
+    using namespace documentation;
+    return {
+        "KameleonVolumeSequenceToRawTask",
+        "kameleon_volume_sequence_to_raw_task",
+        {
+            {
+                "Type",
+                new StringEqualVerifier("KameleonVolumeSequenceToRawTask"),
+                Optional::No,
+                "The type of this task",
+            },
+            {
+                KeyInput,
+                new StringAnnotationVerifier(
+                    "A file path pattern, in which the file name may contain the "
+                    "wildcards '*' and '?'"
+                ),
+                Optional::No,
+                "The cdf files to extract data from",
+            },
+            {
+                KeyOutputDirectory,
+                new StringAnnotationVerifier("A valid directory path"),
+                Optional::No,
+                "The directory that the raw volumes and the lua dictionaries with "
+                "their metadata are written to. Each output file is named after its "
+                "input file",
+            },
+            {
+                KeyVariable,
+                new StringAnnotationVerifier("A valid kameleon variable"),
+                Optional::No,
+                "The variable name to read from the kameleon datasets",
+            },
+            {
+                KeyDimensions,
+                new DoubleVector3Verifier,
+                Optional::No,
+                "A vector representing the number of cells in each dimension",
+            },
+            {
+                KeyLowerDomainBound,
+                new DoubleVector3Verifier,
+                Optional::Yes,
+                "A vector representing the lower bound of the domain, "
+                "in the native kameleon grid units. If it is not specified, the "
+                "bounds of each file's grid are used",
+            },
+            {
+                KeyUpperDomainBound,
+                new DoubleVector3Verifier,
+                Optional::Yes,
+                "A vector representing the upper bound of the domain, "
+                "in the native kameleon grid units. If it is not specified, the "
+                "bounds of each file's grid are used",
+            },
+            {
+                KeyMaxConcurrentFiles,
+                new IntVerifier,
+                Optional::Yes,
+                "The maximum number of files that are converted at the same time. "
+                "Each of them holds a resampled volume in memory. The default value "
+                "is 2",
+            }
+        }
+    };
+}
+
+} // namespace kameleonvolume
+} // namespace openspace
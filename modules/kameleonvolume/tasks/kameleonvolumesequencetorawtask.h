@@ -0,0 +1,76 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_KAMELEONVOLUME___KAMELEONVOLUMESEQUENCETORAWTASK___H__
+#define __OPENSPACE_MODULE_KAMELEONVOLUME___KAMELEONVOLUMESEQUENCETORAWTASK___H__
+
+#include <openspace/util/task.h>
+
+#include <ghoul/glm.h>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace openspace {
+namespace kameleonvolume {
+
+/**
+ * Converts all cdf files that match a glob pattern into a sequence of raw volumes and
+ * the <code>.dictionary</code> metadata files that a
+ * <code>RenderableTimeVaryingVolume</code> reads. Several files are converted
+ * concurrently: while one file is read from disk, others are resampled or written.
+ * Files whose output already exists are skipped, so an interrupted conversion resumes
+ * where it stopped.
+ */
+class KameleonVolumeSequenceToRawTask : public Task {
+public:
+    KameleonVolumeSequenceToRawTask(const ghoul::Dictionary& dictionary);
+    std::string description() override;
+    void perform(const Task::ProgressCallback& progressCallback) override;
+    static documentation::Documentation documentation();
+
+private:
+    /// Converts a single cdf file, returning <code>false</code> if it failed
+    bool convertFile(const std::string& inputPath);
+
+    std::string _inputPattern;
+    std::string _outputDirectory;
+
+    std::string _variable;
+    glm::uvec3 _dimensions;
+    bool _autoDomainBounds;
+    glm::vec3 _lowerDomainBound;
+    glm::vec3 _upperDomainBound;
+    int _maxConcurrentFiles;
+
+    // The cdf library is not thread safe, so opening and closing files and loading
+    // variables from them is serialized
+    std::mutex _fileAccessMutex;
+};
+
+} // namespace kameleonvolume
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_KAMELEONVOLUME___KAMELEONVOLUMESEQUENCETORAWTASK___H__
@@ -31,6 +31,7 @@
 
 #include <ghoul/misc/dictionaryjsonformatter.h>
 #include <ghoul/filesystem/filesystem.h>
+#include <ghoul/fmt.h>
 
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionaryluaformatter.h>
@@ -87,6 +88,11 @@ std::string KameleonVolumeToRawTask::description() {
 
 void KameleonVolumeToRawTask::perform(const Task::ProgressCallback& progressCallback) {
     KameleonVolumeReader reader(_inputPath);
+    if (!reader.loadVariable(_variable)) {
+        throw ghoul::RuntimeError(fmt::format(
+            "Could not load variable '{}' from '{}'", _variable, _inputPath
+        ));
+    }
 
     std::vector<std::string> variables = reader.gridVariableNames();
 
@@ -1,3 +1,4 @@
 set (OPENSPACE_DEPENDENCIES
     space
+    volume
 )
\ No newline at end of file
@@ -30,6 +30,8 @@
 #include <ghoul/misc/assert.h>
 
 #include <modules/multiresvolume/rendering/renderablemultiresvolume.h>
+#include <modules/multiresvolume/tasks/brickselectionbenchmarktask.h>
+#include <modules/multiresvolume/tasks/tspcompressiontask.h>
 
 namespace openspace {
 
@@ -40,6 +42,18 @@ void MultiresVolumeModule::internalInitialize(const ghoul::Dictionary&) {
     ghoul_assert(fRenderable, "No renderable factory existed");
 
     fRenderable->registerClass<RenderableMultiresVolume>("RenderableMultiresVolume");
+
+    auto fTask = FactoryManager::ref().factory<Task>();
+    ghoul_assert(fTask, "No task factory existed");
+    fTask->registerClass<BrickSelectionBenchmarkTask>("BrickSelectionBenchmarkTask");
+    fTask->registerClass<TspCompressionTask>("TspCompressionTask");
+}
+
+std::vector<documentation::Documentation> MultiresVolumeModule::documentations() const {
+    return {
+        BrickSelectionBenchmarkTask::documentation(),
+        TspCompressionTask::documentation()
+    };
 }
 
 } // namespace openspace
@@ -26,6 +26,7 @@
 #define __OPENSPACE_MODULE_MULTIRESVOLUME___MULTIRESVOLUMEMODULE___H__
 
 #include <openspace/util/openspacemodule.h>
+#include <openspace/documentation/documentation.h>
 
 namespace openspace {
 
@@ -35,6 +36,8 @@ public:
 
     MultiresVolumeModule();
 
+    std::vector<documentation::Documentation> documentations() const override;
+
 private:
     void internalInitialize(const ghoul::Dictionary&) override;
 };
@@ -28,10 +28,13 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/texture.h>
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <cassert>
+#include <chrono>
 #include <cstring>
+#include <thread>
 
 namespace {
     constexpr const char* _loggerCat = "AtlasManager";
@@ -39,9 +42,23 @@ namespace {
 
 namespace openspace {
 
-AtlasManager::AtlasManager(TSP* tsp) : _tsp(tsp) {}
-
-AtlasManager::~AtlasManager() {}
+AtlasManager::AtlasManager(TSP* tsp)
+    : _tsp(tsp)
+    , _readerPool(1)
+    , _nextBufferIndex(EVEN)
+    , _nUsedBricks(0)
+    , _nStreamedBricks(0)
+    , _nDiskReads(0)
+    , _diskReadThroughput(0.f)
+    , _nStalls(0)
+{}
+
+AtlasManager::~AtlasManager() {
+    // The reader writes into a mapped pixel buffer and must not outlive it
+    if (_pendingRead.valid()) {
+        _pendingRead.wait();
+    }
+}
 
 bool AtlasManager::initialize() {
     TSP::Header header = _tsp->header();
@@ -59,6 +76,18 @@ bool AtlasManager::initialize() {
     _atlasMap = std::vector<unsigned int>(_nOtLeaves, NOT_USED);
     _nBricksInAtlas = _nBricksInMap;
 
+    _brickFile.open(_tsp->filename(), std::ios::in | std::ios::binary);
+    if (!_brickFile.is_open()) {
+        LERROR("Could not open TSP file '" + _tsp->filename() + "' for streaming");
+        return false;
+    }
+
+    if (_tsp->isCompressed()) {
+        _decompressionPool = std::make_unique<ThreadPool>(
+            std::max(std::thread::hardware_concurrency(), 1u)
+        );
+    }
+
     _freeAtlasCoords = std::vector<unsigned int>(_nBricksInAtlas, 0);
 
     for (unsigned int i = 0; i < _nBricksInAtlas; i++) {
@@ -90,7 +119,21 @@ unsigned int AtlasManager::atlasMapBuffer() {
     return _atlasMapBuffer;
 }
 
-void AtlasManager::updateAtlas(BUFFER_INDEX bufferIndex, std::vector<int>& brickIndices) {
+void AtlasManager::updateAtlas(std::vector<int>& brickIndices) {
+    if (_pendingRead.valid()) {
+        using namespace std::chrono_literals;
+        if (_pendingRead.wait_for(0s) != std::future_status::ready) {
+            // Keep rendering the previous selection until its bricks have been read
+            _nStalls++;
+            return;
+        }
+        finishRequest();
+    }
+
+    requestBricks(brickIndices);
+}
+
+void AtlasManager::requestBricks(const std::vector<int>& brickIndices) {
     size_t nBrickIndices = brickIndices.size();
 
     _requiredBricks.clear();
@@ -98,56 +141,139 @@ void AtlasManager::updateAtlas(BUFFER_INDEX bufferIndex, std::vector<int>& brick
         _requiredBricks.insert(brickIndices[i]);
     }
 
+    // The atlas coordinates of bricks that are no longer required are only overwritten
+    // once the new atlas map is in use, so they can be reused right away
     for (unsigned int it : _prevRequiredBricks) {
         if (!_requiredBricks.count(it)) {
             removeFromAtlas(it);
         }
     }
 
-    // Stats
-    _nUsedBricks = static_cast<unsigned int>(_requiredBricks.size());
-    _nStreamedBricks = 0;
-    _nDiskReads = 0;
+    _request.bricks.clear();
+    _request.atlasCoords.clear();
+    for (unsigned int brickIndex : _requiredBricks) {
+        if (_brickMap.count(brickIndex)) {
+            continue;
+        }
+        unsigned int atlasCoords = _freeAtlasCoords.back();
+        _freeAtlasCoords.pop_back();
+        int level = _nOtLevels - static_cast<int>(floor(log((7.0 * (float(brickIndex % _nOtNodes)) + 1.0))/log(8)) - 1);
+        ghoul_assert(atlasCoords <= 0x0FFFFFFF, "@MISSING");
+        unsigned int atlasData = (level << 28) + atlasCoords;
+        _brickMap.insert(std::pair<unsigned int, unsigned int>(brickIndex, atlasData));
+        _request.bricks.push_back(brickIndex);
+        _request.atlasCoords.push_back(atlasCoords);
+    }
 
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboHandle[bufferIndex]);
-    glBufferData(GL_PIXEL_UNPACK_BUFFER, _volumeSize, 0, GL_STREAM_DRAW);
+    _request.atlasMap = _atlasMap;
+    for (size_t i = 0; i < nBrickIndices; i++) {
+        _request.atlasMap[i] = _brickMap[brickIndices[i]];
+    }
+    _request.nUsedBricks = static_cast<unsigned int>(_requiredBricks.size());
+
+    std::swap(_prevRequiredBricks, _requiredBricks);
+
+    if (_request.bricks.empty()) {
+        finishRequest();
+        return;
+    }
+
+    _request.bufferIndex = _nextBufferIndex;
+    _nextBufferIndex = (_nextBufferIndex == EVEN) ? ODD : EVEN;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboHandle[_request.bufferIndex]);
+    glBufferData(
+        GL_PIXEL_UNPACK_BUFFER,
+        _request.bricks.size() * _brickSize,
+        0,
+        GL_STREAM_DRAW
+    );
     float* mappedBuffer = reinterpret_cast<float*>(glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
     if (!mappedBuffer) {
         LERROR("Failed to map PBO");
         std::cout << glGetError() << std::endl;
+        // The bricks are requested again with the next selection
+        for (unsigned int brickIndex : _request.bricks) {
+            removeFromAtlas(brickIndex);
+        }
+        _prevRequiredBricks.clear();
         return;
     }
 
-    for (auto itStart = _requiredBricks.begin(); itStart != _requiredBricks.end();) {
-        int firstBrick = *itStart;
-        int lastBrick = firstBrick;
-
-        auto itEnd = itStart;
-        for (itEnd++;
-            itEnd != _requiredBricks.end() &&
-            *itEnd == static_cast<unsigned int>(lastBrick) + 1;
-            itEnd++)
-        {
-            lastBrick = *itEnd;
+    _pendingRead = _readerPool.submit([this, mappedBuffer]() {
+        return readBricks(_request.bricks, mappedBuffer);
+    });
+}
+
+AtlasManager::ReadResult AtlasManager::readBricks(const std::vector<unsigned int>& bricks,
+                                                  float* destination)
+{
+    std::chrono::high_resolution_clock::time_point start =
+        std::chrono::high_resolution_clock::now();
+
+    ReadResult result = { 0, 0, 0.0, true };
+
+    // Bricks with consecutive indices are adjacent in the file and in the buffer, so
+    // each run of them is read at once
+    for (size_t first = 0; first < bricks.size();) {
+        size_t last = first;
+        while (last + 1 < bricks.size() && bricks[last + 1] == bricks[last] + 1) {
+            last++;
         }
 
-        addToAtlas(firstBrick, lastBrick, mappedBuffer);
+        const unsigned int nBricks = static_cast<unsigned int>(last - first + 1);
+        const bool success = _tsp->readBricks(
+            _brickFile,
+            bricks[first],
+            nBricks,
+            destination + first * _nBrickVals,
+            _decompressionPool.get()
+        );
+        if (!success) {
+            _brickFile.clear();
+            result.success = false;
+        }
+        result.nDiskReads++;
+        result.nBytes += _tsp->storedBricksSize(bricks[first], nBricks);
 
-        itStart = itEnd;
+        first = last + 1;
     }
 
-    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    result.seconds = std::chrono::duration<double>(
+        std::chrono::high_resolution_clock::now() - start
+    ).count();
+    return result;
+}
 
-    for (size_t i = 0; i < nBrickIndices; i++) {
-        _atlasMap[i] = _brickMap[brickIndices[i]];
-    }
+void AtlasManager::finishRequest() {
+    _nStreamedBricks = static_cast<unsigned int>(_request.bricks.size());
+    _nDiskReads = 0;
 
-    std::swap(_prevRequiredBricks, _requiredBricks);
+    if (_pendingRead.valid()) {
+        ReadResult result = _pendingRead.get();
+        if (!result.success) {
+            LERROR("Failed to read bricks from TSP file '" + _tsp->filename() + "'");
+        }
+        _nDiskReads = result.nDiskReads;
+        _diskReadThroughput = result.seconds > 0.0 ?
+            static_cast<float>(result.nBytes / (1024.0 * 1024.0) / result.seconds) :
+            0.f;
 
-    pboToAtlas(bufferIndex);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboHandle[_request.bufferIndex]);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        pboToAtlas(_request.bufferIndex);
+    }
 
+    _nUsedBricks = _request.nUsedBricks;
+    std::swap(_atlasMap, _request.atlasMap);
+    uploadAtlasMap();
+}
+
+void AtlasManager::uploadAtlasMap() {
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, _atlasMapBuffer);
     GLint *to = reinterpret_cast<GLint*>(
         glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_WRITE_ONLY)
@@ -157,36 +283,6 @@ void AtlasManager::updateAtlas(BUFFER_INDEX bufferIndex, std::vector<int>& brick
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
-void AtlasManager::addToAtlas(int firstBrickIndex, int lastBrickIndex, float* mappedBuffer) {
-    while (_brickMap.count(firstBrickIndex) && firstBrickIndex <= lastBrickIndex) firstBrickIndex++;
-    while (_brickMap.count(lastBrickIndex) && lastBrickIndex >= firstBrickIndex) lastBrickIndex--;
-    if (lastBrickIndex < firstBrickIndex) return;
-
-    int sequenceLength = lastBrickIndex - firstBrickIndex + 1;
-    float* sequenceBuffer = new float[sequenceLength*_nBrickVals];
-    size_t bufferSize = sequenceLength * _brickSize;
-
-    long long offset = TSP::dataPosition() + static_cast<long long>(firstBrickIndex) * static_cast<long long>(_brickSize);
-    _tsp->file().seekg(offset);
-    _tsp->file().read(reinterpret_cast<char*>(sequenceBuffer), bufferSize);
-    _nDiskReads++;
-
-    for (int brickIndex = firstBrickIndex; brickIndex <= lastBrickIndex; brickIndex++) {
-        if (!_brickMap.count(brickIndex)) {
-            unsigned int atlasCoords = _freeAtlasCoords.back();
-            _freeAtlasCoords.pop_back();
-            int level = _nOtLevels - static_cast<int>(floor(log((7.0 * (float(brickIndex % _nOtNodes)) + 1.0))/log(8)) - 1);
-            ghoul_assert(atlasCoords <= 0x0FFFFFFF, "@MISSING");
-            unsigned int atlasData = (level << 28) + atlasCoords;
-            _brickMap.insert(std::pair<unsigned int, unsigned int>(brickIndex, atlasData));
-            _nStreamedBricks++;
-            fillVolume(&sequenceBuffer[_nBrickVals*(brickIndex - firstBrickIndex)], mappedBuffer, atlasCoords);
-        }
-    }
-
-    delete[] sequenceBuffer;
-}
-
 void AtlasManager::removeFromAtlas(int brickIndex) {
     unsigned int atlasData = _brickMap[brickIndex];
     unsigned int atlasCoords = atlasData & 0x0FFFFFFF;
@@ -194,51 +290,32 @@ void AtlasManager::removeFromAtlas(int brickIndex) {
     _freeAtlasCoords.push_back(atlasCoords);
 }
 
-void AtlasManager::fillVolume(float* in, float* out, unsigned int linearAtlasCoords) {
-    int x = linearAtlasCoords % _nBricksPerDim;
-    int y = (linearAtlasCoords / _nBricksPerDim) % _nBricksPerDim;
-    int z = linearAtlasCoords / _nBricksPerDim / _nBricksPerDim;
-
-    unsigned int xMin = x*_paddedBrickDim;
-    unsigned int yMin = y*_paddedBrickDim;
-    unsigned int zMin = z*_paddedBrickDim;
-    unsigned int xMax = xMin + _paddedBrickDim;
-    unsigned int yMax = yMin + _paddedBrickDim;
-    unsigned int zMax = zMin + _paddedBrickDim;
-
-    unsigned int from = 0;
-    for (unsigned int zValCoord = zMin; zValCoord<zMax; ++zValCoord) {
-        for (unsigned int yValCoord = yMin; yValCoord<yMax; ++yValCoord) {
-            for (unsigned int xValCoord = xMin; xValCoord<xMax; ++xValCoord) {
-                unsigned int idx =
-                    xValCoord +
-                    yValCoord*_atlasDim +
-                    zValCoord*_atlasDim*_atlasDim;
-
-                out[idx] = in[from];
-                from++;
-            }
-        }
-    }
-}
-
 void AtlasManager::pboToAtlas(BUFFER_INDEX bufferIndex) {
+    // Only the streamed bricks are uploaded; each of them is stored in the pixel buffer
+    // in the same layout as in the atlas
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboHandle[bufferIndex]);
-    glm::size3_t dim = _textureAtlas->dimensions();
     glBindTexture(GL_TEXTURE_3D, *_textureAtlas);
-    glTexSubImage3D(
-        GL_TEXTURE_3D,                // target
-        0,                            // level
-        0,                            // xoffset
-        0,                            // yoffset
-        0,                            // zoffset
-        static_cast<GLsizei>(dim[0]), // width
-        static_cast<GLsizei>(dim[1]), // height
-        static_cast<GLsizei>(dim[2]), // depth
-        GL_RED,                       // format
-        GL_FLOAT,                     // type
-        NULL                          // *pixels
-    );
+    for (size_t i = 0; i < _request.atlasCoords.size(); i++) {
+        unsigned int linearAtlasCoords = _request.atlasCoords[i];
+        unsigned int x = linearAtlasCoords % _nBricksPerDim;
+        unsigned int y = (linearAtlasCoords / _nBricksPerDim) % _nBricksPerDim;
+        unsigned int z = linearAtlasCoords / _nBricksPerDim / _nBricksPerDim;
+        GLsizei dim = static_cast<GLsizei>(_paddedBrickDim);
+
+        glTexSubImage3D(
+            GL_TEXTURE_3D,                           // target
+            0,                                       // level
+            static_cast<GLint>(x * _paddedBrickDim), // xoffset
+            static_cast<GLint>(y * _paddedBrickDim), // yoffset
+            static_cast<GLint>(z * _paddedBrickDim), // zoffset
+            dim,                                     // width
+            dim,                                     // height
+            dim,                                     // depth
+            GL_RED,                                  // format
+            GL_FLOAT,                                // type
+            reinterpret_cast<void*>(i * _brickSize)  // offset into the pixel buffer
+        );
+    }
     glBindTexture(GL_TEXTURE_3D, 0);
     glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 }
@@ -260,6 +337,14 @@ unsigned int AtlasManager::getNumStreamedBricks() {
     return _nStreamedBricks;
 }
 
+float AtlasManager::getDiskReadThroughput() {
+    return _diskReadThroughput;
+}
+
+unsigned int AtlasManager::getNumStalls() {
+    return _nStalls;
+}
+
 glm::size3_t AtlasManager::textureSize() {
     return _textureAtlas->dimensions();
 }
@@ -26,19 +26,30 @@
 #define __OPENSPACE_MODULE_MULTIRESVOLUME___ATLASMANAGER___H__
 
 #include <modules/multiresvolume/rendering/tsp.h>
+#include <openspace/util/threadpool.h>
 #include <ghoul/glm.h>
 #include <glm/gtx/std_based_type.hpp>
 
 #include <string>
 #include <vector>
 #include <climits>
+#include <fstream>
+#include <future>
 #include <map>
+#include <memory>
 #include <set>
 
 namespace ghoul::opengl { class Texture; }
 
 namespace openspace {
 
+/**
+ * Streams the bricks of the TSP file into a texture atlas. The bricks are read from disk
+ * by a background reader straight into one of two alternating pixel buffers while the
+ * previous selection of bricks is rendered. The bricks of a selection are uploaded to
+ * the atlas by the first update after they have been read; if the reader has not
+ * finished by then, the previous selection remains in use.
+ */
 class AtlasManager {
 public:
     enum BUFFER_INDEX { EVEN = 0, ODD = 1 };
@@ -46,8 +57,7 @@ public:
     AtlasManager(TSP* tsp);
     ~AtlasManager();
 
-    void updateAtlas(BUFFER_INDEX bufferIndex, std::vector<int>& brickIndices);
-    void addToAtlas(int firstBrickIndex, int lastBrickIndex, float* mappedBuffer);
+    void updateAtlas(std::vector<int>& brickIndices);
     void removeFromAtlas(int brickIndex);
     bool initialize();
     std::vector<unsigned int> atlasMap();
@@ -60,13 +70,52 @@ public:
     unsigned int getNumDiskReads();
     unsigned int getNumUsedBricks();
     unsigned int getNumStreamedBricks();
+    // Megabytes per second read from disk for the last selection of bricks. For
+    // compressed TSP files, this is the compressed size over the time it took to read
+    // and decompress the bricks
+    float getDiskReadThroughput();
+    // Number of updates that kept the previous selection because its bricks were still
+    // being read
+    unsigned int getNumStalls();
 
 private:
+    // The bricks of a selection that are not yet in the atlas
+    struct StreamRequest {
+        BUFFER_INDEX bufferIndex;
+        // Sorted brick indices; brick i is read into slot i of the pixel buffer
+        std::vector<unsigned int> bricks;
+        std::vector<unsigned int> atlasCoords;
+        std::vector<unsigned int> atlasMap;
+        unsigned int nUsedBricks;
+    };
+
+    struct ReadResult {
+        unsigned int nDiskReads;
+        size_t nBytes;
+        double seconds;
+        bool success;
+    };
+
+    void requestBricks(const std::vector<int>& brickIndices);
+    void finishRequest();
+    ReadResult readBricks(const std::vector<unsigned int>& bricks, float* destination);
+    void uploadAtlasMap();
+
     const unsigned int NOT_USED = UINT_MAX;
     TSP* _tsp;
     unsigned int _pboHandle[2];
     unsigned int _atlasMapBuffer;
 
+    // The background reader uses its own file stream, so that the TSP file can still be
+    // read on the main thread, for example when histograms are built
+    std::ifstream _brickFile;
+    ThreadPool _readerPool;
+    // Decompresses the bricks of compressed TSP files for the reader
+    std::unique_ptr<ThreadPool> _decompressionPool;
+    std::future<ReadResult> _pendingRead;
+    StreamRequest _request;
+    BUFFER_INDEX _nextBufferIndex;
+
     std::vector<unsigned int> _atlasMap;
     std::map<unsigned int, unsigned int> _brickMap;
     std::vector<unsigned int> _freeAtlasCoords;
@@ -79,6 +128,8 @@ private:
     unsigned int _nUsedBricks;
     unsigned int _nStreamedBricks;
     unsigned int _nDiskReads;
+    float _diskReadThroughput;
+    unsigned int _nStalls;
 
     unsigned int _nBricksPerDim,
                  _nOtLeaves,
@@ -91,8 +142,6 @@ private:
                  _nBricksInAtlas,
                  _nBricksInMap,
                  _atlasDim;
-
-    void fillVolume(float* in, float* out, unsigned int linearAtlasCoords);
 };
 
 } // namespace openspace
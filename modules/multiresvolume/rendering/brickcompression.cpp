@@ -0,0 +1,232 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/multiresvolume/rendering/brickcompression.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+    using openspace::brickcompression::Method;
+
+    // Quantized values have to be represented exactly by a double
+    constexpr const double MaxQuantizedValue = 4503599627370496.0; // 2^52
+
+    void writeVarint(uint64_t value, std::vector<char>& destination) {
+        while (value >= 0x80) {
+            destination.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        destination.push_back(static_cast<char>(value));
+    }
+
+    bool readVarint(const unsigned char*& data, const unsigned char* end,
+                    uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (data == end) {
+                return false;
+            }
+            const unsigned char byte = *data++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool compressLossless(const float* values, size_t nValues,
+                          std::vector<char>& destination)
+    {
+        // Neighboring values share most of their sign, exponent and leading mantissa
+        // bits, so the high byte planes of the xor-ed bit patterns are mostly zero
+        std::vector<uint32_t> residuals(nValues);
+        uint32_t previous = 0;
+        for (size_t i = 0; i < nValues; ++i) {
+            uint32_t bits;
+            std::memcpy(&bits, values + i, sizeof(uint32_t));
+            residuals[i] = bits ^ previous;
+            previous = bits;
+        }
+
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            size_t i = 0;
+            while (i < nValues) {
+                const char byte = static_cast<char>((residuals[i] >> shift) & 0xFF);
+                if (byte != 0) {
+                    destination.push_back(byte);
+                    ++i;
+                    continue;
+                }
+                size_t run = 0;
+                while (i < nValues && ((residuals[i] >> shift) & 0xFF) == 0) {
+                    ++run;
+                    ++i;
+                }
+                destination.push_back(0);
+                writeVarint(run, destination);
+            }
+        }
+        return true;
+    }
+
+    bool decompressLossless(const unsigned char* data, const unsigned char* end,
+                            float* values, size_t nValues)
+    {
+        std::vector<uint32_t> residuals(nValues, 0);
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            size_t i = 0;
+            while (i < nValues) {
+                if (data == end) {
+                    return false;
+                }
+                const unsigned char byte = *data++;
+                if (byte != 0) {
+                    residuals[i++] |= static_cast<uint32_t>(byte) << shift;
+                    continue;
+                }
+                uint64_t run;
+                if (!readVarint(data, end, run) || run == 0 || run > nValues - i) {
+                    return false;
+                }
+                i += run;
+            }
+        }
+        if (data != end) {
+            return false;
+        }
+
+        uint32_t previous = 0;
+        for (size_t i = 0; i < nValues; ++i) {
+            previous ^= residuals[i];
+            std::memcpy(values + i, &previous, sizeof(uint32_t));
+        }
+        return true;
+    }
+
+    bool compressQuantized(const float* values, size_t nValues, float errorBound,
+                           std::vector<char>& destination)
+    {
+        if (!(errorBound > 0.f)) {
+            return false;
+        }
+        const double step = 2.0 * errorBound;
+
+        int64_t previous = 0;
+        for (size_t i = 0; i < nValues; ++i) {
+            const double scaled = values[i] / step;
+            if (!std::isfinite(scaled) || std::abs(scaled) > MaxQuantizedValue) {
+                return false;
+            }
+            const int64_t quantized = std::llround(scaled);
+            const int64_t difference = quantized - previous;
+            previous = quantized;
+
+            // Zigzag encoding keeps small negative differences small
+            const uint64_t zigzag = (static_cast<uint64_t>(difference) << 1) ^
+                                    static_cast<uint64_t>(difference >> 63);
+            writeVarint(zigzag, destination);
+        }
+        return true;
+    }
+
+    bool decompressQuantized(const unsigned char* data, const unsigned char* end,
+                             float errorBound, float* values, size_t nValues)
+    {
+        const double step = 2.0 * errorBound;
+
+        int64_t previous = 0;
+        for (size_t i = 0; i < nValues; ++i) {
+            uint64_t zigzag;
+            if (!readVarint(data, end, zigzag)) {
+                return false;
+            }
+            const int64_t difference = static_cast<int64_t>(zigzag >> 1) ^
+                                       -static_cast<int64_t>(zigzag & 1);
+            previous += difference;
+            values[i] = static_cast<float>(previous * step);
+        }
+        return data == end;
+    }
+} // namespace
+
+namespace openspace::brickcompression {
+
+void compress(const float* values, size_t nValues, Method method, float errorBound,
+              std::vector<char>& destination)
+{
+    const size_t start = destination.size();
+    const size_t rawSize = nValues * sizeof(float);
+
+    destination.push_back(static_cast<char>(method));
+    bool success = false;
+    switch (method) {
+        case Method::Lossless:
+            success = compressLossless(values, nValues, destination);
+            break;
+        case Method::Quantized:
+            success = compressQuantized(values, nValues, errorBound, destination);
+            break;
+        default:
+            break;
+    }
+
+    if (success && destination.size() - start - 1 < rawSize) {
+        return;
+    }
+
+    destination.resize(start);
+    destination.push_back(static_cast<char>(Method::None));
+    const char* bytes = reinterpret_cast<const char*>(values);
+    destination.insert(destination.end(), bytes, bytes + rawSize);
+}
+
+bool decompress(const char* data, size_t size, float errorBound, float* values,
+                size_t nValues)
+{
+    if (size == 0) {
+        return false;
+    }
+    const unsigned char* begin = reinterpret_cast<const unsigned char*>(data) + 1;
+    const unsigned char* end = reinterpret_cast<const unsigned char*>(data) + size;
+
+    switch (static_cast<Method>(data[0])) {
+        case Method::None:
+            if (size - 1 != nValues * sizeof(float)) {
+                return false;
+            }
+            std::memcpy(values, begin, nValues * sizeof(float));
+            return true;
+        case Method::Lossless:
+            return decompressLossless(begin, end, values, nValues);
+        case Method::Quantized:
+            return decompressQuantized(begin, end, errorBound, values, nValues);
+        default:
+            return false;
+    }
+}
+
+} // namespace openspace::brickcompression
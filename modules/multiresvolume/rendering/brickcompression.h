@@ -0,0 +1,72 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_MULTIRESVOLUME___BRICKCOMPRESSION___H__
+#define __OPENSPACE_MODULE_MULTIRESVOLUME___BRICKCOMPRESSION___H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace openspace::brickcompression {
+
+/**
+ * The methods that a brick of a compressed TSP file can be stored with. Every compressed
+ * brick starts with one byte naming its method, so bricks that do not compress well
+ * fall back to being stored uncompressed.
+ */
+enum class Method : uint8_t {
+    /// The values are stored as they are
+    None = 0,
+    /// The bit patterns of neighboring values are xor-ed, split into byte planes and the
+    /// runs of zero bytes in each plane are run-length encoded
+    Lossless = 1,
+    /// The values are quantized to multiples of twice the error bound and the
+    /// differences between neighboring quantized values are stored as variable length
+    /// integers. The error of each value is at most the error bound, up to the rounding
+    /// of the reconstructed value to float
+    Quantized = 2
+};
+
+/**
+ * Compresses the nValues values with the passed method and appends the result to the
+ * destination. The errorBound is only used by Method::Quantized and has to be positive
+ * for it. If the method does not apply to the values (non-finite values for
+ * Method::Quantized) or does not make them smaller, they are stored uncompressed.
+ */
+void compress(const float* values, size_t nValues, Method method, float errorBound,
+    std::vector<char>& destination);
+
+/**
+ * Decompresses the size bytes of a brick written by compress into the nValues values.
+ * The errorBound has to be the same that the brick was compressed with. Returns
+ * <code>false</code> if the data is malformed or does not contain exactly nValues
+ * values.
+ */
+bool decompress(const char* data, size_t size, float errorBound, float* values,
+    size_t nValues);
+
+} // namespace openspace::brickcompression
+
+#endif // __OPENSPACE_MODULE_MULTIRESVOLUME___BRICKCOMPRESSION___H__
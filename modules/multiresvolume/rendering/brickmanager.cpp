@@ -67,6 +67,11 @@ bool BrickManager::readHeader() {
     if (!_tsp->file().is_open())
         return false;
 
+    if (_tsp->isCompressed()) {
+        LERROR("Compressed TSP files are not supported");
+        return false;
+    }
+
     _header = _tsp->header();
 
     LDEBUG(fmt::format("Grid type: {}", _header.gridType_));
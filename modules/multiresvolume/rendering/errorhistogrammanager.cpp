@@ -23,20 +23,26 @@
  ****************************************************************************************/
 
 #include <float.h>
+#include <algorithm>
 #include <map>
 #include <string.h>
 #include <cmath>
+#include <thread>
 
 #include <modules/multiresvolume/rendering/errorhistogrammanager.h>
 #include <openspace/util/histogram.h>
 
 #include <openspace/util/progressbar.h>
+#include <openspace/util/threadpool.h>
 
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/fmt.h>
 
 namespace {
     constexpr const char* _loggerCat = "ErrorHistogramManager";
+
+    // Size of the chunks of leaf bricks that are read at once
+    constexpr const size_t LeafChunkSize = 64 * 1024 * 1024;
 } // namespace
 
 namespace openspace {
@@ -52,6 +58,13 @@ bool ErrorHistogramManager::buildHistograms(int numBins) {
     if (!_file->is_open()) {
         return false;
     }
+    _ancestorFile.close();
+    _ancestorFile.open(_tsp->filename(), std::ios::in | std::ios::binary);
+    if (!_ancestorFile.is_open()) {
+        return false;
+    }
+    _voxelCache.clear();
+
     _minBin = 0.0; // Should be calculated from tsp file
     _maxBin = 1.0; // Should be calculated from tsp file as (maxValue - minValue)
 
@@ -63,6 +76,9 @@ bool ErrorHistogramManager::buildHistograms(int numBins) {
 
     _numInnerNodes = _tsp->numTotalNodes() - numOtLeaves * numBstLeaves;
     _histograms = std::vector<Histogram>(_numInnerNodes);
+    for (unsigned int i = 0; i < _numInnerNodes; i++) {
+        _histograms[i] = Histogram(_minBin, _maxBin, numBins);
+    }
     LINFO(fmt::format("Build {} histograms with {} bins each", _numInnerNodes, numBins));
 
     // All TSP Leaves
@@ -72,22 +88,97 @@ bool ErrorHistogramManager::buildHistograms(int numBins) {
     int numBstNodes = _tsp->numBSTNodes();
     int bstOffset = numBstNodes / 2;
 
+    unsigned int paddedBrickDim = _tsp->paddedBrickDim();
+    if (numOtNodes == 0 || numBstNodes == 0 || numOtLeaves == 0 || paddedBrickDim == 0) {
+        // There are no leaves; this also avoids dividing by a brick size of zero, chunks
+        // without leaves, and reading a first chunk that does not exist
+        _ancestorFile.close();
+        return true;
+    }
+
+    // The octree leaves of a BST leaf are stored consecutively in the file, so they are
+    // streamed in large chunks and compared with their ancestors on worker threads
+    size_t numBrickVals =
+        static_cast<size_t>(paddedBrickDim) * paddedBrickDim * paddedBrickDim;
+    unsigned int leavesPerChunk = static_cast<unsigned int>(std::min<size_t>(
+        std::max<size_t>(LeafChunkSize / (numBrickVals * sizeof(float)), 1),
+        numOtLeaves
+    ));
+
+    struct LeafChunk {
+        unsigned int bstNode;
+        unsigned int firstOtNode;
+        unsigned int numLeaves;
+    };
+    std::vector<LeafChunk> leafChunks;
+    for (int bst = bstOffset; bst < numBstNodes; bst++) {
+        for (int ot = otOffset; ot < numOtNodes; ot += leavesPerChunk) {
+            unsigned int numLeaves = std::min<unsigned int>(
+                leavesPerChunk,
+                numOtNodes - ot
+            );
+            leafChunks.push_back({
+                static_cast<unsigned int>(bst),
+                static_cast<unsigned int>(ot),
+                numLeaves
+            });
+        }
+    }
+
+    auto readChunk = [&](const LeafChunk& chunk, std::vector<float>& values) {
+        values.resize(chunk.numLeaves * numBrickVals);
+        return _tsp->readBricks(
+            *_file,
+            chunk.bstNode * numOtNodes + chunk.firstOtNode,
+            chunk.numLeaves,
+            values.data()
+        );
+    };
+
     int numberOfLeaves = (numBstNodes - bstOffset) * (numOtNodes - otOffset);
     ProgressBar pb(numberOfLeaves);
     int processedLeaves = 0;
-    bool success = true;
-    for (int bst = bstOffset; bst < numBstNodes; bst++) {
-        for (int ot = otOffset; ot < numOtNodes; ot++) {
-            success &= buildFromLeaf(bst, ot);
-            if (!success) return false;
-            pb.print(++processedLeaves);
+
+    ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u));
+    std::array<std::vector<float>, 2> chunkValues;
+    bool success = readChunk(leafChunks.front(), chunkValues[0]);
+    for (size_t i = 0; i < leafChunks.size() && success; ++i) {
+        const LeafChunk& chunk = leafChunks[i];
+        const std::vector<float>& values = chunkValues[i % 2];
+
+        std::vector<std::future<bool>> tasks;
+        tasks.reserve(chunk.numLeaves);
+        for (unsigned int leaf = 0; leaf < chunk.numLeaves; ++leaf) {
+            tasks.push_back(pool.submit([this, &chunk, &values, leaf, numBrickVals]() {
+                return buildFromLeaf(
+                    chunk.bstNode,
+                    chunk.firstOtNode + leaf,
+                    values.data() + leaf * numBrickVals
+                );
+            }));
+        }
+
+        // Read the next chunk while the workers process the current one
+        if (i + 1 < leafChunks.size()) {
+            success &= readChunk(leafChunks[i + 1], chunkValues[(i + 1) % 2]);
         }
+
+        for (std::future<bool>& task : tasks) {
+            success &= task.get();
+        }
+        processedLeaves += chunk.numLeaves;
+        pb.print(processedLeaves);
     }
 
+    _voxelCache.clear();
+    _ancestorFile.close();
     return success;
 }
 
-bool ErrorHistogramManager::buildFromLeaf(unsigned int bstOffset, unsigned int octreeOffset) {
+bool ErrorHistogramManager::buildFromLeaf(unsigned int bstOffset,
+                                          unsigned int octreeOffset,
+                                          const float* leafValues)
+{
     // Traverse all ancestors of leaf and add errors to their histograms
 
     unsigned int brickDim = _tsp->brickDim();
@@ -95,12 +186,8 @@ bool ErrorHistogramManager::buildFromLeaf(unsigned int bstOffset, unsigned int o
     unsigned int padding = (paddedBrickDim - brickDim) / 2;
 
     int numOtNodes = _tsp->numOTNodes();
-    unsigned int leafIndex = bstOffset * numOtNodes + octreeOffset;
-    std::vector<float> leafValues = readValues(leafIndex);
-//    int numVoxels = leafValues.size();
 
     int bstNode = bstOffset;
-    bool bstRightOnly = true;
     unsigned int bstLevel = 0;
 
     do {
@@ -108,24 +195,20 @@ bool ErrorHistogramManager::buildFromLeaf(unsigned int bstOffset, unsigned int o
         glm::vec3 leafOffset(0.0); // Leaf offset in leaf sized voxels
         unsigned int octreeLevel = 0;
         unsigned int octreeNode = octreeOffset;
-        bool octreeLastOnly = true;
         do {
             // Visit ancestor
             if (bstNode != bstOffset || octreeNode != octreeOffset) {
                 // Is actually an ancestor
 
-                std::vector<float> ancestorVoxels;
                 unsigned int ancestorBrickIndex = bstNode * numOtNodes + octreeNode;
                 unsigned int innerNodeIndex = brickToInnerNodeIndex(ancestorBrickIndex);
-                auto it = _voxelCache.find(innerNodeIndex);
-                if (it == _voxelCache.end()) {
-                    // First visit
-                    _histograms[innerNodeIndex] = Histogram(_minBin, _maxBin, _numBins);
-                    ancestorVoxels = readValues(ancestorBrickIndex);
-                    _voxelCache[innerNodeIndex] = ancestorVoxels;
-                } else {
-                    ancestorVoxels = it->second;
-                }
+
+                // The ancestor is compared with every leaf in its subtree
+                unsigned int numVisits = static_cast<unsigned int>(
+                    pow(8, octreeLevel) * pow(2, bstLevel)
+                );
+                std::shared_ptr<const std::vector<float>> ancestorVoxels =
+                    acquireVoxels(innerNodeIndex, ancestorBrickIndex, numVisits);
 
                 float voxelScale = pow(2, octreeLevel);
                 float invVoxelScale = 1.0 / voxelScale;
@@ -133,27 +216,32 @@ bool ErrorHistogramManager::buildFromLeaf(unsigned int bstOffset, unsigned int o
                 // Calculate leaf offset in ancestor sized voxels
                 glm::vec3 ancestorOffset = (leafOffset * invVoxelScale) + glm::vec3(padding - 0.5);
 
+                // Collect the errors locally and merge them into the shared histogram
+                Histogram histogram(_minBin, _maxBin, _numBins);
                 for (int z = 0; z < brickDim; z++) {
                     for (int y = 0; y < brickDim; y++) {
                         for (int x = 0; x < brickDim; x++) {
                             glm::vec3 leafSamplePoint = glm::vec3(x, y, z) + glm::vec3(padding);
                             glm::vec3 ancestorSamplePoint = ancestorOffset + (glm::vec3(x, y, z) + glm::vec3(0.5)) * invVoxelScale;
                             float leafValue = leafValues[linearCoords(leafSamplePoint)];
-                            float ancestorValue = interpolate(ancestorSamplePoint, ancestorVoxels);
+                            float ancestorValue = interpolate(ancestorSamplePoint, *ancestorVoxels);
 
-                            _histograms[innerNodeIndex].addRectangle(leafValue, ancestorValue, std::abs(leafValue - ancestorValue));
+                            histogram.addRectangle(leafValue, ancestorValue, std::abs(leafValue - ancestorValue));
                         }
                     }
                 }
 
-                if (bstRightOnly && octreeLastOnly) {
-                    _voxelCache.erase(innerNodeIndex);
+                {
+                    std::lock_guard<std::mutex> lock(
+                        _histogramMutexes[innerNodeIndex % _histogramMutexes.size()]
+                    );
+                    _histograms[innerNodeIndex].add(histogram);
                 }
+                releaseVoxels(innerNodeIndex);
             }
 
             // Traverse to next octree ancestor
             int octreeChild = (octreeNode - 1) % 8;
-            octreeLastOnly &= octreeChild == 7;
             octreeNode = parentOffset(octreeNode, 8);
 
             int childSize = pow(2, octreeLevel) * brickDim;
@@ -164,7 +252,6 @@ bool ErrorHistogramManager::buildFromLeaf(unsigned int bstOffset, unsigned int o
             octreeLevel++;
         } while (octreeNode != -1);
 
-        bstRightOnly &= (bstNode % 2 == 0);
         bstNode = parentOffset(bstNode, 2);
 
         bstLevel++;
@@ -173,6 +260,33 @@ bool ErrorHistogramManager::buildFromLeaf(unsigned int bstOffset, unsigned int o
     return true;
 }
 
+std::shared_ptr<const std::vector<float>> ErrorHistogramManager::acquireVoxels(
+                                                             unsigned int innerNodeIndex,
+                                                             unsigned int brickIndex,
+                                                             unsigned int numVisits)
+{
+    std::lock_guard<std::mutex> lock(_voxelCacheMutex);
+    auto it = _voxelCache.find(innerNodeIndex);
+    if (it == _voxelCache.end()) {
+        // First visit
+        CachedVoxels voxels = {
+            std::make_shared<const std::vector<float>>(readValues(brickIndex)),
+            numVisits
+        };
+        it = _voxelCache.emplace(innerNodeIndex, std::move(voxels)).first;
+    }
+    return it->second.values;
+}
+
+void ErrorHistogramManager::releaseVoxels(unsigned int innerNodeIndex) {
+    std::lock_guard<std::mutex> lock(_voxelCacheMutex);
+    auto it = _voxelCache.find(innerNodeIndex);
+    if (it != _voxelCache.end() && --(it->second.remainingVisits) == 0) {
+        // The last leaf of the subtree has been compared with the brick
+        _voxelCache.erase(it);
+    }
+}
+
 bool ErrorHistogramManager::loadFromFile(const std::string& filename) {
     std::ifstream file(filename, std::ios::in | std::ios::binary);
     if (!file.is_open()) {
@@ -302,16 +416,12 @@ int ErrorHistogramManager::parentOffset(int offset, int base) const {
     return parentOffset;
 }
 
-std::vector<float> ErrorHistogramManager::readValues(unsigned int brickIndex) const {
+std::vector<float> ErrorHistogramManager::readValues(unsigned int brickIndex) {
     unsigned int paddedBrickDim = _tsp->paddedBrickDim();
     unsigned int numBrickVals = paddedBrickDim * paddedBrickDim * paddedBrickDim;
     std::vector<float> voxelValues(numBrickVals);
 
-    std::streampos offset = _tsp->dataPosition() + static_cast<long long>(brickIndex*numBrickVals*sizeof(float));
-    _file->seekg(offset);
-
-    _file->read(reinterpret_cast<char*>(&voxelValues[0]),
-        static_cast<size_t>(numBrickVals)*sizeof(float));
+    _tsp->readBricks(_ancestorFile, brickIndex, 1, voxelValues.data());
 
     return voxelValues;
 }
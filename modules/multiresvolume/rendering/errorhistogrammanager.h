@@ -28,7 +28,10 @@
 #include <fstream>
 #include <modules/multiresvolume/rendering/tsp.h>
 #include <openspace/util/histogram.h>
+#include <array>
 #include <map>
+#include <memory>
+#include <mutex>
 
 #include <ghoul/glm.h>
 
@@ -46,8 +49,17 @@ public:
     bool saveToFile(const std::string& filename);
 
 private:
+    struct CachedVoxels {
+        std::shared_ptr<const std::vector<float>> values;
+        // Number of leaves that have not been compared with the brick yet
+        unsigned int remainingVisits;
+    };
+
     TSP* _tsp;
     std::ifstream* _file;
+    // Ancestor bricks are read from their own stream, as the leaves are streamed from
+    // _file concurrently
+    std::ifstream _ancestorFile;
 
     std::vector<Histogram> _histograms;
     unsigned int _numInnerNodes;
@@ -55,10 +67,16 @@ private:
     float _maxBin;
     int _numBins;
 
-    std::map<unsigned int, std::vector<float>> _voxelCache;
+    std::map<unsigned int, CachedVoxels> _voxelCache;
+    std::mutex _voxelCacheMutex;
+    std::array<std::mutex, 64> _histogramMutexes;
 
-    bool buildFromLeaf(unsigned int bstOffset, unsigned int octreeOffset);
-    std::vector<float> readValues(unsigned int brickIndex) const;
+    bool buildFromLeaf(unsigned int bstOffset, unsigned int octreeOffset,
+        const float* leafValues);
+    std::shared_ptr<const std::vector<float>> acquireVoxels(unsigned int innerNodeIndex,
+        unsigned int brickIndex, unsigned int numVisits);
+    void releaseVoxels(unsigned int innerNodeIndex);
+    std::vector<float> readValues(unsigned int brickIndex);
 
     int parentOffset(int offset, int base) const;
 
@@ -115,12 +115,7 @@ std::vector<float> HistogramManager::readValues(TSP* tsp, unsigned int brickInde
     unsigned int numBrickVals = paddedBrickDim * paddedBrickDim * paddedBrickDim;
     std::vector<float> voxelValues(numBrickVals);
 
-    std::streampos offset = tsp->dataPosition() + static_cast<long long>(brickIndex*numBrickVals*sizeof(float));
-    std::ifstream& file = tsp->file();
-    file.seekg(offset);
-
-    file.read(reinterpret_cast<char*>(&voxelValues[0]),
-        static_cast<size_t>(numBrickVals)*sizeof(float));
+    tsp->readBricks(tsp->file(), brickIndex, 1, voxelValues.data());
 
     return voxelValues;
 }
@@ -37,11 +37,18 @@
 
 namespace {
     constexpr const char* _loggerCat = "LocalErrorHistogramManager";
+
+    // Maximum number of bricks kept in the voxel cache. The traversal only needs about
+    // one brick per octree and BST level at a time, cache misses are read from disk
+    constexpr const size_t VoxelCacheCapacity = 128;
 } // namespace
 
 namespace openspace {
 
-LocalErrorHistogramManager::LocalErrorHistogramManager(TSP* tsp) : _tsp(tsp) {}
+LocalErrorHistogramManager::LocalErrorHistogramManager(TSP* tsp)
+    : _tsp(tsp)
+    , _voxelCache(VoxelCacheCapacity)
+{}
 
 LocalErrorHistogramManager::~LocalErrorHistogramManager() {}
 
@@ -129,34 +136,11 @@ bool LocalErrorHistogramManager::buildFromOctreeChild(unsigned int bstOffset, un
         if (isOctreeLeaf) {
             childValues = readValues(childIndex);
         } else {
-            unsigned int childInnerNodeIndex = brickToInnerNodeIndex(childIndex);
-            auto it = _voxelCache.find(childInnerNodeIndex);
-            if (it != _voxelCache.end()) {
-                childValues = it->second;
-            } else {
-                LERROR(fmt::format(
-                    "Child {} visited without cache, {}, {}",
-                    childIndex,
-                    bstOffset,
-                    octreeOffset
-                ));
-                return false;
-            }
+            childValues = cachedValues(childIndex);
         }
 
         int octreeChildIndex = (octreeOffset - 1) % 8;
-        if (octreeChildIndex == 0) {
-            parentValues = readValues(parentIndex);
-            _voxelCache[parentInnerNodeIndex] = parentValues;
-        } else {
-            auto it = _voxelCache.find(parentInnerNodeIndex);
-            if (it != _voxelCache.end()) {
-                parentValues = it->second;
-            } else {
-                LERROR(fmt::format("Parent {} visited without cache", parentIndex));
-                return false;
-            }
-        }
+        parentValues = cachedValues(parentIndex);
 
         // Compare values and add errors to parent histogram
         unsigned int paddedBrickDim = _tsp->paddedBrickDim();
@@ -186,11 +170,6 @@ bool LocalErrorHistogramManager::buildFromOctreeChild(unsigned int bstOffset, un
         }
     }
 
-    if (!isOctreeLeaf) {
-        unsigned int childInnerNodeIndex = brickToInnerNodeIndex(childIndex);
-        _voxelCache.erase(childInnerNodeIndex);
-    }
-
     int bstChildIndex = bstOffset % 2;
     bool isLastBstChild = bstOffset > 0 && bstChildIndex == 0;
     if (isOctreeLeaf && isLastBstChild) {
@@ -219,29 +198,11 @@ bool LocalErrorHistogramManager::buildFromBstChild(unsigned int bstOffset, unsig
         if (isBstLeaf) {
             childValues = readValues(childIndex);
         } else {
-            unsigned int childInnerNodeIndex = brickToInnerNodeIndex(childIndex);
-            auto it = _voxelCache.find(childInnerNodeIndex);
-            if (it != _voxelCache.end()) {
-                childValues = it->second;
-            } else {
-                LERROR(fmt::format("Child {} visited without cache", childIndex));
-                return false;
-            }
+            childValues = cachedValues(childIndex);
         }
 
         int bstChildIndex = bstOffset % 2;
-        if (bstChildIndex == 1) {
-            parentValues = readValues(parentIndex);
-            _voxelCache[parentInnerNodeIndex] = parentValues;
-        } else {
-            auto it = _voxelCache.find(parentInnerNodeIndex);
-            if (it != _voxelCache.end()) {
-                parentValues = it->second;
-            } else {
-                LERROR(fmt::format("Parent {} visited without cache", parentIndex));
-                return false;
-            }
-        }
+        parentValues = cachedValues(parentIndex);
 
         // Compare values and add errors to parent histogram
         unsigned int paddedBrickDim = _tsp->paddedBrickDim();
@@ -269,11 +230,6 @@ bool LocalErrorHistogramManager::buildFromBstChild(unsigned int bstOffset, unsig
         }
     }
 
-    if (!isBstLeaf) {
-        unsigned int childInnerNodeIndex = brickToInnerNodeIndex(childIndex);
-        _voxelCache.erase(childInnerNodeIndex);
-    }
-
     int octreeChildIndex = (octreeOffset - 1) % 8;
     bool isLastOctreeChild = octreeOffset > 0 && octreeChildIndex == 7;
     if (isBstLeaf && isLastOctreeChild) {
@@ -441,15 +397,21 @@ std::vector<float> LocalErrorHistogramManager::readValues(unsigned int brickInde
     unsigned int numBrickVals = paddedBrickDim * paddedBrickDim * paddedBrickDim;
     std::vector<float> voxelValues(numBrickVals);
 
-    std::streampos offset = _tsp->dataPosition() + static_cast<long long>(brickIndex*numBrickVals*sizeof(float));
-    _file->seekg(offset);
-
-    _file->read(reinterpret_cast<char*>(&voxelValues[0]),
-        static_cast<size_t>(numBrickVals)*sizeof(float));
+    _tsp->readBricks(*_file, brickIndex, 1, voxelValues.data());
 
     return voxelValues;
 }
 
+const std::vector<float>& LocalErrorHistogramManager::cachedValues(
+                                                                 unsigned int brickIndex)
+{
+    unsigned int innerNodeIndex = brickToInnerNodeIndex(brickIndex);
+    if (!_voxelCache.has(innerNodeIndex)) {
+        _voxelCache.set(innerNodeIndex, readValues(brickIndex));
+    }
+    return _voxelCache.use(innerNodeIndex);
+}
+
 unsigned int LocalErrorHistogramManager::brickToInnerNodeIndex(unsigned int brickIndex) const {
     unsigned int numOtNodes = _tsp->numOTNodes();
     unsigned int numBstLevels = _tsp->numBSTLevels();
@@ -27,8 +27,9 @@
 
 #include <fstream>
 #include <modules/multiresvolume/rendering/tsp.h>
+#include <modules/volume/lrucache.h>
 #include <openspace/util/histogram.h>
-#include <map>
+#include <unordered_map>
 
 #include <ghoul/glm.h>
 
@@ -57,12 +58,15 @@ private:
     float _maxBin;
     int _numBins;
 
-    std::map<unsigned int, std::vector<float>> _voxelCache;
+    // Bounded cache of brick values, keyed by inner node index
+    volume::LruCache<unsigned int, std::vector<float>, std::unordered_map> _voxelCache;
 
     bool buildFromOctreeChild(unsigned int bstOffset, unsigned int octreeOffset);
     bool buildFromBstChild(unsigned int bstOffset, unsigned int octreeOffset);
 
     std::vector<float> readValues(unsigned int brickIndex) const;
+    // Returns the values of an inner node brick, reading them if they are not cached
+    const std::vector<float>& cachedValues(unsigned int brickIndex);
 
     int parentOffset(int offset, int base) const;
 
@@ -326,13 +326,17 @@ bool LocalTfBrickSelector::calculateBrickErrors() {
     TransferFunction *tf = _transferFunction;
     if (!tf) return false;
 
-    size_t tfWidth = tf->width();
+    return calculateBrickErrors(tf->samples());
+}
+
+bool LocalTfBrickSelector::calculateBrickErrors(const std::vector<glm::vec4>& transferFunction) {
+    size_t tfWidth = transferFunction.size();
     if (tfWidth <= 0) return false;
 
     std::vector<float> gradients(tfWidth - 1);
     for (size_t offset = 0; offset < tfWidth - 1; offset++) {
-        glm::vec4 prevRgba = tf->sample(offset);
-        glm::vec4 nextRgba = tf->sample(offset + 1);
+        glm::vec4 prevRgba = transferFunction[offset];
+        glm::vec4 nextRgba = transferFunction[offset + 1];
 
         float colorDifference = glm::distance(prevRgba, nextRgba);
         float alpha = (prevRgba.w + nextRgba.w) * 0.5f;
@@ -26,6 +26,7 @@
 #define __OPENSPACE_MODULE_MULTIRESVOLUME___LOCALTFBRICKSELECTOR___H__
 
 #include <vector>
+#include <ghoul/glm.h>
 #include <modules/multiresvolume/rendering/brickselection.h>
 #include <modules/multiresvolume/rendering/brickselector.h>
 #include <modules/multiresvolume/rendering/brickcover.h>
@@ -53,6 +54,9 @@ public:
     void setMemoryBudget(int memoryBudget);
     void setStreamingBudget(int streamingBudget);
     bool calculateBrickErrors();
+    // Calculates the brick errors from the texels of a transfer function instead of
+    // the transfer function that was passed to the constructor
+    bool calculateBrickErrors(const std::vector<glm::vec4>& transferFunction);
 
 private:
     TSP* _tsp;
@@ -427,7 +427,7 @@ bool RenderableMultiresVolume::setSelectorType(Selector selector) {
 }
 
 void RenderableMultiresVolume::initializeGL() {
-    bool success = _tsp && _tsp->load();
+    bool success = _tsp && _tsp->load() && _tsp->initalizeSSO();
 
     unsigned int maxNumBricks = _tsp->header().xNumBricks_ * _tsp->header().yNumBricks_ * _tsp->header().zNumBricks_;
 
@@ -677,7 +677,9 @@ void RenderableMultiresVolume::update(const UpdateData& data) {
             << _uploadDuration.count() << " "
             << _nUsedBricks << " "
             << _nStreamedBricks << " "
-            << _nDiskReads;
+            << _nDiskReads << " "
+            << _diskReadThroughput << " "
+            << _nStalls;
 
         ofs.close();
 
@@ -746,7 +748,7 @@ void RenderableMultiresVolume::update(const UpdateData& data) {
             uploadStart = selectionEnd;
         }
 
-        _atlasManager->updateAtlas(AtlasManager::EVEN, _brickIndices);
+        _atlasManager->updateAtlas(_brickIndices);
 
         if (_gatheringStats) {
             std::chrono::system_clock::time_point uploadEnd = std::chrono::system_clock::now();
@@ -754,6 +756,8 @@ void RenderableMultiresVolume::update(const UpdateData& data) {
             _nDiskReads = _atlasManager->getNumDiskReads();
             _nUsedBricks = _atlasManager->getNumUsedBricks();
             _nStreamedBricks = _atlasManager->getNumStreamedBricks();
+            _diskReadThroughput = _atlasManager->getDiskReadThroughput();
+            _nStalls = _atlasManager->getNumStalls();
         }
     }
 
@@ -107,6 +107,8 @@ private:
     unsigned int _nDiskReads;
     unsigned int _nUsedBricks;
     unsigned int _nStreamedBricks;
+    float _diskReadThroughput = 0.f;
+    unsigned int _nStalls = 0;
 
     int _timestep;
 
@@ -280,7 +280,13 @@ bool SimpleTfBrickSelector::calculateBrickImportances() {
     TransferFunction *tf = _transferFunction;
     if (!tf) return false;
 
-    size_t tfWidth = tf->width();
+    return calculateBrickImportances(tf->samples());
+}
+
+bool SimpleTfBrickSelector::calculateBrickImportances(
+                                         const std::vector<glm::vec4>& transferFunction)
+{
+    size_t tfWidth = transferFunction.size();
 
     // By changing tfWidth to the correct type size_t, this check is no longer valid since
     // size_t is unsigned ---abock
@@ -307,12 +313,12 @@ bool SimpleTfBrickSelector::calculateBrickImportances() {
         }
 
         float dotProduct = 0;
-        for (size_t i = 0; i < tf->width(); i++) {
+        for (size_t i = 0; i < tfWidth; i++) {
             float x = static_cast<float>(i) / static_cast<float>(tfWidth);
             float sample = histogram->interpolate(x);
 
             ghoul_assert(sample >= 0, "@MISSING");
-            dotProduct += sample * tf->sample(i).w;
+            dotProduct += sample * transferFunction[i].w;
         }
         _brickImportances[brickIndex] = dotProduct;
     }
@@ -29,6 +29,7 @@
 #include <modules/multiresvolume/rendering/brickselector.h>
 #include <modules/multiresvolume/rendering/brickcover.h>
 
+#include <ghoul/glm.h>
 #include <vector>
 
 namespace openspace {
@@ -49,6 +50,9 @@ public:
     void setMemoryBudget(int memoryBudget);
     void setStreamingBudget(int streamingBudget);
     bool calculateBrickImportances();
+    // Calculates the brick importances from the texels of a transfer function instead
+    // of the transfer function that was passed to the constructor
+    bool calculateBrickImportances(const std::vector<glm::vec4>& transferFunction);
  private:
 
     TSP* _tsp;
@@ -29,6 +29,7 @@
 #include <modules/multiresvolume/rendering/brickselector.h>
 #include <modules/multiresvolume/rendering/brickcover.h>
 
+#include <ghoul/glm.h>
 #include <vector>
 
 namespace openspace {
@@ -50,6 +51,12 @@ public:
     void setMemoryBudget(int memoryBudget);
     void setStreamingBudget(int streamingBudget);
     bool calculateBrickErrors();
+    // Calculates the brick errors from the texels of a transfer function instead of
+    // the transfer function that was passed to the constructor
+    bool calculateBrickErrors(const std::vector<glm::vec4>& transferFunction);
+    // The error that the histograms predict for the brick under the current transfer
+    // function, zero for leaves
+    float brickError(unsigned int brickIndex) const;
 
 private:
     TSP* _tsp;
@@ -24,25 +24,36 @@
 
 #include <modules/multiresvolume/rendering/tsp.h>
 
+#include <modules/multiresvolume/rendering/brickcompression.h>
+
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/glm.h>
+#include <openspace/util/threadpool.h>
 
 #include <algorithm>
+#include <array>
 #include <ghoul/fmt.h>
 #include <math.h>
 #include <queue>
+#include <thread>
 
 namespace {
     constexpr const char* _loggerCat = "TSP";
+
+    // Size of the chunks that are read at once when streaming the whole data file
+    constexpr const size_t StreamChunkSize = 128 * 1024 * 1024;
 } // namespace
 
 namespace openspace {
 
 TSP::TSP(const std::string& filename)
     : _filename(filename)
+    , _isCompressed(false)
+    , _compressionHeader({ 0, 0, 0, 0.f })
+    , _brickDataPosition(dataPosition())
     , _dataSSBO(0)
     , paddedBrickDim_(0)
     , numTotalNodes_(0)
@@ -96,7 +107,6 @@ bool TSP::load() {
             }
         }
     }
-    initalizeSSO();
 
     return true;
 }
@@ -108,6 +118,23 @@ bool TSP::readHeader() {
 
     _file.seekg(_file.beg);
 
+    // Compressed files are recognized by their tag; the first value of an uncompressed
+    // file is the grid type
+    _file.read(reinterpret_cast<char*>(&_compressionHeader), sizeof(CompressionHeader));
+    _isCompressed = _file.good() && _compressionHeader.tag == CompressionTag;
+    if (_isCompressed) {
+        if (_compressionHeader.version != CompressionVersion) {
+            LERROR(fmt::format(
+                "Unsupported compressed TSP version {}", _compressionHeader.version
+            ));
+            return false;
+        }
+    }
+    else {
+        _file.clear();
+        _file.seekg(_file.beg);
+    }
+
     _file.read(reinterpret_cast<char*>(&_header), sizeof(Header));
     /*
     file.read(reinterpret_cast<char*>(&gridType_),            sizeof(unsigned int));
@@ -153,6 +180,32 @@ bool TSP::readHeader() {
     data_.resize(numTotalNodes_*NUM_DATA);
     LDEBUG(fmt::format("Data size: {}",  data_.size()));
 
+    if (_isCompressed) {
+        _brickOffsets.resize(static_cast<size_t>(numTotalNodes_) + 1);
+        _file.read(
+            reinterpret_cast<char*>(_brickOffsets.data()),
+            _brickOffsets.size() * sizeof(uint64_t)
+        );
+        if (!_file.good() ||
+            !std::is_sorted(_brickOffsets.begin(), _brickOffsets.end()))
+        {
+            LERROR("Could not read brick offsets");
+            return false;
+        }
+        _brickDataPosition = _file.tellg();
+
+        LDEBUG(fmt::format(
+            "Compression method {}, error bound {}, compressed size {}",
+            _compressionHeader.method,
+            _compressionHeader.errorBound,
+            _brickOffsets.back()
+        ));
+    }
+    else {
+        _brickOffsets.clear();
+        _brickDataPosition = dataPosition();
+    }
+
     return true;
 }
 
@@ -245,10 +298,22 @@ long long TSP::dataPosition() {
     return sizeof(Header);
 }
 
+bool TSP::isCompressed() const {
+    return _isCompressed;
+}
+
+const TSP::CompressionHeader& TSP::compressionHeader() const {
+    return _compressionHeader;
+}
+
 std::ifstream& TSP::file() {
     return _file;
 }
 
+const std::string& TSP::filename() const {
+    return _filename;
+}
+
 unsigned int TSP::numTotalNodes() const { 
     return numTotalNodes_; 
 }
@@ -289,49 +354,220 @@ GLuint TSP::ssbo() const {
     return _dataSSBO;
 }
 
-bool TSP::calculateSpatialError() {
-    unsigned int numBrickVals = paddedBrickDim_*paddedBrickDim_*paddedBrickDim_;
+bool TSP::readBricks(std::ifstream& file, unsigned int firstBrick, unsigned int numBricks,
+                     float* destination, ThreadPool* decompressionPool) const
+{
+    const size_t numBrickVals =
+        static_cast<size_t>(paddedBrickDim_) * paddedBrickDim_ * paddedBrickDim_;
+    const size_t brickSize = numBrickVals * sizeof(float);
+
+    if (!_isCompressed) {
+        file.seekg(dataPosition() + static_cast<long long>(firstBrick * brickSize));
+        file.read(reinterpret_cast<char*>(destination), numBricks * brickSize);
+        return file.good();
+    }
 
-    if (!_file.is_open())
+    if (static_cast<size_t>(firstBrick) + numBricks >= _brickOffsets.size()) {
         return false;
+    }
 
-    std::vector<float> buffer(numBrickVals);
-    std::vector<float> averages(numTotalNodes_);
-    std::vector<float> stdDevs(numTotalNodes_);
+    const uint64_t begin = _brickOffsets[firstBrick];
+    std::vector<char> buffer(storedBricksSize(firstBrick, numBricks));
+    file.seekg(_brickDataPosition + static_cast<long long>(begin));
+    file.read(buffer.data(), buffer.size());
+    if (!file.good()) {
+        return false;
+    }
 
-    // First pass: Calculate average color for each brick
-    LDEBUG("Calculating spatial error, first pass");
-    for (unsigned int brick = 0; brick<numTotalNodes_; ++brick) {
+    auto decompressBricks = [&](unsigned int first, unsigned int end) {
+        bool success = true;
+        for (unsigned int i = first; i < end; ++i) {
+            const uint64_t offset = _brickOffsets[firstBrick + i];
+            success &= brickcompression::decompress(
+                buffer.data() + (offset - begin),
+                static_cast<size_t>(_brickOffsets[firstBrick + i + 1] - offset),
+                _compressionHeader.errorBound,
+                destination + i * numBrickVals,
+                numBrickVals
+            );
+        }
+        return success;
+    };
+
+    if (!decompressionPool || numBricks < 2) {
+        return decompressBricks(0, numBricks);
+    }
+
+    const unsigned int nTasks = std::min(
+        numBricks,
+        static_cast<unsigned int>(decompressionPool->numThreads())
+    );
+    std::vector<std::future<bool>> tasks;
+    tasks.reserve(nTasks);
+    for (unsigned int i = 0; i < nTasks; ++i) {
+        const unsigned int first = i * numBricks / nTasks;
+        const unsigned int end = (i + 1) * numBricks / nTasks;
+        // The caller is waiting for the bricks, so they go ahead of other work
+        tasks.push_back(decompressionPool->submit(
+            [&decompressBricks, first, end]() { return decompressBricks(first, end); },
+            ThreadPool::Priority::High
+        ));
+    }
 
-        // Offset in file
-        std::streampos offset = dataPosition() + static_cast<long long>(brick*numBrickVals*sizeof(float));
-        _file.seekg(offset);
+    bool success = true;
+    for (std::future<bool>& task : tasks) {
+        success &= task.get();
+    }
+    return success;
+}
 
-        _file.read(reinterpret_cast<char*>(&buffer[0]),
-            static_cast<size_t>(numBrickVals)*sizeof(float));
+size_t TSP::storedBricksSize(unsigned int firstBrick, unsigned int numBricks) const {
+    if (static_cast<size_t>(firstBrick) + numBricks > numTotalNodes_) {
+        return 0;
+    }
+    if (!_isCompressed) {
+        return static_cast<size_t>(numBricks) * paddedBrickDim_ * paddedBrickDim_ *
+               paddedBrickDim_ * sizeof(float);
+    }
+    return static_cast<size_t>(
+        _brickOffsets[firstBrick + numBricks] - _brickOffsets[firstBrick]
+    );
+}
+
+const float* TSP::BrickChunk::brick(unsigned int bstNode, unsigned int otNode) const {
+    const size_t index = static_cast<size_t>(bstNode) * numOtNodes + otNode - firstOtNode;
+    return data.data() + index * numBrickVals;
+}
+
+bool TSP::streamOctreeNodes(
+                    const std::function<void(unsigned int, const BrickChunk&)>& function)
+{
+    if (numOTNodes_ == 0 || numBSTNodes_ == 0) {
+        // Nothing to stream; this also avoids dividing by an octree node size of zero
+        // and reading a first chunk that does not exist
+        return true;
+    }
 
-        double average = 0.0;
-        for (auto it = buffer.begin(); it != buffer.end(); ++it) {
-            average += *it;
+    const size_t numBrickVals =
+        static_cast<size_t>(paddedBrickDim_) * paddedBrickDim_ * paddedBrickDim_;
+    const size_t otNodeSize = numBSTNodes_ * numBrickVals * sizeof(float);
+    const unsigned int otNodesPerChunk = static_cast<unsigned int>(std::min<size_t>(
+        std::max<size_t>(StreamChunkSize / otNodeSize, 1),
+        numOTNodes_
+    ));
+
+    // The pool also decompresses the bricks of compressed files while they are read
+    ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u));
+
+    auto readChunk = [&](unsigned int firstOtNode, BrickChunk& chunk) {
+        chunk.firstOtNode = firstOtNode;
+        chunk.numOtNodes = std::min(otNodesPerChunk, numOTNodes_ - firstOtNode);
+        chunk.numBrickVals = numBrickVals;
+        chunk.data.resize(numBSTNodes_ * chunk.numOtNodes * numBrickVals);
+
+        // The bricks of consecutive octree nodes are stored next to each other within
+        // every BST node, so one read per BST node is enough
+        bool success = true;
+        for (unsigned int bst = 0; bst < numBSTNodes_; ++bst) {
+            success &= readBricks(
+                _file,
+                bst * numOTNodes_ + firstOtNode,
+                chunk.numOtNodes,
+                chunk.data.data() + bst * chunk.numOtNodes * numBrickVals,
+                &pool
+            );
         }
+        return success;
+    };
 
-        averages[brick] = static_cast<float>(average / static_cast<double>(numBrickVals));
+    const unsigned int tasksPerChunk = static_cast<unsigned int>(pool.numThreads() * 4);
+
+    std::array<BrickChunk, 2> chunks;
+    if (!readChunk(0, chunks[0])) {
+        LERROR("Could not read brick data");
+        return false;
     }
 
-    // Spatial SNR stats
-    float minError = 1e20f;
-    float maxError = 0.f;
-    std::vector<float> medianArray(numTotalNodes_);
+    unsigned int current = 0;
+    for (unsigned int first = 0; first < numOTNodes_; first += otNodesPerChunk) {
+        const BrickChunk& chunk = chunks[current];
+
+        const unsigned int nTasks = std::min(chunk.numOtNodes, tasksPerChunk);
+        std::vector<std::future<void>> tasks;
+        tasks.reserve(nTasks);
+        for (unsigned int i = 0; i < nTasks; ++i) {
+            const unsigned int begin = first + i * chunk.numOtNodes / nTasks;
+            const unsigned int end = first + (i + 1) * chunk.numOtNodes / nTasks;
+            tasks.push_back(pool.submit([&function, &chunk, begin, end]() {
+                for (unsigned int otNode = begin; otNode < end; ++otNode) {
+                    function(otNode, chunk);
+                }
+            }));
+        }
+
+        // Read the next chunk while the workers process the current one
+        bool success = true;
+        const unsigned int next = first + otNodesPerChunk;
+        if (next < numOTNodes_) {
+            success = readChunk(next, chunks[1 - current]);
+        }
+
+        for (std::future<void>& task : tasks) {
+            task.get();
+        }
+        if (!success) {
+            LERROR("Could not read brick data");
+            return false;
+        }
+        current = 1 - current;
+    }
+    return true;
+}
+
+bool TSP::calculateSpatialError() {
+    const size_t numBrickVals =
+        static_cast<size_t>(paddedBrickDim_) * paddedBrickDim_ * paddedBrickDim_;
+
+    if (!_file.is_open())
+        return false;
+
+    std::vector<double> sums(numTotalNodes_);
+    std::vector<double> squaredSums(numTotalNodes_);
+    std::vector<float> stdDevs(numTotalNodes_);
+
+    // First pass: Calculate the sum and the sum of squares of the voxels in each brick
+    LDEBUG("Calculating spatial error, first pass");
+    const bool success = streamOctreeNodes(
+        [&](unsigned int otNode, const BrickChunk& chunk) {
+            for (unsigned int bst = 0; bst < numBSTNodes_; ++bst) {
+                const float* values = chunk.brick(bst, otNode);
+
+                double sum = 0.0;
+                double squaredSum = 0.0;
+                for (size_t i = 0; i < numBrickVals; ++i) {
+                    sum += values[i];
+                    squaredSum += static_cast<double>(values[i]) * values[i];
+                }
+
+                const unsigned int brick = bst * numOTNodes_ + otNode;
+                sums[brick] = sum;
+                squaredSums[brick] = squaredSum;
+            }
+        }
+    );
+    if (!success) {
+        return false;
+    }
 
     // Second pass: For each brick, compare the covered leaf voxels with
-    // the brick average
+    // the brick average. The squared deviations are expanded into
+    // sum(v^2) - 2 * avg * sum(v) + n * avg^2, so the leaves are not read again
     LDEBUG("Calculating spatial error, second pass");
     for (unsigned int brick = 0; brick<numTotalNodes_; ++brick) {
 
-        // Fetch mean intensity 
-        float brickAvg = averages[brick];
+        // Fetch mean intensity
+        const float brickAvg = static_cast<float>(sums[brick] / numBrickVals);
 
-        // Sum  for std dev computation
         float stdDev = 0.f;
 
         // Get a list of leaf bricks that the current brick covers
@@ -345,59 +581,23 @@ bool TSP::calculateSpatialError() {
             stdDev = -0.1f;
         }
         else {
-
-            // Calculate "standard deviation" corresponding to leaves
-            for (auto lb = coveredLeafBricks.begin();
-                lb != coveredLeafBricks.end(); ++lb) {
-
-                // Read brick
-                std::streampos offset = dataPosition() + static_cast<long long>((*lb)*numBrickVals*sizeof(float));
-                _file.seekg(offset);
-
-                _file.read(reinterpret_cast<char*>(&buffer[0]),
-                    static_cast<size_t>(numBrickVals)*sizeof(float));
-
-                // Add to sum
-                for (auto v = buffer.begin(); v != buffer.end(); ++v) {
-                    stdDev += pow(*v - brickAvg, 2.f);
-                }
-
-
-            }
-
-            // Finish calculation
-            if (sizeof(float) != sizeof(int)) {
-                LERROR("Float and int sizes don't match, can't reintepret");
-                return false;
+            double leafSum = 0.0;
+            double leafSquaredSum = 0.0;
+            for (unsigned int leaf : coveredLeafBricks) {
+                leafSum += sums[leaf];
+                leafSquaredSum += squaredSums[leaf];
             }
 
-            stdDev /= static_cast<float>(coveredLeafBricks.size()*numBrickVals);
-            stdDev = sqrt(stdDev);
+            const double n = static_cast<double>(coveredLeafBricks.size() * numBrickVals);
+            const double squaredDeviations =
+                leafSquaredSum - 2.0 * brickAvg * leafSum + n * brickAvg * brickAvg;
 
-        } // if not leaf
-
-        if (stdDev < minError) {
-            minError = stdDev;
-        }
-        else if (stdDev > maxError) {
-            maxError = stdDev;
+            stdDev = static_cast<float>(sqrt(std::max(squaredDeviations, 0.0) / n));
         }
 
         stdDevs[brick] = stdDev;
-        medianArray[brick] = stdDev;
-
     }
 
-    std::sort(medianArray.begin(), medianArray.end());
-    //float medError = medianArray[medianArray.size()/2];
-
-    /*
-    LDEBUG("\nMin spatial std dev: " << minError);
-    LDEBUG("Max spatial std dev: " << maxError);
-    LDEBUG("Median spatial std dev: " << medError);
-    LDEBUG("");
-    */
-
     // "Normalize" errors
     float minNorm = 1e20f;
     float maxNorm = 0.f;
@@ -431,98 +631,69 @@ bool TSP::calculateSpatialError() {
 }
 
 bool TSP::calculateTemporalError() {
+    const size_t numBrickVals =
+        static_cast<size_t>(paddedBrickDim_) * paddedBrickDim_ * paddedBrickDim_;
 
     if (!_file.is_open())
         return false;
 
     LDEBUG("Calculating temporal error");
 
-    // Statistics
-    //float minErr = 1e20f;
-    //float maxErr = 0.f;
-    std::vector<float> meanArray(numTotalNodes_);
-
     // Save errors
     std::vector<float> errors(numTotalNodes_);
 
-    // Calculate temporal error for one brick at a time
-    for (unsigned int brick = 0; brick<numTotalNodes_; ++brick) {
-
-        unsigned int numBrickVals =
-            paddedBrickDim_*paddedBrickDim_*paddedBrickDim_;
-
-        // Save the individual voxel's average over timesteps. Because the
-        // BSTs are built by averaging leaf nodes, we only need to sample
-        // the brick at the correct coordinate.
-        std::vector<float> voxelAverages(numBrickVals);
-        std::vector<float> voxelStdDevs(numBrickVals);
-
-        // Read the whole brick to fill the averages
-        std::streampos offset = dataPosition() + static_cast<long long>(brick*numBrickVals*sizeof(float));
-        _file.seekg(offset);
-
-        _file.read(reinterpret_cast<char*>(&voxelAverages[0]),
-            static_cast<size_t>(numBrickVals)*sizeof(float));
-
-        // Build a list of the BST leaf bricks (within the same octree level) that
-        // this brick covers
-        std::list<unsigned int> coveredBricks = CoveredBSTLeafBricks(brick);
-
-        // If the brick is at the lowest BST level, automatically set the error 
-        // to -0.1 (enables using -1 as a marker for "no error accepted");
-        // Somewhat ad hoc to get around the fact that the error could be
-        // 0.0 higher up in the tree
-        if (coveredBricks.size() == 1) {
-            errors[brick] = -0.1f;
-        } else {
-            // Calculate standard deviation per voxel, average over brick
-            float avgStdDev = 0.f;
-            for (unsigned int voxel = 0; voxel<numBrickVals; ++voxel) {
-
-                float stdDev = 0.f;
-                for (auto leaf = coveredBricks.begin();
-                    leaf != coveredBricks.end(); ++leaf) {
-
-                    // Sample the leaves at the corresponding voxel position
-
-                    std::streampos offset = dataPosition() + static_cast<long long>((*leaf*numBrickVals + voxel)*sizeof(float));
-                    _file.seekg(offset);
-
-                    float sample;
-                    _file.read(reinterpret_cast<char*>(&sample), sizeof(float));
-
-                    stdDev += pow(sample - voxelAverages[voxel], 2.f);
+    // All BST nodes of an octree node are part of the same chunk, so the temporal
+    // error of a brick can be computed from memory
+    const bool success = streamOctreeNodes(
+        [&](unsigned int otNode, const BrickChunk& chunk) {
+            for (unsigned int bst = 0; bst < numBSTNodes_; ++bst) {
+                const unsigned int brick = bst * numOTNodes_ + otNode;
+
+                // Save the individual voxel's average over timesteps. Because the
+                // BSTs are built by averaging leaf nodes, we only need to sample
+                // the brick at the correct coordinate.
+                const float* voxelAverages = chunk.brick(bst, otNode);
+
+                // Build a list of the BST leaf bricks (within the same octree level)
+                // that this brick covers
+                std::list<unsigned int> coveredBricks = CoveredBSTLeafBricks(brick);
+
+                // If the brick is at the lowest BST level, automatically set the error
+                // to -0.1 (enables using -1 as a marker for "no error accepted");
+                // Somewhat ad hoc to get around the fact that the error could be
+                // 0.0 higher up in the tree
+                if (coveredBricks.size() == 1) {
+                    errors[brick] = -0.1f;
+                    continue;
                 }
-                stdDev /= static_cast<float>(coveredBricks.size());
-                stdDev = sqrt(stdDev);
 
-                avgStdDev += stdDev;
-            } // for voxel
-
-            avgStdDev /= static_cast<float>(numBrickVals);
-            meanArray[brick] = avgStdDev;
-            errors[brick] = avgStdDev;
+                std::vector<const float*> leaves;
+                leaves.reserve(coveredBricks.size());
+                for (unsigned int leaf : coveredBricks) {
+                    leaves.push_back(chunk.brick(leaf / numOTNodes_, otNode));
+                }
 
-        }
+                // Calculate standard deviation per voxel, average over brick
+                float avgStdDev = 0.f;
+                for (size_t voxel = 0; voxel < numBrickVals; ++voxel) {
+                    float stdDev = 0.f;
+                    for (const float* leaf : leaves) {
+                        stdDev += pow(leaf[voxel] - voxelAverages[voxel], 2.f);
+                    }
+                    stdDev /= static_cast<float>(leaves.size());
+                    stdDev = sqrt(stdDev);
+
+                    avgStdDev += stdDev;
+                }
 
-        /*
-        if (avgStdDev < minErr) {
-        minErr = avgStdDev;
-        } else if (avgStdDev > maxErr) {
-        maxErr = avgStdDev;
+                avgStdDev /= static_cast<float>(numBrickVals);
+                errors[brick] = avgStdDev;
+            }
         }
-        */
-
-    } // for all bricks
-
-    std::sort(meanArray.begin(), meanArray.end());
-    //float medErr = meanArray[meanArray.size()/2];
-
-    /*
-    LDEBUG("\nMin temporal error: " << minErr);
-    LDEBUG("Max temporal error: " << maxErr);
-    LDEBUG("Median temporal error: " << medErr);
-    */
+    );
+    if (!success) {
+        return false;
+    }
 
     // Adjust errors using user-provided exponents
     float minNorm = 1e20f;
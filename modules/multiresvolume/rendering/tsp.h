@@ -25,15 +25,20 @@
 #ifndef __OPENSPACE_MODULE_MULTIRESVOLUME___TSP___H__
 #define __OPENSPACE_MODULE_MULTIRESVOLUME___TSP___H__
 
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <list>
 #include <iostream>
 #include <fstream>
+#include <functional>
 
 #include <ghoul/opengl/ghoul_gl.h>
 
 namespace openspace {
+
+class ThreadPool;
+
 class TSP {
 public:
     struct Header {
@@ -48,6 +53,20 @@ public:
         unsigned int zNumBricks_;
     };
 
+    // Compressed TSP files start with this header, followed by the regular Header, a table
+    // of numTotalNodes + 1 brick offsets and the compressed bricks. The offsets are
+    // uint64_t values relative to the end of the table; brick i is stored between
+    // offsets i and i + 1
+    struct CompressionHeader {
+        uint32_t tag;
+        uint32_t version;
+        // A brickcompression::Method
+        uint32_t method;
+        float errorBound;
+    };
+    static constexpr const uint32_t CompressionTag = 0x43505354; // "TSPC"
+    static constexpr const uint32_t CompressionVersion = 1;
+
     enum NodeData {
         BRICK_INDEX = 0,
         CHILD_INDEX,
@@ -60,7 +79,8 @@ public:
     ~TSP();
 
     // load performs readHeader, readCache, writeCache and construct
-    // in the correct sequence
+    // in the correct sequence. It does not touch OpenGL, the structure is
+    // uploaded separately with initalizeSSO
     bool load();
 
     bool readHeader();
@@ -70,8 +90,12 @@ public:
     bool initalizeSSO();
 
     const Header& header() const;
+    // The position of the bricks in uncompressed TSP files
     static long long dataPosition();
+    bool isCompressed() const;
+    const CompressionHeader& compressionHeader() const;
     std::ifstream& file();
+    const std::string& filename() const;
     unsigned int numTotalNodes() const;
     unsigned int numValuesPerNode() const;
     unsigned int numBSTNodes() const;
@@ -83,6 +107,18 @@ public:
     unsigned int numBricksPerAxis() const;
     GLuint ssbo() const;
 
+    // Reads numBricks consecutive bricks, starting at firstBrick, from the passed file
+    // with a single read. The destination has to hold numBricks * paddedBrickDim^3
+    // values. The bricks of compressed files are decompressed on the calling thread, or
+    // in parallel on the decompressionPool if one is passed. The pool must not be the
+    // one that is running the caller
+    bool readBricks(std::ifstream& file, unsigned int firstBrick, unsigned int numBricks,
+        float* destination, ThreadPool* decompressionPool = nullptr) const;
+
+    // Returns the number of bytes that numBricks consecutive bricks, starting at
+    // firstBrick, take up in the file, or 0 if the bricks are not all in the tree
+    size_t storedBricksSize(unsigned int firstBrick, unsigned int numBricks) const;
+
     bool calculateSpatialError();
     bool calculateTemporalError();
 
@@ -97,6 +133,23 @@ public:
     bool isOctreeLeaf(unsigned int _brickIndex);
 
 private:
+    // The bricks of a range of consecutive octree nodes, for all BST nodes
+    struct BrickChunk {
+        const float* brick(unsigned int bstNode, unsigned int otNode) const;
+
+        unsigned int firstOtNode = 0;
+        unsigned int numOtNodes = 0;
+        size_t numBrickVals = 0;
+        std::vector<float> data;
+    };
+
+    // Streams the brick data in chunks of consecutive octree nodes and calls the
+    // function once for every octree node on a pool of worker threads. Every chunk is
+    // read with one sequential read per BST node while the workers are busy with the
+    // previous chunk
+    bool streamOctreeNodes(
+        const std::function<void(unsigned int, const BrickChunk&)>& function);
+
     // Returns a list of the octree leaf nodes that a given input
     // brick covers. If the input is already a leaf, the list will
     // only contain that one index.
@@ -113,6 +166,11 @@ private:
     std::ifstream _file;
     std::streampos _dataOffset;
 
+    bool _isCompressed;
+    CompressionHeader _compressionHeader;
+    std::vector<uint64_t> _brickOffsets;
+    long long _brickDataPosition;
+
     // Holds the actual structure
     std::vector<int> data_;
     GLuint _dataSSBO;
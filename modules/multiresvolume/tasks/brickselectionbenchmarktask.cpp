@@ -0,0 +1,551 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/multiresvolume/tasks/brickselectionbenchmarktask.h>
+
+#include <modules/multiresvolume/rendering/errorhistogrammanager.h>
+#include <modules/multiresvolume/rendering/histogrammanager.h>
+#include <modules/multiresvolume/rendering/localerrorhistogrammanager.h>
+#include <modules/multiresvolume/rendering/localtfbrickselector.h>
+#include <modules/multiresvolume/rendering/shenbrickselector.h>
+#include <modules/multiresvolume/rendering/simpletfbrickselector.h>
+#include <modules/multiresvolume/rendering/tfbrickselector.h>
+#include <modules/multiresvolume/rendering/tsp.h>
+
+#include <openspace/documentation/verifier.h>
+#include <openspace/rendering/transferfunction.h>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <unordered_set>
+
+namespace {
+    constexpr const char* _loggerCat = "BrickSelectionBenchmarkTask";
+
+    constexpr const char* KeyTsp = "Tsp";
+    constexpr const char* KeyReplay = "Replay";
+    constexpr const char* KeyErrorHistograms = "ErrorHistograms";
+    constexpr const char* KeyLocalErrorHistograms = "LocalErrorHistograms";
+    constexpr const char* KeyHistograms = "Histograms";
+    constexpr const char* KeyOutput = "Output";
+    constexpr const char* KeySelectors = "Selectors";
+    constexpr const char* KeyMemoryBudget = "MemoryBudget";
+    constexpr const char* KeyStreamingBudget = "StreamingBudget";
+    constexpr const char* KeySpatialTolerance = "SpatialTolerance";
+    constexpr const char* KeyTemporalTolerance = "TemporalTolerance";
+
+    constexpr const char* SelectorTf = "Tf";
+    constexpr const char* SelectorLocal = "Local";
+    constexpr const char* SelectorSimple = "Simple";
+    constexpr const char* SelectorShen = "Shen";
+
+    constexpr const int DefaultBudget = 2048;
+    constexpr const float DefaultTolerance = 1.f;
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    double milliseconds(Clock::time_point start, Clock::time_point end) {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+} // namespace
+
+namespace openspace {
+
+BrickSelectionBenchmarkTask::BrickSelectionBenchmarkTask(
+                                                      const ghoul::Dictionary& dictionary)
+    : _memoryBudget(DefaultBudget)
+    , _streamingBudget(DefaultBudget)
+    , _spatialTolerance(DefaultTolerance)
+    , _temporalTolerance(DefaultTolerance)
+{
+    openspace::documentation::testSpecificationAndThrow(
+        documentation(),
+        dictionary,
+        "BrickSelectionBenchmarkTask"
+    );
+
+    _tspPath = absPath(dictionary.value<std::string>(KeyTsp));
+    _replayPath = absPath(dictionary.value<std::string>(KeyReplay));
+    _errorHistogramsPath = absPath(dictionary.value<std::string>(KeyErrorHistograms));
+
+    if (dictionary.hasKey(KeyLocalErrorHistograms)) {
+        _localErrorHistogramsPath = absPath(
+            dictionary.value<std::string>(KeyLocalErrorHistograms)
+        );
+    }
+    if (dictionary.hasKey(KeyHistograms)) {
+        _histogramsPath = absPath(dictionary.value<std::string>(KeyHistograms));
+    }
+    if (dictionary.hasKey(KeyOutput)) {
+        _outputPath = absPath(dictionary.value<std::string>(KeyOutput));
+    }
+
+    if (dictionary.hasKey(KeySelectors)) {
+        ghoul::Dictionary selectors = dictionary.value<ghoul::Dictionary>(KeySelectors);
+        for (size_t i = 1; i <= selectors.size(); ++i) {
+            _selectors.push_back(selectors.value<std::string>(std::to_string(i)));
+        }
+    }
+    else {
+        // Run every selector whose histograms are available
+        _selectors.push_back(SelectorTf);
+        if (!_localErrorHistogramsPath.empty()) {
+            _selectors.push_back(SelectorLocal);
+        }
+        if (!_histogramsPath.empty()) {
+            _selectors.push_back(SelectorSimple);
+        }
+        _selectors.push_back(SelectorShen);
+    }
+
+    if (dictionary.hasKey(KeyMemoryBudget)) {
+        _memoryBudget = static_cast<int>(dictionary.value<double>(KeyMemoryBudget));
+    }
+    if (dictionary.hasKey(KeyStreamingBudget)) {
+        _streamingBudget = static_cast<int>(
+            dictionary.value<double>(KeyStreamingBudget)
+        );
+    }
+    if (dictionary.hasKey(KeySpatialTolerance)) {
+        _spatialTolerance = static_cast<float>(
+            dictionary.value<double>(KeySpatialTolerance)
+        );
+    }
+    if (dictionary.hasKey(KeyTemporalTolerance)) {
+        _temporalTolerance = static_cast<float>(
+            dictionary.value<double>(KeyTemporalTolerance)
+        );
+    }
+}
+
+std::string BrickSelectionBenchmarkTask::description() {
+    return "Replay the timesteps and transfer functions in " + _replayPath +
+        " through the brick selectors of " + _tspPath;
+}
+
+void BrickSelectionBenchmarkTask::perform(const Task::ProgressCallback& progressCallback)
+{
+    if (!readReplay()) {
+        progressCallback(1.f);
+        return;
+    }
+
+    TSP tsp(_tspPath);
+    if (!tsp.load()) {
+        LERROR(fmt::format("Could not load TSP file '{}'", _tspPath));
+        progressCallback(1.f);
+        return;
+    }
+
+    // Read every transfer function once, so that parsing them is not measured
+    std::map<std::string, std::vector<glm::vec4>> transferFunctions;
+    for (const Frame& frame : _frames) {
+        if (transferFunctions.find(frame.transferFunction) != transferFunctions.end()) {
+            continue;
+        }
+        std::vector<glm::vec4> samples;
+        try {
+            samples = TransferFunction::samplesFromTxt(frame.transferFunction);
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC(e.component, e.message);
+        }
+        if (samples.empty()) {
+            LERROR(fmt::format(
+                "Could not read transfer function '{}'", frame.transferFunction
+            ));
+            progressCallback(1.f);
+            return;
+        }
+        transferFunctions[frame.transferFunction] = std::move(samples);
+    }
+
+    ErrorHistogramManager errorHistograms(&tsp);
+    if (!errorHistograms.loadFromFile(_errorHistogramsPath)) {
+        LERROR(fmt::format(
+            "Could not load error histograms from '{}'", _errorHistogramsPath
+        ));
+        progressCallback(1.f);
+        return;
+    }
+
+    // All selections are scored with the same transfer function dependent errors
+    TfBrickSelector scorer(
+        &tsp,
+        &errorHistograms,
+        nullptr,
+        _memoryBudget,
+        _streamingBudget
+    );
+
+    std::vector<std::pair<std::string, std::vector<FrameStats>>> results;
+    for (size_t i = 0; i < _selectors.size(); ++i) {
+        const std::string& name = _selectors[i];
+        auto progress = [&](float p) {
+            progressCallback((i + p) / _selectors.size());
+        };
+        auto replaySelector = [&](BrickSelector& selector,
+            const std::function<bool(const std::vector<glm::vec4>&)>& updateErrors)
+        {
+            results.emplace_back(
+                name,
+                replay(tsp, transferFunctions, selector, scorer, updateErrors, progress)
+            );
+        };
+
+        if (name == SelectorTf) {
+            TfBrickSelector selector(
+                &tsp,
+                &errorHistograms,
+                nullptr,
+                _memoryBudget,
+                _streamingBudget
+            );
+            replaySelector(selector, [&selector](const std::vector<glm::vec4>& tf) {
+                return selector.calculateBrickErrors(tf);
+            });
+        }
+        else if (name == SelectorLocal) {
+            LocalErrorHistogramManager histograms(&tsp);
+            if (!histograms.loadFromFile(_localErrorHistogramsPath)) {
+                LERROR(fmt::format(
+                    "Could not load local error histograms from '{}'",
+                    _localErrorHistogramsPath
+                ));
+                continue;
+            }
+            LocalTfBrickSelector selector(
+                &tsp,
+                &histograms,
+                nullptr,
+                _memoryBudget,
+                _streamingBudget
+            );
+            replaySelector(selector, [&selector](const std::vector<glm::vec4>& tf) {
+                return selector.calculateBrickErrors(tf);
+            });
+        }
+        else if (name == SelectorSimple) {
+            HistogramManager histograms;
+            if (!histograms.loadFromFile(_histogramsPath)) {
+                LERROR(fmt::format(
+                    "Could not load histograms from '{}'", _histogramsPath
+                ));
+                continue;
+            }
+            SimpleTfBrickSelector selector(
+                &tsp,
+                &histograms,
+                nullptr,
+                _memoryBudget,
+                _streamingBudget
+            );
+            replaySelector(selector, [&selector](const std::vector<glm::vec4>& tf) {
+                return selector.calculateBrickImportances(tf);
+            });
+        }
+        else if (name == SelectorShen) {
+            ShenBrickSelector selector(&tsp, _spatialTolerance, _temporalTolerance);
+            replaySelector(selector, [](const std::vector<glm::vec4>&) {
+                return true;
+            });
+        }
+        else {
+            LERROR(fmt::format("Unknown brick selector '{}'", name));
+        }
+    }
+
+    for (const std::pair<std::string, std::vector<FrameStats>>& result : results) {
+        report(result.first, result.second);
+    }
+
+    if (!_outputPath.empty()) {
+        std::ofstream file(_outputPath);
+        if (!file.good()) {
+            LERROR(fmt::format("Could not write to '{}'", _outputPath));
+            progressCallback(1.f);
+            return;
+        }
+        file << "selector,frame,timestep,selection_ms,error_update_ms,used_bricks,"
+                "streamed_bricks,memory_utilization,streaming_utilization,error\n";
+        for (const std::pair<std::string, std::vector<FrameStats>>& result : results) {
+            for (size_t i = 0; i < result.second.size(); ++i) {
+                const FrameStats& stats = result.second[i];
+                file << result.first << ','
+                     << i << ','
+                     << _frames[i].timestep << ','
+                     << stats.selectionTime << ','
+                     << stats.errorUpdateTime << ','
+                     << stats.nUsedBricks << ','
+                     << stats.nStreamedBricks << ','
+                     << static_cast<float>(stats.nUsedBricks) / _memoryBudget << ','
+                     << static_cast<float>(stats.nStreamedBricks) / _streamingBudget
+                     << ','
+                     << stats.error << '\n';
+            }
+        }
+    }
+
+    progressCallback(1.f);
+}
+
+bool BrickSelectionBenchmarkTask::readReplay() {
+    std::ifstream file(_replayPath);
+    if (!file.good()) {
+        LERROR(fmt::format("Could not open replay file '{}'", _replayPath));
+        return false;
+    }
+
+    // Every line holds a timestep and the transfer function used in that frame
+    _frames.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream iss(line);
+        Frame frame;
+        if (!(iss >> frame.timestep >> frame.transferFunction)) {
+            LERROR(fmt::format("Malformed line in replay file: '{}'", line));
+            return false;
+        }
+        frame.transferFunction = absPath(frame.transferFunction);
+        _frames.push_back(std::move(frame));
+    }
+
+    if (_frames.empty()) {
+        LERROR(fmt::format("Replay file '{}' contains no frames", _replayPath));
+        return false;
+    }
+    return true;
+}
+
+std::vector<BrickSelectionBenchmarkTask::FrameStats> BrickSelectionBenchmarkTask::replay(
+              TSP& tsp,
+              const std::map<std::string, std::vector<glm::vec4>>& transferFunctions,
+              BrickSelector& selector, TfBrickSelector& scorer,
+              const std::function<bool(const std::vector<glm::vec4>&)>& updateErrors,
+              const std::function<void(float)>& progress)
+{
+    const TSP::Header& header = tsp.header();
+    const int numTimesteps = static_cast<int>(header.numTimesteps_);
+    const size_t nCells = static_cast<size_t>(header.xNumBricks_) *
+                          header.yNumBricks_ * header.zNumBricks_;
+
+    std::vector<int> bricks(nCells, 0);
+    std::vector<FrameStats> stats(_frames.size());
+    std::unordered_set<int> previousBricks;
+    std::unordered_set<int> currentBricks;
+    const std::string* currentTransferFunction = nullptr;
+
+    for (size_t i = 0; i < _frames.size(); ++i) {
+        const Frame& frame = _frames[i];
+        FrameStats& frameStats = stats[i];
+
+        if (!currentTransferFunction ||
+            *currentTransferFunction != frame.transferFunction)
+        {
+            const std::vector<glm::vec4>& tf = transferFunctions.at(
+                frame.transferFunction
+            );
+
+            Clock::time_point start = Clock::now();
+            const bool success = updateErrors(tf);
+            frameStats.errorUpdateTime = milliseconds(start, Clock::now());
+
+            if (!success || !scorer.calculateBrickErrors(tf)) {
+                LERROR(fmt::format(
+                    "Could not calculate brick errors for '{}'", frame.transferFunction
+                ));
+                return {};
+            }
+            currentTransferFunction = &frame.transferFunction;
+        }
+
+        const int timestep = std::min(std::max(frame.timestep, 0), numTimesteps - 1);
+        Clock::time_point start = Clock::now();
+        selector.selectBricks(timestep, bricks);
+        frameStats.selectionTime = milliseconds(start, Clock::now());
+
+        // Bricks that were not used in the previous frame have to be streamed
+        currentBricks.clear();
+        currentBricks.insert(bricks.begin(), bricks.end());
+        frameStats.nUsedBricks = static_cast<int>(currentBricks.size());
+        for (int brick : currentBricks) {
+            if (previousBricks.find(brick) == previousBricks.end()) {
+                ++frameStats.nStreamedBricks;
+            }
+        }
+        std::swap(previousBricks, currentBricks);
+
+        double error = 0.0;
+        for (int brick : bricks) {
+            error += scorer.brickError(brick);
+        }
+        frameStats.error = static_cast<float>(error / nCells);
+
+        progress(static_cast<float>(i + 1) / _frames.size());
+    }
+    return stats;
+}
+
+void BrickSelectionBenchmarkTask::report(const std::string& name,
+                                         const std::vector<FrameStats>& stats) const
+{
+    if (stats.empty()) {
+        return;
+    }
+
+    double totalSelectionTime = 0.0;
+    double maxSelectionTime = 0.0;
+    double totalErrorUpdateTime = 0.0;
+    double totalUsedBricks = 0.0;
+    double totalStreamedBricks = 0.0;
+    double totalError = 0.0;
+    for (const FrameStats& frame : stats) {
+        totalSelectionTime += frame.selectionTime;
+        maxSelectionTime = std::max(maxSelectionTime, frame.selectionTime);
+        totalErrorUpdateTime += frame.errorUpdateTime;
+        totalUsedBricks += frame.nUsedBricks;
+        totalStreamedBricks += frame.nStreamedBricks;
+        totalError += frame.error;
+    }
+    const double n = static_cast<double>(stats.size());
+
+    LINFO(fmt::format(
+        "{}: selection {:.3f} ms mean, {:.3f} ms max, error updates {:.3f} ms in total",
+        name, totalSelectionTime / n, maxSelectionTime, totalErrorUpdateTime
+    ));
+    LINFO(fmt::format(
+        "{}: {:.1f} bricks used ({:.1f}% of the memory budget), {:.1f} bricks "
+        "streamed ({:.1f}% of the streaming budget), mean error {}",
+        name,
+        totalUsedBricks / n,
+        100.0 * totalUsedBricks / n / _memoryBudget,
+        totalStreamedBricks / n,
+        100.0 * totalStreamedBricks / n / _streamingBudget,
+        totalError / n
+    ));
+}
+
+documentation::Documentation BrickSelectionBenchmarkTask::documentation() {
+    using namespace documentation;
+    return {
+        "BrickSelectionBenchmarkTask",
+        "multiresvolume_brick_selection_benchmark_task",
+        {
+            {
+                "Type",
+                new StringEqualVerifier("BrickSelectionBenchmarkTask"),
+                Optional::No,
+                "The type of this task",
+            },
+            {
+                KeyTsp,
+                new StringAnnotationVerifier("A valid file path"),
+                Optional::No,
+                "The TSP file whose bricks are selected",
+            },
+            {
+                KeyReplay,
+                new StringAnnotationVerifier("A valid file path"),
+                Optional::No,
+                "A text file with one frame per line, consisting of the timestep and "
+                "the path to the transfer function (in the txt format) of the frame. "
+                "Lines starting with '#' are ignored",
+            },
+            {
+                KeyErrorHistograms,
+                new StringAnnotationVerifier("A valid file path"),
+                Optional::No,
+                "The cached error histograms of the TSP file. They are used by the Tf "
+                "selector and to measure the error of all selections",
+            },
+            {
+                KeyLocalErrorHistograms,
+                new StringAnnotationVerifier("A valid file path"),
+                Optional::Yes,
+                "The cached local error histograms of the TSP file, used by the Local "
+                "selector",
+            },
+            {
+                KeyHistograms,
+                new StringAnnotationVerifier("A valid file path"),
+                Optional::Yes,
+                "The cached histograms of the TSP file, used by the Simple selector",
+            },
+            {
+                KeyOutput,
+                new StringAnnotationVerifier("A valid file path"),
+                Optional::Yes,
+                "If specified, the statistics of every frame are written to this file "
+                "as comma separated values",
+            },
+            {
+                KeySelectors,
+                new StringListVerifier("'Tf', 'Local', 'Simple' or 'Shen'"),
+                Optional::Yes,
+                "The brick selectors to benchmark. By default, all selectors whose "
+                "histograms are specified are benchmarked",
+            },
+            {
+                KeyMemoryBudget,
+                new IntVerifier,
+                Optional::Yes,
+                "The number of bricks that fit into memory. The default value is 2048",
+            },
+            {
+                KeyStreamingBudget,
+                new IntVerifier,
+                Optional::Yes,
+                "The number of bricks that may be streamed per timestep. The default "
+                "value is 2048",
+            },
+            {
+                KeySpatialTolerance,
+                new DoubleVerifier,
+                Optional::Yes,
+                "The spatial error tolerance of the Shen selector. The default value "
+                "is 1",
+            },
+            {
+                KeyTemporalTolerance,
+                new DoubleVerifier,
+                Optional::Yes,
+                "The temporal error tolerance of the Shen selector. The default value "
+                "is 1",
+            }
+        }
+    };
+}
+
+} // namespace openspace
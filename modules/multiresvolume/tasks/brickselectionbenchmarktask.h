@@ -0,0 +1,106 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_MULTIRESVOLUME___BRICKSELECTIONBENCHMARKTASK___H__
+#define __OPENSPACE_MODULE_MULTIRESVOLUME___BRICKSELECTIONBENCHMARKTASK___H__
+
+#include <openspace/util/task.h>
+
+#include <ghoul/glm.h>
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+class BrickSelector;
+class TfBrickSelector;
+class TSP;
+
+/**
+ * Replays a recorded sequence of timesteps and transfer functions through the brick
+ * selectors of a TSP data set and reports how long each selection takes, how many bricks
+ * are used and streamed, how much of the memory and streaming budgets that is and which
+ * error the selection achieves. The error of a selection is measured with the error
+ * histograms of the TfBrickSelector, averaged over the volume. The selectors only work
+ * on the TSP structure and the histogram caches, so the task does not need OpenGL.
+ */
+class BrickSelectionBenchmarkTask : public Task {
+public:
+    BrickSelectionBenchmarkTask(const ghoul::Dictionary& dictionary);
+    std::string description() override;
+    void perform(const Task::ProgressCallback& progressCallback) override;
+    static documentation::Documentation documentation();
+
+private:
+    struct Frame {
+        int timestep;
+        std::string transferFunction;
+    };
+
+    struct FrameStats {
+        double selectionTime = 0.0;
+        double errorUpdateTime = 0.0;
+        int nUsedBricks = 0;
+        int nStreamedBricks = 0;
+        float error = 0.f;
+    };
+
+    /// Reads the frames of the replay file, returns <code>false</code> on failure
+    bool readReplay();
+
+    /**
+     * Replays all frames through the selector. The updateErrors function is called
+     * whenever the transfer function changes. The scorer's errors have to be up to date
+     * with the transfer function of the frame when the selection is scored.
+     */
+    std::vector<FrameStats> replay(TSP& tsp,
+        const std::map<std::string, std::vector<glm::vec4>>& transferFunctions,
+        BrickSelector& selector, TfBrickSelector& scorer,
+        const std::function<bool(const std::vector<glm::vec4>&)>& updateErrors,
+        const std::function<void(float)>& progress);
+
+    void report(const std::string& name, const std::vector<FrameStats>& stats) const;
+
+    std::string _tspPath;
+    std::string _replayPath;
+    std::string _errorHistogramsPath;
+    std::string _localErrorHistogramsPath;
+    std::string _histogramsPath;
+    std::string _outputPath;
+    std::vector<std::string> _selectors;
+
+    int _memoryBudget;
+    int _streamingBudget;
+    float _spatialTolerance;
+    float _temporalTolerance;
+
+    std::vector<Frame> _frames;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_MULTIRESVOLUME___BRICKSELECTIONBENCHMARKTASK___H__
@@ -0,0 +1,261 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/multiresvolume/tasks/tspcompressiontask.h>
+
+#include <modules/multiresvolume/rendering/tsp.h>
+
+#include <openspace/documentation/verifier.h>
+#include <openspace/util/threadpool.h>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr const char* _loggerCat = "TspCompressionTask";
+
+    constexpr const char* KeyInput = "Input";
+    constexpr const char* KeyOutput = "Output";
+    constexpr const char* KeyMethod = "Method";
+    constexpr const char* KeyErrorBound = "ErrorBound";
+
+    constexpr const char* MethodLossless = "Lossless";
+    constexpr const char* MethodQuantized = "Quantized";
+
+    // Number of uncompressed bytes that are read and compressed at once
+    constexpr const size_t ChunkSize = 64 * 1024 * 1024;
+} // namespace
+
+namespace openspace {
+
+TspCompressionTask::TspCompressionTask(const ghoul::Dictionary& dictionary)
+    : _method(brickcompression::Method::Lossless)
+    , _errorBound(0.f)
+{
+    openspace::documentation::testSpecificationAndThrow(
+        documentation(),
+        dictionary,
+        "TspCompressionTask"
+    );
+
+    _inputPath = absPath(dictionary.value<std::string>(KeyInput));
+    _outputPath = absPath(dictionary.value<std::string>(KeyOutput));
+
+    if (dictionary.hasKey(KeyMethod) &&
+        dictionary.value<std::string>(KeyMethod) == MethodQuantized)
+    {
+        _method = brickcompression::Method::Quantized;
+    }
+    if (dictionary.hasKey(KeyErrorBound)) {
+        _errorBound = static_cast<float>(dictionary.value<double>(KeyErrorBound));
+    }
+}
+
+std::string TspCompressionTask::description() {
+    return "Compress the bricks of TSP file " + _inputPath + " into " + _outputPath;
+}
+
+void TspCompressionTask::perform(const Task::ProgressCallback& progressCallback) {
+    if (_method == brickcompression::Method::Quantized && !(_errorBound > 0.f)) {
+        LERROR("Quantized compression requires a positive error bound");
+        progressCallback(1.f);
+        return;
+    }
+
+    TSP tsp(_inputPath);
+    if (!tsp.readHeader()) {
+        LERROR(fmt::format("Could not read the header of TSP file '{}'", _inputPath));
+        progressCallback(1.f);
+        return;
+    }
+
+    // The bricks are written to a temporary file that is renamed once it is complete,
+    // so that a failed compression does not leave a file with a valid header behind
+    const std::string temporaryPath = _outputPath + ".tmp";
+    std::ofstream file(temporaryPath, std::ios::out | std::ios::binary);
+    if (!file.good()) {
+        LERROR(fmt::format("Could not open '{}' for writing", temporaryPath));
+        progressCallback(1.f);
+        return;
+    }
+    auto discardOutput = [&]() {
+        file.close();
+        std::remove(temporaryPath.c_str());
+        progressCallback(1.f);
+    };
+
+    const unsigned int numBricks = tsp.numTotalNodes();
+    const size_t numBrickVals = static_cast<size_t>(tsp.paddedBrickDim()) *
+                                tsp.paddedBrickDim() * tsp.paddedBrickDim();
+    const size_t brickSize = numBrickVals * sizeof(float);
+    const unsigned int bricksPerChunk = static_cast<unsigned int>(
+        std::min<size_t>(std::max<size_t>(ChunkSize / brickSize, 1), numBricks)
+    );
+
+    TSP::CompressionHeader compressionHeader = {
+        TSP::CompressionTag,
+        TSP::CompressionVersion,
+        static_cast<uint32_t>(_method),
+        _errorBound
+    };
+    file.write(
+        reinterpret_cast<const char*>(&compressionHeader),
+        sizeof(TSP::CompressionHeader)
+    );
+    file.write(reinterpret_cast<const char*>(&tsp.header()), sizeof(TSP::Header));
+
+    // The offset table is written once all bricks have been compressed
+    const std::streampos offsetsPosition = file.tellp();
+    std::vector<uint64_t> offsets(static_cast<size_t>(numBricks) + 1, 0);
+    file.write(
+        reinterpret_cast<const char*>(offsets.data()),
+        offsets.size() * sizeof(uint64_t)
+    );
+
+    ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u));
+    std::vector<float> values(bricksPerChunk * numBrickVals);
+    std::vector<std::vector<char>> compressedBricks(bricksPerChunk);
+
+    for (unsigned int first = 0; first < numBricks; first += bricksPerChunk) {
+        const unsigned int n = std::min(bricksPerChunk, numBricks - first);
+        if (!tsp.readBricks(tsp.file(), first, n, values.data(), &pool)) {
+            LERROR(fmt::format("Could not read bricks from '{}'", _inputPath));
+            discardOutput();
+            return;
+        }
+
+        const unsigned int nTasks = std::min(
+            n,
+            static_cast<unsigned int>(pool.numThreads())
+        );
+        std::vector<std::future<void>> tasks;
+        tasks.reserve(nTasks);
+        for (unsigned int i = 0; i < nTasks; ++i) {
+            const unsigned int begin = i * n / nTasks;
+            const unsigned int end = (i + 1) * n / nTasks;
+            tasks.push_back(pool.submit([&, begin, end]() {
+                for (unsigned int brick = begin; brick < end; ++brick) {
+                    compressedBricks[brick].clear();
+                    brickcompression::compress(
+                        values.data() + brick * numBrickVals,
+                        numBrickVals,
+                        _method,
+                        _errorBound,
+                        compressedBricks[brick]
+                    );
+                }
+            }));
+        }
+        for (std::future<void>& task : tasks) {
+            task.get();
+        }
+
+        for (unsigned int i = 0; i < n; ++i) {
+            const std::vector<char>& brick = compressedBricks[i];
+            file.write(brick.data(), brick.size());
+            offsets[first + i + 1] = offsets[first + i] + brick.size();
+        }
+        progressCallback(static_cast<float>(first + n) / numBricks);
+    }
+
+    file.seekp(offsetsPosition);
+    file.write(
+        reinterpret_cast<const char*>(offsets.data()),
+        offsets.size() * sizeof(uint64_t)
+    );
+    file.close();
+    if (!file.good()) {
+        LERROR(fmt::format("Could not write to '{}'", temporaryPath));
+        discardOutput();
+        return;
+    }
+    if (std::rename(temporaryPath.c_str(), _outputPath.c_str()) != 0) {
+        LERROR(fmt::format("Could not write '{}'", _outputPath));
+        discardOutput();
+        return;
+    }
+
+    const double uncompressedSize = static_cast<double>(numBricks) * brickSize;
+    LINFO(fmt::format(
+        "Compressed {} bricks from {:.1f} MB to {:.1f} MB (ratio {:.2f})",
+        numBricks,
+        uncompressedSize / (1024.0 * 1024.0),
+        offsets.back() / (1024.0 * 1024.0),
+        uncompressedSize / std::max<double>(static_cast<double>(offsets.back()), 1.0)
+    ));
+    progressCallback(1.f);
+}
+
+documentation::Documentation TspCompressionTask::documentation() {
+    using namespace documentation;
+    return {
+        "TspCompressionTask",
+        "multiresvolume_tsp_compression_task",
+        {
+            {
+                "Type",
+                new StringEqualVerifier("TspCompressionTask"),
+                Optional::No,
+                "The type of this task",
+            },
+            {
+                KeyInput,
+                new StringAnnotationVerifier("A valid file path"),
+                Optional::No,
+                "The TSP file to compress",
+            },
+            {
+                KeyOutput,
+                new StringAnnotationVerifier("A valid file path"),
+                Optional::No,
+                "The path of the compressed TSP file that is written",
+            },
+            {
+                KeyMethod,
+                new StringInListVerifier({ MethodLossless, MethodQuantized }),
+                Optional::Yes,
+                "The compression method. 'Lossless' reproduces every value exactly, "
+                "'Quantized' bounds the error of every value by the ErrorBound. The "
+                "default is 'Lossless'",
+            },
+            {
+                KeyErrorBound,
+                new DoubleVerifier,
+                Optional::Yes,
+                "The largest absolute error of a value that is allowed by the "
+                "'Quantized' method",
+            }
+        }
+    };
+}
+
+} // namespace openspace
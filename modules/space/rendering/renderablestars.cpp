@@ -26,6 +26,7 @@
 
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/util/speckloader.h>
 #include <openspace/util/updatestructures.h>
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/rendering/renderengine.h>
@@ -38,6 +39,7 @@
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureunit.h>
 
+#include <algorithm>
 #include <array>
 #include <fstream>
 #include <stdint.h>
@@ -610,74 +612,40 @@ bool RenderableStars::loadData() {
 }
 
 bool RenderableStars::readSpeckFile() {
-    std::string _file = _speckFile;
-    std::ifstream file(_file);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Speck file '{}'", _file));
+    speck::Dataset dataset;
+    try {
+        dataset = speck::loadSpeckFile(_speckFile);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(fmt::format("Failed to read Speck file '{}': {}", _speckFile, e.message));
         return false;
     }
 
-    _nValuesPerStar = 0;
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line = "";
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        if (line[0] == '#' || line.empty()) {
+    _nValuesPerStar = dataset.valuesPerEntry;
+    _fullData = std::move(dataset.entries);
+
+    // Remove the stars whose values are all 0 by moving the remaining ones forward
+    size_t nStars = 0;
+    for (size_t i = 0; i < _fullData.size(); i += _nValuesPerStar) {
+        auto star = _fullData.begin() + i;
+        bool nullArray = std::all_of(
+            star,
+            star + _nValuesPerStar,
+            [](float value) { return value == 0.f; }
+        );
+        if (nullArray) {
             continue;
         }
-
-        if (line.substr(0, 7) != "datavar" &&
-            line.substr(0, 10) != "texturevar" &&
-            line.substr(0, 7) != "texture")
-        {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            break;
-        }
-
-        if (line.substr(0, 7) == "datavar") {
-            // datavar lines are structured as follows:
-            // datavar # description
-            // where # is the index of the data variable; so if we repeatedly overwrite
-            // the 'nValues' variable with the latest index, we will end up with the total
-            // number of values (+3 since X Y Z are not counted in the Speck file index)
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy;
-            str >> _nValuesPerStar;
-            _nValuesPerStar += 1; // We want the number, but the index is 0 based
+        if (nStars * _nValuesPerStar != i) {
+            std::copy(
+                star,
+                star + _nValuesPerStar,
+                _fullData.begin() + nStars * _nValuesPerStar
+            );
         }
+        ++nStars;
     }
-
-    _nValuesPerStar += 3; // X Y Z are not counted in the Speck file indices
-
-    do {
-        std::vector<float> values(_nValuesPerStar);
-
-        std::getline(file, line);
-        std::stringstream str(line);
-
-        for (int i = 0; i < _nValuesPerStar; ++i) {
-            str >> values[i];
-        }
-        bool nullArray = true;
-        for (size_t i = 0; i < values.size(); ++i) {
-            if (values[i] != 0.0) {
-                nullArray = false;
-                break;
-            }
-        }
-        if (!nullArray) {
-            _fullData.insert(_fullData.end(), values.begin(), values.end());
-        }
-    } while (!file.eof());
+    _fullData.resize(nStars * _nValuesPerStar);
 
     return true;
 }
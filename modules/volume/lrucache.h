@@ -45,7 +45,7 @@ public:
         auto prev = _cache.find(key);
         if (prev != _cache.end()) {
             prev->second.first = value;
-            std::list<KeyType>::iterator trackerIter = prev->second.second;
+            typename std::list<KeyType>::iterator trackerIter = prev->second.second;
             _tracker.splice(_tracker.end(),
                 _tracker,
                 trackerIter);
@@ -56,7 +56,7 @@ public:
     };
     ValueType& use(const KeyType& key) {
         auto iter = _cache.find(key);
-        std::list<KeyType>::iterator trackerIter = iter->second.second;
+        typename std::list<KeyType>::iterator trackerIter = iter->second.second;
         _tracker.splice(_tracker.end(),
             _tracker,
             trackerIter);
@@ -0,0 +1,83 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_VOLUME___MAPPEDRAWVOLUME___H__
+#define __OPENSPACE_MODULE_VOLUME___MAPPEDRAWVOLUME___H__
+
+#include <modules/volume/volumelayout.h>
+
+#include <openspace/util/mappedfile.h>
+#include <ghoul/glm.h>
+#include <functional>
+#include <string>
+
+namespace openspace {
+namespace volume {
+
+/**
+ * A read-only view of a raw volume file that is memory mapped instead of read into
+ * memory. It shares the read interface of <code>RawVolume</code>, but voxels are only
+ * read from disk when they are first accessed, so it can be used on volumes that are
+ * larger than the available RAM.
+ */
+template <typename Type>
+class MappedRawVolume {
+public:
+    using VoxelType = Type;
+    using Layout = LinearLayout;
+
+    /**
+     * \throw ghoul::RuntimeError If the file could not be mapped or is smaller than
+     *        \p dimensions require
+     */
+    MappedRawVolume(const std::string& path, const glm::uvec3& dimensions,
+        MappedFile::AccessPattern accessPattern = MappedFile::AccessPattern::Sequential);
+
+    glm::uvec3 dimensions() const;
+    size_t nCells() const;
+    VoxelType get(const glm::uvec3& coordinates) const;
+    VoxelType get(const size_t index) const;
+    void forEachVoxel(
+        const std::function<void(const glm::uvec3&, const VoxelType&)>& fn) const;
+    const VoxelType* data() const;
+    size_t coordsToIndex(const glm::uvec3& cartesian) const;
+    glm::uvec3 indexToCoords(size_t linear) const;
+
+    /**
+     * Hints to the operating system that the \p nSlices z-slices starting at
+     * \p firstSlice will be accessed soon.
+     */
+    void prefetchSlices(unsigned int firstSlice, unsigned int nSlices) const;
+
+private:
+    glm::uvec3 _dimensions;
+    MappedFile _file;
+};
+
+} // namespace volume
+} // namespace openspace
+
+#include "mappedrawvolume.inl"
+
+#endif // __OPENSPACE_MODULE_VOLUME___MAPPEDRAWVOLUME___H__
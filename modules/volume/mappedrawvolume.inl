@@ -0,0 +1,108 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/volume/volumeutils.h>
+#include <ghoul/fmt.h>
+#include <ghoul/misc/exception.h>
+
+namespace openspace {
+namespace volume {
+
+template <typename VoxelType>
+MappedRawVolume<VoxelType>::MappedRawVolume(const std::string& path,
+                                            const glm::uvec3& dimensions,
+                                            MappedFile::AccessPattern accessPattern)
+    : _dimensions(dimensions)
+    , _file(path, accessPattern)
+{
+    if (_file.size() < nCells() * sizeof(VoxelType)) {
+        throw ghoul::RuntimeError(
+            fmt::format(
+                "Raw volume file '{}' is too small for dimensions ({}, {}, {})",
+                path, dimensions.x, dimensions.y, dimensions.z
+            ),
+            "MappedRawVolume"
+        );
+    }
+}
+
+template <typename VoxelType>
+glm::uvec3 MappedRawVolume<VoxelType>::dimensions() const {
+    return _dimensions;
+}
+
+template <typename VoxelType>
+size_t MappedRawVolume<VoxelType>::nCells() const {
+    return static_cast<size_t>(_dimensions.x) *
+           static_cast<size_t>(_dimensions.y) *
+           static_cast<size_t>(_dimensions.z);
+}
+
+template <typename VoxelType>
+VoxelType MappedRawVolume<VoxelType>::get(const glm::uvec3& coordinates) const {
+    return get(coordsToIndex(coordinates));
+}
+
+template <typename VoxelType>
+VoxelType MappedRawVolume<VoxelType>::get(size_t index) const {
+    return data()[index];
+}
+
+template <typename VoxelType>
+void MappedRawVolume<VoxelType>::forEachVoxel(
+    const std::function<void(const glm::uvec3&, const VoxelType&)>& fn) const
+{
+    const VoxelType* voxels = data();
+    for (size_t i = 0; i < nCells(); i++) {
+        fn(indexToCoords(i), voxels[i]);
+    }
+}
+
+template <typename VoxelType>
+const VoxelType* MappedRawVolume<VoxelType>::data() const {
+    // Mappings are page aligned, so the voxels are suitably aligned as well
+    return reinterpret_cast<const VoxelType*>(_file.data());
+}
+
+template <typename VoxelType>
+size_t MappedRawVolume<VoxelType>::coordsToIndex(const glm::uvec3& cartesian) const {
+    return volume::coordsToIndex(cartesian, dimensions());
+}
+
+template <typename VoxelType>
+glm::uvec3 MappedRawVolume<VoxelType>::indexToCoords(size_t linear) const {
+    return volume::indexToCoords(linear, dimensions());
+}
+
+template <typename VoxelType>
+void MappedRawVolume<VoxelType>::prefetchSlices(unsigned int firstSlice,
+                                                unsigned int nSlices) const
+{
+    const size_t sliceSize = static_cast<size_t>(_dimensions.x) *
+                             static_cast<size_t>(_dimensions.y) * sizeof(VoxelType);
+    _file.prefetch(firstSlice * sliceSize, nSlices * sliceSize);
+}
+
+} // namespace volume
+} // namespace openspace
@@ -25,6 +25,8 @@
 #ifndef __OPENSPACE_MODULE_VOLUME___RAWVOLUME___H__
 #define __OPENSPACE_MODULE_VOLUME___RAWVOLUME___H__
 
+#include <modules/volume/volumelayout.h>
+
 #include <ghoul/glm.h>
 #include <functional>
 #include <vector>
@@ -32,12 +34,24 @@
 namespace openspace {
 namespace volume {
 
-template <typename Type>
+/**
+ * A volume that is held in memory. The voxels are stored in the order given by the
+ * StorageLayout, which is either the LinearLayout of raw volume files or a
+ * BrickedLayout. The accessors are the same for both; the linear indices that get and
+ * set accept always refer to the linear layout.
+ */
+template <typename Type, typename StorageLayout = LinearLayout>
 class RawVolume {
+public:
     using VoxelType = Type;
+    using Layout = StorageLayout;
 
-public:
     RawVolume(const glm::uvec3& dimensions);
+
+    /// Converts a volume that is stored in a different layout
+    template <typename OtherLayout>
+    explicit RawVolume(const RawVolume<Type, OtherLayout>& volume);
+
     glm::uvec3 dimensions() const;
     void setDimensions(const glm::uvec3& dimensions);
     size_t nCells() const;
@@ -45,7 +59,11 @@ public:
     VoxelType get(const size_t index) const;
     void set(const glm::uvec3& coordinates, const VoxelType& value);
     void set(size_t index, const VoxelType& value);
+
+    /// Calls fn for every voxel, in the order in which the voxels are stored
     void forEachVoxel(const std::function<void(const glm::uvec3&, const VoxelType&)>& fn);
+
+    /// Returns the voxels in the order of the Layout, including the padding of bricks
     const VoxelType* data() const;
     size_t coordsToIndex(const glm::uvec3& cartesian) const;
     glm::uvec3 indexToCoords(size_t linear) const;
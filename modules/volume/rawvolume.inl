@@ -21,34 +21,59 @@
  * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
-
 #include <modules/volume/volumeutils.h>
 #include "rawvolume.h"
 
+#include <algorithm>
+
 namespace openspace {
 namespace volume {
 
-template <typename VoxelType>
-RawVolume<VoxelType>::RawVolume(const glm::uvec3& dimensions)
+template <typename VoxelType, typename Layout>
+RawVolume<VoxelType, Layout>::RawVolume(const glm::uvec3& dimensions)
     : _dimensions(dimensions)
-    , _data(static_cast<size_t>(dimensions.x) *
-            static_cast<size_t>(dimensions.y) *
-            static_cast<size_t>(dimensions.z))
+    , _data(Layout::storageSize(dimensions))
 {}
 
-template <typename VoxelType>
-glm::uvec3 RawVolume<VoxelType>::dimensions() const {
+template <typename VoxelType, typename Layout>
+template <typename OtherLayout>
+RawVolume<VoxelType, Layout>::RawVolume(const RawVolume<VoxelType, OtherLayout>& volume)
+    : RawVolume(volume.dimensions())
+{
+    // Copy the aligned runs along x that are contiguous in both layouts at once
+    const unsigned int runLength = std::min(
+        std::min(Layout::RunLength, OtherLayout::RunLength),
+        _dimensions.x
+    );
+
+    const VoxelType* source = volume.data();
+    for (unsigned int z = 0; z < _dimensions.z; ++z) {
+        for (unsigned int y = 0; y < _dimensions.y; ++y) {
+            for (unsigned int x = 0; x < _dimensions.x; x += runLength) {
+                const glm::uvec3 coordinates(x, y, z);
+                std::copy_n(
+                    source + OtherLayout::index(coordinates, _dimensions),
+                    std::min(runLength, _dimensions.x - x),
+                    _data.data() + Layout::index(coordinates, _dimensions)
+                );
+            }
+        }
+    }
+}
+
+template <typename VoxelType, typename Layout>
+glm::uvec3 RawVolume<VoxelType, Layout>::dimensions() const {
     return _dimensions;
 }
 
-template <typename VoxelType>
-void RawVolume<VoxelType>::setDimensions(const glm::uvec3& dimensions) {
+template <typename VoxelType, typename Layout>
+void RawVolume<VoxelType, Layout>::setDimensions(const glm::uvec3& dimensions) {
     _dimensions = dimensions;
-    _data.resize(nCells());
+    _data.resize(Layout::storageSize(dimensions));
 }
 
-template<typename VoxelType>
-size_t RawVolume<VoxelType>::nCells() const
+template <typename VoxelType, typename Layout>
+size_t RawVolume<VoxelType, Layout>::nCells() const
 {
     return static_cast<size_t>(
         static_cast<size_t>(_dimensions.x) *
@@ -56,53 +81,99 @@ size_t RawVolume<VoxelType>::nCells() const
         static_cast<size_t>(_dimensions.z));
 }
 
-template <typename VoxelType>
-VoxelType RawVolume<VoxelType>::get(const glm::uvec3& coordinates) const {
-    return get(coordsToIndex(coordinates));
+template <typename VoxelType, typename Layout>
+VoxelType RawVolume<VoxelType, Layout>::get(const glm::uvec3& coordinates) const {
+    return _data[Layout::index(coordinates, _dimensions)];
 }
 
-template <typename VoxelType>
-VoxelType RawVolume<VoxelType>::get(size_t index) const {
-    return _data[index];
+template <typename VoxelType, typename Layout>
+VoxelType RawVolume<VoxelType, Layout>::get(size_t index) const {
+    if constexpr (Layout::IsLinear) {
+        return _data[index];
+    }
+    else {
+        return get(indexToCoords(index));
+    }
 }
 
-template <typename VoxelType>
-void RawVolume<VoxelType>::set(const glm::uvec3& coordinates, const VoxelType& value) {
-    return set(coordsToIndex(coordinates), value);
+template <typename VoxelType, typename Layout>
+void RawVolume<VoxelType, Layout>::set(const glm::uvec3& coordinates,
+                                       const VoxelType& value)
+{
+    _data[Layout::index(coordinates, _dimensions)] = value;
 }
 
-template <typename VoxelType>
-void RawVolume<VoxelType>::set(size_t index, const VoxelType& value) {
-    _data[index] = value;
+template <typename VoxelType, typename Layout>
+void RawVolume<VoxelType, Layout>::set(size_t index, const VoxelType& value) {
+    if constexpr (Layout::IsLinear) {
+        _data[index] = value;
+    }
+    else {
+        set(indexToCoords(index), value);
+    }
 }
 
-template <typename VoxelType>
-void RawVolume<VoxelType>::forEachVoxel(
+template <typename VoxelType, typename Layout>
+void RawVolume<VoxelType, Layout>::forEachVoxel(
     const std::function<void(const glm::uvec3&, const VoxelType&)>& fn)
 {
-    for (size_t i = 0; i < nCells(); i++) {
-        glm::ivec3 coords = indexToCoords(i);
-        fn(coords, _data[i]);
+    if constexpr (Layout::IsLinear) {
+        const VoxelType* voxel = _data.data();
+        for (unsigned int z = 0; z < _dimensions.z; ++z) {
+            for (unsigned int y = 0; y < _dimensions.y; ++y) {
+                for (unsigned int x = 0; x < _dimensions.x; ++x) {
+                    fn(glm::uvec3(x, y, z), *voxel++);
+                }
+            }
+        }
+    }
+    else {
+        // Visit the bricks in storage order and skip the padding of the border bricks
+        constexpr const unsigned int Dim = Layout::RunLength;
+        const glm::uvec3 bricks = Layout::numBricks(_dimensions);
+        const VoxelType* voxel = _data.data();
+        for (unsigned int bz = 0; bz < bricks.z; ++bz) {
+            for (unsigned int by = 0; by < bricks.y; ++by) {
+                for (unsigned int bx = 0; bx < bricks.x; ++bx) {
+                    const glm::uvec3 first(bx * Dim, by * Dim, bz * Dim);
+                    const glm::uvec3 end(
+                        std::min(first.x + Dim, _dimensions.x),
+                        std::min(first.y + Dim, _dimensions.y),
+                        std::min(first.z + Dim, _dimensions.z)
+                    );
+                    for (unsigned int z = first.z; z < first.z + Dim; ++z) {
+                        for (unsigned int y = first.y; y < first.y + Dim; ++y) {
+                            if (z < end.z && y < end.y) {
+                                for (unsigned int x = first.x; x < end.x; ++x) {
+                                    fn(glm::uvec3(x, y, z), voxel[x - first.x]);
+                                }
+                            }
+                            voxel += Dim;
+                        }
+                    }
+                }
+            }
+        }
     }
 }
 
-template <typename VoxelType>
-size_t RawVolume<VoxelType>::coordsToIndex(const glm::uvec3& cartesian) const {
+template <typename VoxelType, typename Layout>
+size_t RawVolume<VoxelType, Layout>::coordsToIndex(const glm::uvec3& cartesian) const {
     return volume::coordsToIndex(cartesian, dimensions());
 }
 
-template <typename VoxelType>
-glm::uvec3 RawVolume<VoxelType>::indexToCoords(size_t linear) const {
+template <typename VoxelType, typename Layout>
+glm::uvec3 RawVolume<VoxelType, Layout>::indexToCoords(size_t linear) const {
     return volume::indexToCoords(linear, dimensions());
 }
 
-template <typename VoxelType>
-VoxelType* RawVolume<VoxelType>::data() {
+template <typename VoxelType, typename Layout>
+VoxelType* RawVolume<VoxelType, Layout>::data() {
     return _data.data();
 }
 
-template <typename VoxelType>
-const VoxelType* RawVolume<VoxelType>::data() const {
+template <typename VoxelType, typename Layout>
+const VoxelType* RawVolume<VoxelType, Layout>::data() const {
     return _data.data();
 }
 
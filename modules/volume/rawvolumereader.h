@@ -26,6 +26,7 @@
 #define __OPENSPACE_MODULE_VOLUME___RAWVOLUMEREADER___H__
 
 #include <functional>
+#include <modules/volume/mappedrawvolume.h>
 #include <modules/volume/rawvolume.h>
 
 namespace openspace {
@@ -45,6 +46,25 @@ public:
     //VoxelType get(const size_t index) const; // TODO: Implement this
     std::unique_ptr<RawVolume<VoxelType>> read();
 
+    /**
+     * Maps the volume file into memory instead of reading it. No voxels are copied;
+     * the pages of the file are read from disk as they are accessed through the
+     * returned view.
+     */
+    std::unique_ptr<MappedRawVolume<VoxelType>> map() const;
+
+    /**
+     * Reads the subvolume of size \p dimensions that starts at \p offset. Only the
+     * pages of the file that contain voxels of the subvolume are read from disk.
+     */
+    std::unique_ptr<RawVolume<VoxelType>> readSubvolume(const glm::uvec3& offset,
+        const glm::uvec3& dimensions) const;
+
+    /**
+     * Reads the z-slice with index \p slice as a volume with a depth of one voxel.
+     */
+    std::unique_ptr<RawVolume<VoxelType>> readSlice(unsigned int slice) const;
+
 private:
     size_t coordsToIndex(const glm::uvec3& cartesian) const;
     glm::uvec3 indexToCoords(size_t linear) const;
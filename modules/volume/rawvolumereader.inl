@@ -22,6 +22,8 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+#include <ghoul/misc/assert.h>
+#include <cstring>
 #include <fstream>
 
 namespace openspace {
@@ -96,5 +98,64 @@ std::unique_ptr<RawVolume<VoxelType>> RawVolumeReader<VoxelType>::read() {
     return volume;
 }
 
+template <typename VoxelType>
+std::unique_ptr<MappedRawVolume<VoxelType>> RawVolumeReader<VoxelType>::map() const {
+    return std::make_unique<MappedRawVolume<VoxelType>>(_path, _dimensions);
+}
+
+template <typename VoxelType>
+std::unique_ptr<RawVolume<VoxelType>>
+RawVolumeReader<VoxelType>::readSubvolume(const glm::uvec3& offset,
+                                          const glm::uvec3& dimensions) const
+{
+    ghoul_assert(
+        offset.x + dimensions.x <= _dimensions.x &&
+        offset.y + dimensions.y <= _dimensions.y &&
+        offset.z + dimensions.z <= _dimensions.z,
+        "Subvolume must be inside the volume"
+    );
+
+    MappedRawVolume<VoxelType> source(
+        _path,
+        _dimensions,
+        MappedFile::AccessPattern::Random
+    );
+    if (dimensions.x == _dimensions.x && dimensions.y == _dimensions.y) {
+        // The subvolume consists of whole slices, which are contiguous in the file
+        source.prefetchSlices(offset.z, dimensions.z);
+    }
+
+    std::unique_ptr<RawVolume<VoxelType>> volume =
+        std::make_unique<RawVolume<VoxelType>>(dimensions);
+
+    // Rows along x are contiguous in both volumes
+    const size_t rowSize = dimensions.x * sizeof(VoxelType);
+    VoxelType* destination = volume->data();
+    for (unsigned int z = 0; z < dimensions.z; ++z) {
+        for (unsigned int y = 0; y < dimensions.y; ++y) {
+            const size_t sourceIndex = source.coordsToIndex(
+                offset + glm::uvec3(0, y, z)
+            );
+            const size_t destinationIndex = volume->coordsToIndex(glm::uvec3(0, y, z));
+            std::memcpy(
+                destination + destinationIndex,
+                source.data() + sourceIndex,
+                rowSize
+            );
+        }
+    }
+    return volume;
+}
+
+template <typename VoxelType>
+std::unique_ptr<RawVolume<VoxelType>>
+RawVolumeReader<VoxelType>::readSlice(unsigned int slice) const
+{
+    return readSubvolume(
+        glm::uvec3(0, 0, slice),
+        glm::uvec3(_dimensions.x, _dimensions.y, 1)
+    );
+}
+
 } // namepsace volume
 } // namespace openspace
@@ -62,6 +62,7 @@ namespace {
     const char* KeyTime = "Time";
     const char* KeyUnit = "VisUnit";
     const float SecondsInOneDay = 60 * 60 * 24;
+    constexpr const size_t BytesPerMegabyte = 1024 * 1024;
 
     static const openspace::properties::Property::PropertyInfo StepSizeInfo = {
         "stepSize",
@@ -117,6 +118,35 @@ namespace {
         "" // @TODO Missing documentation
     };
 
+    static const openspace::properties::Property::PropertyInfo TimestepsAheadInfo = {
+        "timestepsAhead",
+        "Timesteps ahead",
+        "The number of timesteps that are loaded in advance in the direction in which "
+        "the simulation time is moving."
+    };
+
+    static const openspace::properties::Property::PropertyInfo TimestepsBehindInfo = {
+        "timestepsBehind",
+        "Timesteps behind",
+        "The number of timesteps that are kept loaded behind the current timestep, "
+        "opposite to the direction in which the simulation time is moving."
+    };
+
+    static const openspace::properties::Property::PropertyInfo RamBudgetInfo = {
+        "ramBudget",
+        "RAM budget (MB)",
+        "The maximum amount of memory used for timesteps that are loaded into RAM. "
+        "Least recently used timesteps are evicted if the budget would be exceeded."
+    };
+
+    static const openspace::properties::Property::PropertyInfo GpuBudgetInfo = {
+        "gpuBudget",
+        "GPU budget (MB)",
+        "The maximum amount of texture memory used for timesteps that are uploaded to "
+        "the GPU. Least recently used textures are evicted if the budget would be "
+        "exceeded."
+    };
+
     static const openspace::properties::Property::PropertyInfo OpacityInfo = {
         "opacity",
         "Opacity",
@@ -151,6 +181,50 @@ namespace {
 namespace openspace {
 namespace volume {
 
+struct RenderableTimeVaryingVolume::TimestepLoadJob : public Job<LoadedTimestep> {
+    TimestepLoadJob(std::string path, const Timestep& timestep)
+        : _path(std::move(path))
+        , _time(timestep.time)
+        , _dimensions(timestep.dimensions)
+        , _minValue(timestep.minValue)
+        , _maxValue(timestep.maxValue)
+    {}
+
+    void execute() override {
+        RawVolumeReader<float> reader(_path, _dimensions);
+        std::unique_ptr<RawVolume<float>> volume = reader.read();
+
+        const float min = _minValue;
+        const float diff = _maxValue - _minValue;
+        float* data = volume->data();
+        for (size_t i = 0; i < volume->nCells(); ++i) {
+            data[i] = glm::clamp((data[i] - min) / diff, 0.0f, 1.0f);
+        }
+
+        // TODO: handle normalization properly for different timesteps + transfer function
+
+        _product = std::make_shared<LoadedTimestep>();
+        _product->time = _time;
+        _product->histogram = std::make_shared<Histogram>(0.0, 1.0, 100);
+        for (size_t i = 0; i < volume->nCells(); ++i) {
+            _product->histogram->add(data[i]);
+        }
+        _product->rawVolume = std::move(volume);
+    }
+
+    std::shared_ptr<LoadedTimestep> product() override {
+        return _product;
+    }
+
+private:
+    std::string _path;
+    double _time;
+    glm::uvec3 _dimensions;
+    float _minValue;
+    float _maxValue;
+    std::shared_ptr<LoadedTimestep> _product;
+};
+
 RenderableTimeVaryingVolume::RenderableTimeVaryingVolume(
                                                       const ghoul::Dictionary& dictionary)
     : Renderable(dictionary)
@@ -167,6 +241,11 @@ RenderableTimeVaryingVolume::RenderableTimeVaryingVolume(
     , _triggerTimeJump(TriggerTimeJumpInfo)
     , _jumpToTimestep(JumpToTimestepInfo, 0, 0, 256)
     , _currentTimestep(CurrentTimeStepInfo, 0, 0, 256)
+    , _timestepsAhead(TimestepsAheadInfo, 3, 0, 32)
+    , _timestepsBehind(TimestepsBehindInfo, 1, 0, 32)
+    , _ramBudget(RamBudgetInfo, 2048, 0, 65536)
+    , _gpuBudget(GpuBudgetInfo, 1024, 0, 32768)
+    , _loadJobManager(ThreadPool(1))
     , _raycaster(nullptr)
     , _transferFunctionHandler(nullptr)
 
@@ -238,46 +317,6 @@ void RenderableTimeVaryingVolume::initializeGL() {
         }
     }
 
-
-    // TODO: defer loading of data to later (separate thread or at least not when loading)
-    for (auto& p : _volumeTimesteps) {
-        Timestep& t = p.second;
-        std::string path = FileSys.pathByAppendingComponent(
-            _sourceDirectory, t.baseName
-        ) + ".rawvolume";
-        RawVolumeReader<float> reader(path, t.dimensions);
-        t.rawVolume = reader.read();
-
-        float min = t.minValue;
-        float diff = t.maxValue - t.minValue;
-        float *data = t.rawVolume->data();
-        for (size_t i = 0; i < t.rawVolume->nCells(); ++i) {
-            data[i] = glm::clamp((data[i] - min) / diff, 0.0f, 1.0f);
-        }
-
-        t.histogram = std::make_shared<Histogram>(0.0, 1.0, 100);
-        for (int i = 0; i < t.rawVolume->nCells(); ++i) {
-            t.histogram->add(data[i]);
-        }
-
-        // TODO: handle normalization properly for different timesteps + transfer function
-
-        t.texture = std::make_shared<ghoul::opengl::Texture>(
-            t.dimensions,
-            ghoul::opengl::Texture::Format::Red,
-            GL_RED,
-            GL_FLOAT,
-            ghoul::opengl::Texture::FilterMode::Linear,
-            ghoul::opengl::Texture::WrappingMode::Clamp
-        );
-
-        t.texture->setPixelData(
-            reinterpret_cast<void*>(data),
-            ghoul::opengl::Texture::TakeOwnership::No
-        );
-        t.texture->uploadTexture();
-    }
-
     _transferFunctionHandler->initialize();
     _clipPlanes->initialize();
 
@@ -320,6 +359,12 @@ void RenderableTimeVaryingVolume::initializeGL() {
     addProperty(_opacity);
     addProperty(_rNormalization);
     addProperty(_rUpperBound);
+    addProperty(_timestepsAhead);
+    addProperty(_timestepsBehind);
+    addProperty(_ramBudget);
+    addProperty(_gpuBudget);
+    _ramBudget.onChange([this]() { makeRoomInRam(0); });
+    _gpuBudget.onChange([this]() { makeRoomOnGpu(0); });
 
     _raycaster->setGridType(
         (_gridType.value() == 1) ?
@@ -362,6 +407,8 @@ void RenderableTimeVaryingVolume::loadTimestepMetadata(const std::string& path)
     t.time = Time::convertTime(timeString);
     t.inRam = false;
     t.onGpu = false;
+    t.isLoading = false;
+    t.lastUsed = 0;
 
     _volumeTimesteps[t.time] = std::move(t);
 }
@@ -433,11 +480,237 @@ void RenderableTimeVaryingVolume::jumpToTimestep(int target) {
     OsEng.timeManager().setTimeNextFrame(t->time);
 }
 
-void RenderableTimeVaryingVolume::update(const UpdateData&) {
+std::vector<RenderableTimeVaryingVolume::Timestep*>
+RenderableTimeVaryingVolume::prefetchWindow(Timestep* current)
+{
+    const int nTimesteps = static_cast<int>(_volumeTimesteps.size());
+    if (nTimesteps == 0) {
+        return {};
+    }
+
+    int anchor = timestepIndex(current);
+    if (anchor == -1) {
+        // Outside of the sequence; only prefetch if the time is moving towards it
+        const double now = OsEng.timeManager().time().j2000Seconds();
+        if (now < _volumeTimesteps.begin()->first && _travelDirection > 0) {
+            anchor = 0;
+        }
+        else if (now > _volumeTimesteps.rbegin()->first && _travelDirection < 0) {
+            anchor = nTimesteps - 1;
+        }
+        else {
+            return {};
+        }
+    }
+
+    std::vector<Timestep*> timesteps;
+    timesteps.reserve(_volumeTimesteps.size());
+    for (auto& p : _volumeTimesteps) {
+        timesteps.push_back(&p.second);
+    }
+
+    // Ordered by priority: the anchor, then the timesteps ahead, then those behind
+    std::vector<Timestep*> window = { timesteps[anchor] };
+    for (int i = 1; i <= _timestepsAhead; ++i) {
+        const int index = anchor + i * _travelDirection;
+        if (index < 0 || index >= nTimesteps) {
+            break;
+        }
+        window.push_back(timesteps[index]);
+    }
+    for (int i = 1; i <= _timestepsBehind; ++i) {
+        const int index = anchor - i * _travelDirection;
+        if (index < 0 || index >= nTimesteps) {
+            break;
+        }
+        window.push_back(timesteps[index]);
+    }
+    return window;
+}
+
+void RenderableTimeVaryingVolume::collectLoadedTimesteps() {
+    while (_loadJobManager.numFinishedJobs() > 0) {
+        std::shared_ptr<Job<LoadedTimestep>> job = _loadJobManager.popFinishedJob();
+        std::shared_ptr<LoadedTimestep> product = job->product();
+
+        auto it = _volumeTimesteps.find(product->time);
+        if (it == _volumeTimesteps.end()) {
+            continue;
+        }
+        Timestep& t = it->second;
+        t.isLoading = false;
+        if (t.inRam) {
+            // The timestep was requested again after its first job was dropped
+            continue;
+        }
+        t.rawVolume = std::move(product->rawVolume);
+        t.histogram = product->histogram;
+        t.inRam = true;
+        _ramUsage += timestepBytes(t);
+    }
+}
+
+bool RenderableTimeVaryingVolume::makeRoomInRam(size_t bytes) {
+    const size_t budget = static_cast<size_t>(_ramBudget) * BytesPerMegabyte;
+
+    // Timesteps that are being loaded will occupy memory as soon as they are collected
+    size_t usage = _ramUsage;
+    for (const auto& p : _volumeTimesteps) {
+        if (p.second.isLoading && !p.second.inRam) {
+            usage += timestepBytes(p.second);
+        }
+    }
+
+    while (usage + bytes > budget) {
+        // Evict the least recently used timestep that is not in the prefetch window
+        Timestep* lru = nullptr;
+        for (auto& p : _volumeTimesteps) {
+            Timestep& t = p.second;
+            if (t.inRam && t.lastUsed != _updateCount &&
+                (!lru || t.lastUsed < lru->lastUsed))
+            {
+                lru = &t;
+            }
+        }
+        if (!lru) {
+            return false;
+        }
+        usage -= timestepBytes(*lru);
+        evictFromRam(*lru);
+    }
+    return true;
+}
+
+bool RenderableTimeVaryingVolume::makeRoomOnGpu(size_t bytes) {
+    const size_t budget = static_cast<size_t>(_gpuBudget) * BytesPerMegabyte;
+
+    while (_gpuUsage + bytes > budget) {
+        Timestep* lru = nullptr;
+        for (auto& p : _volumeTimesteps) {
+            Timestep& t = p.second;
+            if (t.onGpu && t.lastUsed != _updateCount &&
+                (!lru || t.lastUsed < lru->lastUsed))
+            {
+                lru = &t;
+            }
+        }
+        if (!lru) {
+            return false;
+        }
+        evictFromGpu(*lru);
+    }
+    return true;
+}
+
+void RenderableTimeVaryingVolume::uploadToGpu(Timestep& t) {
+    ghoul_assert(t.inRam, "Timestep must be loaded into RAM before it is uploaded");
+
+    t.texture = std::make_shared<ghoul::opengl::Texture>(
+        t.dimensions,
+        ghoul::opengl::Texture::Format::Red,
+        GL_RED,
+        GL_FLOAT,
+        ghoul::opengl::Texture::FilterMode::Linear,
+        ghoul::opengl::Texture::WrappingMode::Clamp
+    );
+
+    // The texture keeps referring to the voxel data, which is why a timestep that is
+    // evicted from RAM is evicted from the GPU as well
+    t.texture->setPixelData(
+        reinterpret_cast<void*>(t.rawVolume->data()),
+        ghoul::opengl::Texture::TakeOwnership::No
+    );
+    t.texture->uploadTexture();
+    t.onGpu = true;
+    _gpuUsage += timestepBytes(t);
+}
+
+void RenderableTimeVaryingVolume::evictFromRam(Timestep& t) {
+    if (t.onGpu) {
+        evictFromGpu(t);
+    }
+    t.rawVolume = nullptr;
+    t.histogram = nullptr;
+    t.inRam = false;
+    _ramUsage -= timestepBytes(t);
+}
+
+void RenderableTimeVaryingVolume::evictFromGpu(Timestep& t) {
+    t.texture = nullptr;
+    t.onGpu = false;
+    _gpuUsage -= timestepBytes(t);
+}
+
+size_t RenderableTimeVaryingVolume::timestepBytes(const Timestep& t) {
+    return static_cast<size_t>(t.dimensions.x) * static_cast<size_t>(t.dimensions.y) *
+           static_cast<size_t>(t.dimensions.z) * sizeof(float);
+}
+
+void RenderableTimeVaryingVolume::updateTimestepStreaming(Timestep* current) {
+    ++_updateCount;
+    collectLoadedTimesteps();
+
+    std::vector<Timestep*> window = prefetchWindow(current);
+    for (Timestep* t : window) {
+        t->lastUsed = _updateCount;
+    }
+
+    // Drop the queued requests that have left the prefetch window, for example after a
+    // time jump. A job that is already executing will still finish and be collected
+    bool hasStaleRequests = false;
+    for (const auto& p : _volumeTimesteps) {
+        if (p.second.isLoading && p.second.lastUsed != _updateCount) {
+            hasStaleRequests = true;
+            break;
+        }
+    }
+    if (hasStaleRequests) {
+        _loadJobManager.clearEnqueuedJobs();
+        for (auto& p : _volumeTimesteps) {
+            p.second.isLoading = false;
+        }
+    }
+
+    for (Timestep* t : window) {
+        if (t->inRam || t->isLoading) {
+            continue;
+        }
+        // The current timestep is always loaded, even if it does not fit in the budget
+        if (!makeRoomInRam(timestepBytes(*t)) && t != current) {
+            break;
+        }
+        std::string path = FileSys.pathByAppendingComponent(
+            _sourceDirectory, t->baseName
+        ) + ".rawvolume";
+        t->isLoading = true;
+        _loadJobManager.enqueueJob(std::make_shared<TimestepLoadJob>(path, *t));
+    }
+
+    // Upload the current timestep immediately, but only one of the prefetched ones per
+    // update to spread the cost of the texture uploads over several frames
+    bool hasUploadedPrefetched = false;
+    for (Timestep* t : window) {
+        if (!t->inRam || t->onGpu || (t != current && hasUploadedPrefetched)) {
+            continue;
+        }
+        if (!makeRoomOnGpu(timestepBytes(*t)) && t != current) {
+            break;
+        }
+        uploadToGpu(*t);
+        hasUploadedPrefetched |= (t != current);
+    }
+}
+
+void RenderableTimeVaryingVolume::update(const UpdateData& data) {
+    if (data.time.deltaTime() != 0.0) {
+        _travelDirection = data.time.deltaTime() > 0.0 ? 1 : -1;
+    }
+
     if (_raycaster) {
         Timestep* t = currentTimestep();
         _currentTimestep = timestepIndex(t);
-        if (t && t->texture) {
+        updateTimestepStreaming(t);
+        if (t && t->onGpu) {
             if (_raycaster->gridType() == volume::VolumeGridType::Cartesian) {
                 glm::dvec3 scale = t->upperDomainBound - t->lowerDomainBound;
                 glm::dvec3 translation =
@@ -480,6 +753,14 @@ bool RenderableTimeVaryingVolume::isReady() const {
 }
 
 void RenderableTimeVaryingVolume::deinitializeGL() {
+    _loadJobManager.clearEnqueuedJobs();
+    for (auto& p : _volumeTimesteps) {
+        Timestep& t = p.second;
+        if (t.onGpu) {
+            evictFromGpu(t);
+        }
+    }
+
     if (_raycaster) {
         OsEng.renderEngine().raycasterManager().detachRaycaster(*_raycaster.get());
         _raycaster = nullptr;
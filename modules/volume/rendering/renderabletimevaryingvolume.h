@@ -35,8 +35,10 @@
 
 #include <openspace/properties/vectorproperty.h>
 #include <openspace/properties/optionproperty.h>
+#include <openspace/properties/scalarproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/util/boxgeometry.h>
+#include <openspace/util/concurrentjobmanager.h>
 #include <openspace/util/histogram.h>
 
 namespace openspace {
@@ -71,11 +73,23 @@ private:
         std::string unit;
         bool inRam;
         bool onGpu;
+        bool isLoading;
+        // Value of _updateCount the last time this timestep was in the prefetch window
+        unsigned long long lastUsed;
         std::unique_ptr<RawVolume<float>> rawVolume;
         std::shared_ptr<ghoul::opengl::Texture> texture;
         std::shared_ptr<openspace::Histogram> histogram;
     };
 
+    /// The product of a background load job: the normalized volume and its histogram
+    struct LoadedTimestep {
+        double time;
+        std::unique_ptr<RawVolume<float>> rawVolume;
+        std::shared_ptr<openspace::Histogram> histogram;
+    };
+
+    struct TimestepLoadJob;
+
     Timestep* currentTimestep();
     int timestepIndex(const Timestep* t) const;
     Timestep* timestepFromIndex(int index);
@@ -83,6 +97,22 @@ private:
 
     void loadTimestepMetadata(const std::string& path);
 
+    /**
+     * Collects the finished load jobs, requests the timesteps of the prefetch window
+     * that are not yet loaded and uploads loaded timesteps to the GPU. Timesteps outside
+     * of the prefetch window are evicted in least recently used order whenever the RAM
+     * or GPU budgets would be exceeded.
+     */
+    void updateTimestepStreaming(Timestep* current);
+    void collectLoadedTimesteps();
+    std::vector<Timestep*> prefetchWindow(Timestep* current);
+    bool makeRoomInRam(size_t bytes);
+    bool makeRoomOnGpu(size_t bytes);
+    void uploadToGpu(Timestep& t);
+    void evictFromRam(Timestep& t);
+    void evictFromGpu(Timestep& t);
+    static size_t timestepBytes(const Timestep& t);
+
     properties::OptionProperty _gridType;
     std::shared_ptr<VolumeClipPlanes> _clipPlanes;
 
@@ -99,7 +129,18 @@ private:
     properties::IntProperty _jumpToTimestep;
     properties::IntProperty _currentTimestep;
 
+    properties::IntProperty _timestepsAhead;
+    properties::IntProperty _timestepsBehind;
+    properties::IntProperty _ramBudget;
+    properties::IntProperty _gpuBudget;
+
     std::map<double, Timestep> _volumeTimesteps;
+    ConcurrentJobManager<LoadedTimestep> _loadJobManager;
+    size_t _ramUsage = 0;
+    size_t _gpuUsage = 0;
+    unsigned long long _updateCount = 0;
+    // +1 if the simulation time is moving forward, -1 if it is moving backwards
+    int _travelDirection = 1;
     std::unique_ptr<BasicVolumeRaycaster> _raycaster;
 
     std::shared_ptr<TransferFunctionHandler> _transferFunctionHandler;
@@ -0,0 +1,136 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_MODULE_VOLUME___VOLUMELAYOUT___H__
+#define __OPENSPACE_MODULE_VOLUME___VOLUMELAYOUT___H__
+
+#include <ghoul/glm.h>
+#include <limits>
+
+namespace openspace {
+namespace volume {
+
+// Both layouts compute the storage index of a voxel as the sum of one offset per axis,
+// so that the offsets of the taps of a filter can be computed once per axis
+
+/**
+ * The storage order of raw volume files: x varies fastest, then y, then z. Whole rows
+ * along x are contiguous, but neighbors along y and z are a row or a slice apart.
+ */
+struct LinearLayout {
+    static constexpr const bool IsLinear = true;
+    /// The length of the aligned runs along x that are contiguous in memory
+    static constexpr const unsigned int RunLength =
+        std::numeric_limits<unsigned int>::max();
+
+    static size_t storageSize(const glm::uvec3& dimensions) {
+        return static_cast<size_t>(dimensions.x) * dimensions.y * dimensions.z;
+    }
+
+    static size_t xOffset(unsigned int x, const glm::uvec3&) {
+        return x;
+    }
+
+    static size_t yOffset(unsigned int y, const glm::uvec3& dimensions) {
+        return static_cast<size_t>(y) * dimensions.x;
+    }
+
+    static size_t zOffset(unsigned int z, const glm::uvec3& dimensions) {
+        return static_cast<size_t>(z) * dimensions.x * dimensions.y;
+    }
+
+    static size_t index(const glm::uvec3& coordinates, const glm::uvec3& dimensions) {
+        return (static_cast<size_t>(coordinates.z) * dimensions.y + coordinates.y) *
+               dimensions.x + coordinates.x;
+    }
+};
+
+/**
+ * Stores the volume as cubic bricks of BrickDim^3 voxels. The bricks are ordered like
+ * the voxels of the linear layout, and so are the voxels within each brick. Voxels that
+ * are close in any direction are thus likely to share a cache line or page, which
+ * helps slicing along y and z, neighborhood sampling and processing of subregions. The
+ * dimensions are padded up to whole bricks. BrickDim has to be a power of two, so that
+ * indices are computed with shifts and masks only.
+ */
+template <unsigned int BrickDim = 8>
+struct BrickedLayout {
+    static_assert(BrickDim > 0 && (BrickDim & (BrickDim - 1)) == 0,
+        "The brick dimension has to be a power of two");
+
+    static constexpr const bool IsLinear = false;
+    static constexpr const unsigned int RunLength = BrickDim;
+
+    static constexpr unsigned int log2(unsigned int value) {
+        return value <= 1 ? 0 : 1 + log2(value / 2);
+    }
+    static constexpr const unsigned int Shift = log2(BrickDim);
+    static constexpr const unsigned int Mask = BrickDim - 1;
+    static constexpr const size_t BrickSize =
+        static_cast<size_t>(BrickDim) * BrickDim * BrickDim;
+
+    static glm::uvec3 numBricks(const glm::uvec3& dimensions) {
+        return glm::uvec3(
+            (dimensions.x + Mask) >> Shift,
+            (dimensions.y + Mask) >> Shift,
+            (dimensions.z + Mask) >> Shift
+        );
+    }
+
+    static size_t storageSize(const glm::uvec3& dimensions) {
+        const glm::uvec3 bricks = numBricks(dimensions);
+        return static_cast<size_t>(bricks.x) * bricks.y * bricks.z * BrickSize;
+    }
+
+    static size_t xOffset(unsigned int x, const glm::uvec3&) {
+        return (x >> Shift) * BrickSize + (x & Mask);
+    }
+
+    static size_t yOffset(unsigned int y, const glm::uvec3& dimensions) {
+        const size_t bricksX = (dimensions.x + Mask) >> Shift;
+        return (y >> Shift) * bricksX * BrickSize + ((y & Mask) << Shift);
+    }
+
+    static size_t zOffset(unsigned int z, const glm::uvec3& dimensions) {
+        const size_t bricksXY = static_cast<size_t>((dimensions.x + Mask) >> Shift) *
+                                ((dimensions.y + Mask) >> Shift);
+        return (z >> Shift) * bricksXY * BrickSize + ((z & Mask) << (2 * Shift));
+    }
+
+    static size_t index(const glm::uvec3& coordinates, const glm::uvec3& dimensions) {
+        const glm::uvec3 bricks = numBricks(dimensions);
+        const size_t brick =
+            (static_cast<size_t>(coordinates.z >> Shift) * bricks.y +
+            (coordinates.y >> Shift)) * bricks.x + (coordinates.x >> Shift);
+        const size_t voxel = ((coordinates.z & Mask) << (2 * Shift)) |
+                             ((coordinates.y & Mask) << Shift) |
+                             (coordinates.x & Mask);
+        return brick * BrickSize + voxel;
+    }
+};
+
+} // namespace volume
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_VOLUME___VOLUMELAYOUT___H__
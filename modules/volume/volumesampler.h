@@ -25,19 +25,69 @@
 #ifndef __OPENSPACE_MODULE_VOLUME___VOLUMESAMPLER___H__
 #define __OPENSPACE_MODULE_VOLUME___VOLUMESAMPLER___H__
 
+#include <modules/volume/rawvolume.h>
+
+#include <ghoul/glm.h>
+#include <type_traits>
+#include <vector>
+
 namespace openspace {
 namespace volume {
 
+/**
+ * Samples a volume with a box filter of an odd size in voxels, interpolated trilinearly
+ * between the voxels at the filter's edges; a filter size of 1 gives plain trilinear
+ * interpolation. Coordinates outside of the volume are clamped to its border. Cubic
+ * filters of size 1, 3 and 5 have specialized kernels. Volumes with a storage layout
+ * (RawVolume, MappedRawVolume) are read straight from their data, with the storage
+ * offsets of the taps computed once per axis.
+ */
 template <typename VolumeType>
 class VolumeSampler {
 public:
-    using VoxelType = VolumeType;
+    using VoxelType = typename VolumeType::VoxelType;
 
     VolumeSampler(const VolumeType& volume, const glm::vec3& filterSize);
-    typename VolumeType::VoxelType sample(const glm::vec3& position) const;
+    VoxelType sample(const glm::vec3& position) const;
+
+    /**
+     * Samples the volume at the nPositions positions and stores the results in values,
+     * which has to hold nPositions voxels. For trilinear interpolation in volumes with a
+     * storage layout, the positions are processed in blocks whose storage offsets and
+     * weights are computed in a separate pass, which the compiler can vectorize.
+     */
+    void sample(const glm::vec3* positions, size_t nPositions, VoxelType* values) const;
+    std::vector<VoxelType> sample(const std::vector<glm::vec3>& positions) const;
+
+    /**
+     * Resamples the whole volume to the passed dimensions. The centers of the corners
+     * of both volumes are aligned, so voxel <code>i</code> is sampled at
+     * <code>(i + 0.5) * ratio - 0.5</code>, where <code>ratio</code> is the ratio of the
+     * volume's dimensions to the new ones. The z-slices are sampled in parallel, so the
+     * volume has to support concurrent reads, which RawVolume and MappedRawVolume do but
+     * TextureSliceVolumeReader does not.
+     */
+    RawVolume<VoxelType> resample(const glm::uvec3& dimensions) const;
 
 private:
+    // Volumes with a storage layout (RawVolume, MappedRawVolume) take unsigned
+    // coordinates and expose their voxels through data()
+    template <typename T, typename = void>
+    struct HasLayout : std::false_type {};
+
+    template <typename T>
+    struct HasLayout<T, std::void_t<typename T::Layout>> : std::true_type {};
+
+    static constexpr const bool LayoutAccess = HasLayout<VolumeType>::value;
+
+    template <int FilterSize>
+    VoxelType sampleKernel(const glm::vec3& position) const;
+    VoxelType sampleGeneric(const glm::vec3& position) const;
+    void sampleTrilinearBlock(const glm::vec3* positions, size_t nPositions,
+        VoxelType* values) const;
+
     glm::ivec3 _filterSize;
+    glm::ivec3 _clampCeiling;
     const VolumeType* _volume;
 };
 
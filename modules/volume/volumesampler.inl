@@ -22,6 +22,14 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+#include <openspace/util/threadpool.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
 namespace openspace {
 namespace volume {
 
@@ -35,11 +43,162 @@ VolumeSampler<VolumeType>::VolumeSampler(const VolumeType& volume,
         (filterSize - glm::vec3(1.0)) * glm::vec3(0.5)
     ) * glm::ivec3(2) + glm::ivec3(1);
 
+    _clampCeiling = glm::ivec3(volume.dimensions()) - glm::ivec3(1);
     _volume = &volume;
 }
 
 template <typename VolumeType>
-typename VolumeType::VoxelType VolumeSampler<VolumeType>::sample(
+typename VolumeSampler<VolumeType>::VoxelType VolumeSampler<VolumeType>::sample(
+                                                          const glm::vec3& position) const
+{
+    if (_filterSize.x == _filterSize.y && _filterSize.x == _filterSize.z) {
+        switch (_filterSize.x) {
+            case 1:
+                return sampleKernel<1>(position);
+            case 3:
+                return sampleKernel<3>(position);
+            case 5:
+                return sampleKernel<5>(position);
+            default:
+                break;
+        }
+    }
+    return sampleGeneric(position);
+}
+
+template <typename VolumeType>
+void VolumeSampler<VolumeType>::sample(const glm::vec3* positions, size_t nPositions,
+                                       VoxelType* values) const
+{
+    if constexpr (LayoutAccess) {
+        if (_filterSize == glm::ivec3(1)) {
+            sampleTrilinearBlock(positions, nPositions, values);
+            return;
+        }
+    }
+
+    for (size_t i = 0; i < nPositions; ++i) {
+        values[i] = sample(positions[i]);
+    }
+}
+
+template <typename VolumeType>
+std::vector<typename VolumeSampler<VolumeType>::VoxelType>
+VolumeSampler<VolumeType>::sample(const std::vector<glm::vec3>& positions) const {
+    std::vector<VoxelType> values(positions.size());
+    sample(positions.data(), positions.size(), values.data());
+    return values;
+}
+
+template <typename VolumeType>
+RawVolume<typename VolumeSampler<VolumeType>::VoxelType>
+VolumeSampler<VolumeType>::resample(const glm::uvec3& dimensions) const {
+    RawVolume<VoxelType> result(dimensions);
+    VoxelType* data = result.data();
+
+    const glm::vec3 ratio =
+        glm::vec3(glm::ivec3(_volume->dimensions())) / glm::vec3(dimensions);
+
+    // Every worker samples whole z-slices, one row at a time, which it takes from a
+    // shared counter to balance the load
+    std::atomic<unsigned int> nextSlice(0);
+    auto sampleSlices = [&]() {
+        std::vector<glm::vec3> positions(dimensions.x);
+        for (unsigned int z = nextSlice++; z < dimensions.z; z = nextSlice++) {
+            for (unsigned int y = 0; y < dimensions.y; ++y) {
+                for (unsigned int x = 0; x < dimensions.x; ++x) {
+                    positions[x] = (glm::vec3(x, y, z) + glm::vec3(0.5f)) * ratio -
+                                   glm::vec3(0.5f);
+                }
+                const size_t rowIndex =
+                    (static_cast<size_t>(z) * dimensions.y + y) * dimensions.x;
+                sample(positions.data(), positions.size(), data + rowIndex);
+            }
+        }
+    };
+
+    const unsigned int nThreads = std::max(
+        std::min(std::thread::hardware_concurrency(), dimensions.z),
+        1u
+    );
+    ThreadPool pool(nThreads);
+    std::vector<std::future<void>> results;
+    for (unsigned int i = 0; i < nThreads; ++i) {
+        results.push_back(pool.submit(sampleSlices));
+    }
+    for (std::future<void>& r : results) {
+        r.get();
+    }
+
+    return result;
+}
+
+template <typename VolumeType>
+template <int FilterSize>
+typename VolumeSampler<VolumeType>::VoxelType VolumeSampler<VolumeType>::sampleKernel(
+                                                          const glm::vec3& position) const
+{
+    constexpr const int NTaps = FilterSize + 1;
+
+    const glm::vec3 flooredPos = glm::floor(position);
+    const glm::vec3 t = position - flooredPos;
+    const glm::ivec3 minCoords = glm::ivec3(flooredPos) - glm::ivec3(FilterSize / 2);
+
+    // The clamped coordinates and the filter weights of the taps along each axis. Only
+    // the first and the last tap are weighted by the interpolation
+    std::array<glm::ivec3, NTaps> coords;
+    std::array<glm::vec3, NTaps> weights;
+    for (int i = 0; i < NTaps; ++i) {
+        coords[i] = glm::clamp(minCoords + glm::ivec3(i), glm::ivec3(0), _clampCeiling);
+        weights[i] = glm::vec3(1.f);
+    }
+    weights[0] = glm::vec3(1.f) - t;
+    weights[NTaps - 1] = t;
+
+    VoxelType value = VoxelType(0);
+    if constexpr (LayoutAccess) {
+        using Layout = typename VolumeType::Layout;
+        const glm::uvec3 dims = _volume->dimensions();
+        std::array<size_t, NTaps> xOffsets;
+        std::array<size_t, NTaps> yOffsets;
+        std::array<size_t, NTaps> zOffsets;
+        for (int i = 0; i < NTaps; ++i) {
+            xOffsets[i] = Layout::xOffset(coords[i].x, dims);
+            yOffsets[i] = Layout::yOffset(coords[i].y, dims);
+            zOffsets[i] = Layout::zOffset(coords[i].z, dims);
+        }
+
+        const VoxelType* data = _volume->data();
+        for (int z = 0; z < NTaps; ++z) {
+            for (int y = 0; y < NTaps; ++y) {
+                const VoxelType* row = data + zOffsets[z] + yOffsets[y];
+                const float weightYZ = weights[y].y * weights[z].z;
+                for (int x = 0; x < NTaps; ++x) {
+                    value += (weights[x].x * weightYZ) * row[xOffsets[x]];
+                }
+            }
+        }
+    }
+    else {
+        for (int z = 0; z < NTaps; ++z) {
+            for (int y = 0; y < NTaps; ++y) {
+                const float weightYZ = weights[y].y * weights[z].z;
+                for (int x = 0; x < NTaps; ++x) {
+                    value += (weights[x].x * weightYZ) *
+                        _volume->get(glm::ivec3(coords[x].x, coords[y].y, coords[z].z));
+                }
+            }
+        }
+    }
+
+    if constexpr (FilterSize > 1) {
+        value /= static_cast<float>(FilterSize * FilterSize * FilterSize);
+    }
+    return value;
+}
+
+template <typename VolumeType>
+typename VolumeSampler<VolumeType>::VoxelType VolumeSampler<VolumeType>::sampleGeneric(
                                                           const glm::vec3& position) const
 {
     glm::ivec3 flooredPos = static_cast<glm::ivec3>(glm::floor(position));
@@ -49,9 +208,8 @@ typename VolumeType::VoxelType VolumeSampler<VolumeType>::sample(
     glm::ivec3 minCoords = flooredPos - _filterSize / 2; // min coord to sample from
     // max coords to sample from, including interpolation.
     glm::ivec3 maxCoords = minCoords + _filterSize;
-    glm::ivec3 clampCeiling = _volume->dimensions() - glm::ivec3(1);
 
-    typename VolumeType::VoxelType value;
+    VoxelType value = VoxelType(0);
     for (int z = minCoords.z; z <= maxCoords.z; z++) {
         for (int y = minCoords.y; y <= maxCoords.y; y++) {
             for (int x = minCoords.x; x <= maxCoords.x; x++) {
@@ -77,10 +235,15 @@ typename VolumeType::VoxelType VolumeSampler<VolumeType>::sample(
                 glm::ivec3 clampedCoords = glm::clamp(
                     sampleCoords,
                     glm::ivec3(0),
-                    clampCeiling
+                    _clampCeiling
                 );
-                value += filterCoefficient * _volume->get(clampedCoords);
-
+                if constexpr (LayoutAccess) {
+                    value += filterCoefficient *
+                             _volume->get(glm::uvec3(clampedCoords));
+                }
+                else {
+                    value += filterCoefficient * _volume->get(clampedCoords);
+                }
             }
         }
     }
@@ -89,5 +252,63 @@ typename VolumeType::VoxelType VolumeSampler<VolumeType>::sample(
     return value;
 }
 
+template <typename VolumeType>
+void VolumeSampler<VolumeType>::sampleTrilinearBlock(const glm::vec3* positions,
+                                                     size_t nPositions,
+                                                     VoxelType* values) const
+{
+    constexpr const size_t BlockSize = 64;
+
+    using Layout = typename VolumeType::Layout;
+    const glm::uvec3 dims = _volume->dimensions();
+    const VoxelType* data = _volume->data();
+
+    std::array<size_t, BlockSize> x0, x1, y0, y1, z0, z1;
+    std::array<float, BlockSize> tx, ty, tz;
+
+    for (size_t first = 0; first < nPositions; first += BlockSize) {
+        const size_t n = std::min(BlockSize, nPositions - first);
+        const glm::vec3* p = positions + first;
+
+        // First pass: the offsets of the eight neighboring voxels and the interpolation
+        // weights. This pass does not touch the volume and is free of branches
+        for (size_t i = 0; i < n; ++i) {
+            const float fx = std::floor(p[i].x);
+            const float fy = std::floor(p[i].y);
+            const float fz = std::floor(p[i].z);
+            tx[i] = p[i].x - fx;
+            ty[i] = p[i].y - fy;
+            tz[i] = p[i].z - fz;
+
+            const int ix = static_cast<int>(fx);
+            const int iy = static_cast<int>(fy);
+            const int iz = static_cast<int>(fz);
+            x0[i] = Layout::xOffset(std::clamp(ix, 0, _clampCeiling.x), dims);
+            x1[i] = Layout::xOffset(std::clamp(ix + 1, 0, _clampCeiling.x), dims);
+            y0[i] = Layout::yOffset(std::clamp(iy, 0, _clampCeiling.y), dims);
+            y1[i] = Layout::yOffset(std::clamp(iy + 1, 0, _clampCeiling.y), dims);
+            z0[i] = Layout::zOffset(std::clamp(iz, 0, _clampCeiling.z), dims);
+            z1[i] = Layout::zOffset(std::clamp(iz + 1, 0, _clampCeiling.z), dims);
+        }
+
+        // Second pass: gather the voxels and interpolate
+        for (size_t i = 0; i < n; ++i) {
+            const VoxelType* s0 = data + z0[i];
+            const VoxelType* s1 = data + z1[i];
+            const float wx = tx[i];
+            const float wy = ty[i];
+            const float wz = tz[i];
+
+            const VoxelType v00 = (1.f - wx) * s0[y0[i] + x0[i]] + wx * s0[y0[i] + x1[i]];
+            const VoxelType v01 = (1.f - wx) * s0[y1[i] + x0[i]] + wx * s0[y1[i] + x1[i]];
+            const VoxelType v10 = (1.f - wx) * s1[y0[i] + x0[i]] + wx * s1[y0[i] + x1[i]];
+            const VoxelType v11 = (1.f - wx) * s1[y1[i] + x0[i]] + wx * s1[y1[i] + x1[i]];
+
+            values[first + i] = (1.f - wz) * ((1.f - wy) * v00 + wy * v01) +
+                                wz * ((1.f - wy) * v10 + wy * v11);
+        }
+    }
+}
+
 } // namespace volume
 } // namespace openspace
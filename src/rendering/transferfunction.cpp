@@ -111,11 +111,34 @@ void TransferFunction::setCallback(TfChangedCallback callback) {
 }
 
 void TransferFunction::setTextureFromTxt(std::shared_ptr<ghoul::opengl::Texture> ptr) {
+    std::vector<glm::vec4> samples = samplesFromTxt(_filepath);
+    if (samples.empty()) {
+        return;
+    }
+
+    const size_t width = samples.size();
+    float* transferFunction = new float[width * 4];
+    std::memcpy(transferFunction, samples.data(), width * 4 * sizeof(float));
+
+    // no need to deallocate transferFunction. Ownership is transferred to the Texture.
+
+    _texture = std::make_unique<ghoul::opengl::Texture>(
+        transferFunction,
+        glm::size3_t(width, 1, 1),
+        ghoul::opengl::Texture::Format::RGBA,
+        GL_RGBA,
+        GL_FLOAT,
+        ghoul::opengl::Texture::FilterMode::Linear,
+        ghoul::opengl::Texture::WrappingMode::ClampToEdge
+    );
+}
+
+std::vector<glm::vec4> TransferFunction::samplesFromTxt(const std::string& filepath) {
     std::ifstream in;
-    in.open(_filepath.c_str());
+    in.open(filepath.c_str());
 
     if (!in.is_open()) {
-        throw ghoul::FileNotFoundError(_filepath);
+        throw ghoul::FileNotFoundError(filepath);
     }
 
     int width = 512;
@@ -152,7 +175,7 @@ void TransferFunction::setTextureFromTxt(std::shared_ptr<ghoul::opengl::Texture>
     in.close();
 
     if (mappingKeys.size() < 1) {
-        return;
+        return {};
     }
 
     if (mappingKeys.front().position > lower) {
@@ -163,11 +186,7 @@ void TransferFunction::setTextureFromTxt(std::shared_ptr<ghoul::opengl::Texture>
         mappingKeys.push_back({upper,mappingKeys.back().color});
     }
 
-    // allocate new float array with zeros
-    float* transferFunction = new float[width * 4];
-    for (int i = 0; i < 4 * width; ++i) {
-        transferFunction[i] = 0.f;
-    }
+    std::vector<glm::vec4> transferFunction(width, glm::vec4(0.f));
 
     size_t lowerIndex = static_cast<size_t>(floorf(lower * static_cast<float>(width-1)));
     size_t upperIndex = static_cast<size_t>(floorf(upper * static_cast<float>(width-1)));
@@ -190,7 +209,6 @@ void TransferFunction::setTextureFromTxt(std::shared_ptr<ghoul::opengl::Texture>
         float weight = dist / (currentKey->position - prevKey->position);
 
         for (size_t channel = 0; channel < 4; ++channel) {
-            size_t position = 4 * i + channel;
             // Interpolate linearly between prev and next mapping key
             float value = (prevKey->color[channel] * (1.f - weight) +
                           currentKey->color[channel] * weight) / 255.f;
@@ -199,21 +217,11 @@ void TransferFunction::setTextureFromTxt(std::shared_ptr<ghoul::opengl::Texture>
                 value *= (prevKey->color[3] * (1.f - weight) +
                          currentKey->color[3] * weight) / 255.f;
             }
-            transferFunction[position] = value;
+            transferFunction[i][channel] = value;
         }
     }
 
-    // no need to deallocate transferFunction. Ownership is transferred to the Texture.
-
-    _texture = std::make_unique<ghoul::opengl::Texture>(
-        transferFunction,
-        glm::size3_t(width, 1, 1),
-        ghoul::opengl::Texture::Format::RGBA,
-        GL_RGBA,
-        GL_FLOAT,
-        ghoul::opengl::Texture::FilterMode::Linear,
-        ghoul::opengl::Texture::WrappingMode::ClampToEdge
-    );
+    return transferFunction;
 }
 
 void TransferFunction::setTextureFromImage() {
@@ -239,6 +247,15 @@ glm::vec4 TransferFunction::sample(size_t offset) {
     return _texture->texelAsFloat(offset);
 }
 
+std::vector<glm::vec4> TransferFunction::samples() {
+    const size_t nSamples = width();
+    std::vector<glm::vec4> result(nSamples);
+    for (size_t i = 0; i < nSamples; ++i) {
+        result[i] = sample(i);
+    }
+    return result;
+}
+
 size_t TransferFunction::width() {
     update();
     return _texture->width();
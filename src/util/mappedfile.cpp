@@ -0,0 +1,194 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/mappedfile.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/misc/exception.h>
+
+#include <algorithm>
+
+#ifdef WIN32
+#include <Windows.h>
+#else // WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // WIN32
+
+namespace openspace {
+
+MappedFile::MappedFile(const std::string& path, AccessPattern accessPattern)
+    : _path(path)
+{
+#ifdef WIN32
+    const DWORD flags = FILE_ATTRIBUTE_NORMAL |
+        (accessPattern == AccessPattern::Sequential ?
+            FILE_FLAG_SEQUENTIAL_SCAN :
+            FILE_FLAG_RANDOM_ACCESS);
+    HANDLE file = CreateFileA(
+        _path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        flags,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        throw ghoul::RuntimeError(
+            fmt::format("Could not open file '{}'", _path),
+            "MappedFile"
+        );
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    _size = static_cast<size_t>(fileSize.QuadPart);
+    if (_size == 0) {
+        CloseHandle(file);
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping) {
+        // The view keeps a reference to the mapping, so the handles can be closed
+        _data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+#else // WIN32
+    int fd = open(_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw ghoul::RuntimeError(
+            fmt::format("Could not open file '{}'", _path),
+            "MappedFile"
+        );
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw ghoul::RuntimeError(
+            fmt::format("Could not determine the size of file '{}'", _path),
+            "MappedFile"
+        );
+    }
+    _size = static_cast<size_t>(st.st_size);
+    if (_size == 0) {
+        close(fd);
+        return;
+    }
+
+    // The mapping stays valid after the file descriptor is closed
+    void* data = mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data != MAP_FAILED) {
+        madvise(
+            data,
+            _size,
+            accessPattern == AccessPattern::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM
+        );
+        _data = static_cast<const char*>(data);
+    }
+#endif // WIN32
+
+    if (!_data) {
+        throw ghoul::RuntimeError(
+            fmt::format("Could not map file '{}'", _path),
+            "MappedFile"
+        );
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (!_data) {
+        return;
+    }
+#ifdef WIN32
+    UnmapViewOfFile(_data);
+#else // WIN32
+    munmap(const_cast<char*>(_data), _size);
+#endif // WIN32
+}
+
+const std::string& MappedFile::path() const {
+    return _path;
+}
+
+const char* MappedFile::data() const {
+    return _data;
+}
+
+size_t MappedFile::size() const {
+    return _size;
+}
+
+void MappedFile::prefetch(size_t offset, size_t length) const {
+    if (!_data || offset >= _size || length == 0) {
+        return;
+    }
+    length = std::min(length, _size - offset);
+
+#ifdef WIN32
+    WIN32_MEMORY_RANGE_ENTRY range;
+    range.VirtualAddress = const_cast<char*>(_data + offset);
+    range.NumberOfBytes = length;
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else // WIN32
+    // madvise requires a page aligned start address
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t alignedOffset = offset - (offset % pageSize);
+    madvise(
+        const_cast<char*>(_data + alignedOffset),
+        length + (offset - alignedOffset),
+        MADV_WILLNEED
+    );
+#endif // WIN32
+}
+
+void MappedFile::touch(size_t offset, size_t length) const {
+    if (!_data || offset >= _size || length == 0) {
+        return;
+    }
+    length = std::min(length, _size - offset);
+
+#ifdef WIN32
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    const size_t pageSize = static_cast<size_t>(systemInfo.dwPageSize);
+#else // WIN32
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif // WIN32
+
+    // The reads go through a volatile pointer so that they are not optimized away
+    const volatile char* data = _data + offset;
+    char sum = 0;
+    for (size_t i = 0; i < length; i += pageSize) {
+        sum ^= data[i];
+    }
+    sum ^= data[length - 1];
+    (void)sum;
+}
+
+} // namespace openspace
@@ -0,0 +1,460 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/speckloader.h>
+
+#include <openspace/util/mappedfile.h>
+#include <openspace/util/threadpool.h>
+#include <ghoul/fmt.h>
+#include <ghoul/misc/exception.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+#include <thread>
+
+namespace {
+    // Data sections that are smaller than this are parsed on the calling thread, larger
+    // ones are split into chunks of at least this size
+    constexpr const size_t MinChunkSize = 1 << 20;
+
+    // Partiview meshes store at most the position, texture coordinates, and normal of a
+    // vertex
+    constexpr const int MaxValuesPerMeshVertex = 7;
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    // Returns the line starting at it and advances it to the beginning of the next line
+    std::string_view nextLine(const char*& it, const char* end) {
+        const char* lineEnd = static_cast<const char*>(
+            std::memchr(it, '\n', static_cast<size_t>(end - it))
+        );
+        std::string_view line(it, (lineEnd ? lineEnd : end) - it);
+        it = lineEnd ? lineEnd + 1 : end;
+
+        // Guard against wrong line endings (copying files from Windows to Mac) causes
+        // lines to have a final \r
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        return line;
+    }
+
+    // Returns the next whitespace separated token and removes it from the line
+    std::string_view nextToken(std::string_view& line) {
+        size_t begin = 0;
+        while (begin < line.size() && isSpace(line[begin])) {
+            ++begin;
+        }
+        size_t end = begin;
+        while (end < line.size() && !isSpace(line[end])) {
+            ++end;
+        }
+        std::string_view token = line.substr(begin, end - begin);
+        line.remove_prefix(end);
+        return token;
+    }
+
+    // Empty lines and comments, which are signaled by a preceding '#', carry no data
+    bool isEmptyOrComment(std::string_view line) {
+        for (char c : line) {
+            if (!isSpace(c)) {
+                return c == '#';
+            }
+        }
+        return true;
+    }
+
+    // Parses the next number of the line and removes it from the line. Values that are
+    // outside of the range of T are stored as 0
+    template <typename T>
+    bool parseNumber(std::string_view& line, T& value) {
+        const char* first = line.data();
+        const char* last = first + line.size();
+        while (first != last && isSpace(*first)) {
+            ++first;
+        }
+        // std::from_chars does not accept an explicit plus sign
+        if (first != last && *first == '+') {
+            ++first;
+        }
+
+        std::from_chars_result res = std::from_chars(first, last, value);
+        if (res.ec == std::errc::invalid_argument) {
+            return false;
+        }
+        if (res.ec == std::errc::result_out_of_range) {
+            value = T(0);
+        }
+        line.remove_prefix(res.ptr - line.data());
+        return true;
+    }
+
+    // Parses nValues values from the line. Just as with reading from a stream, a value
+    // that is missing or cannot be parsed is set to 0, as are all values following it
+    void parseValues(std::string_view line, float* values, int nValues) {
+        int i = 0;
+        while (i < nValues && parseNumber(line, values[i])) {
+            ++i;
+        }
+        std::fill(values + i, values + nValues, 0.f);
+    }
+
+    void parseEntries(const char* it, const char* end, int valuesPerEntry,
+                      std::vector<float>& entries)
+    {
+        while (it != end) {
+            std::string_view line = nextLine(it, end);
+            if (isEmptyOrComment(line)) {
+                continue;
+            }
+
+            entries.resize(entries.size() + valuesPerEntry);
+            parseValues(line, entries.data() + entries.size() - valuesPerEntry,
+                valuesPerEntry);
+        }
+    }
+
+    [[noreturn]] void throwMalformed(const std::string& path, std::string_view line) {
+        throw ghoul::RuntimeError(
+            fmt::format("Malformed line '{}' in file '{}'", line, path),
+            "SpeckLoader"
+        );
+    }
+
+    // Mesh blocks are structured as follows:
+    // mesh -t texnum -c colorindex -s style {
+    // numU numV
+    // numU * numV lines with the values of one vertex each
+    // }
+    // where texnum is the index of the texture, colorindex is the index of the color for
+    // the mesh, and style is solid, wire, or point. All options are optional
+    openspace::speck::Dataset::Mesh parseMesh(std::string_view options, const char*& it,
+                                              const char* end, const std::string& path)
+    {
+        openspace::speck::Dataset::Mesh mesh;
+        for (std::string_view t = nextToken(options); !t.empty() && t != "{";
+             t = nextToken(options))
+        {
+            if (t == "-t") {
+                parseNumber(options, mesh.textureIndex);
+            }
+            else if (t == "-c") {
+                parseNumber(options, mesh.colorIndex);
+            }
+            else if (t == "-s") {
+                mesh.style = std::string(nextToken(options));
+            }
+        }
+
+        std::string_view line;
+        do {
+            if (it == end) {
+                throwMalformed(path, "mesh");
+            }
+            line = nextLine(it, end);
+        } while (isEmptyOrComment(line));
+
+        std::string_view dims = line;
+        if (!parseNumber(dims, mesh.numU) || !parseNumber(dims, mesh.numV)) {
+            throwMalformed(path, line);
+        }
+
+        const int nVertices = mesh.numU * mesh.numV;
+        mesh.vertices.reserve(nVertices * 3);
+        int iVertex = 0;
+        while (it != end) {
+            line = nextLine(it, end);
+            if (isEmptyOrComment(line)) {
+                continue;
+            }
+
+            std::string_view rest = line;
+            if (nextToken(rest).front() == '}') {
+                return mesh;
+            }
+            if (iVertex == nVertices) {
+                // All vertices have been read, but the block is not closed
+                throwMalformed(path, line);
+            }
+
+            float value;
+            for (int i = 0; i < MaxValuesPerMeshVertex && parseNumber(line, value); ++i) {
+                mesh.vertices.push_back(value);
+            }
+            ++iVertex;
+        }
+
+        throw ghoul::RuntimeError(
+            fmt::format("Unterminated mesh block in file '{}'", path),
+            "SpeckLoader"
+        );
+    }
+} // namespace
+
+namespace openspace::speck {
+
+size_t Dataset::nEntries() const {
+    return entries.size() / valuesPerEntry;
+}
+
+int Dataset::variableIndex(const std::string& name) const {
+    auto it = std::find_if(
+        variables.begin(),
+        variables.end(),
+        [&name](const Variable& v) { return v.name == name; }
+    );
+    return it != variables.end() ? it->index : -1;
+}
+
+Dataset loadSpeckFile(const std::string& path, size_t nThreads) {
+    Dataset res;
+
+    MappedFile file(path, MappedFile::AccessPattern::Sequential);
+    const char* it = file.data();
+    const char* end = file.data() + file.size();
+
+    // The beginning of the speck file has a header that either contains comments
+    // (signaled by a preceding '#') or information about the structure of the file
+    // (signaled by the keywords 'datavar', 'texturevar', 'texture', 'polyorivar',
+    // 'maxcomment', and 'mesh'). The data lines start with the first other line
+    const char* dataBegin = end;
+    while (it != end) {
+        const char* lineBegin = it;
+        std::string_view line = nextLine(it, end);
+        if (isEmptyOrComment(line)) {
+            continue;
+        }
+
+        std::string_view rest = line;
+        std::string_view keyword = nextToken(rest);
+        if (keyword == "datavar") {
+            // datavar lines are structured as follows:
+            // datavar # description
+            // where # is the index of the data variable. Orientations consist of the two
+            // 3d vectors u and v and thus take up six values
+            Dataset::Variable variable;
+            if (!parseNumber(rest, variable.index)) {
+                throwMalformed(path, line);
+            }
+            variable.name = std::string(nextToken(rest));
+
+            const bool isOrientation = variable.name == "orientation" ||
+                                       variable.name == "ori";
+            // +3 because of the x, y and z at the beginning of each line
+            res.valuesPerEntry = std::max(
+                res.valuesPerEntry,
+                variable.index + (isOrientation ? 6 : 1) + 3
+            );
+            res.variables.push_back(std::move(variable));
+        }
+        else if (keyword == "texturevar") {
+            if (!parseNumber(rest, res.textureDataIndex)) {
+                throwMalformed(path, line);
+            }
+        }
+        else if (keyword == "polyorivar") {
+            if (!parseNumber(rest, res.orientationDataIndex)) {
+                throwMalformed(path, line);
+            }
+        }
+        else if (keyword == "texture") {
+            // texture lines are structured as follows:
+            // texture -options index filename
+            // where the options are not being used right now
+            std::string_view token = nextToken(rest);
+            while (!token.empty() && token.front() == '-') {
+                token = nextToken(rest);
+            }
+
+            Dataset::Texture texture;
+            if (!parseNumber(token, texture.index)) {
+                throwMalformed(path, line);
+            }
+            texture.file = std::string(nextToken(rest));
+            res.textures.push_back(std::move(texture));
+        }
+        else if (keyword == "mesh") {
+            res.meshes.push_back(parseMesh(rest, it, end, path));
+        }
+        else if (keyword != "maxcomment") {
+            dataBegin = lineBegin;
+            break;
+        }
+    }
+
+    const size_t dataSize = static_cast<size_t>(end - dataBegin);
+    if (nThreads == 0) {
+        nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    const size_t nChunks = std::clamp<size_t>(dataSize / MinChunkSize, 1, nThreads);
+    if (nChunks == 1) {
+        parseEntries(dataBegin, end, res.valuesPerEntry, res.entries);
+        return res;
+    }
+
+    // Split the data lines into chunks of roughly the same size that each start at the
+    // beginning of a line
+    std::vector<const char*> chunkBegins(nChunks + 1, end);
+    chunkBegins[0] = dataBegin;
+    for (size_t i = 1; i < nChunks; ++i) {
+        const char* split = dataBegin + i * (dataSize / nChunks);
+        const char* lineEnd = static_cast<const char*>(
+            std::memchr(split, '\n', static_cast<size_t>(end - split))
+        );
+        chunkBegins[i] = lineEnd ? lineEnd + 1 : end;
+    }
+
+    std::vector<std::vector<float>> chunks(nChunks);
+    {
+        ThreadPool pool(nChunks);
+        std::vector<std::future<void>> results;
+        results.reserve(nChunks);
+        for (size_t i = 0; i < nChunks; ++i) {
+            results.push_back(pool.submit([&, i]() {
+                parseEntries(
+                    chunkBegins[i],
+                    chunkBegins[i + 1],
+                    res.valuesPerEntry,
+                    chunks[i]
+                );
+            }));
+        }
+        for (std::future<void>& r : results) {
+            r.get();
+        }
+    }
+
+    size_t nValues = 0;
+    for (const std::vector<float>& chunk : chunks) {
+        nValues += chunk.size();
+    }
+    res.entries.reserve(nValues);
+    for (std::vector<float>& chunk : chunks) {
+        res.entries.insert(res.entries.end(), chunk.begin(), chunk.end());
+        chunk = std::vector<float>();
+    }
+    return res;
+}
+
+Labels loadLabelFile(const std::string& path) {
+    Labels res;
+
+    MappedFile file(path, MappedFile::AccessPattern::Sequential);
+    const char* begin = file.data();
+    const char* end = file.data() + file.size();
+
+    // The labels follow the textcolor line, which ends the header. Files without one
+    // consist of labels only
+    const char* it = begin;
+    while (it != end) {
+        std::string_view rest = nextLine(it, end);
+        if (nextToken(rest) == "textcolor") {
+            // TODO: handle cases of labels with different colors
+            begin = it;
+            break;
+        }
+    }
+
+    it = begin;
+    while (it != end) {
+        std::string_view line = nextLine(it, end);
+        if (isEmptyOrComment(line)) {
+            continue;
+        }
+
+        glm::vec3 position;
+        parseValues(line, glm::value_ptr(position), 3);
+        for (int i = 0; i < 3; ++i) {
+            nextToken(line);
+        }
+        nextToken(line); // text keyword
+
+        std::string text;
+        for (std::string_view word = nextToken(line); !word.empty() && word != "#";
+             word = nextToken(line))
+        {
+            if (!text.empty()) {
+                text += ' ';
+            }
+            text.append(word.data(), word.size());
+        }
+
+        res.positions.push_back(position);
+        res.texts.push_back(std::move(text));
+    }
+
+    return res;
+}
+
+std::vector<glm::vec4> loadColorMapFile(const std::string& path) {
+    MappedFile file(path, MappedFile::AccessPattern::Sequential);
+    const char* it = file.data();
+    const char* end = file.data() + file.size();
+
+    // The number of colors is given by the first line that starts with a digit
+    size_t nColors = 0;
+    bool hasNumberOfColors = false;
+    while (it != end && !hasNumberOfColors) {
+        std::string_view line = nextLine(it, end);
+        if (!line.empty() && line.front() >= '0' && line.front() <= '9') {
+            hasNumberOfColors = parseNumber(line, nColors);
+        }
+    }
+    if (!hasNumberOfColors) {
+        throw ghoul::RuntimeError(
+            fmt::format("Color map file '{}' does not specify a number of colors", path),
+            "SpeckLoader"
+        );
+    }
+
+    std::vector<glm::vec4> colors;
+    colors.reserve(nColors);
+    while (it != end && colors.size() < nColors) {
+        std::string_view line = nextLine(it, end);
+        if (isEmptyOrComment(line)) {
+            continue;
+        }
+
+        glm::vec4 color;
+        parseValues(line, glm::value_ptr(color), 4);
+        colors.push_back(color);
+    }
+
+    if (colors.size() < nColors) {
+        throw ghoul::RuntimeError(
+            fmt::format(
+                "Color map file '{}' contains {} instead of {} colors",
+                path, colors.size(), nColors
+            ),
+            "SpeckLoader"
+        );
+    }
+    return colors;
+}
+
+} // namespace openspace::speck
@@ -24,45 +24,85 @@
 
 #include <openspace/util/threadpool.h>
 
+namespace {
+    // The pool and index of the worker that is running on the current thread, if any.
+    // Used to place tasks that are enqueued from within a task on the local queue
+    thread_local const openspace::ThreadPool* CurrentPool = nullptr;
+    thread_local size_t CurrentWorkerIndex = 0;
+
+    // Number of times an idle worker yields before it goes to sleep
+    constexpr const int MaxIdleRounds = 16;
+} // namespace
+
 namespace openspace {
 
-Worker::Worker(ThreadPool& pool_)
-    : pool(pool_)
+CancellationToken::CancellationToken()
+    : _isCancelled(std::make_shared<std::atomic_bool>(false))
 {}
 
-void Worker::operator()() {
-    std::function<void()> task;
-    while (true) {
-        // acquire lock
-        {
-            std::unique_lock<std::mutex> lock(pool.queue_mutex);
+void CancellationToken::cancel() {
+    *_isCancelled = true;
+}
 
-            // look for a work item
-            while (!pool.stop && pool.tasks.empty()) {
-                // if there are none wait for notification
-                pool.condition.wait(lock);
-            }
+bool CancellationToken::isCancelled() const {
+    return *_isCancelled;
+}
 
-            if (pool.stop) { // exit if the pool is stopped
-                return;
-            }
+Worker::Worker(ThreadPool& pool_, size_t index_)
+    : pool(pool_)
+    , index(index_)
+{}
 
-            // get the task from the queue
-            task = pool.tasks.front();
-            pool.tasks.pop_front();
+void Worker::operator()() {
+    CurrentPool = &pool;
+    CurrentWorkerIndex = index;
 
-        } // release lock
+    ThreadPool::Task task;
+    int nIdleRounds = 0;
+    while (true) {
+        if (pool.stop) { // exit if the pool is stopped
+            return;
+        }
 
-        // execute the task
-        task();
+        if (pool.popTask(index, task)) {
+            if (!task.isCancelled || !*task.isCancelled) {
+                task.function();
+            }
+            task = ThreadPool::Task();
+            nIdleRounds = 0;
+            continue;
+        }
+
+        // Give the producers a chance to catch up before going to sleep, which is a lot
+        // more expensive than yielding
+        if (nIdleRounds < MaxIdleRounds) {
+            ++nIdleRounds;
+            std::this_thread::yield();
+            continue;
+        }
+        nIdleRounds = 0;
+
+        // No work item could be found in any queue; wait for notification
+        std::unique_lock<std::mutex> lock(pool.sleep_mutex);
+        ++pool.nSleepingWorkers;
+        pool.condition.wait(lock, [this]() {
+            return pool.stop || pool.nQueuedTasks > 0;
+        });
+        --pool.nSleepingWorkers;
     }
 }
 
 ThreadPool::ThreadPool(size_t numThreads)
-    : stop(false)
+    : nextQueue(0)
+    , nQueuedTasks(0)
+    , nSleepingWorkers(0)
+    , stop(false)
 {
     for (size_t i = 0; i < numThreads; ++i) {
-        workers.push_back(std::thread(Worker(*this)));
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t i = 0; i < numThreads; ++i) {
+        workers.push_back(std::thread(Worker(*this, i)));
     }
 }
 
@@ -74,7 +114,7 @@ ThreadPool::ThreadPool(const ThreadPool& toCopy)
 ThreadPool::~ThreadPool() {
     // stop all threads
     {
-        std::unique_lock<std::mutex> lock(queue_mutex);
+        std::unique_lock<std::mutex> lock(sleep_mutex);
         stop = true;
     }
     condition.notify_all();
@@ -86,23 +126,108 @@ ThreadPool::~ThreadPool() {
 }
 
 // add new work item to the pool
-void ThreadPool::enqueue(std::function<void()> f) {
-    { // acquire lock
-        std::unique_lock<std::mutex> lock(queue_mutex);
+void ThreadPool::enqueue(std::function<void()> f, Priority priority) {
+    push({ std::move(f), nullptr }, priority);
+}
+
+void ThreadPool::enqueue(std::function<void()> f, Priority priority,
+                         CancellationToken token)
+{
+    push({ std::move(f), std::move(token._isCancelled) }, priority);
+}
 
-        // add the task
-        tasks.push_back(f);
-    } // release lock
+void ThreadPool::push(Task task, Priority priority) {
+    if (queues.empty()) {
+        return;
+    }
+
+    // Tasks spawned from one of our own workers stay local, all others are distributed
+    const size_t i = (CurrentPool == this) ?
+        CurrentWorkerIndex :
+        nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+    {
+        WorkQueue& queue = *queues[i];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks[static_cast<int>(priority)].push_back(std::move(task));
+        ++queue.size;
+    }
+    ++nQueuedTasks;
 
-    // wake up one thread
-    condition.notify_one();
+    // wake up one thread, but only if any is asleep. A worker registers itself as
+    // sleeping before checking nQueuedTasks, so one of us is guaranteed to see the
+    // other's update. Taking the lock prevents a lost wakeup for a worker that has just
+    // checked the predicate but not started waiting yet
+    if (nSleepingWorkers > 0) {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+        }
+        condition.notify_one();
+    }
 }
 
 void ThreadPool::clearTasks() {
-    { // acquire lock
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        tasks.clear();
-    } // release lock
+    for (std::unique_ptr<WorkQueue>& queue : queues) {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        for (std::deque<Task>& tasks : queue->tasks) {
+            nQueuedTasks -= tasks.size();
+            queue->size -= tasks.size();
+            tasks.clear();
+        }
+    }
+}
+
+size_t ThreadPool::numThreads() const {
+    return workers.size();
+}
+
+size_t ThreadPool::numQueuedTasks() const {
+    return nQueuedTasks;
+}
+
+bool ThreadPool::popTask(size_t workerIndex, Task& task) {
+    if (nQueuedTasks == 0) {
+        return false;
+    }
+
+    const size_t nQueues = queues.size();
+    for (int p = 0; p < NumPriorities; ++p) {
+        // Own queue first, oldest task first
+        WorkQueue& ownQueue = *queues[workerIndex];
+        if (ownQueue.size > 0) {
+            std::lock_guard<std::mutex> lock(ownQueue.mutex);
+            std::deque<Task>& tasks = ownQueue.tasks[p];
+            if (!tasks.empty()) {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+                --ownQueue.size;
+                --nQueuedTasks;
+                return true;
+            }
+        }
+
+        // Steal from the back of the other workers' queues. Queues that are empty or
+        // currently locked by someone else are skipped rather than waited for
+        for (size_t i = 1; i < nQueues; ++i) {
+            WorkQueue& queue = *queues[(workerIndex + i) % nQueues];
+            if (queue.size == 0) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+            if (!lock.owns_lock()) {
+                continue;
+            }
+            std::deque<Task>& tasks = queue.tasks[p];
+            if (!tasks.empty()) {
+                task = std::move(tasks.back());
+                tasks.pop_back();
+                --queue.size;
+                --nQueuedTasks;
+                return true;
+            }
+        }
+    }
+    return false;
 }
 
 } // namespace openspace
@@ -68,7 +68,9 @@
 #include <test_optionproperty.inl>
 #include <test_powerscalecoordinates.inl>
 #include <test_scriptscheduler.inl>
+#include <test_speckloader.inl>
 #include <test_spicemanager.inl>
+#include <test_threadpool.inl>
 #include <test_timeline.inl>
 
 #ifdef OPENSPACE_MODULE_GLOBEBROWSING_ENABLED
@@ -77,7 +79,15 @@
 #include <test_concurrentjobmanager.inl>
 #include <test_concurrentqueue.inl>
 #include <test_lrucache.inl>
+#include <test_shardedtilecache.inl>
+#include <test_prioritythreadpool.inl>
 #include <test_gdalwms.inl>
+#include <test_tilepackfile.inl>
+#include <test_tiledatakernels.inl>
+#endif
+
+#ifdef OPENSPACE_MODULE_FIELDLINESSEQUENCE_ENABLED
+#include <test_fieldlinesstate.inl>
 #endif
 
 #ifdef OPENSPACE_MODULE_ISWA_ENABLED
@@ -86,6 +96,12 @@
 
 #ifdef OPENSPACE_MODULE_VOLUME_ENABLED
 #include <test_rawvolumeio.inl>
+#include <test_rawvolumelayout.inl>
+#include <test_volumesampler.inl>
+#endif
+
+#ifdef OPENSPACE_MODULE_MULTIRESVOLUME_ENABLED
+#include <test_brickcompression.inl>
 #endif
 
 // Regression tests
@@ -0,0 +1,160 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/multiresvolume/rendering/brickcompression.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+    // A smooth field with a constant region, similar to the bricks of simulation data
+    std::vector<float> smoothBrick(size_t dim) {
+        std::vector<float> values(dim * dim * dim);
+        for (size_t z = 0; z < dim; ++z) {
+            for (size_t y = 0; y < dim; ++y) {
+                for (size_t x = 0; x < dim; ++x) {
+                    const float v = (x < dim / 2) ?
+                        0.f :
+                        std::sin(0.3f * x) * std::cos(0.2f * y) + 0.01f * z;
+                    values[(z * dim + y) * dim + x] = v;
+                }
+            }
+        }
+        return values;
+    }
+} // namespace
+
+class BrickCompressionTest : public testing::Test {};
+
+TEST_F(BrickCompressionTest, LosslessRoundTrip) {
+    using namespace openspace::brickcompression;
+
+    std::vector<float> values = smoothBrick(18);
+    std::vector<char> compressed;
+    compress(values.data(), values.size(), Method::Lossless, 0.f, compressed);
+
+    EXPECT_EQ(static_cast<Method>(compressed[0]), Method::Lossless);
+    EXPECT_LT(compressed.size(), values.size() * sizeof(float));
+
+    std::vector<float> decompressed(values.size());
+    ASSERT_TRUE(decompress(
+        compressed.data(),
+        compressed.size(),
+        0.f,
+        decompressed.data(),
+        decompressed.size()
+    ));
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(values[i], decompressed[i]);
+    }
+}
+
+TEST_F(BrickCompressionTest, QuantizedErrorBound) {
+    using namespace openspace::brickcompression;
+
+    const float errorBound = 1e-3f;
+    std::vector<float> values = smoothBrick(18);
+    std::vector<char> compressed;
+    compress(values.data(), values.size(), Method::Quantized, errorBound, compressed);
+
+    EXPECT_EQ(static_cast<Method>(compressed[0]), Method::Quantized);
+    EXPECT_LT(compressed.size(), values.size() * sizeof(float) / 2);
+
+    std::vector<float> decompressed(values.size());
+    ASSERT_TRUE(decompress(
+        compressed.data(),
+        compressed.size(),
+        errorBound,
+        decompressed.data(),
+        decompressed.size()
+    ));
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_LE(std::abs(values[i] - decompressed[i]), errorBound * 1.0001f);
+    }
+}
+
+TEST_F(BrickCompressionTest, IncompressibleBricksAreStored) {
+    using namespace openspace::brickcompression;
+
+    std::mt19937 generator(1);
+    std::uniform_int_distribution<uint32_t> distribution(0, 0x7F7FFFFF);
+    std::vector<float> values(1000);
+    for (float& value : values) {
+        const uint32_t bits = distribution(generator);
+        std::memcpy(&value, &bits, sizeof(float));
+    }
+    values[10] = std::numeric_limits<float>::infinity();
+
+    for (Method method : { Method::Lossless, Method::Quantized }) {
+        std::vector<char> compressed;
+        compress(values.data(), values.size(), method, 1.f, compressed);
+
+        EXPECT_EQ(static_cast<Method>(compressed[0]), Method::None);
+        EXPECT_EQ(compressed.size(), values.size() * sizeof(float) + 1);
+
+        std::vector<float> decompressed(values.size());
+        ASSERT_TRUE(decompress(
+            compressed.data(),
+            compressed.size(),
+            1.f,
+            decompressed.data(),
+            decompressed.size()
+        ));
+        EXPECT_EQ(0, std::memcmp(
+            values.data(),
+            decompressed.data(),
+            values.size() * sizeof(float)
+        ));
+    }
+}
+
+TEST_F(BrickCompressionTest, MalformedData) {
+    using namespace openspace::brickcompression;
+
+    std::vector<float> values = smoothBrick(10);
+    std::vector<char> compressed;
+    compress(values.data(), values.size(), Method::Lossless, 0.f, compressed);
+
+    std::vector<float> decompressed(values.size());
+    EXPECT_FALSE(decompress(
+        compressed.data(),
+        compressed.size() - 1,
+        0.f,
+        decompressed.data(),
+        decompressed.size()
+    ));
+    EXPECT_FALSE(decompress(
+        compressed.data(),
+        compressed.size(),
+        0.f,
+        decompressed.data(),
+        decompressed.size() + 1
+    ));
+    EXPECT_FALSE(decompress(compressed.data(), 0, 0.f, decompressed.data(), 1));
+}
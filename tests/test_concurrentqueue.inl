@@ -25,6 +25,13 @@
 #include "gtest/gtest.h"
 
 #include <openspace/util/concurrentqueue.h>
+#include <openspace/util/concurrentringbuffer.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -51,3 +58,171 @@ TEST_F(ConcurrentQueueTest, SharedPtr) {
     std::cout << *val << std::endl;
 }
 */
+
+namespace {
+    // Pushes nItemsPerProducer distinct values from each producer thread and pops them
+    // from nConsumers threads. Returns the sum of all popped values
+    template <typename Queue>
+    long long runProducersConsumers(Queue& queue, int nProducers, int nConsumers,
+                                    int nItemsPerProducer)
+    {
+        std::atomic<long long> sum(0);
+        std::atomic_int nPopped(0);
+        const int nTotal = nProducers * nItemsPerProducer;
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < nProducers; ++p) {
+            threads.push_back(std::thread([&, p]() {
+                for (int i = 0; i < nItemsPerProducer; ++i) {
+                    queue.push(p * nItemsPerProducer + i);
+                }
+            }));
+        }
+        for (int c = 0; c < nConsumers; ++c) {
+            threads.push_back(std::thread([&]() {
+                while (true) {
+                    const int n = nPopped++;
+                    if (n >= nTotal) {
+                        return;
+                    }
+                    sum += queue.pop();
+                }
+            }));
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+        return sum;
+    }
+} // namespace
+
+TEST_F(ConcurrentQueueTest, RingBufferBasic) {
+    using namespace openspace;
+
+    ConcurrentRingBuffer<int> q(3, ConcurrentRingBuffer<int>::OnFull::Block);
+    EXPECT_EQ(q.capacity(), 4);
+    EXPECT_EQ(q.size(), 0);
+
+    int val = 0;
+    EXPECT_FALSE(q.tryPop(val));
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(q.tryPush(i));
+    }
+    EXPECT_FALSE(q.tryPush(4)) << "The ring buffer should be full";
+    EXPECT_EQ(q.size(), 4);
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(q.pop(), i);
+    }
+    EXPECT_EQ(q.size(), 0);
+}
+
+TEST_F(ConcurrentQueueTest, RingBufferOverflow) {
+    using namespace openspace;
+
+    ConcurrentRingBuffer<std::shared_ptr<int>> q(4);
+    for (int i = 0; i < 100; ++i) {
+        q.push(std::make_shared<int>(i));
+    }
+    EXPECT_EQ(q.size(), 100);
+
+    for (int i = 0; i < 100; ++i) {
+        std::shared_ptr<int> val = q.pop();
+        ASSERT_NE(val, nullptr);
+        EXPECT_EQ(*val, i) << "Overflowing items should keep their order";
+    }
+    EXPECT_EQ(q.size(), 0);
+}
+
+TEST_F(ConcurrentQueueTest, RingBufferContention) {
+    using namespace openspace;
+
+    constexpr const int NumItems = 100000;
+    for (int nThreads : { 1, 2, 4, 8 }) {
+        const long long nTotal = static_cast<long long>(nThreads) * NumItems;
+        const long long expected = nTotal * (nTotal - 1) / 2;
+
+        ConcurrentRingBuffer<int> blocking(64, ConcurrentRingBuffer<int>::OnFull::Block);
+        EXPECT_EQ(
+            runProducersConsumers(blocking, nThreads, nThreads, NumItems),
+            expected
+        ) << "Blocking ring buffer lost or duplicated items with " << nThreads
+          << " producers and consumers";
+        EXPECT_EQ(blocking.size(), 0);
+
+        ConcurrentRingBuffer<int> overflow(64);
+        EXPECT_EQ(
+            runProducersConsumers(overflow, nThreads, nThreads, NumItems),
+            expected
+        ) << "Overflowing ring buffer lost or duplicated items with " << nThreads
+          << " producers and consumers";
+        EXPECT_EQ(overflow.size(), 0);
+    }
+}
+
+TEST_F(ConcurrentQueueTest, RingBufferOverflowOrder) {
+    using namespace openspace;
+
+    constexpr const int NumProducers = 4;
+    constexpr const int NumItems = 50000;
+
+    // A tiny ring buffer makes the queue switch in and out of overflowing constantly
+    ConcurrentRingBuffer<int> q(2);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < NumProducers; ++p) {
+        producers.emplace_back([&q, p]() {
+            for (int i = 0; i < NumItems; ++i) {
+                q.push(i * NumProducers + p);
+            }
+        });
+    }
+
+    // With a single consumer, the items of each producer have to arrive in the order
+    // in which they were pushed
+    std::array<int, NumProducers> lastItem;
+    lastItem.fill(-1);
+    bool isOrdered = true;
+    for (int i = 0; i < NumProducers * NumItems; ++i) {
+        const int item = q.pop();
+        const int producer = item % NumProducers;
+        const int index = item / NumProducers;
+        isOrdered &= (index == lastItem[producer] + 1);
+        lastItem[producer] = index;
+    }
+    for (std::thread& t : producers) {
+        t.join();
+    }
+
+    EXPECT_TRUE(isOrdered) << "Items of a producer overtook each other";
+    for (int p = 0; p < NumProducers; ++p) {
+        EXPECT_EQ(lastItem[p], NumItems - 1);
+    }
+    EXPECT_EQ(q.size(), 0);
+}
+
+TEST_F(ConcurrentQueueTest, DISABLED_ThroughputBenchmark) {
+    using namespace openspace;
+
+    constexpr const int NumItems = 200000;
+    std::cout << "Threads | ConcurrentQueue (items/s) | ConcurrentRingBuffer (items/s)";
+    std::cout << std::endl;
+    for (int nThreads = 1; nThreads <= 8; nThreads *= 2) {
+        const double nTotal = static_cast<double>(nThreads) * NumItems;
+
+        ConcurrentQueue<int> queue;
+        auto start = std::chrono::high_resolution_clock::now();
+        runProducersConsumers(queue, nThreads, nThreads, NumItems);
+        std::chrono::duration<double> queueTime =
+            std::chrono::high_resolution_clock::now() - start;
+
+        ConcurrentRingBuffer<int> ringBuffer(1024);
+        start = std::chrono::high_resolution_clock::now();
+        runProducersConsumers(ringBuffer, nThreads, nThreads, NumItems);
+        std::chrono::duration<double> ringBufferTime =
+            std::chrono::high_resolution_clock::now() - start;
+
+        std::cout << nThreads << " | " << nTotal / queueTime.count() << " | "
+                  << nTotal / ringBufferTime.count() << std::endl;
+    }
+}
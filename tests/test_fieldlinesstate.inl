@@ -0,0 +1,224 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <modules/fieldlinessequence/util/fieldlinesstate.h>
+
+// This include should be removed after the time class is not dependent on
+// Spice anymore
+#include <openspace/util/spicemanager.h>
+#include <openspace/util/time.h>
+#include <ghoul/filesystem/filesystem.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+class FieldlinesStateTest : public testing::Test {
+protected:
+    void SetUp() override {
+        openspace::SpiceManager::initialize();
+        openspace::SpiceManager::ref().loadKernel(
+            absPath("${TESTDIR}/SpiceTest/spicekernels/naif0008.tls")
+        );
+
+        _prefix = absPath("${TESTDIR}/fieldlines_");
+        std::string time = openspace::Time(TriggerTime).ISO8601();
+        time.replace(13, 1, "-");
+        time.replace(16, 1, "-");
+        time.replace(19, 1, "-");
+        _path = _prefix + time + ".osfls";
+        std::remove(_path.c_str());
+    }
+
+    void TearDown() override {
+        std::remove(_path.c_str());
+        openspace::SpiceManager::deinitialize();
+    }
+
+    // Two lines with 4 and 6 vertices and two extra quantities
+    static openspace::FieldlinesState createState() {
+        openspace::FieldlinesState state;
+        state.setModel(openspace::fls::Model::Batsrus);
+        state.setTriggerTime(TriggerTime);
+        for (int nPoints : { 4, 6 }) {
+            std::vector<glm::vec3> line;
+            for (int i = 0; i < nPoints; ++i) {
+                const float v = static_cast<float>(state.nVertices() + i);
+                line.emplace_back(v, 2.f * v, 3.f * v);
+            }
+            state.addLine(line);
+        }
+        state.setExtraQuantityNames({ "rho", "T" });
+        for (size_t q = 0; q < 2; ++q) {
+            std::vector<float> values(state.nVertices());
+            for (size_t i = 0; i < values.size(); ++i) {
+                values[i] = static_cast<float>(q * 100 + i) + 0.5f;
+            }
+            state.setExtraQuantity(q, std::move(values));
+        }
+        return state;
+    }
+
+    // Overwrites the bytes at offset in the saved file with value
+    template <typename T>
+    void overwrite(std::streamoff offset, T value) {
+        std::fstream f(_path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(offset);
+        f.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    static constexpr const double TriggerTime = 86400.0;
+
+    std::string _prefix;
+    std::string _path;
+};
+
+TEST_F(FieldlinesStateTest, RoundTrip) {
+    using namespace openspace;
+
+    const FieldlinesState expected = createState();
+    FieldlinesState(expected).saveStateToOsfls(_prefix);
+
+    for (bool keepMapped : { false, true }) {
+        FieldlinesState state;
+        ASSERT_TRUE(state.loadStateFromOsfls(_path, keepMapped, { 1 }));
+
+        EXPECT_EQ(state.model(), fls::Model::Batsrus);
+        EXPECT_EQ(state.triggerTime(), TriggerTime);
+        EXPECT_EQ(state.lineStart(), expected.lineStart());
+        EXPECT_EQ(state.lineCount(), expected.lineCount());
+        EXPECT_EQ(state.extraQuantityNames(), expected.extraQuantityNames());
+        ASSERT_EQ(state.nVertices(), expected.nVertices());
+        ASSERT_EQ(state.nExtraQuantities(), expected.nExtraQuantities());
+
+        // Mapped states do not copy the data into the vectors
+        EXPECT_EQ(state.vertexPositions().empty(), keepMapped);
+        EXPECT_EQ(state.extraQuantities().empty(), keepMapped);
+
+        EXPECT_EQ(
+            std::memcmp(
+                state.vertexPositionData(),
+                expected.vertexPositionData(),
+                expected.nVertices() * sizeof(glm::vec3)
+            ),
+            0
+        );
+        for (size_t q = 0; q < expected.nExtraQuantities(); ++q) {
+            EXPECT_EQ(
+                std::memcmp(
+                    state.extraQuantityData(q),
+                    expected.extraQuantityData(q),
+                    expected.nVertices() * sizeof(float)
+                ),
+                0
+            );
+        }
+        EXPECT_EQ(state.extraQuantityData(expected.nExtraQuantities()), nullptr);
+    }
+}
+
+TEST_F(FieldlinesStateTest, TruncatedFile) {
+    createState().saveStateToOsfls(_prefix);
+
+    std::vector<char> content;
+    {
+        std::ifstream f(_path, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(f), {});
+    }
+
+    // Within the header, within the section table and within the last section
+    for (size_t size : { size_t(32), size_t(80), content.size() - 4 }) {
+        {
+            std::ofstream f(_path, std::ios::binary | std::ios::trunc);
+            f.write(content.data(), size);
+        }
+        for (bool keepMapped : { false, true }) {
+            openspace::FieldlinesState state;
+            EXPECT_FALSE(state.loadStateFromOsfls(_path, keepMapped));
+        }
+    }
+}
+
+TEST_F(FieldlinesStateTest, CorruptHeader) {
+    // Offsets of the number of lines, vertices, extra quantities and sections
+    for (std::streamoff offset : { 16, 24, 32, 40 }) {
+        createState().saveStateToOsfls(_prefix);
+        overwrite<uint64_t>(offset, uint64_t(1) << 40);
+
+        for (bool keepMapped : { false, true }) {
+            openspace::FieldlinesState state;
+            EXPECT_FALSE(state.loadStateFromOsfls(_path, keepMapped));
+        }
+    }
+
+    createState().saveStateToOsfls(_prefix);
+    overwrite<int32_t>(0, 2);
+    openspace::FieldlinesState state;
+    EXPECT_FALSE(state.loadStateFromOsfls(_path));
+}
+
+TEST_F(FieldlinesStateTest, InvalidLineRanges) {
+    // The section table after the header starts with the offset and size of the line
+    // starts, followed by the offset and size of the line counts
+    std::streamoff lineStartOffset;
+    std::streamoff lineCountOffset;
+    auto save = [&]() {
+        createState().saveStateToOsfls(_prefix);
+        std::ifstream f(_path, std::ios::binary);
+        uint64_t offsets[3];
+        f.seekg(64);
+        f.read(reinterpret_cast<char*>(offsets), sizeof(offsets));
+        lineStartOffset = static_cast<std::streamoff>(offsets[0]);
+        lineCountOffset = static_cast<std::streamoff>(offsets[2]);
+    };
+
+    // A negative start, a negative count, a line that ends after the last vertex and a
+    // count that overflows when it is added to the start
+    save();
+    overwrite<int32_t>(lineStartOffset, -1);
+    openspace::FieldlinesState state;
+    EXPECT_FALSE(state.loadStateFromOsfls(_path));
+
+    save();
+    overwrite<int32_t>(lineCountOffset, -1);
+    EXPECT_FALSE(state.loadStateFromOsfls(_path));
+
+    save();
+    overwrite<int32_t>(lineCountOffset + sizeof(int32_t), 7);
+    EXPECT_FALSE(state.loadStateFromOsfls(_path, true));
+
+    save();
+    overwrite<int32_t>(lineCountOffset + sizeof(int32_t), 0x7fffffff);
+    EXPECT_FALSE(state.loadStateFromOsfls(_path, true));
+
+    // The unchanged file is still valid
+    save();
+    EXPECT_TRUE(state.loadStateFromOsfls(_path, true));
+}
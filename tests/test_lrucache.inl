@@ -22,8 +22,11 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+#include <modules/globebrowsing/cache/intrusivelrucache.h>
 #include <modules/globebrowsing/cache/lrucache.h>
 
+#include <chrono>
+
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <glm/glm.hpp>
@@ -95,3 +98,162 @@ TEST_F(LRUCacheTest, StructKey) {
     ASSERT_EQ(lru.get(key1), val2);
     ASSERT_EQ(lru.get(key2), val2);
 }
+
+TEST_F(LRUCacheTest, IntrusiveGet) {
+    openspace::globebrowsing::cache::IntrusiveLRUCache<int, std::string, DefaultHasher>
+        lru(4);
+    lru.put(1, "hej");
+    lru.put(12, "san");
+    ASSERT_STREQ(lru.get(1).c_str(), "hej") << "testing get";
+}
+
+TEST_F(LRUCacheTest, IntrusiveCleaningCache) {
+    openspace::globebrowsing::cache::IntrusiveLRUCache<int, double, DefaultHasher> lru(4);
+    lru.put(1, 1.2);
+    lru.put(12, 2.3);
+    lru.put(123, 33.4);
+    lru.put(1234, 4.5);
+    lru.put(12345, 6.7);
+    ASSERT_FALSE(lru.exist(1)) << "Element should have been cleaned out of cache";
+    ASSERT_TRUE(lru.exist(12)) << "Element should remain in cache";
+}
+
+TEST_F(LRUCacheTest, IntrusiveStructKey) {
+    openspace::globebrowsing::cache::IntrusiveLRUCache<
+        MyKey, std::string, DefaultHasherMyKey
+    > lru(4);
+
+    // These two custom keys should be treated as equal
+    MyKey key1 = { 2, 3 };
+    MyKey key2 = { 2, 3 };
+
+    std::string val1 = "value 1";
+    std::string val2 = "value 2";
+
+    lru.put(key1, val1);
+    ASSERT_TRUE(lru.exist(key1));
+    ASSERT_EQ(lru.get(key1), val1);
+
+    // Putting key2 should replace key1
+    lru.put(key2, val2);
+    ASSERT_TRUE(lru.exist(key2));
+    ASSERT_EQ(lru.size(), 1);
+    ASSERT_EQ(lru.get(key1), val2);
+    ASSERT_EQ(lru.get(key2), val2);
+}
+
+TEST_F(LRUCacheTest, IntrusiveOrder) {
+    using Cache =
+        openspace::globebrowsing::cache::IntrusiveLRUCache<int, int, DefaultHasher>;
+    Cache lru(3);
+    lru.put(1, 10);
+    lru.put(2, 20);
+    lru.put(3, 30);
+    ASSERT_TRUE(lru.touch(1));
+    ASSERT_FALSE(lru.touch(4));
+
+    std::vector<Cache::Item> popped;
+    lru.putAndFetchPopped(4, 40, popped);
+    ASSERT_EQ(popped.size(), 1);
+    EXPECT_EQ(popped[0].first, 2) << "The least recently used item should be popped";
+
+    EXPECT_EQ(lru.popMRU().first, 4);
+    EXPECT_EQ(lru.popLRU().first, 3);
+    EXPECT_EQ(lru.popLRU().first, 1);
+    EXPECT_TRUE(lru.isEmpty());
+}
+
+TEST_F(LRUCacheTest, IntrusiveMatchesReference) {
+    using namespace openspace::globebrowsing::cache;
+
+    // Drive both implementations with the same pseudo-random sequence of operations,
+    // large enough to exercise growing the table and removing from long probe chains
+    LRUCache<int, int, DefaultHasher> reference(500);
+    IntrusiveLRUCache<int, int, DefaultHasher> intrusive(500);
+
+    unsigned int state = 1;
+    auto random = [&state]() {
+        state = state * 1103515245 + 12345;
+        return static_cast<int>((state >> 16) % 2000);
+    };
+
+    for (int i = 0; i < 100000; ++i) {
+        const int key = random();
+        switch (i % 4) {
+            case 0:
+            case 1: {
+                std::vector<std::pair<int, int>> a = reference.putAndFetchPopped(key, i);
+                std::vector<std::pair<int, int>> b = intrusive.putAndFetchPopped(key, i);
+                ASSERT_EQ(a, b);
+                break;
+            }
+            case 2:
+                ASSERT_EQ(reference.touch(key), intrusive.touch(key));
+                break;
+            case 3:
+                ASSERT_EQ(reference.exist(key), intrusive.exist(key));
+                if (reference.exist(key)) {
+                    ASSERT_EQ(reference.get(key), intrusive.get(key));
+                }
+                break;
+        }
+        ASSERT_EQ(reference.size(), intrusive.size());
+    }
+
+    while (!reference.isEmpty()) {
+        ASSERT_EQ(reference.popLRU(), intrusive.popLRU());
+    }
+    ASSERT_TRUE(intrusive.isEmpty());
+}
+
+namespace {
+    // Replays the access pattern of the tile cache: a working set of tiles that is
+    // touched every frame, while new tiles are put and old tiles are evicted
+    template <typename Cache>
+    double benchmarkCache(int nFrames, int nTilesPerFrame, size_t cacheSize) {
+        Cache cache(cacheSize);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        int nextKey = 0;
+        for (int frame = 0; frame < nFrames; ++frame) {
+            for (int i = 0; i < nTilesPerFrame; ++i) {
+                const int key = nextKey - i;
+                if (!cache.touch(key)) {
+                    // The tile cache puts without fetching the evicted items, which
+                    // does not allocate
+                    cache.put(key, static_cast<double>(key));
+                }
+            }
+            nextKey += nTilesPerFrame / 16;
+            for (int i = 0; i < nTilesPerFrame / 16; ++i) {
+                cache.put(nextKey + i, 0.0);
+            }
+        }
+        std::chrono::duration<double> duration =
+            std::chrono::high_resolution_clock::now() - start;
+        return duration.count();
+    }
+} // namespace
+
+TEST_F(LRUCacheTest, DISABLED_Benchmark) {
+    using namespace openspace::globebrowsing::cache;
+
+    constexpr const int NumFrames = 200;
+    for (int nTiles : { 1000, 10000, 40000 }) {
+        const size_t cacheSize = static_cast<size_t>(nTiles) * 2;
+        const double list = benchmarkCache<LRUCache<int, double, DefaultHasher>>(
+            NumFrames,
+            nTiles,
+            cacheSize
+        );
+        const double intrusive =
+            benchmarkCache<IntrusiveLRUCache<int, double, DefaultHasher>>(
+                NumFrames,
+                nTiles,
+                cacheSize
+            );
+        std::cout << nTiles << " tiles/frame: LRUCache " << list * 1000.0
+                  << " ms, IntrusiveLRUCache " << intrusive * 1000.0 << " ms"
+                  << std::endl;
+    }
+}
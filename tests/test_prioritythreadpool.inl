@@ -0,0 +1,136 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/other/prioritythreadpool.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class PriorityThreadPoolTest : public testing::Test {
+protected:
+    using Pool = openspace::globebrowsing::PriorityThreadPool<unsigned long long>;
+
+    // Occupies the single worker of the pool until the returned promise is fulfilled so
+    // that the following tasks are queued up before any of them is executed
+    std::promise<void> blockWorker(Pool& pool) {
+        std::promise<void> release;
+        std::shared_future<void> released = release.get_future().share();
+        auto started = std::make_shared<std::promise<void>>();
+        std::future<void> isStarted = started->get_future();
+        pool.enqueue([started, released]() {
+            started->set_value();
+            released.wait();
+        }, 0);
+        isStarted.wait();
+        return release;
+    }
+
+    std::function<void()> recordTask(unsigned long long key) {
+        return [this, key]() {
+            std::lock_guard<std::mutex> guard(_mutex);
+            _executed.push_back(key);
+        };
+    }
+
+    std::vector<unsigned long long> waitForExecuted(size_t numTasks) {
+        while (true) {
+            {
+                std::lock_guard<std::mutex> guard(_mutex);
+                if (_executed.size() >= numTasks) {
+                    return _executed;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    std::mutex _mutex;
+    std::vector<unsigned long long> _executed;
+};
+
+TEST_F(PriorityThreadPoolTest, HighestPriorityFirst) {
+    Pool pool(1, 10);
+    std::promise<void> release = blockWorker(pool);
+
+    pool.enqueue(recordTask(1), 1, 1.f);
+    pool.enqueue(recordTask(2), 2, 3.f);
+    pool.enqueue(recordTask(3), 3, 2.f);
+    pool.enqueue(recordTask(4), 4, 0.f);
+    release.set_value();
+
+    std::vector<unsigned long long> expected = { 2, 3, 1, 4 };
+    ASSERT_EQ(waitForExecuted(4), expected);
+}
+
+TEST_F(PriorityThreadPoolTest, EqualPriorityMostRecentFirst) {
+    Pool pool(1, 10);
+    std::promise<void> release = blockWorker(pool);
+
+    pool.enqueue(recordTask(1), 1);
+    pool.enqueue(recordTask(2), 2);
+    pool.enqueue(recordTask(3), 3);
+    ASSERT_TRUE(pool.touch(1));
+    ASSERT_FALSE(pool.touch(4));
+    release.set_value();
+
+    std::vector<unsigned long long> expected = { 1, 3, 2 };
+    ASSERT_EQ(waitForExecuted(3), expected);
+}
+
+TEST_F(PriorityThreadPoolTest, UpdatePrioritiesDemotesMissingKeys) {
+    Pool pool(1, 10);
+    std::promise<void> release = blockWorker(pool);
+
+    pool.enqueue(recordTask(1), 1, 5.f);
+    pool.enqueue(recordTask(2), 2, 1.f);
+    pool.enqueue(recordTask(3), 3, 1.f);
+    pool.updatePriorities({ { 3, 10.f } });
+    release.set_value();
+
+    std::vector<unsigned long long> expected = { 3, 2, 1 };
+    ASSERT_EQ(waitForExecuted(3), expected);
+}
+
+TEST_F(PriorityThreadPoolTest, FullQueueDropsLowestPriority) {
+    Pool pool(1, 2);
+    std::promise<void> release = blockWorker(pool);
+
+    pool.enqueue(recordTask(1), 1, 2.f);
+    pool.enqueue(recordTask(2), 2, 1.f);
+    pool.enqueue(recordTask(3), 3, 3.f);
+    release.set_value();
+
+    std::vector<unsigned long long> dropped = { 2 };
+    ASSERT_EQ(pool.getUnqueuedTasksKeys(), dropped);
+    ASSERT_TRUE(pool.getUnqueuedTasksKeys().empty());
+
+    std::vector<unsigned long long> expected = { 3, 1 };
+    ASSERT_EQ(waitForExecuted(2), expected);
+}
@@ -27,12 +27,52 @@
 #include <openspace/util/timeline.h>
 #include <openspace/util/time.h>
 
+#include <modules/volume/mappedrawvolume.h>
 #include <modules/volume/rawvolume.h>
 #include <modules/volume/rawvolumereader.h>
 #include <modules/volume/rawvolumewriter.h>
 
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/glm.h>
+#include <ghoul/misc/exception.h>
+
+#include <chrono>
+#include <iostream>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif // __linux__
+
+namespace {
+    // Writes a volume of the given dimensions in which every voxel stores its index
+    openspace::volume::RawVolume<float> writeIndexVolume(const std::string& path,
+                                                         const glm::uvec3& dims)
+    {
+        using namespace openspace::volume;
+
+        RawVolume<float> vol(dims);
+        for (size_t i = 0; i < vol.nCells(); ++i) {
+            vol.set(i, static_cast<float>(i));
+        }
+        RawVolumeWriter<float> writer(path);
+        writer.write(vol);
+        return vol;
+    }
+
+    // Asks the operating system to drop the cached pages of the file so that the next
+    // load has to go to disk. Only supported on Linux; elsewhere all loads are warm
+    void dropFromPageCache(const std::string& path) {
+#ifdef __linux__
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            fdatasync(fd);
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+        }
+#endif // __linux__
+    }
+} // namespace
 
 class RawVolumeIoTest : public testing::Test {};
 
@@ -90,3 +130,123 @@ TEST_F(RawVolumeIoTest, BasicInputOutput) {
         ASSERT_EQ(v, value(x));
     });
 }
+
+TEST_F(RawVolumeIoTest, MappedInput) {
+    using namespace openspace::volume;
+
+    glm::uvec3 dims{ 3, 5, 7 };
+    std::string volumePath = absPath("${TESTDIR}/mappedvolume.rawvolume");
+    RawVolume<float> vol = writeIndexVolume(volumePath, dims);
+
+    RawVolumeReader<float> reader(volumePath, dims);
+    std::unique_ptr<MappedRawVolume<float>> mapped = reader.map();
+    ASSERT_EQ(mapped->dimensions(), dims);
+    ASSERT_EQ(mapped->nCells(), vol.nCells());
+
+    size_t nVisited = 0;
+    mapped->forEachVoxel([&vol, &nVisited](const glm::uvec3& x, float v) {
+        ASSERT_EQ(v, vol.get(x));
+        ++nVisited;
+    });
+    ASSERT_EQ(nVisited, vol.nCells());
+    ASSERT_EQ(mapped->get(glm::uvec3(2, 4, 6)), vol.get(glm::uvec3(2, 4, 6)));
+}
+
+TEST_F(RawVolumeIoTest, MappedInputTooSmall) {
+    using namespace openspace::volume;
+
+    std::string volumePath = absPath("${TESTDIR}/smallmappedvolume.rawvolume");
+    writeIndexVolume(volumePath, glm::uvec3(2, 2, 2));
+
+    RawVolumeReader<float> reader(volumePath, glm::uvec3(2, 2, 3));
+    ASSERT_THROW(reader.map(), ghoul::RuntimeError);
+}
+
+TEST_F(RawVolumeIoTest, SubvolumeInput) {
+    using namespace openspace::volume;
+
+    glm::uvec3 dims{ 6, 5, 4 };
+    std::string volumePath = absPath("${TESTDIR}/subvolume.rawvolume");
+    RawVolume<float> vol = writeIndexVolume(volumePath, dims);
+
+    glm::uvec3 offset{ 1, 2, 1 };
+    glm::uvec3 subDims{ 4, 3, 2 };
+    RawVolumeReader<float> reader(volumePath, dims);
+    std::unique_ptr<RawVolume<float>> subvolume = reader.readSubvolume(offset, subDims);
+    ASSERT_EQ(subvolume->dimensions(), subDims);
+    subvolume->forEachVoxel([&vol, &offset](const glm::uvec3& x, float v) {
+        ASSERT_EQ(v, vol.get(offset + x));
+    });
+}
+
+TEST_F(RawVolumeIoTest, SliceInput) {
+    using namespace openspace::volume;
+
+    glm::uvec3 dims{ 4, 3, 5 };
+    std::string volumePath = absPath("${TESTDIR}/slicevolume.rawvolume");
+    RawVolume<float> vol = writeIndexVolume(volumePath, dims);
+
+    RawVolumeReader<float> reader(volumePath, dims);
+    for (unsigned int z = 0; z < dims.z; ++z) {
+        std::unique_ptr<RawVolume<float>> slice = reader.readSlice(z);
+        ASSERT_EQ(slice->dimensions(), glm::uvec3(dims.x, dims.y, 1));
+        slice->forEachVoxel([&vol, z](const glm::uvec3& x, float v) {
+            ASSERT_EQ(v, vol.get(glm::uvec3(x.x, x.y, z)));
+        });
+    }
+}
+
+TEST_F(RawVolumeIoTest, DISABLED_LoadBenchmark) {
+    using namespace openspace::volume;
+    using Clock = std::chrono::high_resolution_clock;
+    using Ms = std::chrono::duration<double, std::milli>;
+
+    glm::uvec3 dims{ 256, 256, 256 };
+    std::string volumePath = absPath("${TESTDIR}/benchmarkvolume.rawvolume");
+    writeIndexVolume(volumePath, dims);
+    RawVolumeReader<float> reader(volumePath, dims);
+
+    // Sum all voxels so that every page of the mapping is actually touched
+    auto sumMapped = [](const MappedRawVolume<float>& volume) {
+        double sum = 0.0;
+        for (size_t i = 0; i < volume.nCells(); ++i) {
+            sum += volume.get(i);
+        }
+        return sum;
+    };
+
+    for (const char* cache : { "cold", "warm" }) {
+        const bool isCold = std::string(cache) == "cold";
+
+        if (isCold) {
+            dropFromPageCache(volumePath);
+        }
+        Clock::time_point start = Clock::now();
+        std::unique_ptr<RawVolume<float>> read = reader.read();
+        const double readTime = Ms(Clock::now() - start).count();
+
+        if (isCold) {
+            dropFromPageCache(volumePath);
+        }
+        start = Clock::now();
+        std::unique_ptr<MappedRawVolume<float>> mapped = reader.map();
+        const double mapTime = Ms(Clock::now() - start).count();
+        const double sum = sumMapped(*mapped);
+        const double mapAndTouchTime = Ms(Clock::now() - start).count();
+
+        if (isCold) {
+            dropFromPageCache(volumePath);
+        }
+        start = Clock::now();
+        std::unique_ptr<RawVolume<float>> slice = reader.readSlice(dims.z / 2);
+        const double sliceTime = Ms(Clock::now() - start).count();
+
+        ASSERT_EQ(read->get(dims - glm::uvec3(1)), mapped->get(dims - glm::uvec3(1)));
+        ASSERT_GT(sum, 0.0);
+        ASSERT_EQ(slice->get(glm::uvec3(0)), read->get(glm::uvec3(0, 0, dims.z / 2)));
+
+        std::cout << cache << ": read " << readTime << " ms, map " << mapTime
+                  << " ms, map and touch all voxels " << mapAndTouchTime
+                  << " ms, read slice " << sliceTime << " ms" << std::endl;
+    }
+}
@@ -0,0 +1,211 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/volume/rawvolume.h>
+#include <modules/volume/volumelayout.h>
+#include <modules/volume/volumesampler.h>
+
+#include <ghoul/glm.h>
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+    // Fills a volume so that every voxel stores its linear index
+    template <typename Layout>
+    openspace::volume::RawVolume<float, Layout> indexVolume(const glm::uvec3& dims) {
+        openspace::volume::RawVolume<float, Layout> volume(dims);
+        for (unsigned int z = 0; z < dims.z; ++z) {
+            for (unsigned int y = 0; y < dims.y; ++y) {
+                for (unsigned int x = 0; x < dims.x; ++x) {
+                    const glm::uvec3 coords(x, y, z);
+                    volume.set(coords, static_cast<float>(volume.coordsToIndex(coords)));
+                }
+            }
+        }
+        return volume;
+    }
+} // namespace
+
+class RawVolumeLayoutTest : public testing::Test {};
+
+TEST_F(RawVolumeLayoutTest, BrickedAccessors) {
+    using namespace openspace::volume;
+
+    // Not a multiple of the brick size along any axis
+    const glm::uvec3 dims(13, 9, 6);
+    RawVolume<float, BrickedLayout<4>> volume = indexVolume<BrickedLayout<4>>(dims);
+
+    EXPECT_EQ(volume.nCells(), size_t(13 * 9 * 6));
+    for (size_t i = 0; i < volume.nCells(); ++i) {
+        EXPECT_EQ(volume.get(i), static_cast<float>(i));
+        EXPECT_EQ(volume.get(volume.indexToCoords(i)), static_cast<float>(i));
+    }
+
+    volume.set(size_t(100), -1.f);
+    EXPECT_EQ(volume.get(volume.indexToCoords(100)), -1.f);
+}
+
+TEST_F(RawVolumeLayoutTest, Conversions) {
+    using namespace openspace::volume;
+
+    const glm::uvec3 dims(21, 17, 10);
+    RawVolume<float> linear = indexVolume<LinearLayout>(dims);
+
+    RawVolume<float, BrickedLayout<8>> bricked(linear);
+    RawVolume<float, BrickedLayout<4>> smallBricked(bricked);
+    RawVolume<float, BrickedLayout<16>> largeBricked(smallBricked);
+    RawVolume<float> back(largeBricked);
+
+    ASSERT_EQ(back.dimensions(), dims);
+    for (size_t i = 0; i < linear.nCells(); ++i) {
+        EXPECT_EQ(bricked.get(i), linear.get(i));
+        EXPECT_EQ(smallBricked.get(i), linear.get(i));
+        EXPECT_EQ(back.get(i), linear.get(i));
+    }
+}
+
+TEST_F(RawVolumeLayoutTest, ForEachVoxel) {
+    using namespace openspace::volume;
+
+    const glm::uvec3 dims(10, 3, 9);
+    RawVolume<float, BrickedLayout<4>> volume = indexVolume<BrickedLayout<4>>(dims);
+
+    std::vector<int> visits(volume.nCells(), 0);
+    volume.forEachVoxel([&](const glm::uvec3& coords, const float& value) {
+        const size_t index = volume.coordsToIndex(coords);
+        EXPECT_EQ(value, static_cast<float>(index));
+        visits[index]++;
+    });
+    for (int v : visits) {
+        EXPECT_EQ(v, 1);
+    }
+}
+
+TEST_F(RawVolumeLayoutTest, Sampling) {
+    using namespace openspace::volume;
+
+    const glm::uvec3 dims(12, 11, 7);
+    RawVolume<float> linear = indexVolume<LinearLayout>(dims);
+    RawVolume<float, BrickedLayout<4>> bricked(linear);
+
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<float> distribution(-1.f, 12.f);
+    for (float filterSize : { 1.f, 3.f, 7.f }) {
+        VolumeSampler<RawVolume<float>> linearSampler(linear, glm::vec3(filterSize));
+        VolumeSampler<RawVolume<float, BrickedLayout<4>>> brickedSampler(
+            bricked,
+            glm::vec3(filterSize)
+        );
+        for (int i = 0; i < 100; ++i) {
+            const glm::vec3 p(
+                distribution(generator),
+                distribution(generator),
+                distribution(generator)
+            );
+            EXPECT_FLOAT_EQ(linearSampler.sample(p), brickedSampler.sample(p));
+        }
+    }
+}
+
+TEST_F(RawVolumeLayoutTest, DISABLED_LayoutBenchmark) {
+    using namespace openspace::volume;
+    using Clock = std::chrono::high_resolution_clock;
+    using Ms = std::chrono::duration<double, std::milli>;
+    using BrickedVolume = RawVolume<float, BrickedLayout<8>>;
+
+    const glm::uvec3 dims(256, 256, 256);
+    RawVolume<float> linear = indexVolume<LinearLayout>(dims);
+
+    Clock::time_point start = Clock::now();
+    BrickedVolume bricked(linear);
+    const double toBrickedTime = Ms(Clock::now() - start).count();
+    start = Clock::now();
+    RawVolume<float> back(bricked);
+    const double toLinearTime = Ms(Clock::now() - start).count();
+    ASSERT_EQ(back.get(dims - glm::uvec3(1)), linear.get(dims - glm::uvec3(1)));
+
+    std::mt19937 generator(5);
+    std::uniform_real_distribution<float> distribution(0.f, 255.f);
+    std::vector<glm::vec3> positions(1000000);
+    for (glm::vec3& p : positions) {
+        p = glm::vec3(
+            distribution(generator),
+            distribution(generator),
+            distribution(generator)
+        );
+    }
+
+    auto run = [&](const std::string& layout, auto& volume) {
+        double sum = 0.0;
+
+        Clock::time_point s = Clock::now();
+        volume.forEachVoxel([&sum](const glm::uvec3&, const float& v) { sum += v; });
+        const double forEachTime = Ms(Clock::now() - s).count();
+
+        // Slices perpendicular to each axis
+        std::vector<double> sliceTimes;
+        for (int axis = 0; axis < 3; ++axis) {
+            s = Clock::now();
+            for (unsigned int j = 0; j < dims[(axis + 2) % 3]; ++j) {
+                for (unsigned int i = 0; i < dims[(axis + 1) % 3]; ++i) {
+                    glm::uvec3 coords;
+                    coords[axis] = dims[axis] / 2;
+                    coords[(axis + 1) % 3] = i;
+                    coords[(axis + 2) % 3] = j;
+                    sum += volume.get(coords);
+                }
+            }
+            sliceTimes.push_back(Ms(Clock::now() - s).count());
+        }
+
+        std::vector<double> samplerTimes;
+        for (float filterSize : { 1.f, 3.f }) {
+            VolumeSampler<std::decay_t<decltype(volume)>> sampler(
+                volume,
+                glm::vec3(filterSize)
+            );
+            s = Clock::now();
+            for (const glm::vec3& p : positions) {
+                sum += sampler.sample(p);
+            }
+            samplerTimes.push_back(Ms(Clock::now() - s).count());
+        }
+
+        ASSERT_GT(sum, 0.0);
+        std::cout << layout << ": forEachVoxel " << forEachTime << " ms, x/y/z slice "
+                  << sliceTimes[0] << "/" << sliceTimes[1] << "/" << sliceTimes[2]
+                  << " ms, 1M samples with filter 1/3 " << samplerTimes[0] << "/"
+                  << samplerTimes[1] << " ms" << std::endl;
+    };
+
+    run("linear", linear);
+    run("bricked", bricked);
+    std::cout << "conversion to bricked " << toBrickedTime << " ms, to linear "
+              << toLinearTime << " ms" << std::endl;
+}
@@ -0,0 +1,231 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/globebrowsing/cache/shardedtilecache.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+class ShardedTileCacheTest : public testing::Test {};
+
+namespace {
+    using openspace::globebrowsing::Tile;
+    using openspace::globebrowsing::TileIndex;
+    using openspace::globebrowsing::cache::ProviderTileKey;
+    using openspace::globebrowsing::cache::ShardedTileCache;
+
+    constexpr const unsigned long long TextureType = 1;
+    constexpr const size_t TileBytes = 100;
+
+    // The cache never dereferences the textures, so the texture pointer can be used to
+    // tell the tiles apart
+    Tile makeTile(int id) {
+        return Tile(
+            reinterpret_cast<ghoul::opengl::Texture*>(static_cast<uintptr_t>(id)),
+            nullptr,
+            Tile::Status::OK
+        );
+    }
+
+    int tileId(const Tile& tile) {
+        return static_cast<int>(reinterpret_cast<uintptr_t>(tile.texture()));
+    }
+
+    ProviderTileKey key(unsigned int providerID, int x) {
+        return { TileIndex(x, 0, 10), providerID };
+    }
+} // namespace
+
+TEST_F(ShardedTileCacheTest, SeparateProviders) {
+    ShardedTileCache cache;
+    cache.setBudget(10 * TileBytes);
+
+    cache.put(key(1, 0), TextureType, makeTile(1), TileBytes);
+    cache.put(key(2, 0), TextureType, makeTile(2), TileBytes);
+
+    // The same tile index of different providers refers to different tiles
+    ASSERT_TRUE(cache.exist(key(1, 0)));
+    ASSERT_TRUE(cache.exist(key(2, 0)));
+    ASSERT_FALSE(cache.exist(key(3, 0)));
+    EXPECT_EQ(tileId(cache.get(key(1, 0))), 1);
+    EXPECT_EQ(tileId(cache.get(key(2, 0))), 2);
+    EXPECT_EQ(cache.get(key(3, 0)).status(), Tile::Status::Unavailable);
+
+    EXPECT_EQ(cache.cachedBytes(1), TileBytes);
+    EXPECT_EQ(cache.cachedBytes(2), TileBytes);
+    EXPECT_EQ(cache.cachedBytes(), 2 * TileBytes);
+    EXPECT_EQ(cache.nHits(), 2);
+    EXPECT_EQ(cache.nMisses(), 1);
+
+    // Replacing a tile does not count its size twice
+    cache.put(key(1, 0), TextureType, makeTile(3), TileBytes);
+    EXPECT_EQ(tileId(cache.get(key(1, 0))), 3);
+    EXPECT_EQ(cache.cachedBytes(), 2 * TileBytes);
+
+    cache.clear();
+    EXPECT_FALSE(cache.exist(key(1, 0)));
+    EXPECT_EQ(cache.cachedBytes(), 0u);
+}
+
+TEST_F(ShardedTileCacheTest, BudgetEviction) {
+    std::vector<int> evicted;
+    ShardedTileCache cache([&](const ShardedTileCache::CachedTile& t) {
+        evicted.push_back(tileId(t.tile));
+    });
+    cache.setBudget(4 * TileBytes);
+
+    for (int i = 0; i < 4; ++i) {
+        cache.put(key(1, i), TextureType, makeTile(i + 1), TileBytes);
+    }
+    ASSERT_TRUE(evicted.empty());
+
+    // Using the first tile makes the second one the least recently used
+    cache.get(key(1, 0));
+    cache.put(key(1, 4), TextureType, makeTile(5), TileBytes);
+
+    ASSERT_EQ(evicted.size(), 1u);
+    EXPECT_EQ(evicted[0], 2);
+    EXPECT_FALSE(cache.exist(key(1, 1)));
+    EXPECT_TRUE(cache.exist(key(1, 0)));
+    EXPECT_TRUE(cache.exist(key(1, 4)));
+    EXPECT_EQ(cache.cachedBytes(), 4 * TileBytes);
+    EXPECT_EQ(cache.nEvictions(), 1);
+}
+
+TEST_F(ShardedTileCacheTest, ProviderQuota) {
+    ShardedTileCache cache;
+    cache.setBudget(10 * TileBytes);
+    cache.setMaximumProviderShare(0.5f);
+
+    for (int i = 0; i < 8; ++i) {
+        cache.put(key(1, i), TextureType, makeTile(i + 1), TileBytes);
+    }
+    EXPECT_EQ(cache.cachedBytes(1), 5 * TileBytes);
+    EXPECT_TRUE(cache.exist(key(1, 7)));
+    EXPECT_FALSE(cache.exist(key(1, 2)));
+
+    // A tile that is larger than the quota by itself is still kept
+    cache.put(key(2, 0), TextureType, makeTile(9), 6 * TileBytes);
+    EXPECT_TRUE(cache.exist(key(2, 0)));
+}
+
+TEST_F(ShardedTileCacheTest, KeepInsertedTileOfOtherType) {
+    constexpr const unsigned long long OtherTextureType = 2;
+
+    ShardedTileCache cache;
+    cache.setBudget(TileBytes);
+
+    // Both texture types hold a single tile after each insertion, so the inserted tile
+    // must not be chosen for eviction regardless of the order of the types
+    cache.put(key(1, 0), TextureType, makeTile(1), TileBytes);
+    cache.put(key(1, 1), OtherTextureType, makeTile(2), TileBytes);
+    EXPECT_FALSE(cache.exist(key(1, 0)));
+    EXPECT_TRUE(cache.exist(key(1, 1)));
+
+    cache.put(key(1, 2), TextureType, makeTile(3), TileBytes);
+    EXPECT_FALSE(cache.exist(key(1, 1)));
+    EXPECT_TRUE(cache.exist(key(1, 2)));
+    EXPECT_EQ(cache.cachedBytes(1), TileBytes);
+    EXPECT_EQ(cache.nEvictions(), 2);
+}
+
+TEST_F(ShardedTileCacheTest, FairShareVictim) {
+    ShardedTileCache cache;
+    cache.setBudget(6 * TileBytes);
+
+    for (int i = 0; i < 5; ++i) {
+        cache.put(key(1, i), TextureType, makeTile(i + 1), TileBytes);
+    }
+    cache.put(key(2, 0), TextureType, makeTile(10), TileBytes);
+
+    // The budget is exceeded by a tile of provider 2, but provider 1 is the one that is
+    // above its fair share of the budget, so its least recently used tile is evicted
+    cache.put(key(2, 1), TextureType, makeTile(11), TileBytes);
+    EXPECT_EQ(cache.cachedBytes(1), 4 * TileBytes);
+    EXPECT_EQ(cache.cachedBytes(2), 2 * TileBytes);
+    EXPECT_FALSE(cache.exist(key(1, 0)));
+    EXPECT_TRUE(cache.exist(key(2, 0)));
+}
+
+TEST_F(ShardedTileCacheTest, EvictTileOfType) {
+    constexpr const unsigned long long OtherTextureType = 2;
+
+    int nCallbacks = 0;
+    ShardedTileCache cache([&](const ShardedTileCache::CachedTile&) { ++nCallbacks; });
+    cache.setBudget(10 * TileBytes);
+
+    for (int i = 0; i < 3; ++i) {
+        cache.put(key(1, i), TextureType, makeTile(i + 1), TileBytes);
+    }
+    cache.put(key(2, 0), TextureType, makeTile(10), TileBytes);
+    cache.put(key(2, 1), OtherTextureType, makeTile(11), TileBytes);
+
+    // Provider 1 is furthest above its fair share among the providers with tiles of the
+    // requested type
+    Tile tile = cache.evictTileOfType(TextureType);
+    EXPECT_EQ(tileId(tile), 1);
+    EXPECT_EQ(cache.cachedBytes(1), 2 * TileBytes);
+
+    tile = cache.evictTileOfType(OtherTextureType);
+    EXPECT_EQ(tileId(tile), 11);
+    tile = cache.evictTileOfType(OtherTextureType);
+    EXPECT_EQ(tile.status(), Tile::Status::Unavailable);
+
+    // The caller reuses the texture of the returned tile, so it is not released
+    EXPECT_EQ(nCallbacks, 0);
+    EXPECT_EQ(cache.nEvictions(), 2);
+}
+
+TEST_F(ShardedTileCacheTest, ConcurrentEvictTileOfType) {
+    constexpr const int NumThreads = 4;
+    constexpr const int NumProviders = 8;
+    constexpr const int NumTilesPerProvider = 2000;
+
+    ShardedTileCache cache;
+    cache.setBudget(NumProviders * NumTilesPerProvider * TileBytes);
+    for (int p = 0; p < NumProviders; ++p) {
+        for (int i = 0; i < NumTilesPerProvider; ++i) {
+            cache.put(key(p, i), TextureType, makeTile(i + 1), TileBytes);
+        }
+    }
+
+    // Threads that select the same victim must not evict the same or a missing tile
+    std::atomic<int> nEvicted = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NumThreads; ++t) {
+        threads.emplace_back([&]() {
+            while (cache.evictTileOfType(TextureType).status() == Tile::Status::OK) {
+                ++nEvicted;
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(nEvicted.load(), NumProviders * NumTilesPerProvider);
+    EXPECT_EQ(cache.cachedBytes(), 0u);
+}
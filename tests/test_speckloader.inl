@@ -0,0 +1,201 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/util/speckloader.h>
+
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/misc/exception.h>
+
+#include <fstream>
+#include <sstream>
+
+namespace {
+    void writeFile(const std::string& path, const std::string& contents) {
+        std::ofstream file(path, std::ofstream::binary);
+        file << contents;
+    }
+} // namespace
+
+class SpeckLoaderTest : public testing::Test {};
+
+TEST_F(SpeckLoaderTest, Header) {
+    using namespace openspace::speck;
+
+    std::string path = absPath("${TESTDIR}/header.speck");
+    writeFile(
+        path,
+        "# comment\r\n"
+        "datavar 0 colorb_v\r\n"
+        "datavar 1 lum\n"
+        "texturevar 1\n"
+        "texture -M 1 galaxy.sgi\n"
+        "polyorivar 2\n"
+        "datavar 2 orientation\n"
+        "maxcomment 12\n"
+    );
+
+    Dataset dataset = loadSpeckFile(path);
+    ASSERT_EQ(3, dataset.variables.size());
+    EXPECT_EQ(1, dataset.variableIndex("lum"));
+    EXPECT_EQ(-1, dataset.variableIndex("distly"));
+    EXPECT_EQ(1, dataset.textureDataIndex);
+    EXPECT_EQ(2, dataset.orientationDataIndex);
+    ASSERT_EQ(1, dataset.textures.size());
+    EXPECT_EQ(1, dataset.textures[0].index);
+    EXPECT_EQ("galaxy.sgi", dataset.textures[0].file);
+    // X, Y, Z, two scalar variables, and the two orientation vectors
+    EXPECT_EQ(11, dataset.valuesPerEntry);
+    EXPECT_EQ(0, dataset.nEntries());
+}
+
+TEST_F(SpeckLoaderTest, Entries) {
+    using namespace openspace::speck;
+
+    std::string path = absPath("${TESTDIR}/entries.speck");
+    writeFile(
+        path,
+        "datavar 0 lum\n"
+        "datavar 1 distly\n"
+        "1 2 3 4 5 # name\r\n"
+        "\n"
+        "# comment\n"
+        "+1.5 -2e3 3 abc 5\n"
+        "  6 7 8"
+    );
+
+    Dataset dataset = loadSpeckFile(path);
+    ASSERT_EQ(5, dataset.valuesPerEntry);
+    ASSERT_EQ(3, dataset.nEntries());
+    const std::vector<float> expected = {
+        1.f, 2.f, 3.f, 4.f, 5.f,
+        1.5f, -2000.f, 3.f, 0.f, 0.f,
+        6.f, 7.f, 8.f, 0.f, 0.f
+    };
+    EXPECT_EQ(expected, dataset.entries);
+}
+
+TEST_F(SpeckLoaderTest, ChunkedEntries) {
+    using namespace openspace::speck;
+
+    std::string path = absPath("${TESTDIR}/chunked.speck");
+    std::ostringstream contents;
+    contents << "datavar 0 lum\n";
+    std::vector<float> expected;
+    // Large enough to be split into several chunks
+    for (int i = 0; i < 250000; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            const float value = static_cast<float>(i * 4 + j);
+            contents << value << ' ';
+            expected.push_back(value);
+        }
+        contents << (i % 1000 == 0 ? "\n\n" : "\n");
+    }
+    writeFile(path, contents.str());
+
+    Dataset single = loadSpeckFile(path, 1);
+    Dataset chunked = loadSpeckFile(path, 8);
+    EXPECT_EQ(expected, single.entries);
+    EXPECT_EQ(expected, chunked.entries);
+}
+
+TEST_F(SpeckLoaderTest, Meshes) {
+    using namespace openspace::speck;
+
+    std::string path = absPath("${TESTDIR}/meshes.speck");
+    writeFile(
+        path,
+        "# comment\n"
+        "mesh -t 2 -c 3 -s wire {\n"
+        "2 1\n"
+        "1 2 3\n"
+        "4 5 6 7 8 9 10 11\n"
+        "}\n"
+        "mesh {\n"
+        "1 1\n"
+        "}\n"
+    );
+
+    Dataset dataset = loadSpeckFile(path);
+    ASSERT_EQ(2, dataset.meshes.size());
+    EXPECT_EQ(2, dataset.meshes[0].textureIndex);
+    EXPECT_EQ(3, dataset.meshes[0].colorIndex);
+    EXPECT_EQ("wire", dataset.meshes[0].style);
+    EXPECT_EQ(2, dataset.meshes[0].numU);
+    EXPECT_EQ(1, dataset.meshes[0].numV);
+    // At most seven values are read per vertex
+    EXPECT_EQ(10, dataset.meshes[0].vertices.size());
+    EXPECT_TRUE(dataset.meshes[1].style.empty());
+    EXPECT_TRUE(dataset.meshes[1].vertices.empty());
+
+    writeFile(path, "mesh {\n1 1\n1 2 3\n");
+    EXPECT_THROW(loadSpeckFile(path), ghoul::RuntimeError);
+}
+
+TEST_F(SpeckLoaderTest, Labels) {
+    using namespace openspace::speck;
+
+    std::string path = absPath("${TESTDIR}/labels.label");
+    writeFile(
+        path,
+        "# comment\n"
+        "textcolor 1\n"
+        "1 2 3 text Andromeda Galaxy # M31\n"
+        "\n"
+        "4 5 6 text Sun\r\n"
+    );
+
+    Labels labels = loadLabelFile(path);
+    ASSERT_EQ(2, labels.texts.size());
+    ASSERT_EQ(2, labels.positions.size());
+    EXPECT_EQ("Andromeda Galaxy", labels.texts[0]);
+    EXPECT_EQ("Sun", labels.texts[1]);
+    EXPECT_EQ(glm::vec3(1.f, 2.f, 3.f), labels.positions[0]);
+    EXPECT_EQ(glm::vec3(4.f, 5.f, 6.f), labels.positions[1]);
+}
+
+TEST_F(SpeckLoaderTest, ColorMap) {
+    using namespace openspace::speck;
+
+    std::string path = absPath("${TESTDIR}/colors.cmap");
+    writeFile(path, "# comment\n2\n0.5 0.25 0 1\n# comment\n1 1 1 0.5\n");
+
+    std::vector<glm::vec4> colors = loadColorMapFile(path);
+    ASSERT_EQ(2, colors.size());
+    EXPECT_EQ(glm::vec4(0.5f, 0.25f, 0.f, 1.f), colors[0]);
+    EXPECT_EQ(glm::vec4(1.f, 1.f, 1.f, 0.5f), colors[1]);
+
+    writeFile(path, "3\n1 1 1 1\n");
+    EXPECT_THROW(loadColorMapFile(path), ghoul::RuntimeError);
+}
+
+TEST_F(SpeckLoaderTest, MissingFile) {
+    using namespace openspace::speck;
+
+    EXPECT_THROW(
+        loadSpeckFile(absPath("${TESTDIR}/doesnotexist.speck")),
+        ghoul::RuntimeError
+    );
+}
@@ -0,0 +1,258 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/util/threadpool.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+
+class ThreadPoolTest : public testing::Test {};
+
+namespace {
+    // Replica of the previous single-queue thread pool, used as the baseline in the
+    // throughput benchmark
+    class SingleQueueThreadPool {
+    public:
+        SingleQueueThreadPool(size_t numThreads) {
+            for (size_t i = 0; i < numThreads; ++i) {
+                _workers.push_back(std::thread([this]() {
+                    while (true) {
+                        std::function<void()> task;
+                        {
+                            std::unique_lock<std::mutex> lock(_mutex);
+                            _condition.wait(lock, [this]() {
+                                return _stop || !_tasks.empty();
+                            });
+                            if (_stop) {
+                                return;
+                            }
+                            task = std::move(_tasks.front());
+                            _tasks.pop_front();
+                        }
+                        task();
+                    }
+                }));
+            }
+        }
+
+        ~SingleQueueThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _condition.notify_all();
+            for (std::thread& t : _workers) {
+                t.join();
+            }
+        }
+
+        void enqueue(std::function<void()> f) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _tasks.push_back(std::move(f));
+            }
+            _condition.notify_one();
+        }
+
+    private:
+        std::vector<std::thread> _workers;
+        std::deque<std::function<void()>> _tasks;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        bool _stop = false;
+    };
+
+    // Enqueues nTasks tiny tasks from nProducers threads and waits until all of them
+    // have been executed. Returns the throughput in tasks per second
+    template <typename Pool>
+    double measureThroughput(Pool& pool, int nProducers, int nTasks) {
+        std::atomic_int nFinished(0);
+        const int tasksPerProducer = nTasks / nProducers;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> producers;
+        for (int i = 0; i < nProducers; ++i) {
+            producers.push_back(std::thread([&]() {
+                for (int j = 0; j < tasksPerProducer; ++j) {
+                    pool.enqueue([&nFinished]() { ++nFinished; });
+                }
+            }));
+        }
+        for (std::thread& t : producers) {
+            t.join();
+        }
+        while (nFinished < tasksPerProducer * nProducers) {
+            std::this_thread::yield();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::chrono::duration<double> duration = end - start;
+        return (tasksPerProducer * nProducers) / duration.count();
+    }
+} // namespace
+
+TEST_F(ThreadPoolTest, ExecutesAllTasks) {
+    using namespace openspace;
+
+    std::atomic_int counter(0);
+    {
+        ThreadPool pool(4);
+        std::vector<std::future<int>> futures;
+        for (int i = 0; i < 1000; ++i) {
+            futures.push_back(pool.submit([&counter, i]() {
+                ++counter;
+                return i;
+            }));
+        }
+
+        int sum = 0;
+        for (std::future<int>& f : futures) {
+            sum += f.get();
+        }
+        EXPECT_EQ(sum, 999 * 1000 / 2);
+    }
+    EXPECT_EQ(counter, 1000);
+}
+
+TEST_F(ThreadPoolTest, SingleThreadIsFifo) {
+    using namespace openspace;
+
+    ThreadPool pool(1);
+    std::vector<int> order;
+    std::mutex orderMutex;
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 100; ++i) {
+        futures.push_back(pool.submit([&, i]() {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(i);
+        }));
+    }
+    for (std::future<void>& f : futures) {
+        f.wait();
+    }
+
+    ASSERT_EQ(order.size(), 100);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(order[i], i);
+    }
+}
+
+TEST_F(ThreadPoolTest, Priorities) {
+    using namespace openspace;
+
+    ThreadPool pool(1);
+
+    // Block the only worker until all tasks have been enqueued
+    std::promise<void> gate;
+    std::shared_future<void> gateFuture = gate.get_future().share();
+    pool.enqueue([gateFuture]() { gateFuture.wait(); });
+
+    std::vector<int> order;
+    std::future<void> low = pool.submit(
+        [&order]() { order.push_back(2); },
+        ThreadPool::Priority::Low
+    );
+    std::future<void> normal = pool.submit([&order]() { order.push_back(1); });
+    std::future<void> high = pool.submit(
+        [&order]() { order.push_back(0); },
+        ThreadPool::Priority::High
+    );
+    gate.set_value();
+    low.wait();
+
+    ASSERT_EQ(order.size(), 3);
+    EXPECT_EQ(order[0], 0);
+    EXPECT_EQ(order[1], 1);
+    EXPECT_EQ(order[2], 2);
+}
+
+TEST_F(ThreadPoolTest, Cancellation) {
+    using namespace openspace;
+
+    ThreadPool pool(1);
+
+    std::promise<void> gate;
+    std::shared_future<void> gateFuture = gate.get_future().share();
+    pool.enqueue([gateFuture]() { gateFuture.wait(); });
+
+    bool hasExecuted = false;
+    CancellationToken token;
+    std::future<void> f = pool.submit(
+        [&hasExecuted]() { hasExecuted = true; },
+        ThreadPool::Priority::Normal,
+        token
+    );
+    token.cancel();
+    gate.set_value();
+
+    EXPECT_THROW(f.get(), std::future_error);
+    EXPECT_FALSE(hasExecuted);
+}
+
+TEST_F(ThreadPoolTest, TasksSpawningTasks) {
+    using namespace openspace;
+
+    std::atomic_int counter(0);
+    ThreadPool pool(4);
+    for (int i = 0; i < 100; ++i) {
+        pool.enqueue([&]() {
+            for (int j = 0; j < 10; ++j) {
+                pool.enqueue([&counter]() { ++counter; });
+            }
+        });
+    }
+    while (counter < 1000) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(counter, 1000);
+}
+
+TEST_F(ThreadPoolTest, DISABLED_ThroughputBenchmark) {
+    using namespace openspace;
+
+    constexpr const int NumTasks = 200000;
+    const int nProducers = std::max(1u, std::thread::hardware_concurrency() / 2);
+
+    std::cout << "Threads | single queue (tasks/s) | work stealing (tasks/s)";
+    std::cout << std::endl;
+    for (size_t nThreads = 1; nThreads <= 64; nThreads *= 2) {
+        double baseline = 0.0;
+        {
+            SingleQueueThreadPool pool(nThreads);
+            baseline = measureThroughput(pool, nProducers, NumTasks);
+        }
+        double stealing = 0.0;
+        {
+            ThreadPool pool(nThreads);
+            stealing = measureThroughput(pool, nProducers, NumTasks);
+        }
+        std::cout << nThreads << " | " << baseline << " | " << stealing << std::endl;
+    }
+}
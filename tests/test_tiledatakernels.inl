@@ -0,0 +1,276 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/tile/rawtiledatareader/tiledatakernels.h>
+#include <modules/globebrowsing/tile/rawtiledatareader/tiledatatype.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+    namespace kernels = openspace::globebrowsing::tiledatakernels;
+    namespace tiledatatype = openspace::globebrowsing::tiledatatype;
+
+    template <typename T>
+    std::vector<char> randomData(size_t count, std::mt19937& random) {
+        // Bounded so that the values fit into every type and do not overflow to
+        // infinity when converted to float
+        constexpr const double Bound = 1e6;
+        std::uniform_real_distribution<double> distribution(
+            std::max(-Bound, static_cast<double>(std::numeric_limits<T>::lowest())),
+            std::min(Bound, static_cast<double>(std::numeric_limits<T>::max()))
+        );
+        std::vector<char> data(count * sizeof(T));
+        for (size_t i = 0; i < count; ++i) {
+            T value = static_cast<T>(distribution(random));
+            std::memcpy(data.data() + i * sizeof(T), &value, sizeof(T));
+        }
+        return data;
+    }
+
+    std::vector<char> randomData(GLenum glType, size_t count, std::mt19937& random) {
+        switch (glType) {
+            case GL_UNSIGNED_BYTE:  return randomData<GLubyte>(count, random);
+            case GL_UNSIGNED_SHORT:
+            case GL_HALF_FLOAT:     return randomData<GLushort>(count, random);
+            case GL_SHORT:          return randomData<GLshort>(count, random);
+            case GL_UNSIGNED_INT:   return randomData<GLuint>(count, random);
+            case GL_INT:            return randomData<GLint>(count, random);
+            case GL_FLOAT:          return randomData<GLfloat>(count, random);
+            case GL_DOUBLE:         return randomData<GLdouble>(count, random);
+            default:                return {};
+        }
+    }
+
+    // The per-value statistics the kernels replace
+    void referenceStatistics(std::vector<float>& values, size_t nRasters,
+                             float noDataValue, bool replaceMissingData,
+                             std::vector<kernels::RasterStatistics>& statistics)
+    {
+        for (size_t i = 0; i < values.size(); ++i) {
+            kernels::RasterStatistics& s = statistics[i % nRasters];
+            float value = values[i];
+            if (value != noDataValue && value == value) {
+                s.min = std::min(s.min, value);
+                s.max = std::max(s.max, value);
+            }
+            else {
+                s.hasMissingData = true;
+                if (replaceMissingData) {
+                    values[i] = -FLT_MAX;
+                }
+            }
+        }
+    }
+
+    const std::vector<GLenum> DataTypes = {
+        GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_HALF_FLOAT, GL_SHORT, GL_UNSIGNED_INT,
+        GL_INT, GL_FLOAT, GL_DOUBLE
+    };
+} // namespace
+
+class TileDataKernelsTest : public testing::Test {};
+
+TEST_F(TileDataKernelsTest, ConvertToFloat) {
+    std::mt19937 random(1337);
+    // Not a multiple of any vector width to also exercise the scalar remainder
+    const size_t count = 1031;
+    for (GLenum glType : DataTypes) {
+        std::vector<char> data = randomData(glType, count, random);
+        std::vector<float> converted(count);
+        kernels::convertToFloat(glType, data.data(), count, converted.data());
+
+        const size_t bytesPerDatum = tiledatatype::numberOfBytes(glType);
+        for (size_t i = 0; i < count; ++i) {
+            ASSERT_EQ(
+                tiledatatype::interpretFloat(glType, data.data() + i * bytesPerDatum),
+                converted[i]
+            ) << "Type " << glType << " differs at " << i;
+        }
+    }
+}
+
+TEST_F(TileDataKernelsTest, StatisticsSingleRaster) {
+    const float noData = -9999.f;
+    std::vector<float> values = { 3.f, noData, -2.f, NAN, 7.f, 1.f, 0.f, 5.f, 4.f };
+    std::vector<kernels::RasterStatistics> statistics(1);
+    kernels::accumulateStatistics(
+        values.data(),
+        values.size(),
+        1,
+        noData,
+        true,
+        statistics.data()
+    );
+
+    EXPECT_EQ(statistics[0].min, -2.f);
+    EXPECT_EQ(statistics[0].max, 7.f);
+    EXPECT_TRUE(statistics[0].hasMissingData);
+    EXPECT_TRUE(statistics[0].hasData());
+    EXPECT_EQ(values[1], -FLT_MAX);
+    EXPECT_EQ(values[3], -FLT_MAX);
+    EXPECT_EQ(values[8], 4.f);
+}
+
+TEST_F(TileDataKernelsTest, StatisticsAllMissing) {
+    const float noData = 0.f;
+    std::vector<float> values(37, noData);
+    std::vector<kernels::RasterStatistics> statistics(1);
+    kernels::accumulateStatistics(
+        values.data(),
+        values.size(),
+        1,
+        noData,
+        false,
+        statistics.data()
+    );
+
+    EXPECT_FALSE(statistics[0].hasData());
+    EXPECT_TRUE(statistics[0].hasMissingData);
+    EXPECT_EQ(values[0], noData);
+}
+
+TEST_F(TileDataKernelsTest, StatisticsInterleavedRasters) {
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> distribution(-100.f, 100.f);
+    const float noData = 13.f;
+
+    for (size_t nRasters = 1; nRasters <= 4; ++nRasters) {
+        const size_t nPixels = 517;
+        std::vector<float> values(nPixels * nRasters);
+        for (float& v : values) {
+            v = distribution(random);
+        }
+        // Only the second raster has missing data
+        if (nRasters > 1) {
+            values[nRasters + 1] = noData;
+            values[5 * nRasters + 1] = NAN;
+        }
+
+        std::vector<float> expectedValues = values;
+        std::vector<kernels::RasterStatistics> expected(nRasters);
+        referenceStatistics(expectedValues, nRasters, noData, true, expected);
+
+        std::vector<kernels::RasterStatistics> statistics(nRasters);
+        kernels::accumulateStatistics(
+            values.data(),
+            nPixels,
+            nRasters,
+            noData,
+            true,
+            statistics.data()
+        );
+
+        for (size_t r = 0; r < nRasters; ++r) {
+            EXPECT_EQ(expected[r].min, statistics[r].min);
+            EXPECT_EQ(expected[r].max, statistics[r].max);
+            EXPECT_EQ(expected[r].hasMissingData, statistics[r].hasMissingData);
+        }
+        EXPECT_EQ(expectedValues, values);
+    }
+}
+
+TEST_F(TileDataKernelsTest, CopyToMappedBuffer) {
+    std::vector<char> source(4096 + 64);
+    for (size_t i = 0; i < source.size(); ++i) {
+        source[i] = static_cast<char>(i * 7);
+    }
+
+    for (size_t offset : { 0, 1, 8, 15 }) {
+        for (size_t numBytes : { 0, 3, 64, 100, 4096 }) {
+            std::vector<char> destination(source.size() + 16, 0);
+            kernels::copyToMappedBuffer(
+                destination.data() + offset,
+                source.data(),
+                numBytes
+            );
+            EXPECT_EQ(
+                0,
+                std::memcmp(destination.data() + offset, source.data(), numBytes)
+            );
+            EXPECT_EQ(destination[offset + numBytes], 0);
+        }
+    }
+}
+
+// Run with --gtest_also_run_disabled_tests to compare the kernels to per-value code on
+// synthetic 512 x 512 height tiles of every data type
+TEST_F(TileDataKernelsTest, DISABLED_Benchmark) {
+    using Clock = std::chrono::high_resolution_clock;
+    const size_t TileSize = 512;
+    const size_t NumTiles = 50;
+    const size_t count = TileSize * TileSize;
+    const float noData = 0.f;
+    std::mt19937 random(0);
+
+    for (GLenum glType : DataTypes) {
+        std::vector<char> data = randomData(glType, count, random);
+        std::vector<float> values(count);
+        const size_t bytesPerDatum = tiledatatype::numberOfBytes(glType);
+
+        Clock::time_point start = Clock::now();
+        std::vector<kernels::RasterStatistics> reference(1);
+        for (size_t t = 0; t < NumTiles; ++t) {
+            for (size_t i = 0; i < count; ++i) {
+                values[i] = tiledatatype::interpretFloat(
+                    glType,
+                    data.data() + i * bytesPerDatum
+                );
+            }
+            referenceStatistics(values, 1, noData, false, reference);
+        }
+        Clock::time_point middle = Clock::now();
+        std::vector<kernels::RasterStatistics> statistics(1);
+        for (size_t t = 0; t < NumTiles; ++t) {
+            kernels::convertToFloat(glType, data.data(), count, values.data());
+            kernels::accumulateStatistics(
+                values.data(),
+                count,
+                1,
+                noData,
+                false,
+                statistics.data()
+            );
+        }
+        Clock::time_point end = Clock::now();
+
+        ASSERT_EQ(reference[0].min, statistics[0].min);
+        ASSERT_EQ(reference[0].max, statistics[0].max);
+
+        using Ms = std::chrono::duration<double, std::milli>;
+        const double perValue = Ms(middle - start).count() / NumTiles;
+        const double kernel = Ms(end - middle).count() / NumTiles;
+        std::cout << "GLenum 0x" << std::hex << glType << std::dec << ": per value "
+                  << perValue << " ms/tile, kernels " << kernel << " ms/tile ("
+                  << perValue / kernel << "x)" << std::endl;
+    }
+}
@@ -0,0 +1,295 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/cache/tilepackfile.h>
+#include <modules/globebrowsing/tile/rawtile.h>
+#include <modules/globebrowsing/tile/tilemetadata.h>
+#include <modules/globebrowsing/tile/tiletextureinitdata.h>
+
+#include <ghoul/filesystem/filesystem.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+class TilePackFileTest : public testing::Test {
+protected:
+    void SetUp() override {
+        _path = absPath("${TESTDIR}/tiles.pack");
+        std::remove(_path.c_str());
+        std::remove((_path + ".index").c_str());
+    }
+
+    void TearDown() override {
+        std::remove(_path.c_str());
+        std::remove((_path + ".index").c_str());
+    }
+
+    static openspace::globebrowsing::TileTextureInitData initData() {
+        return openspace::globebrowsing::TileTextureInitData(
+            16,
+            16,
+            GL_UNSIGNED_BYTE,
+            ghoul::opengl::Texture::Format::RGBA,
+            false
+        );
+    }
+
+    // Writes tiles (i, i, 5) for i in [0, n) with every byte set to i
+    static void writeTiles(openspace::globebrowsing::cache::TilePackFile& packFile,
+                           int n)
+    {
+        using namespace openspace::globebrowsing;
+        std::vector<char> data(packFile.tileTextureInitData().totalNumBytes());
+        for (int i = 0; i < n; ++i) {
+            RawTile rawTile;
+            rawTile.tileIndex = TileIndex(i, i, 5);
+            rawTile.error = RawTile::ReadError::None;
+            auto metaData = std::make_shared<TileMetaData>();
+            metaData->maxValues = { static_cast<float>(i) + 0.25f };
+            metaData->minValues = { -static_cast<float>(i) };
+            metaData->hasMissingData = { i % 2 == 0 };
+            rawTile.tileMetaData = metaData;
+            std::memset(data.data(), i, data.size());
+            ASSERT_TRUE(packFile.writeTile(rawTile, data.data()));
+        }
+    }
+
+    static void expectTile(openspace::globebrowsing::cache::TilePackFile& packFile,
+                           int i)
+    {
+        using namespace openspace::globebrowsing;
+        std::vector<char> data(packFile.tileTextureInitData().totalNumBytes());
+        std::shared_ptr<RawTile> rawTile = packFile.readTile(
+            TileIndex(i, i, 5), data.data(), nullptr
+        );
+        ASSERT_NE(rawTile, nullptr) << "Tile " << i << " missing";
+        EXPECT_EQ(rawTile->imageData, data.data());
+        EXPECT_EQ(rawTile->error, RawTile::ReadError::None);
+        EXPECT_EQ(data.front(), static_cast<char>(i));
+        EXPECT_EQ(data.back(), static_cast<char>(i));
+        ASSERT_NE(rawTile->tileMetaData, nullptr);
+        EXPECT_EQ(rawTile->tileMetaData->maxValues[0], static_cast<float>(i) + 0.25f);
+        EXPECT_EQ(rawTile->tileMetaData->minValues[0], -static_cast<float>(i));
+        EXPECT_EQ(rawTile->tileMetaData->hasMissingData[0], i % 2 == 0);
+    }
+
+    std::string _path;
+};
+
+TEST_F(TilePackFileTest, ReadWrite) {
+    using namespace openspace::globebrowsing;
+
+    cache::TilePackFile packFile(_path, initData(), 1024 * 1024);
+    writeTiles(packFile, 10);
+    EXPECT_EQ(packFile.numTiles(), 10);
+
+    for (int i = 0; i < 10; ++i) {
+        expectTile(packFile, i);
+    }
+
+    std::vector<char> data(initData().totalNumBytes());
+    EXPECT_EQ(packFile.readTile(TileIndex(10, 10, 5), data.data(), nullptr), nullptr);
+
+    // Writing the same tile twice is ignored
+    RawTile rawTile;
+    rawTile.tileIndex = TileIndex(0, 0, 5);
+    EXPECT_FALSE(packFile.writeTile(rawTile, data.data()));
+}
+
+TEST_F(TilePackFileTest, ReadWhileWriting) {
+    using namespace openspace::globebrowsing;
+
+    // Every tile is read right after it was written, so the records have to be mapped
+    // while the pack file grows
+    cache::TilePackFile packFile(_path, initData(), 1024 * 1024);
+    for (int i = 0; i < 100; ++i) {
+        std::vector<char> data(initData().totalNumBytes());
+        std::memset(data.data(), i, data.size());
+        RawTile rawTile;
+        rawTile.tileIndex = TileIndex(i, i, 5);
+        rawTile.error = RawTile::ReadError::None;
+        ASSERT_TRUE(packFile.writeTile(rawTile, data.data()));
+
+        std::vector<char> result(initData().totalNumBytes());
+        ASSERT_NE(packFile.readTile(TileIndex(i, i, 5), result.data(), nullptr), nullptr);
+        EXPECT_EQ(result, data);
+        ASSERT_NE(packFile.readTile(TileIndex(0, 0, 5), result.data(), nullptr), nullptr);
+        EXPECT_EQ(result.back(), 0);
+    }
+}
+
+TEST_F(TilePackFileTest, Reopen) {
+    using namespace openspace::globebrowsing;
+    {
+        cache::TilePackFile packFile(_path, initData(), 1024 * 1024);
+        writeTiles(packFile, 10);
+    }
+
+    cache::TilePackFile packFile(
+        _path,
+        initData(),
+        1024 * 1024,
+        cache::TilePackFile::ReadOnly::Yes
+    );
+    EXPECT_EQ(packFile.numTiles(), 10);
+    for (int i = 0; i < 10; ++i) {
+        expectTile(packFile, i);
+    }
+}
+
+TEST_F(TilePackFileTest, RebuildIndex) {
+    using namespace openspace::globebrowsing;
+    {
+        cache::TilePackFile packFile(_path, initData(), 1024 * 1024);
+        writeTiles(packFile, 10);
+    }
+
+    // Simulate a crash while writing a tile without updating the index
+    {
+        std::ofstream file(_path, std::ofstream::binary | std::ofstream::app);
+        file << "incomplete";
+    }
+
+    cache::TilePackFile packFile(_path, initData(), 1024 * 1024);
+    EXPECT_EQ(packFile.numTiles(), 10);
+    for (int i = 0; i < 10; ++i) {
+        expectTile(packFile, i);
+    }
+}
+
+TEST_F(TilePackFileTest, CorruptIndex) {
+    using namespace openspace::globebrowsing;
+    {
+        cache::TilePackFile packFile(_path, initData(), 1024 * 1024);
+        writeTiles(packFile, 10);
+    }
+
+    // Overwrite the number of entries in the index header with a value that is larger
+    // than the index file
+    {
+        std::fstream file(
+            _path + ".index",
+            std::fstream::binary | std::fstream::in | std::fstream::out
+        );
+        const uint64_t nEntries = std::numeric_limits<uint64_t>::max() / 2;
+        file.seekp(24);
+        file.write(reinterpret_cast<const char*>(&nEntries), sizeof(uint64_t));
+    }
+
+    cache::TilePackFile packFile(_path, initData(), 1024 * 1024);
+    EXPECT_EQ(packFile.numTiles(), 10);
+    for (int i = 0; i < 10; ++i) {
+        expectTile(packFile, i);
+    }
+}
+
+TEST_F(TilePackFileTest, IncompatibleTextureSettings) {
+    using namespace openspace::globebrowsing;
+    {
+        cache::TilePackFile packFile(_path, initData(), 1024 * 1024);
+        writeTiles(packFile, 10);
+    }
+
+    TileTextureInitData otherInitData(
+        32,
+        32,
+        GL_UNSIGNED_BYTE,
+        ghoul::opengl::Texture::Format::RGBA,
+        false
+    );
+    cache::TilePackFile packFile(_path, otherInitData, 1024 * 1024);
+    EXPECT_EQ(packFile.numTiles(), 0);
+}
+
+TEST_F(TilePackFileTest, Compaction) {
+    using namespace openspace::globebrowsing;
+
+    // The record header, metadata and padding of each tile fit within 64 bytes
+    const size_t recordSize = initData().totalNumBytes() + 64;
+    const size_t maximumSize = 20 * recordSize;
+    {
+        cache::TilePackFile packFile(_path, initData(), 2 * maximumSize);
+        writeTiles(packFile, 19);
+    }
+    {
+        // Touch the last tiles to make them the most recently used
+        cache::TilePackFile packFile(_path, initData(), 2 * maximumSize);
+        std::vector<char> data(initData().totalNumBytes());
+        for (int i = 14; i < 19; ++i) {
+            std::shared_ptr<RawTile> rawTile = packFile.readTile(
+                TileIndex(i, i, 5), data.data(), nullptr
+            );
+            EXPECT_NE(rawTile, nullptr);
+        }
+    }
+
+    // Reducing the maximum size compacts the pack file when it is opened
+    cache::TilePackFile packFile(_path, initData(), maximumSize);
+    EXPECT_LE(packFile.size(), maximumSize * 3 / 4);
+    EXPECT_LT(packFile.numTiles(), 19);
+    for (int i = 14; i < 19; ++i) {
+        expectTile(packFile, i);
+    }
+
+    // There is room for new tiles after the compaction
+    std::vector<char> data(initData().totalNumBytes());
+    RawTile rawTile;
+    rawTile.tileIndex = TileIndex(100, 100, 5);
+    EXPECT_TRUE(packFile.writeTile(rawTile, data.data()));
+    EXPECT_NE(packFile.readTile(rawTile.tileIndex, nullptr, data.data()), nullptr);
+}
+
+TEST_F(TilePackFileTest, DatasetInfo) {
+    using namespace openspace::globebrowsing;
+
+    cache::TilePackFile::DatasetInfo info = {
+        -1.f, 2.f, 3.f, 4.f, 5.f, 1024, 512, 3, 7
+    };
+    {
+        cache::TilePackFile packFile(_path, initData(), 1024 * 1024);
+        EXPECT_FALSE(packFile.hasDatasetInfo());
+        writeTiles(packFile, 5);
+        packFile.setDatasetInfo(info);
+    }
+
+    cache::TilePackFile packFile(
+        _path,
+        initData(),
+        1024 * 1024,
+        cache::TilePackFile::ReadOnly::Yes
+    );
+    ASSERT_TRUE(packFile.hasDatasetInfo());
+    EXPECT_EQ(packFile.datasetInfo().noDataValue, info.noDataValue);
+    EXPECT_EQ(packFile.datasetInfo().depthTransformScale, info.depthTransformScale);
+    EXPECT_EQ(packFile.datasetInfo().rasterXSize, info.rasterXSize);
+    EXPECT_EQ(packFile.datasetInfo().maxChunkLevel, info.maxChunkLevel);
+    for (int i = 0; i < 5; ++i) {
+        expectTile(packFile, i);
+    }
+}
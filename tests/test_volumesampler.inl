@@ -0,0 +1,160 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2018                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/volume/rawvolume.h>
+#include <modules/volume/volumesampler.h>
+
+#include <ghoul/glm.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+    openspace::volume::RawVolume<float> randomVolume(const glm::uvec3& dims) {
+        openspace::volume::RawVolume<float> volume(dims);
+        std::mt19937 generator(7);
+        std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+        for (size_t i = 0; i < volume.nCells(); ++i) {
+            volume.set(i, distribution(generator));
+        }
+        return volume;
+    }
+
+    std::vector<glm::vec3> randomPositions(const glm::uvec3& dims, size_t n) {
+        // Includes positions outside of the volume to cover the clamping
+        std::mt19937 generator(11);
+        std::vector<glm::vec3> positions(n);
+        for (glm::vec3& p : positions) {
+            for (int axis = 0; axis < 3; ++axis) {
+                std::uniform_real_distribution<float> distribution(
+                    -2.f,
+                    static_cast<float>(dims[axis]) + 1.f
+                );
+                p[axis] = distribution(generator);
+            }
+        }
+        return positions;
+    }
+
+    // A box filter of the passed odd size that is interpolated at its edges, evaluated
+    // tap by tap
+    float referenceSample(const openspace::volume::RawVolume<float>& volume,
+                          const glm::ivec3& filterSize, const glm::vec3& position)
+    {
+        const glm::ivec3 dims = glm::ivec3(volume.dimensions());
+        const glm::vec3 floored = glm::floor(position);
+        const glm::vec3 t = position - floored;
+        const glm::ivec3 minCoords = glm::ivec3(floored) - filterSize / 2;
+
+        double value = 0.0;
+        for (int z = 0; z <= filterSize.z; ++z) {
+            for (int y = 0; y <= filterSize.y; ++y) {
+                for (int x = 0; x <= filterSize.x; ++x) {
+                    const glm::ivec3 tap = glm::ivec3(x, y, z);
+                    double weight = 1.0;
+                    for (int axis = 0; axis < 3; ++axis) {
+                        if (tap[axis] == 0) {
+                            weight *= 1.0 - t[axis];
+                        }
+                        else if (tap[axis] == filterSize[axis]) {
+                            weight *= t[axis];
+                        }
+                    }
+                    const glm::ivec3 coords = glm::clamp(
+                        minCoords + tap,
+                        glm::ivec3(0),
+                        dims - glm::ivec3(1)
+                    );
+                    value += weight * volume.get(glm::uvec3(coords));
+                }
+            }
+        }
+        return static_cast<float>(value / (filterSize.x * filterSize.y * filterSize.z));
+    }
+} // namespace
+
+class VolumeSamplerTest : public testing::Test {};
+
+TEST_F(VolumeSamplerTest, FilterSizes) {
+    using namespace openspace::volume;
+
+    const glm::uvec3 dims(9, 7, 8);
+    RawVolume<float> volume = randomVolume(dims);
+    const std::vector<glm::vec3> positions = randomPositions(dims, 200);
+
+    const std::vector<glm::ivec3> filterSizes = {
+        glm::ivec3(1), glm::ivec3(3), glm::ivec3(5), glm::ivec3(7), glm::ivec3(3, 1, 5)
+    };
+    for (const glm::ivec3& filterSize : filterSizes) {
+        VolumeSampler<RawVolume<float>> sampler(volume, glm::vec3(filterSize));
+        for (const glm::vec3& p : positions) {
+            EXPECT_NEAR(sampler.sample(p), referenceSample(volume, filterSize, p), 1e-5f);
+        }
+    }
+}
+
+TEST_F(VolumeSamplerTest, BatchMatchesSingle) {
+    using namespace openspace::volume;
+
+    const glm::uvec3 dims(9, 7, 8);
+    RawVolume<float> volume = randomVolume(dims);
+    // Not a multiple of the block size
+    const std::vector<glm::vec3> positions = randomPositions(dims, 1000);
+
+    for (float filterSize : { 1.f, 3.f }) {
+        VolumeSampler<RawVolume<float>> sampler(volume, glm::vec3(filterSize));
+        const std::vector<float> values = sampler.sample(positions);
+        ASSERT_EQ(values.size(), positions.size());
+        for (size_t i = 0; i < positions.size(); ++i) {
+            EXPECT_NEAR(values[i], sampler.sample(positions[i]), 1e-5f);
+        }
+    }
+}
+
+TEST_F(VolumeSamplerTest, Resample) {
+    using namespace openspace::volume;
+
+    const glm::uvec3 dims(16, 12, 10);
+    RawVolume<float> volume = randomVolume(dims);
+
+    // Sampling at the voxel centers reproduces the volume
+    VolumeSampler<RawVolume<float>> identitySampler(volume, glm::vec3(1.f));
+    RawVolume<float> same = identitySampler.resample(dims);
+    for (size_t i = 0; i < volume.nCells(); ++i) {
+        EXPECT_EQ(same.get(i), volume.get(i));
+    }
+
+    const glm::uvec3 smallDims(4, 4, 5);
+    const glm::vec3 ratio = glm::vec3(dims) / glm::vec3(smallDims);
+    VolumeSampler<RawVolume<float>> sampler(volume, ratio);
+    RawVolume<float> small = sampler.resample(smallDims);
+    ASSERT_EQ(small.dimensions(), smallDims);
+    for (size_t i = 0; i < small.nCells(); ++i) {
+        const glm::vec3 coords = glm::vec3(small.indexToCoords(i));
+        const glm::vec3 position = (coords + glm::vec3(0.5f)) * ratio - glm::vec3(0.5f);
+        EXPECT_NEAR(small.get(i), sampler.sample(position), 1e-5f);
+    }
+}